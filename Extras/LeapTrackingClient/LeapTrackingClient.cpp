@@ -0,0 +1,170 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+// Reference client for the plugin tracking server, see README.md. Subscribes, prints the palm of every hand it
+// receives and reports dropped frames from gaps in the sequence numbers.
+
+#include "../../Source/UltraleapTrackingCore/Public/LeapTrackingProtocol.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef SOCKET SocketType;
+#define CloseSocket closesocket
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+typedef int SocketType;
+#define INVALID_SOCKET -1
+#define CloseSocket close
+#endif
+
+namespace
+{
+// Renew the subscription well within the server's client timeout
+const double HelloIntervalSeconds = 1.0;
+
+double Seconds()
+{
+	using namespace std::chrono;
+	return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void SendHello(SocketType Socket, const sockaddr_in& Server, const uint16_t RateHz)
+{
+	uint8_t Buffer[LeapTrackingProtocol::HelloSize];
+	const size_t Size = LeapTrackingProtocol::WriteHello(Buffer, sizeof(Buffer), RateHz);
+	sendto(Socket, (const char*) Buffer, (int) Size, 0, (const sockaddr*) &Server, sizeof(Server));
+}
+
+void SendGoodbye(SocketType Socket, const sockaddr_in& Server)
+{
+	uint8_t Buffer[LeapTrackingProtocol::PreambleSize];
+	const size_t Size = LeapTrackingProtocol::WriteGoodbye(Buffer, sizeof(Buffer));
+	sendto(Socket, (const char*) Buffer, (int) Size, 0, (const sockaddr*) &Server, sizeof(Server));
+}
+}	 // namespace
+
+int main(int argc, char** argv)
+{
+	const char* Host = argc > 1 ? argv[1] : "127.0.0.1";
+	const int Port = argc > 2 ? atoi(argv[2]) : LeapTrackingProtocol::DefaultPort;
+	const int RateHz = argc > 3 ? atoi(argv[3]) : 30;
+	const int NumFrames = argc > 4 ? atoi(argv[4]) : 0;
+
+#ifdef _WIN32
+	WSADATA WsaData;
+	WSAStartup(MAKEWORD(2, 2), &WsaData);
+#endif
+
+	SocketType Socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (Socket == INVALID_SOCKET)
+	{
+		fprintf(stderr, "Couldn't create a socket\n");
+		return 1;
+	}
+
+	// Wake up regularly to renew the subscription
+#ifdef _WIN32
+	DWORD Timeout = 250;
+	setsockopt(Socket, SOL_SOCKET, SO_RCVTIMEO, (const char*) &Timeout, sizeof(Timeout));
+#else
+	timeval Timeout = {0, 250000};
+	setsockopt(Socket, SOL_SOCKET, SO_RCVTIMEO, &Timeout, sizeof(Timeout));
+#endif
+
+	sockaddr_in Server = {};
+	Server.sin_family = AF_INET;
+	Server.sin_port = htons((uint16_t) Port);
+	if (inet_pton(AF_INET, Host, &Server.sin_addr) != 1)
+	{
+		fprintf(stderr, "%s is not an IPv4 address\n", Host);
+		return 1;
+	}
+
+	printf("Subscribing to %s:%d at %dHz, protocol version %d\n", Host, Port, RateHz, LeapTrackingProtocol::Version);
+	SendHello(Socket, Server, (uint16_t) RateHz);
+	double LastHello = Seconds();
+
+	uint8_t Buffer[LeapTrackingProtocol::MaxFrameSize];
+	LeapTrackingProtocol::FHand Hands[LeapTrackingProtocol::MaxHands];
+	uint32_t LastSequence = 0;
+	unsigned long Received = 0;
+	unsigned long Dropped = 0;
+
+	while (NumFrames == 0 || Received < (unsigned long) NumFrames)
+	{
+		if (Seconds() - LastHello > HelloIntervalSeconds)
+		{
+			SendHello(Socket, Server, (uint16_t) RateHz);
+			LastHello = Seconds();
+		}
+
+		const int Size = (int) recv(Socket, (char*) Buffer, sizeof(Buffer), 0);
+		if (Size <= 0)
+		{
+			continue;
+		}
+
+		uint16_t Version = 0;
+		const LeapTrackingProtocol::EMessageType Type = LeapTrackingProtocol::ReadPreamble(Buffer, Size, Version);
+		if (Type == LeapTrackingProtocol::EMessageType::Goodbye)
+		{
+			if (Version != LeapTrackingProtocol::Version)
+			{
+				fprintf(stderr, "Server speaks protocol version %d, this client version %d\n", Version,
+					LeapTrackingProtocol::Version);
+				break;
+			}
+			// The server stopped, resubscribe in case it comes back
+			printf("Server said goodbye\n");
+			LastSequence = 0;
+			continue;
+		}
+
+		LeapTrackingProtocol::FFrameHeader Header;
+		if (Type != LeapTrackingProtocol::EMessageType::Frame || !LeapTrackingProtocol::ReadFrame(Buffer, Size, Header, Hands))
+		{
+			continue;
+		}
+
+		// Sequence restarts at 1 when the server sees us as a new client
+		if (LastSequence != 0 && Header.Sequence > LastSequence + 1)
+		{
+			Dropped += Header.Sequence - LastSequence - 1;
+		}
+		LastSequence = Header.Sequence;
+		Received++;
+
+		printf("#%u frame %d t=%lld hands=%d", Header.Sequence, Header.FrameId, (long long) Header.TimestampMicros,
+			Header.HandCount);
+		for (int HandIndex = 0; HandIndex < Header.HandCount; HandIndex++)
+		{
+			const float* Palm = Hands[HandIndex].Joints[2];
+			printf(" %s palm=(%.1f, %.1f, %.1f) grab=%.2f", Hands[HandIndex].HandType == 0 ? "L" : "R", Palm[0], Palm[1],
+				Palm[2], Hands[HandIndex].GrabStrength);
+		}
+		printf("\n");
+	}
+
+	printf("Received %lu frames, dropped %lu\n", Received, Dropped);
+	SendGoodbye(Socket, Server);
+	CloseSocket(Socket);
+#ifdef _WIN32
+	WSACleanup();
+#endif
+	return 0;
+}
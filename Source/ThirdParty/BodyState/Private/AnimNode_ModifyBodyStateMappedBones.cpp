@@ -21,6 +21,7 @@
 #include "AnimNode_ModifyBodyStateMappedBones.h"
 
 #include "AnimationRuntime.h"
+#include "BodyStateStats.h"
 #include "BoneControllers/AnimNode_SkeletalControlBase.h"
 #include "Runtime/Engine/Public/Animation/AnimInstanceProxy.h"
 #include "Skeleton/BodyStateArm.h"
@@ -283,7 +284,8 @@ void FAnimNode_ModifyBodyStateMappedBones::SetHandGlobalScale(FTransform& NewBon
 float FAnimNode_ModifyBodyStateMappedBones::CalculateLeapHandLength(const FMappedBoneAnimData& MappedBoneAnimData)
 {
 	float Length = 0;
-	TArray<FCachedBoneLink> FingerBones;
+	// Evaluated every frame, point at the cached bones rather than copying them to the heap
+	TArray<const FCachedBoneLink*, TInlineAllocator<8>> FingerBones;
 	for (auto& CachedBone : MappedBoneAnimData.CachedBoneList)
 	{
 		switch (CachedBone.BSBone->BoneType)
@@ -296,14 +298,14 @@ float FAnimNode_ModifyBodyStateMappedBones::CalculateLeapHandLength(const FMappe
 			case EBodyStateBasicBoneType::BONE_MIDDLE_1_PROXIMAL_R:
 			case EBodyStateBasicBoneType::BONE_MIDDLE_2_INTERMEDIATE_R:
 			case EBodyStateBasicBoneType::BONE_MIDDLE_3_DISTAL_R:
-				FingerBones.Add(CachedBone);
+				FingerBones.Add(&CachedBone);
 				break;
 		}
 	}
 
 	for (int i = 0; i < (FingerBones.Num() - 1); ++i)
 	{
-		float Magnitude = FVector::Distance(FingerBones[i].BSBone->BoneData.Transform.GetLocation(),FingerBones[i+1].BSBone->BoneData.Transform.GetLocation());
+		float Magnitude = FVector::Distance(FingerBones[i]->BSBone->BoneData.Transform.GetLocation(),FingerBones[i+1]->BSBone->BoneData.Transform.GetLocation());
 		Length += Magnitude;
 	}
 	return Length;
@@ -311,6 +313,7 @@ float FAnimNode_ModifyBodyStateMappedBones::CalculateLeapHandLength(const FMappe
 
 void FAnimNode_ModifyBodyStateMappedBones::EvaluateComponentPose_AnyThread(FComponentSpacePoseContext& Output)
 {
+	BODYSTATE_SCOPE_CYCLE_COUNTER(STAT_BodyStateAnimEvaluate);
 	Super::EvaluateComponentPose_AnyThread(Output);
 
 	if (!CheckInitEvaulate())
@@ -318,7 +321,7 @@ void FAnimNode_ModifyBodyStateMappedBones::EvaluateComponentPose_AnyThread(FComp
 		return;
 	}
 	
-	for (auto MappedBoneAnimData : BSAnimInstance->MappedBoneList)
+	for (const FMappedBoneAnimData& MappedBoneAnimData : BSAnimInstance->MappedBoneList)
 	{
 		
 		if (!MappedBoneAnimData.BodyStateSkeleton)
@@ -334,6 +337,7 @@ void FAnimNode_ModifyBodyStateMappedBones::EvaluateComponentPose_AnyThread(FComp
 		float BlendWeight = FMath::Clamp<float>(ActualAlpha, 0.f, 1.f);
 
 		FScopeLock ScopeLock(&MappedBoneAnimData.BodyStateSkeleton->BoneDataLock);
+		MappedBoneAnimData.BodyStateSkeleton->LastEvaluationCycles.store(FPlatformTime::Cycles64(), std::memory_order_relaxed);
 
 		// cached for elbow position
 		const FCachedBoneLink* ArmCachedBone = nullptr;
@@ -345,9 +349,9 @@ void FAnimNode_ModifyBodyStateMappedBones::EvaluateComponentPose_AnyThread(FComp
 		}
 		int LoopCount = 0;
 		FTransform PrevBoneTM;
-		FCachedBoneLink* CachedPrevBone = &MappedBoneAnimData.CachedBoneList[0];
+		const FCachedBoneLink* CachedPrevBone = &MappedBoneAnimData.CachedBoneList[0];
 
-		for (auto& CachedBone : MappedBoneAnimData.CachedBoneList)
+		for (const FCachedBoneLink& CachedBone : MappedBoneAnimData.CachedBoneList)
 		{
 			if (CachedBone.MeshBone.BoneIndex == -1)
 			{
@@ -376,9 +380,9 @@ void FAnimNode_ModifyBodyStateMappedBones::EvaluateComponentPose_AnyThread(FComp
 				ApplyTranslation(CachedBone, NewBoneTM, WristCachedBone, ArmCachedBone, MappedBoneAnimData);
 			}
 			// Set the transform back into the anim system
-			TArray<FBoneTransform> TempTransform;
-			TempTransform.Add(FBoneTransform(CachedBone.MeshBone.GetCompactPoseIndex(BoneContainer), NewBoneTM));
-			Output.Pose.LocalBlendCSBoneTransforms(TempTransform, BlendWeight);
+			BoneTransformScratch.Reset();
+			BoneTransformScratch.Add(FBoneTransform(CompactPoseBoneToModify, NewBoneTM));
+			Output.Pose.LocalBlendCSBoneTransforms(BoneTransformScratch, BlendWeight);
 
 			CachedPrevBone = &CachedBone;
 			PrevBoneTM = NewBoneTM;
@@ -21,6 +21,7 @@
 #include "BodyStateAnimInstance.h"
 
 #include "BodyStateBPLibrary.h"
+#include "BodyStateStats.h"
 #include "BodyStateUtility.h"
 #include "Kismet/KismetMathLibrary.h"
 
@@ -1071,6 +1072,7 @@ void UBodyStateAnimInstance::NativeInitializeAnimation()
 
 void UBodyStateAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
 {
+	BODYSTATE_SCOPE_CYCLE_COUNTER(STAT_BodyStateAnimUpdate);
 	Super::NativeUpdateAnimation(DeltaSeconds);
 
 	// SN: may want to optimize this at some pt
@@ -20,6 +20,7 @@
 
 #include "BodyStateSkeletonStorage.h"
 
+#include "BodyStateStats.h"
 #include "BodyStateUtility.h"
 #include "CoreMinimal.h"
 #include "Misc/App.h"
@@ -147,6 +148,7 @@ UBodyStateSkeleton* FBodyStateSkeletonStorage::MergedSkeleton()
 
 void FBodyStateSkeletonStorage::UpdateMergeSkeletonData()
 {
+	BODYSTATE_SCOPE_CYCLE_COUNTER(STAT_BodyStateSkeletonMerge);
 	double Now = FApp::GetCurrentTime();
 	DeltaTime = (Now - LastFrameTime);
 
@@ -160,7 +162,6 @@ void FBodyStateSkeletonStorage::UpdateMergeSkeletonData()
 
 	// Reset our confidence
 	PrivateMergedSkeleton->ClearConfidence();
-	PrivateMergedSkeleton->TrackingTags.Empty();
 
 	// Merges all skeleton data
 	{
@@ -170,6 +171,18 @@ void FBodyStateSkeletonStorage::UpdateMergeSkeletonData()
 			UBodyStateSkeleton* Skeleton = Elem.Value.Skeleton;
 			PrivateMergedSkeleton->MergeFromOtherSkeleton(Skeleton);
 		}
+
+		// Tags are merged uniquely, drop the ones no device reports anymore rather than rebuilding the list each tick
+		PrivateMergedSkeleton->TrackingTags.RemoveAll([this](const FString& Tag) {
+			for (auto& Elem : Devices)
+			{
+				if (Elem.Value.Skeleton->TrackingTags.Contains(Tag))
+				{
+					return false;
+				}
+			}
+			return true;
+		});
 	}
 
 	// Dispatch estimator function lambdas which give merge skeleton and expect further updated values
@@ -180,6 +193,7 @@ void FBodyStateSkeletonStorage::UpdateMergeSkeletonData()
 
 void FBodyStateSkeletonStorage::CallMergingFunctions()
 {
+	BODYSTATE_SCOPE_CYCLE_COUNTER(STAT_BodyStateMergingFunctions);
 	// Call all merging functions on our private merged skeleton
 	for (auto& Pair : MergingFunctions)
 	{
@@ -0,0 +1,42 @@
+/*************************************************************************************************************************************
+ *The MIT License(MIT)
+ *
+ *Copyright(c) 2016 Jan Kaniewski(Getnamo)
+ *Modified work Copyright(C) 2019 - 2021 Ultraleap, Inc.
+ *
+ *Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation
+ *files(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+ *merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons to whom the Software is
+ *furnished to do so, subject to the following conditions :
+ *
+ *The above copyright notice and this permission notice shall be included in all copies or
+ *substantial portions of the Software.
+ *
+ *THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ *FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+// "stat BodyState", also traced on the BodyState channel (-trace=cpu,bodystate)
+DECLARE_STATS_GROUP(TEXT("BodyState"), STATGROUP_BodyState, STATCAT_Advanced);
+
+UE_TRACE_CHANNEL_EXTERN(BodyStateChannel);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("BodyState Dispatch Input"), STAT_BodyStateDispatchInput, STATGROUP_BodyState, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("BodyState Skeleton Merge"), STAT_BodyStateSkeletonMerge, STATGROUP_BodyState, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("BodyState Merging Functions"), STAT_BodyStateMergingFunctions, STATGROUP_BodyState, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("BodyState Scene Listeners"), STAT_BodyStateSceneListeners, STATGROUP_BodyState, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("BodyState Anim Update"), STAT_BodyStateAnimUpdate, STATGROUP_BodyState, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("BodyState Anim Evaluate"), STAT_BodyStateAnimEvaluate, STATGROUP_BodyState, );
+
+#define BODYSTATE_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat);              \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, BodyStateChannel)
@@ -25,6 +25,7 @@
 #include "BodyStateHMDSnapshot.h"
 #include "BodyStateInputInterface.h"
 #include "BodyStateSkeletonStorage.h"
+#include "BodyStateStats.h"
 #include "Framework/Application/SlateApplication.h"
 
 // UE v4.6 IM event wrappers
@@ -120,6 +121,7 @@ void FBodyStateInputDevice::SendControllerEvents()
 void FBodyStateInputDevice::DispatchInput()
 {
 	// TODO expand this
+	BODYSTATE_SCOPE_CYCLE_COUNTER(STAT_BodyStateDispatchInput);
 
 	// Fetch input from all attached devices
 	SkeletonStorage->CallFunctionOnDevices(
@@ -143,6 +145,7 @@ void FBodyStateInputDevice::UpdateSceneListeners()
 	{
 		return;
 	}
+	BODYSTATE_SCOPE_CYCLE_COUNTER(STAT_BodyStateSceneListeners);
 
 	for (auto Listener : BoneSceneListeners)
 	{
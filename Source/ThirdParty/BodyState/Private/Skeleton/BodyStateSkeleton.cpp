@@ -489,6 +489,24 @@ void UBodyStateSkeleton::SetFromOtherSkeleton(UBodyStateSkeleton* Other)
 	}
 }
 
+// Merging runs every tick, a plain assignment would free and reallocate the strings even though they rarely change
+static void CopyBoneMeta(FBodyStateBoneMeta& Meta, const FBodyStateBoneMeta& Other)
+{
+	Meta.ParentDistinctMeta = Other.ParentDistinctMeta;
+	Meta.Accuracy = Other.Accuracy;
+	Meta.Confidence = Other.Confidence;
+	Meta.TimeStamp = Other.TimeStamp;
+
+	if (!Meta.TrackingType.Equals(Other.TrackingType, ESearchCase::CaseSensitive))
+	{
+		Meta.TrackingType = Other.TrackingType;
+	}
+	if (Meta.TrackingTags != Other.TrackingTags)
+	{
+		Meta.TrackingTags = Other.TrackingTags;
+	}
+}
+
 void UBodyStateSkeleton::MergeFromOtherSkeleton(UBodyStateSkeleton* Other)
 {
 	if (!bTrackingActive)
@@ -510,7 +528,7 @@ void UBodyStateSkeleton::MergeFromOtherSkeleton(UBodyStateSkeleton* Other)
 			if (OtherBone->Meta.Confidence >= Bone->Meta.Confidence)
 			{
 				Bone->BoneData = OtherBone->BoneData;
-				Bone->Meta = OtherBone->Meta;
+				CopyBoneMeta(Bone->Meta, OtherBone->Meta);
 			}
 		}
 	
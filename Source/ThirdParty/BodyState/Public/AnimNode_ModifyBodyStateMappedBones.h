@@ -70,5 +70,7 @@ private:
 	
 
 	float CalculateLeapHandLength(const FMappedBoneAnimData& MappedBoneAnimData);
-	
+
+	// Reused for every bone so evaluation doesn't allocate
+	TArray<FBoneTransform> BoneTransformScratch;
 };
\ No newline at end of file
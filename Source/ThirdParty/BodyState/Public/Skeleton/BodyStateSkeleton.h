@@ -25,6 +25,8 @@
 #include "Skeleton/BodyStateBone.h"
 #include "UObject/CoreNet.h"
 
+#include <atomic>
+
 #include "BodyStateSkeleton.generated.h"
 
 // Used for replication
@@ -192,6 +194,9 @@ class BODYSTATE_API UBodyStateSkeleton : public UObject
 
 	FCriticalSection BoneDataLock;
 
+	/** FPlatformTime::Cycles64() when an anim graph last read the bones, used by devices to measure data latency */
+	std::atomic<uint64> LastEvaluationCycles{0};
+
 protected:
 	TArray<FNamedBoneData> TrackedBoneData();
 	TArray<FKeyedTransform> TrackedBasicBones();
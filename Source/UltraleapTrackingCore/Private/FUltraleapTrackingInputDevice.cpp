@@ -8,20 +8,27 @@
 
 #include "FUltraleapTrackingInputDevice.h"
 
+#include "BodyStateAnimInstance.h"
 #include "BodyStateBPLibrary.h"
+#include "Components/SkeletalMeshComponent.h"
 #include "Engine/Engine.h"
 #include "Framework/Application/SlateApplication.h"
 #include "IBodyState.h"
 #include "IXRTrackingSystem.h"
+#include "LeapAllocationGuard.h"
 #include "LeapAsync.h"
 #include "LeapComponent.h"
+#include "LeapSharedFrameWrapper.h"
+#include "LeapStats.h"
 #include "LeapUtility.h"
+#include "Misc/App.h"
 #include "Skeleton/BodyStateSkeleton.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/UObjectIterator.h"
 #include "UltraleapTrackingData.h"
 
-DECLARE_STATS_GROUP(TEXT("UltraleapTracking"), STATGROUP_UltraleapTracking, STATCAT_Advanced);
-DECLARE_CYCLE_STAT(TEXT("Leap Game Input and Events"), STAT_LeapInputTick, STATGROUP_UltraleapTracking);
-DECLARE_CYCLE_STAT(TEXT("Leap BodyState Tick"), STAT_LeapBodyStateTick, STATGROUP_UltraleapTracking);
+// Consumers are counted at this interval, adding a component or polling a frame checks at once
+static const double ConsumerCheckInterval = 0.5;
 
 #pragma region Utility
 bool FUltraleapTrackingInputDevice::bUseNewTrackingModeAPI = true;
@@ -34,8 +41,12 @@ void FUltraleapTrackingInputDevice::CallFunctionOnComponents(TFunction<void(ULea
 		return;
 	}
 
+	// Events are outside the steady state allocation guard, the delegates bound to them allocate freely
+	bEventsThisTick = true;
+
 	if (IsInGameThread())
 	{
+		FLeapAllocationGuardExclusion AllocationGuardExclusion;
 		for (ULeapComponent* EventDelegate : EventDelegates)
 		{
 			InFunction(EventDelegate);
@@ -55,7 +66,8 @@ void FUltraleapTrackingInputDevice::CallFunctionOnComponents(TFunction<void(ULea
 // UE v4.6 IM event wrappers
 bool FUltraleapTrackingInputDevice::EmitKeyUpEventForKey(FKey Key, int32 User = 0, bool Repeat = false)
 {
-	if (IsInGameThread())
+	// No Slate when running headless, e.g. from a commandlet
+	if (IsInGameThread() && FSlateApplication::IsInitialized())
 	{
 		FKeyEvent KeyEvent(Key, FSlateApplication::Get().GetModifierKeys(), User, Repeat, 0, 0);
 		return FSlateApplication::Get().ProcessKeyUpEvent(KeyEvent);
@@ -65,7 +77,7 @@ bool FUltraleapTrackingInputDevice::EmitKeyUpEventForKey(FKey Key, int32 User =
 
 bool FUltraleapTrackingInputDevice::EmitKeyDownEventForKey(FKey Key, int32 User = 0, bool Repeat = false)
 {
-	if (IsInGameThread())
+	if (IsInGameThread() && FSlateApplication::IsInitialized())
 	{
 		FKeyEvent KeyEvent(Key, FSlateApplication::Get().GetModifierKeys(), User, Repeat, 0, 0);
 		return FSlateApplication::Get().ProcessKeyDownEvent(KeyEvent);
@@ -75,7 +87,7 @@ bool FUltraleapTrackingInputDevice::EmitKeyDownEventForKey(FKey Key, int32 User
 
 bool FUltraleapTrackingInputDevice::EmitAnalogInputEventForKey(FKey Key, float Value, int32 User = 0, bool Repeat = false)
 {
-	if (IsInGameThread())
+	if (IsInGameThread() && FSlateApplication::IsInitialized())
 	{
 		FAnalogInputEvent AnalogInputEvent(Key, FSlateApplication::Get().GetModifierKeys(), User, Repeat, 0, 0, Value);
 		return FSlateApplication::Get().ProcessAnalogInputEvent(AnalogInputEvent);
@@ -112,6 +124,20 @@ void FUltraleapTrackingInputDevice::OnConnect()
 		UE_LOG(UltraleapTrackingLog, Log, TEXT("LeapService: OnConnect."));
 
 		IsWaitingForConnect = false;
+		StartupCache.NoteConnected(FPlatformTime::Seconds());
+
+		// Ask for the mode straight away, the game asking for the same one later then doesn't switch the service again
+		if (bStartupCacheApplied && StartupCache.HasMode())
+		{
+			if (bUseNewTrackingModeAPI)
+			{
+				SetTrackingMode(Options.Mode);
+			}
+			else
+			{
+				SetLeapPolicy(LEAP_POLICY_OPTIMIZE_HMD, Options.Mode == ELeapMode::LEAP_MODE_VR);
+			}
+		}
 
 		SetOptions(Options);
 
@@ -131,8 +157,19 @@ void FUltraleapTrackingInputDevice::OnConnectionLost()
 void FUltraleapTrackingInputDevice::OnDeviceFound(const LEAP_DEVICE_INFO* Props)
 {
 	Stats.DeviceInfo.SetFromLeapDevice((_LEAP_DEVICE_INFO*) Props);
+	StartupCache.NoteDeviceFound(FPlatformTime::Seconds(), Stats.DeviceInfo.Serial);
+	// OpenXR reports a placeholder device
+	if (bStartupCacheApplied && OpenXRWrapper == nullptr && StartupCache.SetDevice(Stats.DeviceInfo))
+	{
+		StartupCache.Save();
+	}
 	SetOptions(Options);
 
+	if (SharedFramePublisher.IsValid())
+	{
+		SharedFramePublisher->PublishDeviceInfo(*Props);
+	}
+
 	if (LeapImageHandler)
 	{
 		LeapImageHandler->Reset();
@@ -198,7 +235,13 @@ void FUltraleapTrackingInputDevice::OnDeviceFailure(const eLeapDeviceStatus Fail
 
 void FUltraleapTrackingInputDevice::OnFrame(const LEAP_TRACKING_EVENT* Frame)
 {
-	// Not used. Polled on separate thread for lower latency.
+	// Only fixed rate processing takes every frame here, otherwise the game thread polls the latest for lower latency
+	FixedRateProcessor.ProcessFrame(*Frame);
+
+	if (SharedFramePublisher.IsValid())
+	{
+		SharedFramePublisher->Publish(*Frame, LeapGetNow());
+	}
 }
 
 void FUltraleapTrackingInputDevice::OnImage(const LEAP_IMAGE_EVENT* ImageEvent)
@@ -322,14 +365,20 @@ FUltraleapTrackingInputDevice::FUltraleapTrackingInputDevice(const TSharedRef<FG
 	SwitchTrackingSource(START_IN_OPEN_XR_MODE);
 	Options.bUseOpenXRAsSource = START_IN_OPEN_XR_MODE;
 
+	FCoreUObjectDelegates::PreLoadMap.AddRaw(this, &FUltraleapTrackingInputDevice::OnPreLoadMap);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.AddRaw(this, &FUltraleapTrackingInputDevice::OnPostLoadMap);
+
 	// Multi-device note: attach multiple devices and get another ID?
 	// Origin will be different if mixing vr with desktop/mount
 
-	// Add IM keys
-	EKeys::AddKey(FKeyDetails(EKeysLeap::LeapPinchL, LOCTEXT("LeapPinchL", "Leap (L) Pinch"), FKeyDetails::GamepadKey));
-	EKeys::AddKey(FKeyDetails(EKeysLeap::LeapGrabL, LOCTEXT("LeapGrabL", "Leap (L) Grab"), FKeyDetails::GamepadKey));
-	EKeys::AddKey(FKeyDetails(EKeysLeap::LeapPinchR, LOCTEXT("LeapPinchR", "Leap (R) Pinch"), FKeyDetails::GamepadKey));
-	EKeys::AddKey(FKeyDetails(EKeysLeap::LeapGrabR, LOCTEXT("LeapGrabR", "Leap (R) Grab"), FKeyDetails::GamepadKey));
+	// Add IM keys, once even if more than one device is created (e.g. by the replay benchmark)
+	if (!EKeys::GetKeyDetails(EKeysLeap::LeapPinchL).IsValid())
+	{
+		EKeys::AddKey(FKeyDetails(EKeysLeap::LeapPinchL, LOCTEXT("LeapPinchL", "Leap (L) Pinch"), FKeyDetails::GamepadKey));
+		EKeys::AddKey(FKeyDetails(EKeysLeap::LeapGrabL, LOCTEXT("LeapGrabL", "Leap (L) Grab"), FKeyDetails::GamepadKey));
+		EKeys::AddKey(FKeyDetails(EKeysLeap::LeapPinchR, LOCTEXT("LeapPinchR", "Leap (R) Pinch"), FKeyDetails::GamepadKey));
+		EKeys::AddKey(FKeyDetails(EKeysLeap::LeapGrabR, LOCTEXT("LeapGrabR", "Leap (R) Grab"), FKeyDetails::GamepadKey));
+	}
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -349,6 +398,31 @@ void FUltraleapTrackingInputDevice::PostEarlyInit()
 	LiveLink->SyncSubjectToSkeleton(IBodyState::Get().SkeletonForDevice(BodyStateDeviceId));
 #endif
 
+	// Runtime LiveLink source, also available in packaged builds
+	if (FLeapLiveLinkSource::IsEnabled())
+	{
+		LiveLinkSource = MakeShared<FLeapLiveLinkSource>(IBodyState::Get().SkeletonForDevice(BodyStateDeviceId));
+		LiveLinkSource->AddToClient();
+	}
+
+	// Tracking server for external processes
+	if (FLeapTrackingServer::IsEnabled())
+	{
+		TrackingServer = MakeUnique<FLeapTrackingServer>();
+		TrackingServer->Start();
+	}
+
+	// Motion archive of every processed frame
+	const FString MotionArchivePath = FLeapMotionArchiveWriter::GetConfiguredPath();
+	if (!MotionArchivePath.IsEmpty())
+	{
+		MotionArchive = MakeUnique<FLeapMotionArchiveWriter>();
+		if (!MotionArchive->Open(MotionArchivePath))
+		{
+			MotionArchive.Reset();
+		}
+	}
+
 	// Image support
 	LeapImageHandler = MakeShareable(new FLeapImage);
 	LeapImageHandler->OnImageCallback.AddRaw(this, &FUltraleapTrackingInputDevice::OnImageCallback);
@@ -362,6 +436,20 @@ FUltraleapTrackingInputDevice::~FUltraleapTrackingInputDevice()
 		LiveLink->ShutDown();
 	}
 #endif
+	if (LiveLinkSource.IsValid())
+	{
+		LiveLinkSource->RemoveFromClient();
+		LiveLinkSource.Reset();
+	}
+	TrackingServer.Reset();
+	MotionArchive.Reset();
+
+	FCoreUObjectDelegates::PreLoadMap.RemoveAll(this);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.RemoveAll(this);
+	if (bHoldingForMapLoad)
+	{
+		ConsumerTracker.RemoveReference();
+	}
 
 	ShutdownLeap();
 }
@@ -380,65 +468,358 @@ void FUltraleapTrackingInputDevice::SendControllerEvents()
 
 void FUltraleapTrackingInputDevice::CaptureAndEvaluateInput()
 {
-	SCOPE_CYCLE_COUNTER(STAT_LeapInputTick);
+	LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapInputTick);
+	LEAP_LLM_SCOPE(Ultraleap_Frames);
+	if (UpdateConsumers())
+	{
+		return;
+	}
+
+	FLeapTelemetryScope TelemetryScope(Leap.Get(), "Unreal input tick", __FILE__, __LINE__);
+	FLeapAllocationGuard AllocationGuard(TEXT("Leap input tick"));
+
+	bEventsThisTick = false;
+	const int32 PastNumberOfHands = CurrentFrame.NumberOfHandsVisible;
+	bool bCaptured = false;
+	if (FixedRateProcessor.IsEnabled() && FixedRateProcessor.HasProcessedFrames())
+	{
+		bCaptured = EvaluateProcessedFrames();
+	}
+	else if (CaptureFrame())
+	{
+		bCaptured = true;
+		if (!ConsumerTracker.ConsumeWarmupFrame(LastTrackingFrameId))
+		{
+			ParseEvents();
+		}
+	}
+	if (bCaptured)
+	{
+		bJointCacheValid = false;
+	}
+	if (bCaptured && StartupCache.IsWaitingForFrames())
+	{
+		StartupCache.NoteFrame(FPlatformTime::Seconds(), CurrentFrame.NumberOfHandsVisible);
+	}
+	AllocationGuard.SetSteadyState(UpdateSteadyState(PastNumberOfHands));
+}
+
+bool FUltraleapTrackingInputDevice::UpdateConsumers()
+{
+	const double Now = FPlatformTime::Seconds();
+	if (Now < NextConsumerCheckTime)
+	{
+		return ConsumerTracker.IsPaused();
+	}
+	NextConsumerCheckTime = Now + ConsumerCheckInterval;
+
+	// New subscriptions still have to be seen while paused, publishing handles them otherwise
+	if (TrackingServer && ConsumerTracker.IsPaused())
+	{
+		TrackingServer->ReceiveMessages(Now);
+	}
+
+	// The runtime source is accepted by the local LiveLink client as soon as it's added, whether or not anything evaluates
+	// its subjects, and there's no telling which. So it only counts while leap.LiveLink.Source explicitly asks for it
+	int32 LiveLinkClients = LiveLinkSource.IsValid() && LiveLinkSource->HasClient() && FLeapLiveLinkSource::IsEnabled() ? 1 : 0;
+#if WITH_EDITOR
+	// The editor producer only has a connection once a remote client subscribed to it
+	if (LiveLink.IsValid() && LiveLink->HasConnection())
+	{
+		LiveLinkClients++;
+	}
+#endif
+	const int32 Subscribers = (TrackingServer ? TrackingServer->GetNumClients() : 0) + (SharedFramePublisher ? 1 : 0) +
+							  (MotionArchive ? 1 : 0);
+
+	ConsumerTracker.SetSettings(FLeapConsumerTracker::GetConfiguredSettings());
+	ConsumerTracker.SetCount(ELeapConsumerType::Component, EventDelegates.Num());
+	ConsumerTracker.SetCount(ELeapConsumerType::AnimInstance, CountAnimInstanceConsumers());
+	ConsumerTracker.SetCount(ELeapConsumerType::LiveLink, LiveLinkClients);
+	ConsumerTracker.SetCount(ELeapConsumerType::Subscriber, Subscribers);
+	if (ConsumerTracker.Update(Now, !FApp::HasFocus()))
+	{
+		OnTrackingPausedChanged();
+	}
+
+	// The service may still be connecting or applying the pause policy, keep trying until it takes
+	const bool bWantDevicePaused = ConsumerTracker.IsPaused() && FLeapConsumerTracker::ShouldPauseDevice();
+	if (bWantDevicePaused != bDevicePaused && Leap.IsValid() && Leap->IsConnected() && Leap->SetPaused(bWantDevicePaused))
+	{
+		bDevicePaused = bWantDevicePaused;
+	}
+	return ConsumerTracker.IsPaused();
+}
+
+void FUltraleapTrackingInputDevice::OnTrackingPausedChanged()
+{
+	if (ConsumerTracker.IsPaused())
+	{
+		FixedRateProcessor.SetEnabled(false);
+		UE_LOG(UltraleapTrackingLog, Log, TEXT("Nothing consumes hands, tracking paused."));
+		return;
+	}
+
+	// Filters and the steady state were left at the hands from before the pause
+	FixedRateProcessor.SetEnabled(Options.bUseFixedRateProcessing);
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("Tracking resumed for %d consumers."),
+		ConsumerTracker.GetNumConsumers(FPlatformTime::Seconds()));
+	JointFilterBank.Reset();
+	SteadyStateFrames = 0;
+}
+
+void FUltraleapTrackingInputDevice::OnPreLoadMap(const FString& MapName)
+{
+	// Nothing unregistering with the old world pauses tracking, hands are there as soon as the new world is
+	if (!bHoldingForMapLoad)
+	{
+		bHoldingForMapLoad = true;
+		ConsumerTracker.AddReference();
+	}
+}
+
+void FUltraleapTrackingInputDevice::OnPostLoadMap(UWorld* World)
+{
+	// The new world's consumers are registered by now, without any the pause delay starts from here
+	if (bHoldingForMapLoad)
+	{
+		bHoldingForMapLoad = false;
+		ConsumerTracker.RemoveReference();
+		NextConsumerCheckTime = 0;
+	}
+	StartupCache.NoteMapLoaded(FPlatformTime::Seconds());
+}
+
+int32 FUltraleapTrackingInputDevice::CountAnimInstanceConsumers() const
+{
+	// Visibility isn't used: hand meshes commonly hide while their hand isn't tracked, so they would never resume
+	int32 Count = 0;
+	ForEachObjectOfClass(
+		UBodyStateAnimInstance::StaticClass(),
+		[&Count](UObject* Object) {
+			const USkeletalMeshComponent* Mesh = CastChecked<UBodyStateAnimInstance>(Object)->GetSkelMeshComponent();
+			const UWorld* World = Mesh ? Mesh->GetWorld() : nullptr;
+			if (World && World->IsGameWorld() && Mesh->IsRegistered())
+			{
+				Count++;
+			}
+		},
+		true, RF_ClassDefaultObject | RF_ArchetypeObject);
+	return Count;
+}
+
+void FUltraleapTrackingInputDevice::AddTrackingConsumer()
+{
+	ConsumerTracker.AddReference();
+	NextConsumerCheckTime = 0;
+}
+
+void FUltraleapTrackingInputDevice::RemoveTrackingConsumer()
+{
+	ConsumerTracker.RemoveReference();
+}
+
+void FUltraleapTrackingInputDevice::NotePoll()
+{
+	ConsumerTracker.NotePoll(FPlatformTime::Seconds());
+	if (ConsumerTracker.IsPaused())
+	{
+		NextConsumerCheckTime = 0;
+	}
+}
+
+bool FUltraleapTrackingInputDevice::UpdateSteadyState(int32 PastNumberOfHands)
+{
+	// Hands coming and going resize the frame and fire events, allocations are only unexpected once that settles
+	if (bEventsThisTick || CurrentFrame.NumberOfHandsVisible != PastNumberOfHands)
+	{
+		SteadyStateFrames = 0;
+	}
+	else
+	{
+		SteadyStateFrames++;
+	}
+	return SteadyStateFrames > FLeapAllocationGuard::GetWarmupFrames();
+}
+
+bool FUltraleapTrackingInputDevice::CaptureFrame()
+{
 	// Did a device connect?
 	if (!Leap->IsConnected() || !Leap->GetDeviceProperties())
 	{
-		return;
+		return false;
 	}
 
 	// Todo: get frame and parse for each device
 
-	_LEAP_TRACKING_EVENT* Frame = Leap->GetFrame();
+	_LEAP_TRACKING_EVENT* Frame = nullptr;
+	{
+		LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapGetFrame);
+		Frame = Leap->GetFrame();
+	}
 
 	// Is the frame valid?
 	if (!Frame)
 	{
-		return;
+		LEAP_INC_COUNTER(LeapFramesSkipped);
+		return false;
+	}
+
+	// Recycle the oldest frame, assigning over it would reallocate the digit and bone arrays of every hand. From here
+	// on CurrentFrame is always filled in, falling back to the tracking frame if interpolation has nothing yet
+	LEAP_TRACKING_EVENT* const TrackingFrame = Frame;
+	Swap(PastFrame, CurrentFrame);
+	CurrentFrame.FinalRotationAdjustment = PastFrame.FinalRotationAdjustment;
+
+	// The game can tick faster than the device, in which case we process the same frame again
+	if (Frame->tracking_frame_id == LastTrackingFrameId)
+	{
+		LEAP_INC_COUNTER(LeapFramesSkipped);
 	}
+	else
+	{
+		LEAP_INC_COUNTER(LeapFramesReceived);
+		LastTrackingFrameId = Frame->tracking_frame_id;
+	}
+
+	if (FLeapLatencyTracker::IsEnabled())
+	{
+		LatencyTracker.OnFrameConsumed(*Leap, *Frame, GetAnimEvaluationCycles());
+	}
+	TimeWarpTimeStamp = Frame->info.timestamp;
+	int64 LeapTimeNow = 0;
+	LeapTimeNow = Leap->GetNow();
+
+	// OpenXR data is already in HMD/world space so no HMD history is needed
 	if (!Options.bUseOpenXRAsSource)
 	{
-		TimeWarpTimeStamp = Frame->info.timestamp;
-		int64 LeapTimeNow = 0;
-		LeapTimeNow = Leap->GetNow();
 		SnapshotHandler.AddCurrentHMDSample(LeapTimeNow);
+	}
 
-		HandInterpolationTimeOffset = Options.HandInterpFactor * FrameTimeInMicros;
-		FingerInterpolationTimeOffset = Options.FingerInterpFactor * FrameTimeInMicros;
+	HandInterpolationTimeOffset = Options.HandInterpFactor * FrameTimeInMicros;
+	FingerInterpolationTimeOffset = Options.FingerInterpFactor * FrameTimeInMicros;
 
-		// interpolation not supported in OpenXR
-		if (Options.bUseInterpolation)
-		{
-			// Let's interpolate the frame using leap function
+	// With OpenXR as the source the wrapper extrapolates with its own motion model, only when asked to
+	const bool bInterpolate = Options.bUseInterpolation && (!Options.bUseOpenXRAsSource || Options.bUseOpenXRPrediction);
+	if (bInterpolate)
+	{
+		// Let's interpolate the frame using leap function
 
-			// Get the future interpolated finger frame
+		// Get the future interpolated finger frame
+		{
+			LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapInterpolation);
+			LEAP_INC_COUNTER(LeapInterpolations);
 			Frame = Leap->GetInterpolatedFrameAtTime(LeapTimeNow + FingerInterpolationTimeOffset);
-			CurrentFrame.SetFromLeapFrame(Frame);
+		}
+		{
+			LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapFrameConversion);
+			CurrentFrame.SetFromLeapFrame(Frame ? Frame : TrackingFrame);
+		}
 
-			// Get the future interpolated hand frame, farther than fingers to provide
-			// lower latency
+		// Get the future interpolated hand frame, farther than fingers to provide
+		// lower latency
+		{
+			LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapInterpolation);
+			LEAP_INC_COUNTER(LeapInterpolations);
 			Frame = Leap->GetInterpolatedFrameAtTime(LeapTimeNow + HandInterpolationTimeOffset);
-			CurrentFrame.SetInterpolationPartialFromLeapFrame(Frame);
-
-			// Track our extrapolation time in stats
-			Stats.FrameExtrapolationInMS = (CurrentFrame.TimeStamp - TimeWarpTimeStamp) / 1000.f;
 		}
-		else
 		{
-			CurrentFrame.SetFromLeapFrame(Frame);
-			Stats.FrameExtrapolationInMS = 0;
+			LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapFrameConversion);
+			CurrentFrame.SetInterpolationPartialFromLeapFrame(Frame);
 		}
+
+		// Track our extrapolation time in stats
+		Stats.FrameExtrapolationInMS = (CurrentFrame.TimeStamp - TimeWarpTimeStamp) / 1000.f;
 	}
 	else
 	{
+		LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapFrameConversion);
 		CurrentFrame.SetFromLeapFrame(Frame);
 		Stats.FrameExtrapolationInMS = 0;
 	}
+	LEAP_SET_COUNTER(LeapHandsTracked, CurrentFrame.NumberOfHandsVisible);
+
+	// Smooth in device space so head motion applied in ParseEvents isn't filtered
+	const bool bUseSmoothing = Options.bUseJointSmoothing || Options.bUseRotationSmoothing;
+	if (bUseSmoothing)
+	{
+		LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapJointSmoothing);
+		JointFilterBank.FilterFrame(CurrentFrame, FrameTimeInMicros / 1000000.f);
+	}
+
+	// BodyState can take the OpenXR poses as they are, smoothing only exists on the Leap frame
+	bUsingOpenXRHandPoses = OpenXRWrapper && Options.bUseOpenXRDirectBodyState && !bUseSmoothing;
+	if (bUsingOpenXRHandPoses)
+	{
+		LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapOpenXRConversion);
+		for (int32 HandIndex = 0; HandIndex < 2; HandIndex++)
+		{
+			OpenXRHandPoseValid[HandIndex] = OpenXRWrapper->GetHandPose(HandIndex, bInterpolate,
+				LeapTimeNow + FingerInterpolationTimeOffset, LeapTimeNow + HandInterpolationTimeOffset,
+				OpenXRHandPoses[HandIndex]);
+		}
+	}
+
+	return true;
+}
+
+bool FUltraleapTrackingInputDevice::EvaluateProcessedFrames()
+{
+	if (!Leap->IsConnected() || !Leap->GetDeviceProperties())
+	{
+		return false;
+	}
+
+	// Frames still queued were scaled for the previous world, the next ones use this one
+	FixedRateProcessor.SetWorldScale(FLeapUtility::GetWorldScaleFactor());
+	const int32 NumFrames = FixedRateProcessor.TakeFrames(ProcessedFrames);
+	if (NumFrames == 0)
+	{
+		// The game ticked faster than the device, nothing new to process
+		LEAP_INC_COUNTER(LeapFramesSkipped);
+		return false;
+	}
+
+	if (FLeapLatencyTracker::IsEnabled())
+	{
+		if (const LEAP_TRACKING_EVENT* Frame = Leap->GetFrame())
+		{
+			LatencyTracker.OnFrameConsumed(*Leap, *Frame, GetAnimEvaluationCycles());
+		}
+	}
+	if (!Options.bUseOpenXRAsSource)
+	{
+		SnapshotHandler.AddCurrentHMDSample(Leap->GetNow());
+	}
+	Stats.FrameExtrapolationInMS = 0;
+	bUsingOpenXRHandPoses = false;
 
-	ParseEvents();
+	// Gestures see every device frame in order, timed by the device, only the latest is broadcast
+	for (int32 Index = 0; Index < NumFrames; Index++)
+	{
+		// Recycle the oldest frame back into the processor, as CaptureFrame recycles it for conversion
+		Swap(PastFrame, CurrentFrame);
+		Swap(CurrentFrame, ProcessedFrames[Index]);
+		CurrentFrame.FinalRotationAdjustment = PastFrame.FinalRotationAdjustment;
+		LastTrackingFrameId = CurrentFrame.FrameId;
+		TimeWarpTimeStamp = CurrentFrame.TimeStamp;
+		LEAP_INC_COUNTER(LeapFramesReceived);
+
+		if (!ConsumerTracker.ConsumeWarmupFrame(LastTrackingFrameId))
+		{
+			ParseEventsAt(CurrentFrame.TimeStamp, Index == NumFrames - 1);
+		}
+	}
+	LEAP_SET_COUNTER(LeapHandsTracked, CurrentFrame.NumberOfHandsVisible);
+	return true;
 }
 
 void FUltraleapTrackingInputDevice::ParseEvents()
+{
+	ParseEventsAt(Leap->GetNow(), true);
+}
+
+void FUltraleapTrackingInputDevice::ParseEventsAt(int64 InGestureTime, bool bBroadcastFrame)
 {
 	// Early exit: no device attached that produces data
 	if (AttachedDevices.Num() < 1)
@@ -450,6 +831,8 @@ void FUltraleapTrackingInputDevice::ParseEvents()
 	// Note with Open XR, the data is already transformed for the HMD/player camera
 	if (Options.Mode == LEAP_MODE_VR && Options.bTransformOriginToHMD && !Options.bUseOpenXRAsSource)
 	{
+		LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapHMDTransform);
+
 		// Correction for HMD offset and rotation has already been applied in call
 		// to CaptureAndEvaluateInput through CurrentFrame->SetFromLeapFrame()
 
@@ -487,24 +870,57 @@ void FUltraleapTrackingInputDevice::ParseEvents()
 		CurrentFrame.TranslateFrame(FinalHMDTranslation);
 	}
 
+	// Gesture and visibility timeouts run on this clock, the device's in fixed rate mode
+	GestureTime = InGestureTime;
 	if (LastLeapTime == 0)
-		LastLeapTime = Leap->GetNow();
+		LastLeapTime = GestureTime;
 
-	CheckHandVisibility();
-	CheckGrabGesture();
-	CheckPinchGesture();
+	{
+		LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapGestureChecks);
+		CheckHandVisibility();
+		CheckGrabGesture();
+		CheckPinchGesture();
+	}
 
 	// Emit tracking data if it is being captured
-	CallFunctionOnComponents([this](ULeapComponent* Component) {
-		// Scale input?
-		// FinalFrameData.ScaleByWorldScale(Component->GetWorld()->GetWorldSettings()->WorldToMeters
-		// / 100.f);
-		Component->OnLeapTrackingData.Broadcast(CurrentFrame);
-	});
+	if (bBroadcastFrame)
+	{
+		LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapDelegateBroadcast);
+		// Called every tick so this doesn't go through CallFunctionOnComponents, which would allocate the TFunction
+		// and count as an event
+		if (EventDelegates.Num() > 0 && IsInGameThread())
+		{
+			FLeapAllocationGuardExclusion AllocationGuardExclusion;
+			for (ULeapComponent* EventDelegate : EventDelegates)
+			{
+				// Scale input?
+				// FinalFrameData.ScaleByWorldScale(Component->GetWorld()->GetWorldSettings()->WorldToMeters
+				// / 100.f);
+				EventDelegate->OnLeapTrackingData.Broadcast(CurrentFrame);
+			}
+		}
+		else if (EventDelegates.Num() > 0)
+		{
+			CallFunctionOnComponents(
+				[this](ULeapComponent* Component) { Component->OnLeapTrackingData.Broadcast(CurrentFrame); });
+		}
+	}
+
+	if (TrackingServer.IsValid() && bBroadcastFrame)
+	{
+		TrackingServer->PublishFrame(CurrentFrame);
+	}
+
+	// Every device frame when processing at the device rate, not just the broadcast one
+	if (MotionArchive.IsValid())
+	{
+		ArchiveJoints.SetFromFrame(CurrentFrame);
+		ArchiveFrame.SetFromJoints(ArchiveJoints, CurrentFrame.TimeStamp);
+		MotionArchive->AddFrame(ArchiveFrame);
+	}
 
-	// It's now the past data
-	PastFrame = CurrentFrame;
-	LastLeapTime = Leap->GetNow();
+	// CurrentFrame becomes the past data when the next frame is captured
+	LastLeapTime = GestureTime;
 }
 
 void FUltraleapTrackingInputDevice::CheckHandVisibility()
@@ -514,11 +930,11 @@ void FUltraleapTrackingInputDevice::CheckHandVisibility()
 		// Update visible hand list, must happen first
 		if (IsLeftVisible)
 		{
-			TimeSinceLastLeftVisible = TimeSinceLastLeftVisible + (Leap->GetNow() - LastLeapTime);
+			TimeSinceLastLeftVisible = TimeSinceLastLeftVisible + (GestureTime - LastLeapTime);
 		}
 		if (IsRightVisible)
 		{
-			TimeSinceLastRightVisible = TimeSinceLastRightVisible + (Leap->GetNow() - LastLeapTime);
+			TimeSinceLastRightVisible = TimeSinceLastRightVisible + (GestureTime - LastLeapTime);
 		}
 		for (auto& Hand : CurrentFrame.Hands)
 		{
@@ -589,7 +1005,7 @@ void FUltraleapTrackingInputDevice::CheckHandVisibility()
 		// Hand end tracking must be called first before we call begin tracking
 		// Add each hand to visible hands
 		// CurrentFrame.Hands;
-		TArray<int32> VisibleHands;
+		TArray<int32, TInlineAllocator<4>> VisibleHands;
 		for (auto& Hand : CurrentFrame.Hands)
 		{
 			VisibleHands.Add(Hand.Id);
@@ -624,19 +1040,6 @@ void FUltraleapTrackingInputDevice::CheckHandVisibility()
 
 		for (auto& Hand : CurrentFrame.Hands)
 		{
-			FLeapHandData PastHand;
-
-			// Hand list is tiny, typically 1-3, just enum until you find the matching
-			// one
-			for (auto& EnumPastHand : PastFrame.Hands)
-			{
-				if (Hand.Id == EnumPastHand.Id)
-				{
-					// Same id? same hand
-					PastHand = EnumPastHand;
-				}
-			}
-
 			if (!PastVisibleHands.Contains(Hand.Id))	// or if the hand changed type?
 			{
 				// New hand
@@ -653,11 +1056,11 @@ void FUltraleapTrackingInputDevice::CheckPinchGesture()
 	{
 		if (IsLeftPinching)
 		{
-			TimeSinceLastLeftPinch = TimeSinceLastLeftPinch + (Leap->GetNow() - LastLeapTime);
+			TimeSinceLastLeftPinch = TimeSinceLastLeftPinch + (GestureTime - LastLeapTime);
 		}
 		if (IsRightPinching)
 		{
-			TimeSinceLastRightPinch = TimeSinceLastRightPinch + (Leap->GetNow() - LastLeapTime);
+			TimeSinceLastRightPinch = TimeSinceLastRightPinch + (GestureTime - LastLeapTime);
 		}
 		for (auto& Hand : CurrentFrame.Hands)
 		{
@@ -712,22 +1115,21 @@ void FUltraleapTrackingInputDevice::CheckPinchGesture()
 	{
 		for (auto& Hand : CurrentFrame.Hands)
 		{
-			FLeapHandData PastHand;
-
 			// Hand list is tiny, typically 1-3, just enum until you find the matching
-			// one
-			for (auto& EnumPastHand : PastFrame.Hands)
+			// one, only the strength is needed so don't copy the hand
+			float PastPinchStrength = 0.f;
+			for (const FLeapHandData& EnumPastHand : PastFrame.Hands)
 			{
 				if (Hand.Id == EnumPastHand.Id)
 				{
 					// Same id? same hand
-					PastHand = EnumPastHand;
+					PastPinchStrength = EnumPastHand.PinchStrength;
 				}
 			}
 
 			const FLeapHandData& FinalHandData = Hand;
 			// Pinch
-			if (Hand.PinchStrength > StartPinchThreshold && PastHand.PinchStrength <= StartPinchThreshold)
+			if (Hand.PinchStrength > StartPinchThreshold && PastPinchStrength <= StartPinchThreshold)
 			{
 				if (Hand.HandType == EHandType::LEAP_HAND_LEFT)
 				{
@@ -741,7 +1143,7 @@ void FUltraleapTrackingInputDevice::CheckPinchGesture()
 					[FinalHandData](ULeapComponent* Component) { Component->OnHandPinched.Broadcast(FinalHandData); });
 			}
 			// Unpinch (TODO: Adjust values)
-			else if (Hand.PinchStrength <= EndPinchThreshold && PastHand.PinchStrength > EndPinchThreshold)
+			else if (Hand.PinchStrength <= EndPinchThreshold && PastPinchStrength > EndPinchThreshold)
 			{
 				if (Hand.HandType == EHandType::LEAP_HAND_LEFT)
 				{
@@ -764,11 +1166,11 @@ void FUltraleapTrackingInputDevice::CheckGrabGesture()
 	{
 		if (IsLeftGrabbing)
 		{
-			TimeSinceLastLeftGrab = TimeSinceLastLeftGrab + (Leap->GetNow() - LastLeapTime);
+			TimeSinceLastLeftGrab = TimeSinceLastLeftGrab + (GestureTime - LastLeapTime);
 		}
 		if (IsRightGrabbing)
 		{
-			TimeSinceLastRightGrab = TimeSinceLastRightGrab + (Leap->GetNow() - LastLeapTime);
+			TimeSinceLastRightGrab = TimeSinceLastRightGrab + (GestureTime - LastLeapTime);
 		}
 		for (auto& Hand : CurrentFrame.Hands)
 		{
@@ -823,22 +1225,21 @@ void FUltraleapTrackingInputDevice::CheckGrabGesture()
 	{
 		for (auto& Hand : CurrentFrame.Hands)
 		{
-			FLeapHandData PastHand;
-
 			// Hand list is tiny, typically 1-3, just enum until you find the matching
-			// one
-			for (auto& EnumPastHand : PastFrame.Hands)
+			// one, only the strength is needed so don't copy the hand
+			float PastGrabStrength = 0.f;
+			for (const FLeapHandData& EnumPastHand : PastFrame.Hands)
 			{
 				if (Hand.Id == EnumPastHand.Id)
 				{
 					// Same id? same hand
-					PastHand = EnumPastHand;
+					PastGrabStrength = EnumPastHand.GrabStrength;
 				}
 			}
 
 			const FLeapHandData& FinalHandData = Hand;
 
-			if (Hand.GrabStrength > StartGrabThreshold && PastHand.GrabStrength <= StartGrabThreshold)
+			if (Hand.GrabStrength > StartGrabThreshold && PastGrabStrength <= StartGrabThreshold)
 			{
 				if (Hand.HandType == EHandType::LEAP_HAND_LEFT)
 				{
@@ -852,7 +1253,7 @@ void FUltraleapTrackingInputDevice::CheckGrabGesture()
 					[FinalHandData](ULeapComponent* Component) { Component->OnHandGrabbed.Broadcast(FinalHandData); });
 			}
 			// Release
-			else if (Hand.GrabStrength <= EndGrabThreshold && PastHand.GrabStrength > EndGrabThreshold)
+			else if (Hand.GrabStrength <= EndGrabThreshold && PastGrabStrength > EndGrabThreshold)
 			{
 				if (Hand.HandType == EHandType::LEAP_HAND_LEFT)
 				{
@@ -910,6 +1311,9 @@ void FUltraleapTrackingInputDevice::AddEventDelegate(const ULeapComponent* Event
 
 		UE_LOG(UltraleapTrackingLog, Log, TEXT("AddEventDelegate (%d)."), EventDelegates.Num());
 	}
+
+	// Resume right away rather than at the next consumer check
+	NextConsumerCheckTime = 0;
 }
 
 void FUltraleapTrackingInputDevice::RemoveEventDelegate(const ULeapComponent* EventDelegate)
@@ -926,6 +1330,13 @@ void FUltraleapTrackingInputDevice::ShutdownLeap()
 
 	if (Leap != nullptr)
 	{
+		// The service keeps a paused device paused for every client after we are gone
+		if (bDevicePaused)
+		{
+			Leap->SetPaused(false);
+			bDevicePaused = false;
+		}
+
 		// This will kill the leap thread
 		Leap->CloseConnection();
 	}
@@ -937,14 +1348,27 @@ void FUltraleapTrackingInputDevice::ShutdownLeap()
 
 void FUltraleapTrackingInputDevice::AreHandsVisible(bool& LeftHandIsVisible, bool& RightHandIsVisible)
 {
+	NotePoll();
 	LeftHandIsVisible = CurrentFrame.LeftHandVisible;
 	RightHandIsVisible = CurrentFrame.RightHandVisible;
 }
 
 void FUltraleapTrackingInputDevice::LatestFrame(FLeapFrameData& OutFrame)
 {
+	NotePoll();
 	OutFrame = CurrentFrame;
 }
+
+const FLeapJointCache& FUltraleapTrackingInputDevice::GetJointCache()
+{
+	NotePoll();
+	if (!bJointCacheValid)
+	{
+		JointCache.SetFromFrame(CurrentFrame);
+		bJointCacheValid = true;
+	}
+	return JointCache;
+}
 void FUltraleapTrackingInputDevice::SetSwizzles(
 	ELeapQuatSwizzleAxisB ToX, ELeapQuatSwizzleAxisB ToY, ELeapQuatSwizzleAxisB ToZ, ELeapQuatSwizzleAxisB ToW)
 {
@@ -990,23 +1414,62 @@ void FUltraleapTrackingInputDevice::SetTrackingMode(ELeapMode Flag)
 			break;
 	}
 }
+
+TFuture<FLeapConfigResult> FUltraleapTrackingInputDevice::RequestConfigValue(const FString& Key)
+{
+	return Leap.IsValid() ? Leap->RequestConfigValue(Key) : IUltraleapTrackingPlugin::MakeFailedConfigResult(Key);
+}
+
+TFuture<FLeapConfigResult> FUltraleapTrackingInputDevice::SaveConfigValue(const FString& Key, const FLeapConfigValue& Value)
+{
+	return Leap.IsValid() ? Leap->SaveConfigValue(Key, Value) : IUltraleapTrackingPlugin::MakeFailedConfigResult(Key);
+}
+
+bool FUltraleapTrackingInputDevice::GetCachedConfigValue(const FString& Key, FLeapConfigValue& OutValue)
+{
+	return Leap.IsValid() && Leap->GetCachedConfigValue(Key, OutValue);
+}
 #pragma endregion Leap Input Device
 
 #pragma region BodyState
 
 void FUltraleapTrackingInputDevice::UpdateInput(int32 DeviceID, class UBodyStateSkeleton* Skeleton)
 {
-	SCOPE_CYCLE_COUNTER(STAT_LeapBodyStateTick);
+	LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapBodyStateTick);
+	LEAP_LLM_SCOPE(Ultraleap_BodyState);
+	if (ConsumerTracker.IsPaused())
+	{
+		return;
+	}
+	FLeapAllocationGuard AllocationGuard(TEXT("Leap BodyState update"));
+	AllocationGuard.SetSteadyState(SteadyStateFrames > FLeapAllocationGuard::GetWarmupFrames());
 	// UE_LOG(UltraleapTrackingLog, Log, TEXT("Update requested for %d"),
 	// DeviceID);
 	bool bLeftIsTracking = false;
 	bool bRightIsTracking = false;
 
+	if (bUsingOpenXRHandPoses)
+	{
+		FScopeLock ScopeLock(&Skeleton->BoneDataLock);
+
+		// Index 0 is the left hand, see FOpenXRToLeapWrapper::GetFrame()
+		if (OpenXRHandPoseValid[0])
+		{
+			SetBSArmFromOpenXRPose(Skeleton->LeftArm(), OpenXRHandPoses[0]);
+			bLeftIsTracking = true;
+		}
+		if (OpenXRHandPoseValid[1])
+		{
+			SetBSArmFromOpenXRPose(Skeleton->RightArm(), OpenXRHandPoses[1]);
+			bRightIsTracking = true;
+		}
+	}
+	else
 	{
 		FScopeLock ScopeLock(&Skeleton->BoneDataLock);
 
 		// Update our skeleton with new data
-		for (auto LeapHand : CurrentFrame.Hands)
+		for (const FLeapHandData& LeapHand : CurrentFrame.Hands)
 		{
 			if (LeapHand.HandType == EHandType::LEAP_HAND_LEFT)
 			{
@@ -1089,8 +1552,12 @@ void FUltraleapTrackingInputDevice::UpdateInput(int32 DeviceID, class UBodyState
 // Livelink is an editor only thing
 #if WITH_EDITOR
 	// LiveLink logic
-	if (LiveLink->HasConnection())
+	if (LiveLink.IsValid() && LiveLink->HasConnection())
 	{
+		LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapLiveLinkUpdate);
+		LEAP_LLM_SCOPE(Ultraleap_LiveLink);
+		// LiveLink frames are allocated per update by the LiveLink client
+		FLeapAllocationGuardExclusion AllocationGuardExclusion;
 		if (bTrackedBonesChanged)
 		{
 			LiveLink->SyncSubjectToSkeleton(Skeleton);
@@ -1098,6 +1565,12 @@ void FUltraleapTrackingInputDevice::UpdateInput(int32 DeviceID, class UBodyState
 		LiveLink->UpdateFromBodyState(Skeleton);
 	}
 #endif
+
+	// Staging only, the source pushes from its own thread
+	if (LiveLinkSource.IsValid() && LiveLinkSource->HasClient())
+	{
+		LiveLinkSource->UpdateFromBodyState(Skeleton);
+	}
 }
 
 void FUltraleapTrackingInputDevice::OnDeviceDetach()
@@ -1156,7 +1629,94 @@ void FUltraleapTrackingInputDevice::SetBSHandFromLeapHand(UBodyStateHand* Hand,
 	}*/
 }
 
+void FUltraleapTrackingInputDevice::SetBSArmFromOpenXRPose(UBodyStateArm* Arm, const FOpenXRHandPose& Pose)
+{
+	// Mirrors the Leap frame route: the wrist keypoint is the whole arm bone, the palm gives the wrist orientation
+	const FVector& WristPosition = Pose.Positions[(int32) EHandKeypoint::Wrist];
+
+	Arm->LowerArm->SetPosition(WristPosition);
+	Arm->LowerArm->SetOrientation(Pose.Rotations[(int32) EHandKeypoint::Wrist]);
+
+	UBodyStateHand* Hand = Arm->Hand;
+	Hand->Wrist->SetPosition(WristPosition);
+	Hand->Wrist->SetOrientation(Pose.PalmOrientation);
+
+	// OpenXR has no zero length thumb metacarpal so its keypoints line up with the BodyState thumb directly
+	UBodyStateFinger* Thumb = Hand->ThumbFinger();
+	UBodyStateBone* ThumbBones[] = {Thumb->Metacarpal, Thumb->Proximal, Thumb->Distal};
+	for (int32 BoneIndex = 0; BoneIndex < UE_ARRAY_COUNT(ThumbBones); BoneIndex++)
+	{
+		const int32 Keypoint = (int32) EHandKeypoint::ThumbMetacarpal + BoneIndex;
+		ThumbBones[BoneIndex]->SetPosition(Pose.Positions[Keypoint]);
+		ThumbBones[BoneIndex]->SetOrientation(Pose.Rotations[Keypoint]);
+	}
+	Thumb->bIsExtended = false;
+
+	// Each finger is metacarpal, proximal, intermediate, distal then tip
+	UBodyStateFinger* Fingers[] = {Hand->IndexFinger(), Hand->MiddleFinger(), Hand->RingFinger(), Hand->PinkyFinger()};
+	const int32 FirstKeypoints[] = {(int32) EHandKeypoint::IndexMetacarpal, (int32) EHandKeypoint::MiddleMetacarpal,
+		(int32) EHandKeypoint::RingMetacarpal, (int32) EHandKeypoint::LittleMetacarpal};
+	for (int32 FingerIndex = 0; FingerIndex < UE_ARRAY_COUNT(Fingers); FingerIndex++)
+	{
+		UBodyStateFinger* Finger = Fingers[FingerIndex];
+		UBodyStateBone* Bones[] = {Finger->Metacarpal, Finger->Proximal, Finger->Intermediate, Finger->Distal};
+		for (int32 BoneIndex = 0; BoneIndex < UE_ARRAY_COUNT(Bones); BoneIndex++)
+		{
+			const int32 Keypoint = FirstKeypoints[FingerIndex] + BoneIndex;
+			Bones[BoneIndex]->SetPosition(Pose.Positions[Keypoint]);
+			Bones[BoneIndex]->SetOrientation(Pose.Rotations[Keypoint]);
+		}
+
+		// The OpenXR wrapper never reports extension
+		Finger->bIsExtended = false;
+	}
+}
+
 #pragma endregion BodyState
+void FUltraleapTrackingInputDevice::SetTrackingWrapper(TSharedPtr<IHandTrackingWrapper> InWrapper)
+{
+	check(InWrapper.IsValid());
+
+	if (Leap != nullptr)
+	{
+		Leap->CloseConnection();
+	}
+	OpenXRWrapper = nullptr;
+	IsWaitingForConnect = false;
+
+	Leap = InWrapper;
+	StartupCache.BeginConnection(FPlatformTime::Seconds());
+	LatencyTracker.Reset();
+	FixedRateProcessor.Reset();
+	SteadyStateFrames = 0;
+	Leap->OpenConnection(this);
+}
+void FUltraleapTrackingInputDevice::ApplyStartupCache()
+{
+	if (!FLeapStartupCache::IsEnabled())
+	{
+		return;
+	}
+	bStartupCacheApplied = true;
+	if (!StartupCache.Load())
+	{
+		return;
+	}
+
+	// Fidelity presets depend on the device type, the first options applied on connect already use the right ones
+	if (StartupCache.HasDevice() && Stats.DeviceInfo.Serial.IsEmpty())
+	{
+		Stats.DeviceInfo = StartupCache.GetDevice();
+	}
+	// Sent as soon as the service connects
+	if (StartupCache.HasMode())
+	{
+		Options.Mode = StartupCache.GetMode();
+	}
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("Startup cache applied: device %s, tracking mode %d."),
+		StartupCache.HasDevice() ? *StartupCache.GetDevice().Serial : TEXT("none"),
+		StartupCache.HasMode() ? (int32) StartupCache.GetMode() : -1);
+}
 void FUltraleapTrackingInputDevice::SwitchTrackingSource(const bool UseOpenXRAsSource)
 {
 	if (IsWaitingForConnect)
@@ -1171,16 +1731,41 @@ void FUltraleapTrackingInputDevice::SwitchTrackingSource(const bool UseOpenXRAsS
 
 	if (UseOpenXRAsSource)
 	{
-		Leap = TSharedPtr<IHandTrackingWrapper>(new FOpenXRToLeapWrapper);
+		OpenXRWrapper = new FOpenXRToLeapWrapper;
+		Leap = TSharedPtr<IHandTrackingWrapper>(OpenXRWrapper);
 	}
 	else
 	{
-		Leap = TSharedPtr<IHandTrackingWrapper>(new FLeapWrapper);
+		OpenXRWrapper = nullptr;
+		const ELeapSharedFrameMode SharedFrameMode = FLeapSharedFrameRing::GetConfiguredMode();
+		if (SharedFrameMode == ELeapSharedFrameMode::Consume)
+		{
+			// Another process owns the device
+			Leap = TSharedPtr<IHandTrackingWrapper>(new FLeapSharedFrameWrapper(FLeapSharedFrameRing::GetConfiguredName()));
+		}
+		else
+		{
+			Leap = TSharedPtr<IHandTrackingWrapper>(new FLeapWrapper);
+			if (SharedFrameMode == ELeapSharedFrameMode::Publish && !SharedFramePublisher.IsValid())
+			{
+				SharedFramePublisher = MakeUnique<FLeapSharedFrameRing>();
+				if (!SharedFramePublisher->Create(FLeapSharedFrameRing::GetConfiguredName()))
+				{
+					UE_LOG(UltraleapTrackingLog, Warning, TEXT("Couldn't create the shared frame ring %s"),
+						*FLeapSharedFrameRing::GetConfiguredName());
+					SharedFramePublisher.Reset();
+				}
+			}
+		}
 	}
 	if (!UseOpenXRAsSource)
 	{
 		IsWaitingForConnect = true;
 	}
+	StartupCache.BeginConnection(FPlatformTime::Seconds());
+	LatencyTracker.Reset();
+	FixedRateProcessor.Reset();
+	SteadyStateFrames = 0;
 	Leap->OpenConnection(this);
 }
 void FUltraleapTrackingInputDevice::SetOptions(const FLeapOptions& InOptions)
@@ -1201,6 +1786,10 @@ void FUltraleapTrackingInputDevice::SetOptions(const FLeapOptions& InOptions)
 	// Did we change the mode?
 	if (Options.Mode != InOptions.Mode)
 	{
+		if (bStartupCacheApplied && StartupCache.SetMode(InOptions.Mode))
+		{
+			StartupCache.Save();
+		}
 		if (bUseNewTrackingModeAPI)
 		{
 			SetTrackingMode(InOptions.Mode);
@@ -1451,9 +2040,6 @@ void FUltraleapTrackingInputDevice::SetOptions(const FLeapOptions& InOptions)
 		Options.bUseTimeWarp = false;
 	}
 
-	// Always sync global offsets
-	FLeapUtility::SetLeapGlobalOffsets(Options.HMDPositionOffset, Options.HMDRotationOffset);
-
 	/*UseTimeBasedVisibilityCheck =*/UseTimeBasedGestureCheck = !Options.bUseFrameBasedGestureDetection;
 
 	StartGrabThreshold = Options.StartGrabThreshold;
@@ -1462,6 +2048,26 @@ void FUltraleapTrackingInputDevice::SetOptions(const FLeapOptions& InOptions)
 	EndPinchThreshold = Options.EndPinchThreshold;
 	GrabTimeout = Options.GrabTimeout;
 	PinchTimeout = Options.PinchTimeout;
+
+	JointFilterBank.Init(Options.JointSmoothingMinCutoff, Options.JointSmoothingCutoffSlope, Options.JointSmoothingDeltaCutoff);
+	JointFilterBank.InitRotations(
+		Options.RotationSmoothingMinCutoff, Options.RotationSmoothingCutoffSlope, Options.JointSmoothingDeltaCutoff);
+	JointFilterBank.SetChannels(Options.bUseJointSmoothing, Options.bUseRotationSmoothing);
+
+	FLeapFixedRateProcessor::FSettings ProcessorSettings;
+	ProcessorSettings.bFilterPositions = Options.bUseJointSmoothing;
+	ProcessorSettings.bFilterRotations = Options.bUseRotationSmoothing;
+	ProcessorSettings.MinCutoff = Options.JointSmoothingMinCutoff;
+	ProcessorSettings.CutoffSlope = Options.JointSmoothingCutoffSlope;
+	ProcessorSettings.DeltaCutoff = Options.JointSmoothingDeltaCutoff;
+	ProcessorSettings.RotationMinCutoff = Options.RotationSmoothingMinCutoff;
+	ProcessorSettings.RotationCutoffSlope = Options.RotationSmoothingCutoffSlope;
+	// Always sync global offsets, the processor writes them so its service thread conversion never sees them change
+	ProcessorSettings.MountTranslationOffset = Options.HMDPositionOffset;
+	ProcessorSettings.MountRotationOffset = Options.HMDRotationOffset;
+	ProcessorSettings.WorldScale = FLeapUtility::GetWorldScaleFactor();
+	FixedRateProcessor.SetSettings(ProcessorSettings);
+	FixedRateProcessor.SetEnabled(Options.bUseFixedRateProcessing && !ConsumerTracker.IsPaused());
 }
 FLeapOptions FUltraleapTrackingInputDevice::GetOptions()
 {
@@ -1470,6 +2076,33 @@ FLeapOptions FUltraleapTrackingInputDevice::GetOptions()
 
 FLeapStats FUltraleapTrackingInputDevice::GetStats()
 {
-	return Stats;
+	FLeapStats CurrentStats = Stats;
+	CurrentStats.bIsTrackingPaused = ConsumerTracker.IsPaused();
+	CurrentStats.TrackingConsumers = ConsumerTracker.GetNumConsumers(FPlatformTime::Seconds());
+	CurrentStats.Startup = StartupCache.GetStats();
+	if (Leap.IsValid())
+	{
+		Leap->GetConnectionStats(CurrentStats.ServiceConnection);
+	}
+	return CurrentStats;
+}
+FLeapLatencyPercentiles FUltraleapTrackingInputDevice::GetLatencyPercentiles(ELeapLatencyStage Stage) const
+{
+	return LatencyTracker.GetPercentiles(Stage);
+}
+// Anim instances usually read the merged skeleton (device 0) rather than ours, take whichever was evaluated last
+uint64 FUltraleapTrackingInputDevice::GetAnimEvaluationCycles() const
+{
+	uint64 Cycles = 0;
+	IBodyState& BodyState = IBodyState::Get();
+	if (UBodyStateSkeleton* MergedSkeleton = BodyState.SkeletonForDevice(0))
+	{
+		Cycles = MergedSkeleton->LastEvaluationCycles.load(std::memory_order_relaxed);
+	}
+	if (UBodyStateSkeleton* DeviceSkeleton = BodyState.SkeletonForDevice(BodyStateDeviceId))
+	{
+		Cycles = FMath::Max(Cycles, DeviceSkeleton->LastEvaluationCycles.load(std::memory_order_relaxed));
+	}
+	return Cycles;
 }
 #pragma endregion Leap Input Device
@@ -15,8 +15,18 @@
 #include "IXRTrackingSystem.h"
 #include "LeapC.h"
 #include "LeapComponent.h"
+#include "LeapConsumerTracker.h"
+#include "LeapFixedRateProcessor.h"
 #include "LeapImage.h"
+#include "LeapJointCache.h"
+#include "LeapJointFilterBank.h"
+#include "LeapLatencyTracker.h"
 #include "LeapLiveLink.h"
+#include "LeapLiveLinkSource.h"
+#include "LeapMotionArchive.h"
+#include "LeapSharedFrameRing.h"
+#include "LeapStartupCache.h"
+#include "LeapTrackingServer.h"
 #include "LeapUtility.h"
 #include "LeapWrapper.h"
 #include "OpenXRToLeapWrapper.h"
@@ -49,8 +59,14 @@ public:
 
 	/** Main input capture and event parsing 'tick' */
 	void CaptureAndEvaluateInput();
+
+	/** Fill CurrentFrame from the wrapper, false if there was no frame to parse */
+	bool CaptureFrame();
 	void ParseEvents();
 
+	/** Fixed rate processing: check gestures on each device frame processed since the last tick, in device time */
+	bool EvaluateProcessedFrames();
+
 	/** Set which MessageHandler will get the events from SendControllerEvents. */
 	virtual void SetMessageHandler(const TSharedRef<FGenericApplicationMessageHandler>& InMessageHandler) override;
 
@@ -66,13 +82,23 @@ public:
 
 	void AddEventDelegate(const ULeapComponent* EventDelegate);
 	void RemoveEventDelegate(const ULeapComponent* EventDelegate);
+
+	/** Keep tracking running for a consumer the device can't see, see leap.Pause.Auto */
+	void AddTrackingConsumer();
+	void RemoveTrackingConsumer();
 	void ShutdownLeap();
 	void AreHandsVisible(bool& LeftHandIsVisible, bool& RightHandIsVisible);
 	void LatestFrame(FLeapFrameData& OutFrame);
+	/** CurrentFrame flattened on first access after each capture */
+	const FLeapJointCache& GetJointCache();
 	void SetSwizzles(ELeapQuatSwizzleAxisB ToX, ELeapQuatSwizzleAxisB ToY, ELeapQuatSwizzleAxisB ToZ, ELeapQuatSwizzleAxisB ToW);
 	// Policy and toggles
 	void SetLeapPolicy(ELeapPolicyFlag Flag, bool Enable);
 	void SetTrackingMode(ELeapMode Flag);
+	// Tracking service configuration, futures complete on the service thread
+	TFuture<FLeapConfigResult> RequestConfigValue(const FString& Key);
+	TFuture<FLeapConfigResult> SaveConfigValue(const FString& Key, const FLeapConfigValue& Value);
+	bool GetCachedConfigValue(const FString& Key, FLeapConfigValue& OutValue);
 	// BodyState
 	virtual void UpdateInput(int32 DeviceID, class UBodyStateSkeleton* Skeleton) override;
 	virtual void OnDeviceDetach();
@@ -82,12 +108,24 @@ public:
 	void SetOptions(const FLeapOptions& Options);
 	FLeapOptions GetOptions();
 	FLeapStats GetStats();
+	FLeapLatencyPercentiles GetLatencyPercentiles(ELeapLatencyStage Stage) const;
 	const TArray<FString>& GetAttachedDevices()
 	{
 		return AttachedDevices;
 	}
 	void PostEarlyInit();
 
+	int32 GetBodyStateDeviceId() const
+	{
+		return BodyStateDeviceId;
+	}
+
+	/** Replace the tracking source, e.g. with a replay wrapper. Options still decide on the next SetOptions source switch */
+	void SetTrackingWrapper(TSharedPtr<IHandTrackingWrapper> InWrapper);
+
+	/** Apply the last session's device and tracking mode while connecting and keep them up to date, see leap.Startup.Cache */
+	void ApplyStartupCache();
+
 private:
 	bool UseTimeBasedVisibilityCheck = false;
 	bool UseTimeBasedGestureCheck = false;
@@ -114,6 +152,36 @@ private:
 	int64_t TimeSinceLastRightVisible = 10000;
 	int64_t VisibilityTimeout = 1000000;	// 1 Second
 	int64_t LastLeapTime = 0;
+	int64_t GestureTime = 0;
+	int64_t LastTrackingFrameId = -1;
+
+	// Pauses tracking while nothing consumes hands, see leap.Pause.Auto
+	FLeapConsumerTracker ConsumerTracker;
+	double NextConsumerCheckTime = 0;
+	bool bDevicePaused = false;
+	/** Refresh the consumer counts and apply a pause or resume, true while tracking is paused */
+	bool UpdateConsumers();
+	void OnTrackingPausedChanged();
+	int32 CountAnimInstanceConsumers() const;
+	/** Frame or visibility polled through the plugin interface */
+	void NotePoll();
+
+	// Single joint reads without copying CurrentFrame
+	FLeapJointCache JointCache;
+	bool bJointCacheValid = false;
+
+	// Startup state between sessions and time to first hand
+	FLeapStartupCache StartupCache;
+	bool bStartupCacheApplied = false;
+	// Map loads count as a consumer, the new world's consumers only appear once it's loaded
+	bool bHoldingForMapLoad = false;
+	void OnPreLoadMap(const FString& MapName);
+	void OnPostLoadMap(UWorld* World);
+
+	// Input ticks without events or hands changing, see leap.AllocationGuard
+	int32 SteadyStateFrames = 0;
+	bool bEventsThisTick = false;
+	bool UpdateSteadyState(int32 PastNumberOfHands);
 	FLeapHandData LastLeftHand;
 	FLeapHandData LastRightHand;
 
@@ -131,6 +199,8 @@ private:
 	void CheckHandVisibility();
 	void CheckPinchGesture();
 	void CheckGrabGesture();
+	/** ParseEvents with timeouts measured up to InGestureTime, only the latest frame of a batch is broadcast */
+	void ParseEventsAt(int64 InGestureTime, bool bBroadcastFrame);
 
 	int64 GetInterpolatedNow();
 
@@ -159,8 +229,24 @@ private:
 	FLeapFrameData CurrentFrame;
 	FLeapFrameData PastFrame;
 
+	// Joint smoothing
+	FLeapJointFilterBank JointFilterBank;
+
+	// Every device frame converted and smoothed on the service thread, see FLeapOptions::bUseFixedRateProcessing
+	FLeapFixedRateProcessor FixedRateProcessor;
+	TArray<FLeapFrameData> ProcessedFrames;
+
+	// Hand data age per pipeline stage
+	FLeapLatencyTracker LatencyTracker;
+	uint64 GetAnimEvaluationCycles() const;
+
+	// Direct OpenXR to BodyState poses, captured alongside CurrentFrame
+	FOpenXRHandPose OpenXRHandPoses[2];
+	bool OpenXRHandPoseValid[2] = {false, false};
+	bool bUsingOpenXRHandPoses = false;
+
 	TArray<FString> AttachedDevices;
-	TArray<int32> PastVisibleHands;
+	TArray<int32, TInlineAllocator<4>> PastVisibleHands;
 
 	// Time warp support
 	BSHMDSnapshotHandler SnapshotHandler;
@@ -173,6 +259,8 @@ private:
 	static bool bUseNewTrackingModeAPI;
 	// Wrapper link
 	TSharedPtr<IHandTrackingWrapper> Leap;
+	// Set while Leap is the OpenXR wrapper
+	FOpenXRToLeapWrapper* OpenXRWrapper = nullptr;
 
 	// LeapWrapper Callbacks
 	virtual void OnConnect() override;
@@ -194,11 +282,24 @@ private:
 	// LiveLink
 	TSharedPtr<FLeapLiveLinkProducer> LiveLink;
 #endif
+	TSharedPtr<FLeapLiveLinkSource> LiveLinkSource;
+
+	// Processed hands for external processes
+	TUniquePtr<FLeapTrackingServer> TrackingServer;
+
+	// Raw frames for other engine processes on this machine, written from the service thread
+	TUniquePtr<FLeapSharedFrameRing> SharedFramePublisher;
+
+	// Every processed frame recorded for QA and analytics, encoded and written on the archive's own thread
+	TUniquePtr<FLeapMotionArchiveWriter> MotionArchive;
+	FLeapJointCache ArchiveJoints;
+	FLeapMotionArchiveFrame ArchiveFrame;
 
 	// Convenience Converters - Todo: wrap into separate class?
 	void SetBSFingerFromLeapDigit(class UBodyStateFinger* Finger, const FLeapDigitData& LeapDigit);
 	void SetBSThumbFromLeapThumb(class UBodyStateFinger* Finger, const FLeapDigitData& LeapDigit);
 	void SetBSHandFromLeapHand(class UBodyStateHand* Hand, const FLeapHandData& LeapHand);
+	void SetBSArmFromOpenXRPose(class UBodyStateArm* Arm, const FOpenXRHandPose& Pose);
 
 	void SwitchTrackingSource(const bool UseOpenXRAsSource);
 
@@ -92,6 +92,30 @@ void FUltraleapTrackingPlugin::RemoveEventDelegate(const ULeapComponent* EventDe
 	}
 }
 
+void FUltraleapTrackingPlugin::AddTrackingConsumer()
+{
+	if (bActive)
+	{
+		LeapInputDevice->AddTrackingConsumer();
+	}
+	else
+	{
+		DeferredTrackingConsumers++;
+	}
+}
+
+void FUltraleapTrackingPlugin::RemoveTrackingConsumer()
+{
+	if (bActive)
+	{
+		LeapInputDevice->RemoveTrackingConsumer();
+	}
+	else if (DeferredTrackingConsumers > 0)
+	{
+		DeferredTrackingConsumers--;
+	}
+}
+
 FLeapStats FUltraleapTrackingPlugin::GetLeapStats()
 {
 	if (bActive)
@@ -104,6 +128,18 @@ FLeapStats FUltraleapTrackingPlugin::GetLeapStats()
 	}
 }
 
+FLeapLatencyPercentiles FUltraleapTrackingPlugin::GetLatencyPercentiles(ELeapLatencyStage Stage)
+{
+	if (bActive)
+	{
+		return LeapInputDevice->GetLatencyPercentiles(Stage);
+	}
+	else
+	{
+		return IUltraleapTrackingPlugin::GetLatencyPercentiles(Stage);
+	}
+}
+
 void FUltraleapTrackingPlugin::SetOptions(const FLeapOptions& Options)
 {
 	if (bActive)
@@ -141,6 +177,18 @@ void FUltraleapTrackingPlugin::GetLatestFrameData(FLeapFrameData& OutData)
 	}
 }
 
+const FLeapJointCache& FUltraleapTrackingPlugin::GetJointCache()
+{
+	if (bActive)
+	{
+		return LeapInputDevice->GetJointCache();
+	}
+	else
+	{
+		return IUltraleapTrackingPlugin::GetJointCache();
+	}
+}
+
 void FUltraleapTrackingPlugin::SetLeapPolicy(ELeapPolicyFlag Flag, bool Enable)
 {
 	if (bActive)
@@ -148,6 +196,36 @@ void FUltraleapTrackingPlugin::SetLeapPolicy(ELeapPolicyFlag Flag, bool Enable)
 		LeapInputDevice->SetLeapPolicy(Flag, Enable);
 	}
 }
+
+TFuture<FLeapConfigResult> FUltraleapTrackingPlugin::RequestConfigValue(const FString& Key)
+{
+	if (bActive)
+	{
+		return LeapInputDevice->RequestConfigValue(Key);
+	}
+	else
+	{
+		return IUltraleapTrackingPlugin::RequestConfigValue(Key);
+	}
+}
+
+TFuture<FLeapConfigResult> FUltraleapTrackingPlugin::SaveConfigValue(const FString& Key, const FLeapConfigValue& Value)
+{
+	if (bActive)
+	{
+		return LeapInputDevice->SaveConfigValue(Key, Value);
+	}
+	else
+	{
+		return IUltraleapTrackingPlugin::SaveConfigValue(Key, Value);
+	}
+}
+
+bool FUltraleapTrackingPlugin::GetCachedConfigValue(const FString& Key, FLeapConfigValue& OutValue)
+{
+	return bActive && LeapInputDevice->GetCachedConfigValue(Key, OutValue);
+}
+
 void FUltraleapTrackingPlugin::SetSwizzles(
 	ELeapQuatSwizzleAxisB ToX, ELeapQuatSwizzleAxisB ToY, ELeapQuatSwizzleAxisB ToZ, ELeapQuatSwizzleAxisB ToW)
 {
@@ -204,6 +282,8 @@ TSharedPtr<class IInputDevice> FUltraleapTrackingPlugin::CreateInputDevice(
 	if (!LeapInputDevice.IsValid())
 	{
 		LeapInputDevice = MakeShareable(new FUltraleapTrackingInputDevice(InMessageHandler));
+		// Before the service connects, only the plugin's device remembers state between sessions
+		LeapInputDevice->ApplyStartupCache();
 	}
 	else
 	{
@@ -219,6 +299,11 @@ TSharedPtr<class IInputDevice> FUltraleapTrackingPlugin::CreateInputDevice(
 	}
 	DeferredComponentList.Empty();
 
+	for (; DeferredTrackingConsumers > 0; DeferredTrackingConsumers--)
+	{
+		LeapInputDevice->AddTrackingConsumer();
+	}
+
 	return LeapInputDevice;
 }
 
@@ -24,12 +24,19 @@ public:
 
 	virtual void AddEventDelegate(const ULeapComponent* EventDelegate) override;
 	virtual void RemoveEventDelegate(const ULeapComponent* EventDelegate) override;
+	virtual void AddTrackingConsumer() override;
+	virtual void RemoveTrackingConsumer() override;
 	virtual FLeapStats GetLeapStats() override;
+	virtual FLeapLatencyPercentiles GetLatencyPercentiles(ELeapLatencyStage Stage) override;
 	virtual void SetOptions(const FLeapOptions& Options) override;
 	virtual FLeapOptions GetOptions() override;
 	virtual void AreHandsVisible(bool& LeftHandIsVisible, bool& RightHandIsVisible) override;
 	virtual void GetLatestFrameData(FLeapFrameData& OutData) override;
+	virtual const FLeapJointCache& GetJointCache() override;
 	virtual void SetLeapPolicy(ELeapPolicyFlag Flag, bool Enable) override;
+	virtual TFuture<FLeapConfigResult> RequestConfigValue(const FString& Key) override;
+	virtual TFuture<FLeapConfigResult> SaveConfigValue(const FString& Key, const FLeapConfigValue& Value) override;
+	virtual bool GetCachedConfigValue(const FString& Key, FLeapConfigValue& OutValue) override;
 	virtual void GetAttachedDevices(TArray<FString>& Devices) override;
 
 	virtual void ShutdownLeap() override;
@@ -41,6 +48,7 @@ public:
 private:
 	TSharedPtr<class FUltraleapTrackingInputDevice> LeapInputDevice;
 	TArray<ULeapComponent*> DeferredComponentList;
+	int32 DeferredTrackingConsumers = 0;
 
 	bool bActive = false;
 	void* LeapDLLHandle;
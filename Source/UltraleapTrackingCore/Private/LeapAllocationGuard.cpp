@@ -0,0 +1,80 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapAllocationGuard.h"
+
+#if LEAP_ALLOCATION_GUARD
+
+#include "HAL/IConsoleManager.h"
+#include "LeapMallocCounter.h"
+
+static TAutoConsoleVariable<int32> CVarLeapAllocationGuard(TEXT("leap.AllocationGuard"), 0,
+	TEXT("Ensure the per frame hand tracking work makes no heap allocations in steady state. Wraps GMalloc once enabled."));
+
+static TAutoConsoleVariable<int32> CVarLeapAllocationGuardWarmup(TEXT("leap.AllocationGuard.WarmupFrames"), 120,
+	TEXT("Frames with the same hands and no events before leap.AllocationGuard counts allocations"));
+
+FLeapAllocationGuard* FLeapAllocationGuard::ActiveGuard = nullptr;
+
+FLeapAllocationGuard::FLeapAllocationGuard(const TCHAR* InScopeName)
+	: ScopeName(InScopeName), bActive(false), bSteadyState(false)
+{
+	if (CVarLeapAllocationGuard.GetValueOnGameThread() == 0 || ActiveGuard != nullptr)
+	{
+		return;
+	}
+	check(IsInGameThread());
+
+	bActive = true;
+	ActiveGuard = this;
+	FLeapMallocCounter::Install().StartCounting();
+}
+
+FLeapAllocationGuard::~FLeapAllocationGuard()
+{
+	if (!bActive)
+	{
+		return;
+	}
+	FLeapMallocCounter& Counter = FLeapMallocCounter::Install();
+	Counter.StopCounting();
+	ActiveGuard = nullptr;
+
+	const FLeapMallocCounter::FCounts Counts = Counter.GetCounts();
+	ensureMsgf(!bSteadyState || Counts.Allocations == 0, TEXT("%s made %llu heap allocations (%llu bytes) in steady state"),
+		ScopeName, Counts.Allocations, Counts.Bytes);
+}
+
+int32 FLeapAllocationGuard::GetWarmupFrames()
+{
+	return CVarLeapAllocationGuardWarmup.GetValueOnGameThread();
+}
+
+int32 FLeapAllocationGuardExclusion::Depth = 0;
+
+FLeapAllocationGuardExclusion::FLeapAllocationGuardExclusion() : bPaused(false)
+{
+	if (FLeapAllocationGuard::ActiveGuard && IsInGameThread())
+	{
+		bPaused = true;
+		if (Depth++ == 0)
+		{
+			FLeapMallocCounter::Install().StopCounting();
+		}
+	}
+}
+
+FLeapAllocationGuardExclusion::~FLeapAllocationGuardExclusion()
+{
+	if (bPaused && --Depth == 0)
+	{
+		FLeapMallocCounter::Install().ResumeCounting();
+	}
+}
+
+#endif
@@ -0,0 +1,86 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Compiled out of test and shipping builds
+#define LEAP_ALLOCATION_GUARD (!UE_BUILD_SHIPPING && !UE_BUILD_TEST)
+
+#if LEAP_ALLOCATION_GUARD
+
+/**
+ * Counts the heap allocations the game thread makes during the per frame hand tracking work.
+ *
+ * Enabled with leap.AllocationGuard, which wraps GMalloc with FLeapMallocCounter. Once the owner reports the
+ * pipeline is in steady state (same hands, no events) any allocation raises an ensure, which fails automation
+ * tests, so allocation regressions in the hot path are caught.
+ */
+class FLeapAllocationGuard
+{
+public:
+	explicit FLeapAllocationGuard(const TCHAR* InScopeName);
+	~FLeapAllocationGuard();
+
+	/** Whether allocations in this scope are a failure, decided at the end of the scope */
+	void SetSteadyState(bool bInSteadyState)
+	{
+		bSteadyState = bInSteadyState;
+	}
+
+	/** Frames the pipeline has to be stable for before allocations count */
+	static int32 GetWarmupFrames();
+
+private:
+	friend class FLeapAllocationGuardExclusion;
+
+	const TCHAR* ScopeName;
+	bool bActive;
+	bool bSteadyState;
+
+	/** Guards are game thread only and never nested */
+	static FLeapAllocationGuard* ActiveGuard;
+};
+
+/** Stops the active guard counting for the rest of the scope, for code outside the pipeline e.g. blueprint delegates */
+class FLeapAllocationGuardExclusion
+{
+public:
+	FLeapAllocationGuardExclusion();
+	~FLeapAllocationGuardExclusion();
+
+private:
+	bool bPaused;
+
+	/** Only the outermost exclusion stops and resumes counting */
+	static int32 Depth;
+};
+
+#else
+
+class FLeapAllocationGuard
+{
+public:
+	explicit FLeapAllocationGuard(const TCHAR* InScopeName)
+	{
+	}
+	void SetSteadyState(bool bInSteadyState)
+	{
+	}
+	static int32 GetWarmupFrames()
+	{
+		return 0;
+	}
+};
+
+class FLeapAllocationGuardExclusion
+{
+};
+
+#endif
@@ -0,0 +1,160 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapBenchmark.h"
+
+#include "Animation/AnimInstance.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+#include "FUltraleapTrackingInputDevice.h"
+#include "GenericPlatform/GenericApplicationMessageHandler.h"
+#include "IBodyState.h"
+#include "LeapReplayWrapper.h"
+#include "LeapUtility.h"
+
+void FLeapBenchmarkStage::Add(const uint64 InCycles, const FLeapMallocCounter::FCounts& InCounts)
+{
+	Micros.Add(FPlatformTime::ToMilliseconds64(InCycles) * 1000.0);
+	Allocations += InCounts.Allocations;
+	Bytes += InCounts.Bytes;
+	MaxAllocations = FMath::Max(MaxAllocations, InCounts.Allocations);
+}
+
+double FLeapBenchmarkStage::GetMeanMicros() const
+{
+	double Sum = 0.0;
+	for (const double Sample : Micros)
+	{
+		Sum += Sample;
+	}
+	return Sum / FMath::Max(Micros.Num(), 1);
+}
+
+double FLeapBenchmarkStage::GetPercentileMicros(const double Percentile) const
+{
+	if (Micros.Num() == 0)
+	{
+		return 0.0;
+	}
+	TArray<double> Sorted = Micros;
+	Sorted.Sort();
+	return Sorted[FMath::Clamp(FMath::CeilToInt(Percentile * Sorted.Num()) - 1, 0, Sorted.Num() - 1)];
+}
+
+double FLeapBenchmarkStage::GetAllocationsPerFrame() const
+{
+	return (double) Allocations / FMath::Max(Micros.Num(), 1);
+}
+
+TSharedRef<FJsonObject> FLeapBenchmarkStage::ToJson() const
+{
+	TArray<double> Sorted = Micros;
+	Sorted.Sort();
+
+	// Nearest rank
+	auto Percentile = [&Sorted](const double P) {
+		return Sorted.Num() ? Sorted[FMath::Clamp(FMath::CeilToInt(P * Sorted.Num()) - 1, 0, Sorted.Num() - 1)] : 0.0;
+	};
+	const double NumFrames = FMath::Max(Sorted.Num(), 1);
+
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetNumberField(TEXT("mean_us"), GetMeanMicros());
+	Json->SetNumberField(TEXT("p50_us"), Percentile(0.5));
+	Json->SetNumberField(TEXT("p90_us"), Percentile(0.9));
+	Json->SetNumberField(TEXT("p99_us"), Percentile(0.99));
+	Json->SetNumberField(TEXT("max_us"), Sorted.Num() ? Sorted.Last() : 0.0);
+	Json->SetNumberField(TEXT("allocations_per_frame"), Allocations / NumFrames);
+	Json->SetNumberField(TEXT("max_allocations"), MaxAllocations);
+	Json->SetNumberField(TEXT("allocated_bytes_per_frame"), Bytes / NumFrames);
+	return Json;
+}
+
+bool FLeapBenchmarkPipeline::Create(TSharedPtr<FLeapReplayWrapper> InReplay, const bool bInterpolation, const bool bSmoothing)
+{
+	Replay = InReplay;
+	Now = 0;
+
+	Device = MakeShareable(new FUltraleapTrackingInputDevice(MakeShareable(new FGenericApplicationMessageHandler())));
+	Device->PostEarlyInit();
+	Device->SetTrackingWrapper(Replay);
+
+	FLeapOptions Options = Device->GetOptions();
+	Options.TrackingFidelity = ELeapTrackingFidelity::LEAP_CUSTOM;
+	Options.bUseInterpolation = bInterpolation;
+	Options.bUseJointSmoothing = bSmoothing;
+	Options.bUseRotationSmoothing = bSmoothing;
+	Device->SetOptions(Options);
+
+	Skeleton = IBodyState::Get().SkeletonForDevice(Device->GetBodyStateDeviceId());
+	return Skeleton != nullptr;
+}
+
+void FLeapBenchmarkPipeline::Advance(const float Step)
+{
+	Now += (int64) (Step * 1000000.0);
+	Replay->SetNow(Now);
+	Device->Tick(Step);
+
+	// Game thread callbacks queued by the device, outside of any measured stage
+	FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+}
+
+void FLeapBenchmarkPipeline::Destroy()
+{
+	Skeleton = nullptr;
+	Device.Reset();
+	Replay.Reset();
+}
+
+bool FLeapBenchmarkAnimScene::Create(const FString& MeshPath, const FString& AnimClassPath)
+{
+	USkeletalMesh* Mesh = LoadObject<USkeletalMesh>(nullptr, *MeshPath);
+	UClass* AnimClass = LoadClass<UAnimInstance>(nullptr, *AnimClassPath);
+	if (!Mesh || !AnimClass)
+	{
+		UE_LOG(UltraleapTrackingLog, Error, TEXT("Leap benchmark couldn't load mesh %s or anim class %s"), *MeshPath, *AnimClassPath);
+		return false;
+	}
+
+	World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("UltraleapBenchmark"));
+	GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(World);
+
+	AActor* Actor = World->SpawnActor<AActor>();
+	Component = NewObject<USkeletalMeshComponent>(Actor);
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 1
+	Component->SetSkeletalMeshAsset(Mesh);
+#else
+	Component->SetSkeletalMesh(Mesh);
+#endif
+	Component->SetAnimInstanceClass(AnimClass);
+	Component->bEnableUpdateRateOptimizations = false;
+	Component->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	Component->RegisterComponent();
+	return true;
+}
+
+void FLeapBenchmarkAnimScene::Evaluate(const float Step)
+{
+	Component->TickAnimation(Step, false);
+	Component->RefreshBoneTransforms();
+}
+
+void FLeapBenchmarkAnimScene::Destroy()
+{
+	if (World)
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		World = nullptr;
+		Component = nullptr;
+	}
+}
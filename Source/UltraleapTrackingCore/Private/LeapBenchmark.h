@@ -0,0 +1,86 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeapMallocCounter.h"
+
+class FJsonObject;
+class FLeapReplayWrapper;
+class FUltraleapTrackingInputDevice;
+class UBodyStateSkeleton;
+class USkeletalMeshComponent;
+
+/**
+ * Timings and allocation counts of one pipeline stage, one sample per frame.
+ *
+ * Shared by the replay benchmark commandlet and the performance automation tests so both report the same
+ * numbers under the same names.
+ */
+class FLeapBenchmarkStage
+{
+public:
+	explicit FLeapBenchmarkStage(const TCHAR* InName) : Name(InName)
+	{
+	}
+
+	void Add(const uint64 InCycles, const FLeapMallocCounter::FCounts& InCounts);
+
+	int32 Num() const
+	{
+		return Micros.Num();
+	}
+
+	double GetMeanMicros() const;
+
+	/** Nearest rank, Percentile in [0, 1] */
+	double GetPercentileMicros(const double Percentile) const;
+
+	double GetAllocationsPerFrame() const;
+
+	/** mean_us, p50_us, p90_us, p99_us, max_us, allocations_per_frame, max_allocations, allocated_bytes_per_frame */
+	TSharedRef<FJsonObject> ToJson() const;
+
+	const TCHAR* Name;
+	TArray<double> Micros;
+	uint64 Allocations = 0;
+	uint64 Bytes = 0;
+	uint64 MaxAllocations = 0;
+};
+
+/** An input device fed by a replay wrapper, stepped at a fixed rate without a tracking service */
+struct FLeapBenchmarkPipeline
+{
+	TSharedPtr<FLeapReplayWrapper> Replay;
+	TSharedPtr<FUltraleapTrackingInputDevice> Device;
+	UBodyStateSkeleton* Skeleton = nullptr;
+	int64 Now = 0;
+
+	/** InReplay already has its source set. False if the device has no BodyState skeleton */
+	bool Create(TSharedPtr<FLeapReplayWrapper> InReplay, const bool bInterpolation, const bool bSmoothing);
+
+	/** Advance the replay clock and the device by Step and run the game thread callbacks the device queued */
+	void Advance(const float Step);
+
+	void Destroy();
+};
+
+/** A skeletal mesh in its own world for measuring anim evaluation, only alive while it is measured */
+struct FLeapBenchmarkAnimScene
+{
+	UWorld* World = nullptr;
+	USkeletalMeshComponent* Component = nullptr;
+
+	bool Create(const FString& MeshPath, const FString& AnimClassPath);
+
+	/** Anim instance update and bone evaluation on the calling thread, needs a.ParallelAnimEvaluation 0 */
+	void Evaluate(const float Step);
+
+	void Destroy();
+};
@@ -10,7 +10,11 @@
 
 #include "LeapBlueprintFunctionLibrary.h"
 
+#include "Components/SceneComponent.h"
+#include "Engine/Engine.h"
 #include "IUltraleapTrackingPlugin.h"
+#include "IXRTrackingSystem.h"
+#include "LeapHandQueries.h"
 #include "Misc/ConfigCacheIni.h"
 
 FRotator ULeapBlueprintFunctionLibrary::DebugRotator;
@@ -43,10 +47,142 @@ void ULeapBlueprintFunctionLibrary::GetLeapStats(FLeapStats& OutStats)
 	OutStats = IUltraleapTrackingPlugin::Get().GetLeapStats();
 }
 
+void ULeapBlueprintFunctionLibrary::GetLatencyPercentiles(ELeapLatencyStage Stage, FLeapLatencyPercentiles& OutPercentiles)
+{
+	OutPercentiles = IUltraleapTrackingPlugin::Get().GetLatencyPercentiles(Stage);
+}
+
+bool ULeapBlueprintFunctionLibrary::GetLeapJoint(EHandType Hand, int32 Digit, int32 Joint, FVector& Position, FRotator& Rotation)
+{
+	return IUltraleapTrackingPlugin::Get().GetJointCache().GetJoint(Hand, Digit, Joint, Position, Rotation);
+}
+
+bool ULeapBlueprintFunctionLibrary::GetLeapFingertip(EHandType Hand, int32 Digit, FVector& Position)
+{
+	FRotator Rotation;
+	return GetLeapJoint(Hand, Digit, FLeapJointCache::NumJoints - 1, Position, Rotation);
+}
+
+bool ULeapBlueprintFunctionLibrary::GetLeapPalm(
+	EHandType Hand, FVector& Position, FVector& Normal, FVector& Direction, FRotator& Orientation)
+{
+	const FLeapJointCache::FHand& Cached = IUltraleapTrackingPlugin::Get().GetJointCache().GetHand(Hand);
+	Position = Cached.PalmPosition;
+	Normal = Cached.PalmNormal;
+	Direction = Cached.PalmDirection;
+	Orientation = Cached.PalmOrientation;
+	return Cached.bVisible;
+}
+
+bool ULeapBlueprintFunctionLibrary::GetLeapPinch(EHandType Hand, float& PinchStrength, float& PinchDistance, float& GrabStrength)
+{
+	const FLeapJointCache::FHand& Cached = IUltraleapTrackingPlugin::Get().GetJointCache().GetHand(Hand);
+	PinchStrength = Cached.PinchStrength;
+	PinchDistance = Cached.PinchDistance;
+	GrabStrength = Cached.GrabStrength;
+	return Cached.bVisible;
+}
+
+FTransform ULeapBlueprintFunctionLibrary::GetLeapTrackingToWorldTransform(const USceneComponent* TrackingOrigin)
+{
+	if (TrackingOrigin)
+	{
+		return TrackingOrigin->GetComponentTransform();
+	}
+	if (GEngine && GEngine->XRSystem.IsValid())
+	{
+		return GEngine->XRSystem->GetTrackingToWorldTransform();
+	}
+	return FTransform::Identity;
+}
+
+FVector ULeapBlueprintFunctionLibrary::ConvertWorldLocationToLeapSpace(
+	const USceneComponent* TrackingOrigin, const FVector& WorldLocation)
+{
+	return GetLeapTrackingToWorldTransform(TrackingOrigin).InverseTransformPosition(WorldLocation);
+}
+
+FVector ULeapBlueprintFunctionLibrary::ConvertLeapLocationToWorld(
+	const USceneComponent* TrackingOrigin, const FVector& LeapLocation)
+{
+	return GetLeapTrackingToWorldTransform(TrackingOrigin).TransformPosition(LeapLocation);
+}
+
+bool ULeapBlueprintFunctionLibrary::FindNearestLeapJoint(const FVector& Point, bool bFingertipsOnly, FLeapJointQueryResult& Result)
+{
+	return FLeapHandQueries::FindNearestJoint(IUltraleapTrackingPlugin::Get().GetJointCache(), Point, bFingertipsOnly, Result);
+}
+
+bool ULeapBlueprintFunctionLibrary::FindNearestLeapHand(const FVector& Point, TEnumAsByte<EHandType>& Hand, float& Distance)
+{
+	FLeapJointQueryResult Result;
+	if (!FLeapHandQueries::FindNearestJoint(IUltraleapTrackingPlugin::Get().GetJointCache(), Point, false, Result))
+	{
+		return false;
+	}
+	Hand = Result.Hand;
+	Distance = Result.Distance;
+	return true;
+}
+
+bool ULeapBlueprintFunctionLibrary::FindNearestLeapHandToWorldLocation(
+	const USceneComponent* TrackingOrigin, const FVector& WorldLocation, TEnumAsByte<EHandType>& Hand, float& Distance)
+{
+	const FTransform TrackingToWorld = GetLeapTrackingToWorldTransform(TrackingOrigin);
+	FLeapJointQueryResult Result;
+	if (!FLeapHandQueries::FindNearestJoint(IUltraleapTrackingPlugin::Get().GetJointCache(),
+			TrackingToWorld.InverseTransformPosition(WorldLocation), false, Result))
+	{
+		return false;
+	}
+	// Measured in the world, the tracking origin may be scaled
+	Hand = Result.Hand;
+	Distance = FVector::Distance(TrackingToWorld.TransformPosition(Result.Position), WorldLocation);
+	return true;
+}
+
+int32 ULeapBlueprintFunctionLibrary::FindLeapJointsInBox(
+	const FTransform& BoxTransform, const FVector& Extent, TArray<FLeapJointQueryResult>& Results)
+{
+	Results.Reset();
+	return FLeapHandQueries::FindJointsInBox(IUltraleapTrackingPlugin::Get().GetJointCache(), BoxTransform, Extent, Results);
+}
+
+int32 ULeapBlueprintFunctionLibrary::FindLeapJointsInSphere(
+	const FVector& Center, float Radius, TArray<FLeapJointQueryResult>& Results)
+{
+	Results.Reset();
+	return FLeapHandQueries::FindJointsInSphere(IUltraleapTrackingPlugin::Get().GetJointCache(), Center, Radius, Results);
+}
+
+bool ULeapBlueprintFunctionLibrary::IsLeapHandInBox(EHandType Hand, const FTransform& BoxTransform, const FVector& Extent)
+{
+	return FLeapHandQueries::IsHandInBox(IUltraleapTrackingPlugin::Get().GetJointCache(), Hand, BoxTransform, Extent);
+}
+
+bool ULeapBlueprintFunctionLibrary::GetLeapHandDistanceToSegment(
+	EHandType Hand, const FVector& Start, const FVector& End, FLeapJointQueryResult& Result)
+{
+	return FLeapHandQueries::GetHandDistanceToSegment(IUltraleapTrackingPlugin::Get().GetJointCache(), Hand, Start, End, Result);
+}
+
+bool ULeapBlueprintFunctionLibrary::GetLeapFingertipDistance(
+	EHandType HandA, int32 DigitA, EHandType HandB, int32 DigitB, float& Distance)
+{
+	return FLeapHandQueries::GetFingertipDistance(
+		IUltraleapTrackingPlugin::Get().GetJointCache(), HandA, DigitA, HandB, DigitB, Distance);
+}
+
 void ULeapBlueprintFunctionLibrary::SetLeapPolicy(ELeapPolicyFlag Flag, bool Enable)
 {
 	IUltraleapTrackingPlugin::Get().SetLeapPolicy(Flag, Enable);
 }
+
+bool ULeapBlueprintFunctionLibrary::GetCachedLeapConfigValue(const FString& Key, FLeapConfigValue& OutValue)
+{
+	return IUltraleapTrackingPlugin::Get().GetCachedConfigValue(Key, OutValue);
+}
+
 void ULeapBlueprintFunctionLibrary::GetAttachedLeapDevices(TArray<FString>& Devices)
 {
 	IUltraleapTrackingPlugin::Get().GetAttachedDevices(Devices);
@@ -0,0 +1,67 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapConfigAsyncAction.h"
+
+#include "IUltraleapTrackingPlugin.h"
+#include "LeapAsync.h"
+
+ULeapConfigAsyncAction::ULeapConfigAsyncAction(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer), bIsSave(false)
+{
+}
+
+ULeapConfigAsyncAction* ULeapConfigAsyncAction::RequestLeapConfigValue(UObject* WorldContextObject, const FString& Key)
+{
+	ULeapConfigAsyncAction* Action = NewObject<ULeapConfigAsyncAction>();
+	Action->Key = Key;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+ULeapConfigAsyncAction* ULeapConfigAsyncAction::SaveLeapConfigValue(
+	UObject* WorldContextObject, const FString& Key, const FLeapConfigValue& Value)
+{
+	ULeapConfigAsyncAction* Action = NewObject<ULeapConfigAsyncAction>();
+	Action->Key = Key;
+	Action->Value = Value;
+	Action->bIsSave = true;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void ULeapConfigAsyncAction::Activate()
+{
+	IUltraleapTrackingPlugin& Plugin = IUltraleapTrackingPlugin::Get();
+	TFuture<FLeapConfigResult> Future = bIsSave ? Plugin.SaveConfigValue(Key, Value) : Plugin.RequestConfigValue(Key);
+
+	// Completes on the service thread, or right here if the request failed at once. Either way the pins fire from the
+	// game thread's task queue, never inside Activate
+	TWeakObjectPtr<ULeapConfigAsyncAction> WeakThis(this);
+	Future.Next([WeakThis](const FLeapConfigResult& Result) {
+		FLeapAsync::RunShortLambdaOnGameThread([WeakThis, Result] {
+			if (ULeapConfigAsyncAction* Action = WeakThis.Get())
+			{
+				Action->HandleResult(Result);
+			}
+		});
+	});
+}
+
+void ULeapConfigAsyncAction::HandleResult(const FLeapConfigResult& Result)
+{
+	if (Result.bSuccess)
+	{
+		OnSuccess.Broadcast(Result);
+	}
+	else
+	{
+		OnFailure.Broadcast(Result);
+	}
+	SetReadyToDestroy();
+}
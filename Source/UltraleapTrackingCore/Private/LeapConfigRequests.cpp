@@ -0,0 +1,167 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapConfigRequests.h"
+
+#include "HAL/IConsoleManager.h"
+#include "LeapUtility.h"
+
+static TAutoConsoleVariable<float> CVarLeapConfigTimeout(TEXT("leap.Config.Timeout"), 5.f,
+	TEXT("Seconds to wait for the tracking service to answer a configuration read or write before it fails"));
+
+double FLeapConfigRequests::GetConfiguredTimeout()
+{
+	return FMath::Max(CVarLeapConfigTimeout.GetValueOnAnyThread(), 0.f);
+}
+
+TFuture<FLeapConfigResult> FLeapConfigRequests::Issue(
+	const FString& Key, const FLeapConfigValue* SavedValue, double Deadline, TFunctionRef<bool(uint32& OutRequestId)> Send)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	uint32 RequestId = 0;
+	if (!Send(RequestId))
+	{
+		return IUltraleapTrackingPlugin::MakeFailedConfigResult(Key);
+	}
+
+	FPendingRequest& Request = Pending.AddDefaulted_GetRef();
+	Request.RequestId = RequestId;
+	Request.Key = Key;
+	Request.bIsSave = SavedValue != nullptr;
+	if (SavedValue)
+	{
+		Request.SavedValue = *SavedValue;
+	}
+	Request.Deadline = Deadline;
+	return Request.Promise.GetFuture();
+}
+
+TOptional<FLeapConfigRequests::FPendingRequest> FLeapConfigRequests::TakeRequest(uint32 RequestId, bool bIsSave)
+{
+	TOptional<FPendingRequest> Request;
+	for (int32 Index = 0; Index < Pending.Num(); Index++)
+	{
+		if (Pending[Index].RequestId == RequestId && Pending[Index].bIsSave == bIsSave)
+		{
+			Request.Emplace(MoveTemp(Pending[Index]));
+			Pending.RemoveAtSwap(Index, 1, false);
+			break;
+		}
+	}
+	return Request;
+}
+
+bool FLeapConfigRequests::HandleResponse(uint32 RequestId, const FLeapConfigValue& Value)
+{
+	FLeapConfigResult Result;
+
+	Lock.Lock();
+	TOptional<FPendingRequest> Request = TakeRequest(RequestId, false);
+	if (Request.IsSet())
+	{
+		// Unknown means the service has no setting with this key
+		Result.Key = Request->Key;
+		Result.Value = Value;
+		Result.bSuccess = Value.Type != ELeapConfigValueType::LEAP_CONFIG_UNKNOWN;
+		if (Result.bSuccess)
+		{
+			Cache.Add(Request->Key, Value);
+		}
+	}
+	Lock.Unlock();
+
+	// Continuations run here, outside the lock so they can issue further requests
+	if (!Request.IsSet())
+	{
+		return false;
+	}
+	Request->Promise.SetValue(MoveTemp(Result));
+	return true;
+}
+
+bool FLeapConfigRequests::HandleChange(uint32 RequestId, bool bSuccess)
+{
+	FLeapConfigResult Result;
+
+	Lock.Lock();
+	TOptional<FPendingRequest> Request = TakeRequest(RequestId, true);
+	if (Request.IsSet())
+	{
+		Result.Key = Request->Key;
+		Result.Value = Request->SavedValue;
+		Result.bSuccess = bSuccess;
+		if (bSuccess)
+		{
+			Cache.Add(Request->Key, Request->SavedValue);
+		}
+	}
+	Lock.Unlock();
+
+	if (!Request.IsSet())
+	{
+		return false;
+	}
+	Request->Promise.SetValue(MoveTemp(Result));
+	return true;
+}
+
+void FLeapConfigRequests::ExpireRequests(double Now)
+{
+	TArray<FPendingRequest> Expired;
+
+	Lock.Lock();
+	for (int32 Index = Pending.Num() - 1; Index >= 0; Index--)
+	{
+		if (Now >= Pending[Index].Deadline)
+		{
+			Expired.Add(MoveTemp(Pending[Index]));
+			Pending.RemoveAtSwap(Index, 1, false);
+		}
+	}
+	Lock.Unlock();
+
+	for (FPendingRequest& Request : Expired)
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("Tracking service didn't answer the config %s of %s in time."),
+			Request.bIsSave ? TEXT("write") : TEXT("read"), *Request.Key);
+		Request.Promise.SetValue(FLeapConfigResult(Request.Key));
+	}
+}
+
+void FLeapConfigRequests::FailAll()
+{
+	TArray<FPendingRequest> Failed;
+
+	Lock.Lock();
+	Failed = MoveTemp(Pending);
+	Pending.Reset();
+	Lock.Unlock();
+
+	for (FPendingRequest& Request : Failed)
+	{
+		Request.Promise.SetValue(FLeapConfigResult(Request.Key));
+	}
+}
+
+bool FLeapConfigRequests::GetCachedValue(const FString& Key, FLeapConfigValue& OutValue) const
+{
+	FScopeLock ScopeLock(&Lock);
+	if (const FLeapConfigValue* Value = Cache.Find(Key))
+	{
+		OutValue = *Value;
+		return true;
+	}
+	return false;
+}
+
+int32 FLeapConfigRequests::GetNumPending() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Pending.Num();
+}
@@ -0,0 +1,71 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "Async/Future.h"
+#include "CoreMinimal.h"
+#include "IUltraleapTrackingPlugin.h"
+#include "UltraleapTrackingData.h"
+
+/**
+ * Correlates LeapRequestConfigValue and LeapSaveConfigValue requests with the ConfigResponse and ConfigChange events
+ * answering them, and caches the last value known for each key. Thread safe.
+ *
+ * Issue() makes the LeapC call under the lock, so an answer the service thread polls straight away still finds its
+ * request. Futures complete on the thread delivering the answer, usually the service thread. Requests unanswered by
+ * their deadline (leap.Config.Timeout) or still pending when the connection goes away fail.
+ */
+class FLeapConfigRequests
+{
+public:
+	/** Seconds a request waits for the service to answer, see leap.Config.Timeout */
+	static double GetConfiguredTimeout();
+
+	/**
+	 * Register a request sent by Send, which makes the LeapC call and returns false if it failed. SavedValue is the
+	 * value being written, null for reads.
+	 */
+	TFuture<FLeapConfigResult> Issue(
+		const FString& Key, const FLeapConfigValue* SavedValue, double Deadline, TFunctionRef<bool(uint32& OutRequestId)> Send);
+
+	/** A ConfigResponse event, false if no pending read has this id, e.g. a request made outside the plugin */
+	bool HandleResponse(uint32 RequestId, const FLeapConfigValue& Value);
+
+	/** A ConfigChange event, false if no pending write has this id */
+	bool HandleChange(uint32 RequestId, bool bSuccess);
+
+	/** Fail requests past their deadline, cheap while nothing is pending */
+	void ExpireRequests(double Now);
+
+	/** Fail every pending request, the connection they were sent on is gone */
+	void FailAll();
+
+	/** Last value read or successfully written for the key */
+	bool GetCachedValue(const FString& Key, FLeapConfigValue& OutValue) const;
+
+	int32 GetNumPending() const;
+
+private:
+	struct FPendingRequest
+	{
+		uint32 RequestId = 0;
+		FString Key;
+		bool bIsSave = false;
+		FLeapConfigValue SavedValue;
+		double Deadline = 0;
+		TPromise<FLeapConfigResult> Promise;
+	};
+
+	/** Remove the request with this id and kind, unset if there is none */
+	TOptional<FPendingRequest> TakeRequest(uint32 RequestId, bool bIsSave);
+
+	mutable FCriticalSection Lock;
+	TArray<FPendingRequest> Pending;
+	TMap<FString, FLeapConfigValue> Cache;
+};
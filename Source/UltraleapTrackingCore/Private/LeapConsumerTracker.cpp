@@ -0,0 +1,140 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapConsumerTracker.h"
+
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarLeapPauseAuto(TEXT("leap.Pause.Auto"), 0,
+	TEXT("Pause hand tracking while no component, hand mesh, LiveLink client or subscriber consumes hands. Off by "
+		 "default, input key bindings aren't counted as consumers"));
+
+static TAutoConsoleVariable<int32> CVarLeapPauseDevice(TEXT("leap.Pause.Device"), 0,
+	TEXT("Also pause the device with LeapSetPause while tracking is paused. This pauses it for every client of the "
+		 "service until the plugin resumes or shuts down"));
+
+static TAutoConsoleVariable<float> CVarLeapPauseDelay(TEXT("leap.Pause.Delay"), 2.f,
+	TEXT("Seconds without consumers before tracking pauses, rides out level loads and components being recreated"));
+
+static TAutoConsoleVariable<int32> CVarLeapPauseWarmupFrames(TEXT("leap.Pause.WarmupFrames"), 5,
+	TEXT("New tracking frames processed without firing events after tracking resumes"));
+
+static TAutoConsoleVariable<int32> CVarLeapPauseInBackground(TEXT("leap.Pause.InBackground"), 0,
+	TEXT("Also pause while the application is minimized or in the background, whatever the consumers"));
+
+FLeapConsumerTracker::FSettings FLeapConsumerTracker::GetConfiguredSettings()
+{
+	FSettings ConfiguredSettings;
+	ConfiguredSettings.bEnabled = CVarLeapPauseAuto.GetValueOnGameThread() != 0;
+	ConfiguredSettings.PauseDelay = FMath::Max(CVarLeapPauseDelay.GetValueOnGameThread(), 0.f);
+	ConfiguredSettings.WarmupFrames = FMath::Max(CVarLeapPauseWarmupFrames.GetValueOnGameThread(), 0);
+	ConfiguredSettings.bPauseInBackground = CVarLeapPauseInBackground.GetValueOnGameThread() != 0;
+	return ConfiguredSettings;
+}
+
+bool FLeapConsumerTracker::ShouldPauseDevice()
+{
+	return CVarLeapPauseDevice.GetValueOnGameThread() != 0;
+}
+
+FLeapConsumerTracker::FLeapConsumerTracker()
+	: LastPollTime(-DBL_MAX), LastConsumerTime(-1), bPaused(false), WarmupFramesRemaining(0), LastWarmupFrameId(0)
+{
+	FMemory::Memzero(Counts);
+}
+
+void FLeapConsumerTracker::SetCount(ELeapConsumerType Type, int32 Count)
+{
+	Counts[(int32) Type] = Count;
+}
+
+void FLeapConsumerTracker::AddReference()
+{
+	Counts[(int32) ELeapConsumerType::Explicit]++;
+}
+
+void FLeapConsumerTracker::RemoveReference()
+{
+	int32& References = Counts[(int32) ELeapConsumerType::Explicit];
+	if (ensureMsgf(References > 0, TEXT("RemoveTrackingConsumer without a matching AddTrackingConsumer")))
+	{
+		References--;
+	}
+}
+
+void FLeapConsumerTracker::NotePoll(double Now)
+{
+	LastPollTime = Now;
+}
+
+int32 FLeapConsumerTracker::GetNumConsumers(double Now) const
+{
+	int32 NumConsumers = 0;
+	for (int32 Type = 0; Type < (int32) ELeapConsumerType::Num; Type++)
+	{
+		if (Type != (int32) ELeapConsumerType::Poll)
+		{
+			NumConsumers += Counts[Type];
+		}
+	}
+	if (Now - LastPollTime < Settings.PauseDelay)
+	{
+		NumConsumers++;
+	}
+	return NumConsumers;
+}
+
+bool FLeapConsumerTracker::Update(double Now, bool bAppInBackground)
+{
+	// Consumers get a full delay to turn up after startup
+	if (LastConsumerTime < 0)
+	{
+		LastConsumerTime = Now;
+	}
+
+	bool bShouldPause = false;
+	if (Settings.bEnabled)
+	{
+		if (GetNumConsumers(Now) > 0)
+		{
+			LastConsumerTime = Now;
+		}
+		bShouldPause = (Settings.bPauseInBackground && bAppInBackground) || Now - LastConsumerTime >= Settings.PauseDelay;
+	}
+	else
+	{
+		LastConsumerTime = Now;
+	}
+
+	if (bShouldPause == bPaused)
+	{
+		return false;
+	}
+	bPaused = bShouldPause;
+	if (!bPaused)
+	{
+		WarmupFramesRemaining = Settings.WarmupFrames;
+		LastWarmupFrameId = 0;
+	}
+	return true;
+}
+
+bool FLeapConsumerTracker::ConsumeWarmupFrame(int64 TrackingFrameId)
+{
+	if (WarmupFramesRemaining <= 0)
+	{
+		return false;
+	}
+	// The game can tick faster than the device, only new frames count
+	if (TrackingFrameId != LastWarmupFrameId)
+	{
+		LastWarmupFrameId = TrackingFrameId;
+		WarmupFramesRemaining--;
+	}
+	return true;
+}
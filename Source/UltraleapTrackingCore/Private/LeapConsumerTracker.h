@@ -0,0 +1,96 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Everything that keeps hand tracking running */
+enum class ELeapConsumerType : uint8
+{
+	/** ULeapComponent listening for events */
+	Component,
+	/** BodyState anim instance on a skeletal mesh in a game world */
+	AnimInstance,
+	/** The runtime LiveLink source while leap.LiveLink.Source is set, or a client subscribed to the editor producer */
+	LiveLink,
+	/** Tracking server client or a shared frame ring being published */
+	Subscriber,
+	/** Frame or hand visibility polled through the plugin interface, counts for PauseDelay after the last poll */
+	Poll,
+	/** IUltraleapTrackingPlugin::AddTrackingConsumer references */
+	Explicit,
+	Num
+};
+
+/**
+ * Decides when the input device pauses hand tracking because nothing consumes hands, game thread only.
+ *
+ * The device refreshes the consumer counts, then Update() pauses once there have been none for PauseDelay seconds
+ * (optionally also while the app is in the background) and resumes as soon as one returns. After a resume the first
+ * WarmupFrames new tracking frames only refresh the hands, events resume once the filters have settled on live data.
+ *
+ * Off unless leap.Pause.Auto is set: projects that only bind the Leap input keys consume hands without being counted.
+ * Also configured with leap.Pause.Delay, leap.Pause.WarmupFrames and leap.Pause.InBackground.
+ */
+class FLeapConsumerTracker
+{
+public:
+	struct FSettings
+	{
+		bool bEnabled = false;
+		double PauseDelay = 2.0;
+		int32 WarmupFrames = 5;
+		bool bPauseInBackground = false;
+	};
+
+	static FSettings GetConfiguredSettings();
+
+	/** Whether pausing should also pause the device through the service, see leap.Pause.Device */
+	static bool ShouldPauseDevice();
+
+	FLeapConsumerTracker();
+
+	void SetSettings(const FSettings& InSettings)
+	{
+		Settings = InSettings;
+	}
+
+	/** Count of a consumer type the device polls */
+	void SetCount(ELeapConsumerType Type, int32 Count);
+
+	void AddReference();
+	void RemoveReference();
+
+	/** A frame or visibility was polled, resumes at the next Update if paused */
+	void NotePoll(double Now);
+
+	/** Consumers right now, polls included while they are recent */
+	int32 GetNumConsumers(double Now) const;
+
+	/** Pause or resume as the consumers and the app state require, true if the paused state changed */
+	bool Update(double Now, bool bAppInBackground);
+
+	bool IsPaused() const
+	{
+		return bPaused;
+	}
+
+	/** Call for every processed frame, true while warming up after a resume and events should be held back */
+	bool ConsumeWarmupFrame(int64 TrackingFrameId);
+
+private:
+	FSettings Settings;
+	int32 Counts[(int32) ELeapConsumerType::Num];
+	double LastPollTime;
+	double LastConsumerTime;
+	bool bPaused;
+
+	int32 WarmupFramesRemaining;
+	int64 LastWarmupFrameId;
+};
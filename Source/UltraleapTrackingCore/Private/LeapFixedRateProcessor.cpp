@@ -0,0 +1,116 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapFixedRateProcessor.h"
+
+#include "LeapStats.h"
+#include "LeapUtility.h"
+
+FLeapFixedRateProcessor::FLeapFixedRateProcessor()
+	: bEnabled(false), bHasProcessedFrames(false), bFilter(false), WorldScale(1.f), LastTimeStamp(0), Head(0), Count(0)
+{
+	FilterBank.SetChannels(false, false);
+}
+
+void FLeapFixedRateProcessor::SetEnabled(bool bInEnabled)
+{
+	if (bEnabled != bInEnabled)
+	{
+		bEnabled = bInEnabled;
+		Reset();
+	}
+}
+
+void FLeapFixedRateProcessor::SetSettings(const FSettings& InSettings)
+{
+	FScopeLock ScopeLock(&Lock);
+	FLeapUtility::SetLeapGlobalOffsets(InSettings.MountTranslationOffset, InSettings.MountRotationOffset);
+	FilterBank.Init(InSettings.MinCutoff, InSettings.CutoffSlope, InSettings.DeltaCutoff);
+	FilterBank.InitRotations(InSettings.RotationMinCutoff, InSettings.RotationCutoffSlope, InSettings.DeltaCutoff);
+	FilterBank.SetChannels(InSettings.bFilterPositions, InSettings.bFilterRotations);
+	bFilter = InSettings.bFilterPositions || InSettings.bFilterRotations;
+	WorldScale = InSettings.WorldScale;
+}
+
+void FLeapFixedRateProcessor::SetWorldScale(float InWorldScale)
+{
+	FScopeLock ScopeLock(&Lock);
+	WorldScale = InWorldScale;
+}
+
+void FLeapFixedRateProcessor::ProcessFrame(const LEAP_TRACKING_EVENT& Frame)
+{
+	if (!bEnabled)
+	{
+		return;
+	}
+	LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapServiceFrameProcessing);
+	LEAP_LLM_SCOPE(Ultraleap_Frames);
+
+	FScopeLock ScopeLock(&Lock);
+
+	// The game thread stalled, the oldest frame makes room
+	if (Count == MaxQueuedFrames)
+	{
+		Head = (Head + 1) % MaxQueuedFrames;
+		Count--;
+		LEAP_INC_COUNTER(LeapFramesDropped);
+	}
+
+	// Conversion reuses the hand arrays of the frame recycled into this slot, and scales with the game thread's snapshot
+	FLeapFrameData& Processed = Queue[(Head + Count) % MaxQueuedFrames];
+	{
+		FLeapUtility::FScopedWorldScale ScopedWorldScale(WorldScale);
+		Processed.SetFromLeapFrame((LEAP_TRACKING_EVENT*) &Frame);
+	}
+	Processed.FinalRotationAdjustment = FRotator::ZeroRotator;
+
+	// Filter with the device's time step, the game's frame time has nothing to do with how far the hands moved
+	float DeltaTime = LastTimeStamp > 0 ? (Frame.info.timestamp - LastTimeStamp) / 1000000.f : 0.f;
+	if (DeltaTime <= 0.f && Frame.framerate > 0.f)
+	{
+		DeltaTime = 1.f / Frame.framerate;
+	}
+	LastTimeStamp = Frame.info.timestamp;
+	if (bFilter)
+	{
+		FilterBank.FilterFrame(Processed, FMath::Min(DeltaTime, MaxDeltaTime));
+	}
+
+	Count++;
+	bHasProcessedFrames = true;
+}
+
+int32 FLeapFixedRateProcessor::TakeFrames(TArray<FLeapFrameData>& InOutFrames)
+{
+	// Sized once, afterwards frames only change places
+	if (InOutFrames.Num() < MaxQueuedFrames)
+	{
+		InOutFrames.SetNum(MaxQueuedFrames);
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	const int32 NumFrames = Count;
+	for (int32 Index = 0; Index < NumFrames; Index++)
+	{
+		Swap(InOutFrames[Index], Queue[(Head + Index) % MaxQueuedFrames]);
+	}
+	Head = (Head + NumFrames) % MaxQueuedFrames;
+	Count = 0;
+	return NumFrames;
+}
+
+void FLeapFixedRateProcessor::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+	Head = 0;
+	Count = 0;
+	LastTimeStamp = 0;
+	FilterBank.Reset();
+	bHasProcessedFrames = false;
+}
@@ -0,0 +1,102 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+#include "LeapC.h"
+#include "LeapJointFilterBank.h"
+#include "UltraleapTrackingData.h"
+
+/**
+ * Processes every device frame exactly once at the device's rate, instead of once per game tick.
+ *
+ * ProcessFrame() runs on the service thread for each tracking event. It converts the frame and smooths it with the
+ * frame's own device time step, then queues it. Each tick the game thread drains the queue with TakeFrames() and runs
+ * the gesture checks once per queued frame in device time. Pinch, grab and visibility timing then no longer depend on
+ * the frame rate: a 144 Hz game doesn't process repeated frames and a 45 Hz game doesn't skip any.
+ *
+ * Enabled with FLeapOptions::bUseFixedRateProcessing. Only sources delivering frames from a service thread feed it,
+ * the input device keeps polling the others once per tick.
+ */
+class FLeapFixedRateProcessor
+{
+public:
+	/** Frames held for the game thread, the oldest are dropped while it stalls, e.g. on a level load */
+	static constexpr int32 MaxQueuedFrames = 8;
+
+	/** Longest time step given to the filters, e.g. after tracking resumes */
+	static constexpr float MaxDeltaTime = 0.1f;
+
+	struct FSettings
+	{
+		bool bFilterPositions = false;
+		bool bFilterRotations = false;
+		float MinCutoff = 1.5f;
+		float CutoffSlope = 0.05f;
+		float DeltaCutoff = 1.f;
+		float RotationMinCutoff = 1.5f;
+		float RotationCutoffSlope = 0.5f;
+		FVector MountTranslationOffset = FVector(80.f, 0.f, 0.f);
+		FRotator MountRotationOffset = FRotator::ZeroRotator;
+		/** See FLeapUtility::GetWorldScaleFactor, the service thread can't read the world itself */
+		float WorldScale = 1.f;
+	};
+
+	FLeapFixedRateProcessor();
+
+	/** Game thread, frames are only processed while enabled. Disabling drops the queue and filter history */
+	void SetEnabled(bool bInEnabled);
+	bool IsEnabled() const
+	{
+		return bEnabled;
+	}
+
+	/**
+	 * Game thread, applies from the next processed frame. Also sets the FLeapUtility mount offsets: conversion on the
+	 * service thread reads them, so they are only written under the lock it converts under
+	 */
+	void SetSettings(const FSettings& InSettings);
+
+	/** Game thread, refresh the world scale snapshot, e.g. after a level load changed WorldToMeters */
+	void SetWorldScale(float InWorldScale);
+
+	/** Service thread, for every tracking event */
+	void ProcessFrame(const LEAP_TRACKING_EVENT& Frame);
+
+	/**
+	 * Game thread. Swap the frames processed since the last call into InOutFrames, oldest first, and return how many.
+	 * The frames given back are recycled so steady state processing doesn't allocate.
+	 */
+	int32 TakeFrames(TArray<FLeapFrameData>& InOutFrames);
+
+	/** Whether a frame was processed since the last Reset(), false for sources that don't deliver frames */
+	bool HasProcessedFrames() const
+	{
+		return bHasProcessedFrames;
+	}
+
+	/** Drop queued frames and filter history, e.g. after a pause or a tracking source switch */
+	void Reset();
+
+private:
+	FCriticalSection Lock;
+	FThreadSafeBool bEnabled;
+	FThreadSafeBool bHasProcessedFrames;
+
+	bool bFilter;
+	float WorldScale;
+	FLeapJointFilterBank FilterBank;
+	int64 LastTimeStamp;
+
+	// Ring of processed frames, Count of them starting at Head
+	FLeapFrameData Queue[MaxQueuedFrames];
+	int32 Head;
+	int32 Count;
+};
@@ -0,0 +1,481 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapGestureRecognizer.h"
+
+namespace
+{
+// Window lengths compared per template, relative to its duration
+const float DurationScales[] = {0.8f, 1.f, 1.25f};
+
+// Fingertips are measured in hand sizes so they weigh the same for every gesture size
+const float HandScale = 10.f;
+
+// A recording whose palm barely moved would match any trembling hand
+const float MinTemplateExtent = 1.f;
+
+/** Resample NumIn time ordered samples to NumOut evenly spaced steps from Start to Start + Duration */
+template <typename GetSampleFunction>
+void ResampleSamples(GetSampleFunction&& GetSample, const int32 NumIn, const double Start, const double Duration,
+	const int32 NumOut, TArray<FVector>& OutPoints)
+{
+	using FSample = FLeapGestureRecognizer::FSample;
+	const int32 NumPoints = FLeapGestureRecognizer::NumPoints;
+	OutPoints.SetNumUninitialized(NumOut * NumPoints, false);
+
+	// First sample at or after Start, then walk forward
+	int32 Low = 0;
+	int32 High = NumIn;
+	while (Low < High)
+	{
+		const int32 Middle = (Low + High) / 2;
+		if (GetSample(Middle).Time < Start)
+		{
+			Low = Middle + 1;
+		}
+		else
+		{
+			High = Middle;
+		}
+	}
+	int32 Next = Low;
+
+	for (int32 Step = 0; Step < NumOut; Step++)
+	{
+		const double Time = Start + Duration * Step / (NumOut - 1);
+		while (Next < NumIn - 1 && GetSample(Next).Time < Time)
+		{
+			Next++;
+		}
+		const FSample& After = GetSample(Next);
+		const FSample& Before = GetSample(FMath::Max(Next - 1, 0));
+		const double Span = After.Time - Before.Time;
+		const float Alpha = Span > 0.0 ? FMath::Clamp(float((Time - Before.Time) / Span), 0.f, 1.f) : 1.f;
+		for (int32 Point = 0; Point < NumPoints; Point++)
+		{
+			OutPoints[Step * NumPoints + Point] = FMath::Lerp(Before.Points[Point], After.Points[Point], Alpha);
+		}
+	}
+}
+
+float SquaredDistance(const float* A, const float* B, const int32 NumFeatures)
+{
+	float Sum = 0.f;
+	for (int32 Feature = 0; Feature < NumFeatures; Feature++)
+	{
+		Sum += FMath::Square(A[Feature] - B[Feature]);
+	}
+	return Sum;
+}
+}	 // namespace
+
+FLeapGestureRecognizer::FLeapGestureRecognizer() : FLeapGestureRecognizer(FLeapGestureRecognizerSettings())
+{
+}
+
+FLeapGestureRecognizer::FLeapGestureRecognizer(const FLeapGestureRecognizerSettings& InSettings) : BandWidth(1), Cursor(0)
+{
+	for (int32 HandIndex = 0; HandIndex < NumHands; HandIndex++)
+	{
+		Histories[HandIndex] = MakeUnique<FHandHistory>();
+		bVisible[HandIndex] = false;
+	}
+	SetSettings(InSettings);
+}
+
+void FLeapGestureRecognizer::SetSettings(const FLeapGestureRecognizerSettings& InSettings)
+{
+	Settings = InSettings;
+	Settings.NumSamples = FMath::Clamp(Settings.NumSamples, 4, 256);
+	Settings.Threshold = FMath::Max(Settings.Threshold, KINDA_SMALL_NUMBER);
+	Settings.MaxEvaluationsPerFrame = FMath::Max(Settings.MaxEvaluationsPerFrame, 1);
+	Settings.ExtentTolerance = FMath::Max(Settings.ExtentTolerance, 1.f);
+	BandWidth = FMath::Max(FMath::CeilToInt(Settings.WarpingBand * Settings.NumSamples), 1);
+
+	const int32 NumSamples = Settings.NumSamples;
+	Query.SetNumUninitialized(NumSamples * NumFeatures);
+	CumulativeBound.SetNumUninitialized(NumSamples + 1);
+	PreviousRow.SetNumUninitialized(NumSamples);
+	CurrentRow.SetNumUninitialized(NumSamples);
+	WindowPoints.SetNumUninitialized(NumSamples * NumPoints);
+
+	// Features and envelopes depend on the settings
+	TArray<FTemplate> Added = MoveTemp(Templates);
+	Templates.Reset();
+	for (const FTemplate& Template : Added)
+	{
+		AddTemplate(Template.Source);
+	}
+	Reset();
+}
+
+bool FLeapGestureRecognizer::MakeTemplate(FName Name, const TArray<FSample>& Recorded, FLeapGestureTemplate& OutTemplate) const
+{
+	if (Recorded.Num() < 2 || Recorded.Last().Time <= Recorded[0].Time)
+	{
+		return false;
+	}
+	TArray<FVector> Points;
+	TArray<float> Features;
+	const double Duration = Recorded.Last().Time - Recorded[0].Time;
+	ResampleSamples([&Recorded](const int32 Index) -> const FSample& { return Recorded[Index]; }, Recorded.Num(),
+		Recorded[0].Time, Duration, Settings.NumSamples, Points);
+	const float Extent = Normalize(Points, Features);
+	if (Extent < MinTemplateExtent)
+	{
+		return false;
+	}
+
+	OutTemplate = FLeapGestureTemplate();
+	OutTemplate.Name = Name;
+	OutTemplate.Duration = Duration;
+	OutTemplate.Extent = Extent;
+	OutTemplate.Samples.Reserve(Features.Num() / 3);
+	for (int32 Index = 0; Index < Features.Num(); Index += 3)
+	{
+		OutTemplate.Samples.Emplace(Features[Index], Features[Index + 1], Features[Index + 2]);
+	}
+	return true;
+}
+
+bool FLeapGestureRecognizer::AddTemplate(const FLeapGestureTemplate& Template)
+{
+	const int32 NumTemplateSamples = Template.Samples.Num() / NumPoints;
+	if (NumTemplateSamples < 2 || Template.Samples.Num() % NumPoints != 0 || Template.Duration <= 0.f)
+	{
+		return false;
+	}
+
+	FTemplate& Added = Templates.AddDefaulted_GetRef();
+	Added.Source = Template;
+	Added.Threshold = Template.Threshold > 0.f ? Template.Threshold : Settings.Threshold;
+
+	// Resampled in steps if it was made with another NumSamples
+	const int32 NumSamples = Settings.NumSamples;
+	Added.Features.SetNumUninitialized(NumSamples * NumFeatures);
+	for (int32 Step = 0; Step < NumSamples; Step++)
+	{
+		const float Position = float(Step) * (NumTemplateSamples - 1) / (NumSamples - 1);
+		const int32 Before = FMath::Min(FMath::FloorToInt(Position), NumTemplateSamples - 2);
+		const float Alpha = Position - Before;
+		for (int32 Point = 0; Point < NumPoints; Point++)
+		{
+			const FVector Value = FMath::Lerp(
+				Template.Samples[Before * NumPoints + Point], Template.Samples[(Before + 1) * NumPoints + Point], Alpha);
+			for (int32 Axis = 0; Axis < 3; Axis++)
+			{
+				Added.Features[Step * NumFeatures + Point * 3 + Axis] = Value[Axis];
+			}
+		}
+	}
+
+	// Envelope over the warping band, for LB_Keogh
+	Added.Upper.SetNumUninitialized(NumSamples * NumFeatures);
+	Added.Lower.SetNumUninitialized(NumSamples * NumFeatures);
+	for (int32 Step = 0; Step < NumSamples; Step++)
+	{
+		for (int32 Feature = 0; Feature < NumFeatures; Feature++)
+		{
+			float Upper = -MAX_flt;
+			float Lower = MAX_flt;
+			for (int32 Other = FMath::Max(Step - BandWidth, 0); Other <= FMath::Min(Step + BandWidth, NumSamples - 1); Other++)
+			{
+				Upper = FMath::Max(Upper, Added.Features[Other * NumFeatures + Feature]);
+				Lower = FMath::Min(Lower, Added.Features[Other * NumFeatures + Feature]);
+			}
+			Added.Upper[Step * NumFeatures + Feature] = Upper;
+			Added.Lower[Step * NumFeatures + Feature] = Lower;
+		}
+	}
+	Cursor = 0;
+	return true;
+}
+
+void FLeapGestureRecognizer::ClearTemplates()
+{
+	Templates.Reset();
+	Cursor = 0;
+	for (TUniquePtr<FHandHistory>& History : Histories)
+	{
+		History->PendingTemplate = INDEX_NONE;
+		History->PendingConfidence = 0.f;
+	}
+}
+
+void FLeapGestureRecognizer::Reset()
+{
+	for (int32 HandIndex = 0; HandIndex < NumHands; HandIndex++)
+	{
+		FHandHistory& History = *Histories[HandIndex];
+		History.Num = 0;
+		History.CooldownEnd = -1.0;
+		History.PendingTemplate = INDEX_NONE;
+		History.PendingConfidence = 0.f;
+		bVisible[HandIndex] = false;
+	}
+}
+
+void FLeapGestureRecognizer::GetSample(const FLeapJointCache::FHand& Hand, const double Time, FSample& OutSample)
+{
+	OutSample.Time = Time;
+	OutSample.Points[0] = Hand.PalmPosition;
+	for (int32 Digit = 0; Digit < FLeapJointCache::NumDigits; Digit++)
+	{
+		OutSample.Points[1 + Digit] = Hand.JointPositions[Digit][FLeapJointCache::NumJoints - 1];
+	}
+}
+
+void FLeapGestureRecognizer::AddFrame(const FLeapJointCache& Joints, const double Time, TArray<FLeapGestureMatch>& OutMatches)
+{
+	FSample Sample;
+	for (const EHandType Hand : {EHandType::LEAP_HAND_LEFT, EHandType::LEAP_HAND_RIGHT})
+	{
+		const FLeapJointCache::FHand& JointHand = Joints.GetHand(Hand);
+		GetSample(JointHand, Time, Sample);
+		AddHand(Hand, JointHand.bVisible, Sample);
+	}
+	EndFrame(Time, OutMatches);
+}
+
+void FLeapGestureRecognizer::AddHand(const EHandType Hand, const bool bInVisible, const FSample& Sample)
+{
+	const int32 HandIndex = Hand == EHandType::LEAP_HAND_LEFT ? 0 : 1;
+	FHandHistory& History = *Histories[HandIndex];
+	bVisible[HandIndex] = bInVisible;
+
+	// A gesture has to be seen whole
+	if (!bInVisible)
+	{
+		History.Num = 0;
+		return;
+	}
+	if (History.Num > 0 && Sample.Time <= History.At(History.Num - 1).Time)
+	{
+		return;
+	}
+	if (History.Num == HistoryCapacity)
+	{
+		History.Head = (History.Head + 1) % HistoryCapacity;
+		History.Num--;
+	}
+	History.Samples[(History.Head + History.Num) % HistoryCapacity] = Sample;
+	History.Num++;
+}
+
+void FLeapGestureRecognizer::EndFrame(const double Time, TArray<FLeapGestureMatch>& OutMatches)
+{
+	const int32 NumCandidates = NumHands * Templates.Num() * NumScales;
+	int32 NumEvaluations = 0;
+	for (int32 Step = 0; Step < NumCandidates && NumEvaluations < Settings.MaxEvaluationsPerFrame; Step++)
+	{
+		const int32 Candidate = Cursor;
+		Cursor = (Cursor + 1) % NumCandidates;
+		const int32 HandIndex = Candidate / (Templates.Num() * NumScales);
+		const int32 TemplateIndex = (Candidate / NumScales) % Templates.Num();
+		const int32 ScaleIndex = Candidate % NumScales;
+
+		FHandHistory& History = *Histories[HandIndex];
+		if (!bVisible[HandIndex] || Time < History.CooldownEnd)
+		{
+			continue;
+		}
+		const FTemplate& Template = Templates[TemplateIndex];
+		if (!ResampleWindow(History, Template.Source.Duration * DurationScales[ScaleIndex], WindowPoints))
+		{
+			continue;
+		}
+		NumEvaluations++;
+
+		// Only a match more confident than the hand's pending one is worth finishing
+		const float MaxCost = Settings.NumSamples * FMath::Square(Template.Threshold * (1.f - History.PendingConfidence));
+		const float Cost = Evaluate(Template, MaxCost);
+		if (Cost < MaxCost)
+		{
+			History.PendingDistance = FMath::Sqrt(Cost / Settings.NumSamples);
+			History.PendingConfidence = 1.f - History.PendingDistance / Template.Threshold;
+			History.PendingTemplate = TemplateIndex;
+			History.PendingTime = Time;
+		}
+	}
+
+	for (int32 HandIndex = 0; HandIndex < NumHands; HandIndex++)
+	{
+		FHandHistory& History = *Histories[HandIndex];
+		if (History.PendingTemplate == INDEX_NONE || Time - History.PendingTime < Settings.SettleSeconds)
+		{
+			continue;
+		}
+		FLeapGestureMatch& Match = OutMatches.AddDefaulted_GetRef();
+		Match.Name = Templates[History.PendingTemplate].Source.Name;
+		Match.Hand = HandIndex == 0 ? EHandType::LEAP_HAND_LEFT : EHandType::LEAP_HAND_RIGHT;
+		Match.Confidence = History.PendingConfidence;
+		Match.Distance = History.PendingDistance;
+
+		// The same motion would match again on the next frames
+		History.Num = 0;
+		History.CooldownEnd = Time + Settings.CooldownSeconds;
+		History.PendingTemplate = INDEX_NONE;
+		History.PendingConfidence = 0.f;
+	}
+}
+
+bool FLeapGestureRecognizer::ResampleWindow(const FHandHistory& History, const double Duration, TArray<FVector>& OutPoints) const
+{
+	if (History.Num < 2)
+	{
+		return false;
+	}
+	const double End = History.At(History.Num - 1).Time;
+	const double Start = End - Duration;
+	if (History.At(0).Time > Start)
+	{
+		return false;
+	}
+	ResampleSamples([&History](const int32 Index) -> const FSample& { return History.At(Index); }, History.Num, Start,
+		Duration, Settings.NumSamples, OutPoints);
+	return true;
+}
+
+float FLeapGestureRecognizer::Normalize(const TArray<FVector>& Points, TArray<float>& OutFeatures) const
+{
+	const int32 NumSamples = Points.Num() / NumPoints;
+	OutFeatures.SetNumUninitialized(NumSamples * NumFeatures, false);
+
+	FVector Mean = FVector::ZeroVector;
+	for (int32 Step = 0; Step < NumSamples; Step++)
+	{
+		Mean += Points[Step * NumPoints];
+	}
+	Mean /= NumSamples;
+	float SquaredSpread = 0.f;
+	for (int32 Step = 0; Step < NumSamples; Step++)
+	{
+		SquaredSpread += FVector::DistSquared(Points[Step * NumPoints], Mean);
+	}
+	const float Spread = FMath::Sqrt(SquaredSpread / NumSamples);
+
+	// The palm's path whatever its size, the fingertips' pose relative to the palm
+	const float PalmScale = 1.f / FMath::Max(Spread, KINDA_SMALL_NUMBER);
+	const float FingertipScale = Settings.FingertipWeight / HandScale;
+	for (int32 Step = 0; Step < NumSamples; Step++)
+	{
+		const FVector& Palm = Points[Step * NumPoints];
+		float* Features = &OutFeatures[Step * NumFeatures];
+		for (int32 Point = 0; Point < NumPoints; Point++)
+		{
+			const FVector Feature =
+				Point == 0 ? (Palm - Mean) * PalmScale : (Points[Step * NumPoints + Point] - Palm) * FingertipScale;
+			Features[Point * 3] = Feature.X;
+			Features[Point * 3 + 1] = Feature.Y;
+			Features[Point * 3 + 2] = Feature.Z;
+		}
+	}
+	return Spread;
+}
+
+float FLeapGestureRecognizer::Evaluate(const FTemplate& Template, const float MaxCost)
+{
+	Stats.Evaluations++;
+	const int32 NumSamples = Settings.NumSamples;
+	const float Spread = Normalize(WindowPoints, Query);
+	const float Extent = Template.Source.Extent;
+	if (Spread * Settings.ExtentTolerance < Extent || Spread > Extent * Settings.ExtentTolerance)
+	{
+		Stats.PrunedByExtent++;
+		return MaxCost;
+	}
+
+	// Every warping path starts and ends at the first and last steps of both
+	const int32 Last = (NumSamples - 1) * NumFeatures;
+	const float KimBound = SquaredDistance(&Query[0], &Template.Features[0], NumFeatures) +
+						   SquaredDistance(&Query[Last], &Template.Features[Last], NumFeatures);
+	if (KimBound >= MaxCost)
+	{
+		Stats.PrunedByKim++;
+		return MaxCost;
+	}
+
+	// Each step of the window is at least this far from any template step inside the band
+	float KeoghBound = 0.f;
+	for (int32 Step = 0; Step < NumSamples; Step++)
+	{
+		float StepBound = 0.f;
+		for (int32 Feature = Step * NumFeatures; Feature < (Step + 1) * NumFeatures; Feature++)
+		{
+			const float Value = Query[Feature];
+			StepBound += Value > Template.Upper[Feature]   ? FMath::Square(Value - Template.Upper[Feature])
+						 : Value < Template.Lower[Feature] ? FMath::Square(Template.Lower[Feature] - Value)
+														   : 0.f;
+		}
+		CumulativeBound[Step] = StepBound;
+		KeoghBound += StepBound;
+		if (KeoghBound >= MaxCost)
+		{
+			Stats.PrunedByKeogh++;
+			return MaxCost;
+		}
+	}
+
+	// Bound of the steps still to come, for abandoning the DTW
+	CumulativeBound[NumSamples] = 0.f;
+	for (int32 Step = NumSamples - 1; Step >= 0; Step--)
+	{
+		CumulativeBound[Step] += CumulativeBound[Step + 1];
+	}
+
+	const float Cost = Dtw(Query, Template, MaxCost);
+	if (Cost >= MaxCost)
+	{
+		Stats.AbandonedDtw++;
+		return MaxCost;
+	}
+	Stats.CompletedDtw++;
+	return Cost;
+}
+
+float FLeapGestureRecognizer::Dtw(const TArray<float>& Window, const FTemplate& Template, const float MaxCost)
+{
+	const int32 NumSamples = Settings.NumSamples;
+	float* Previous = PreviousRow.GetData();
+	float* Current = CurrentRow.GetData();
+	for (int32 Column = 0; Column < NumSamples; Column++)
+	{
+		Previous[Column] = MAX_flt;
+	}
+
+	for (int32 Row = 0; Row < NumSamples; Row++)
+	{
+		for (int32 Column = 0; Column < NumSamples; Column++)
+		{
+			Current[Column] = MAX_flt;
+		}
+		float RowMin = MAX_flt;
+		const int32 FirstColumn = FMath::Max(Row - BandWidth, 0);
+		const int32 LastColumn = FMath::Min(Row + BandWidth, NumSamples - 1);
+		for (int32 Column = FirstColumn; Column <= LastColumn; Column++)
+		{
+			const float Distance =
+				SquaredDistance(&Window[Row * NumFeatures], &Template.Features[Column * NumFeatures], NumFeatures);
+			float Best = Row == 0 && Column == 0 ? 0.f : Previous[Column];
+			if (Column > 0)
+			{
+				Best = FMath::Min3(Best, Previous[Column - 1], Current[Column - 1]);
+			}
+			Current[Column] = Best == MAX_flt ? MAX_flt : Best + Distance;
+			RowMin = FMath::Min(RowMin, Current[Column]);
+		}
+
+		// The rest of the path crosses every remaining row
+		if (RowMin == MAX_flt || RowMin + CumulativeBound[Row + 1] >= MaxCost)
+		{
+			return MaxCost;
+		}
+		Swap(Previous, Current);
+	}
+	return Previous[NumSamples - 1];
+}
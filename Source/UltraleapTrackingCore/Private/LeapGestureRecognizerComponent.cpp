@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapGestureRecognizerComponent.h"
+
+#include "IUltraleapTrackingPlugin.h"
+#include "LeapStats.h"
+#include "LeapUtility.h"
+
+namespace
+{
+// Longer than any gesture, and short enough for the history to hold a slow performance of it
+const double MaxRecordingSeconds = 2.5;
+}	 // namespace
+
+ULeapGestureRecognizerComponent::ULeapGestureRecognizerComponent()
+	: bRecording(false), bRecordingLost(false), RecordingHand(EHandType::LEAP_HAND_RIGHT)
+{
+	PrimaryComponentTick.bCanEverTick = true;
+
+	const FLeapGestureRecognizerSettings Defaults;
+	Threshold = Defaults.Threshold;
+	MaxComparisonsPerTick = Defaults.MaxEvaluationsPerFrame;
+	CooldownSeconds = Defaults.CooldownSeconds;
+	FingertipWeight = Defaults.FingertipWeight;
+}
+
+FLeapGestureRecognizerSettings ULeapGestureRecognizerComponent::GetSettings() const
+{
+	FLeapGestureRecognizerSettings Settings;
+	Settings.Threshold = Threshold;
+	Settings.MaxEvaluationsPerFrame = MaxComparisonsPerTick;
+	Settings.CooldownSeconds = CooldownSeconds;
+	Settings.FingertipWeight = FingertipWeight;
+	return Settings;
+}
+
+void ULeapGestureRecognizerComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	Recognizer.SetSettings(GetSettings());
+	Recognizer.ClearTemplates();
+	for (const FLeapGestureTemplate& Template : Templates)
+	{
+		if (!Recognizer.AddTemplate(Template))
+		{
+			UE_LOG(UltraleapTrackingLog, Warning, TEXT("Gesture template %s has no samples"), *Template.Name.ToString());
+		}
+	}
+}
+
+bool ULeapGestureRecognizerComponent::AddGestureTemplate(const FLeapGestureTemplate& Template)
+{
+	if (!Recognizer.AddTemplate(Template))
+	{
+		return false;
+	}
+	Templates.Add(Template);
+	return true;
+}
+
+void ULeapGestureRecognizerComponent::ClearGestureTemplates()
+{
+	Templates.Reset();
+	Recognizer.ClearTemplates();
+}
+
+void ULeapGestureRecognizerComponent::StartRecordingGesture(FName Name, EHandType Hand)
+{
+	bRecording = true;
+	bRecordingLost = false;
+	RecordingName = Name;
+	RecordingHand = Hand;
+	Recording.Reset();
+}
+
+bool ULeapGestureRecognizerComponent::StopRecordingGesture(FLeapGestureTemplate& Template)
+{
+	const bool bWasRecording = bRecording;
+	bRecording = false;
+	return bWasRecording && !bRecordingLost && Recognizer.MakeTemplate(RecordingName, Recording, Template);
+}
+
+void ULeapGestureRecognizerComponent::TickComponent(
+	float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapGestureRecognition);
+
+	const FLeapJointCache& Joints = IUltraleapTrackingPlugin::Get().GetJointCache();
+	const double Time = GetWorld()->GetTimeSeconds();
+
+	if (bRecording)
+	{
+		const FLeapJointCache::FHand& Hand = Joints.GetHand(RecordingHand);
+		if (!Hand.bVisible)
+		{
+			bRecordingLost |= Recording.Num() > 0;
+		}
+		else if (Recording.Num() == 0 || Time - Recording[0].Time < MaxRecordingSeconds)
+		{
+			FLeapGestureRecognizer::GetSample(Hand, Time, Recording.AddDefaulted_GetRef());
+		}
+	}
+
+	Matches.Reset();
+	Recognizer.AddFrame(Joints, Time, Matches);
+	for (const FLeapGestureMatch& Match : Matches)
+	{
+		OnGestureRecognized.Broadcast(Match.Name, Match.Hand, Match.Confidence);
+	}
+}
@@ -0,0 +1,195 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapHandQueries.h"
+
+namespace
+{
+const EHandType HandTypes[2] = {EHandType::LEAP_HAND_LEFT, EHandType::LEAP_HAND_RIGHT};
+const int32 Fingertip = FLeapJointCache::NumJoints - 1;
+
+/** Call Visit(Digit, Joint, Position) for each joint of the hand, or only each fingertip */
+template <typename VisitorType>
+void ForEachJoint(const FLeapJointCache::FHand& Hand, bool bFingertipsOnly, VisitorType Visit)
+{
+	for (int32 Digit = 0; Digit < FLeapJointCache::NumDigits; Digit++)
+	{
+		for (int32 Joint = bFingertipsOnly ? Fingertip : 0; Joint < FLeapJointCache::NumJoints; Joint++)
+		{
+			Visit(Digit, Joint, Hand.JointPositions[Digit][Joint]);
+		}
+	}
+}
+
+FLeapJointQueryResult MakeResult(EHandType Hand, int32 Digit, int32 Joint, const FVector& Position, float Distance)
+{
+	FLeapJointQueryResult Result;
+	Result.Hand = Hand;
+	Result.Digit = Digit;
+	Result.Joint = Joint;
+	Result.Position = Position;
+	Result.Distance = Distance;
+	return Result;
+}
+
+bool IsInBox(const FVector& Position, const FTransform& BoxTransform, const FVector& Extent)
+{
+	const FVector Local = BoxTransform.GetRotation().UnrotateVector(Position - BoxTransform.GetLocation());
+	return FMath::Abs(Local.X) <= Extent.X && FMath::Abs(Local.Y) <= Extent.Y && FMath::Abs(Local.Z) <= Extent.Z;
+}
+}	 // namespace
+
+bool FLeapHandQueries::FindNearestJoint(
+	const FLeapJointCache& Joints, const FVector& Point, bool bFingertipsOnly, FLeapJointQueryResult& OutResult)
+{
+	float NearestDistSquared = MAX_flt;
+	for (EHandType HandType : HandTypes)
+	{
+		const FLeapJointCache::FHand& Hand = Joints.GetHand(HandType);
+		if (!Hand.bVisible)
+		{
+			continue;
+		}
+		ForEachJoint(Hand, bFingertipsOnly, [&](int32 Digit, int32 Joint, const FVector& Position) {
+			const float DistSquared = FVector::DistSquared(Position, Point);
+			if (DistSquared < NearestDistSquared)
+			{
+				NearestDistSquared = DistSquared;
+				OutResult = MakeResult(HandType, Digit, Joint, Position, 0.f);
+			}
+		});
+	}
+	if (NearestDistSquared == MAX_flt)
+	{
+		return false;
+	}
+	OutResult.Distance = FMath::Sqrt(NearestDistSquared);
+	return true;
+}
+
+int32 FLeapHandQueries::FindJointsInBox(const FLeapJointCache& Joints, const FTransform& BoxTransform, const FVector& Extent,
+	TArray<FLeapJointQueryResult>& OutResults)
+{
+	const int32 NumBefore = OutResults.Num();
+	const FVector Center = BoxTransform.GetLocation();
+	for (EHandType HandType : HandTypes)
+	{
+		const FLeapJointCache::FHand& Hand = Joints.GetHand(HandType);
+		if (!Hand.bVisible)
+		{
+			continue;
+		}
+		ForEachJoint(Hand, false, [&](int32 Digit, int32 Joint, const FVector& Position) {
+			if (IsInBox(Position, BoxTransform, Extent))
+			{
+				OutResults.Add(MakeResult(HandType, Digit, Joint, Position, FVector::Dist(Position, Center)));
+			}
+		});
+	}
+	return OutResults.Num() - NumBefore;
+}
+
+int32 FLeapHandQueries::FindJointsInSphere(
+	const FLeapJointCache& Joints, const FVector& Center, float Radius, TArray<FLeapJointQueryResult>& OutResults)
+{
+	const int32 NumBefore = OutResults.Num();
+	const float RadiusSquared = FMath::Square(Radius);
+	for (EHandType HandType : HandTypes)
+	{
+		const FLeapJointCache::FHand& Hand = Joints.GetHand(HandType);
+		if (!Hand.bVisible)
+		{
+			continue;
+		}
+		ForEachJoint(Hand, false, [&](int32 Digit, int32 Joint, const FVector& Position) {
+			const float DistSquared = FVector::DistSquared(Position, Center);
+			if (DistSquared <= RadiusSquared)
+			{
+				OutResults.Add(MakeResult(HandType, Digit, Joint, Position, FMath::Sqrt(DistSquared)));
+			}
+		});
+	}
+	return OutResults.Num() - NumBefore;
+}
+
+bool FLeapHandQueries::IsHandInBox(
+	const FLeapJointCache& Joints, EHandType HandType, const FTransform& BoxTransform, const FVector& Extent)
+{
+	const FLeapJointCache::FHand& Hand = Joints.GetHand(HandType);
+	if (!Hand.bVisible)
+	{
+		return false;
+	}
+	for (int32 Digit = 0; Digit < FLeapJointCache::NumDigits; Digit++)
+	{
+		for (int32 Joint = 0; Joint < FLeapJointCache::NumJoints; Joint++)
+		{
+			if (IsInBox(Hand.JointPositions[Digit][Joint], BoxTransform, Extent))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool FLeapHandQueries::GetHandDistanceToSegment(const FLeapJointCache& Joints, EHandType HandType, const FVector& Start,
+	const FVector& End, FLeapJointQueryResult& OutResult)
+{
+	const FLeapJointCache::FHand& Hand = Joints.GetHand(HandType);
+	if (!Hand.bVisible)
+	{
+		return false;
+	}
+	float NearestDistSquared = MAX_flt;
+	ForEachJoint(Hand, false, [&](int32 Digit, int32 Joint, const FVector& Position) {
+		const float DistSquared = FVector::DistSquared(Position, FMath::ClosestPointOnSegment(Position, Start, End));
+		if (DistSquared < NearestDistSquared)
+		{
+			NearestDistSquared = DistSquared;
+			OutResult = MakeResult(HandType, Digit, Joint, Position, 0.f);
+		}
+	});
+	OutResult.Distance = FMath::Sqrt(NearestDistSquared);
+	return true;
+}
+
+bool FLeapHandQueries::GetFingertipDistance(
+	const FLeapJointCache& Joints, EHandType HandA, int32 DigitA, EHandType HandB, int32 DigitB, float& OutDistance)
+{
+	FVector PositionA;
+	FVector PositionB;
+	FRotator Rotation;
+	if (!Joints.GetJoint(HandA, DigitA, Fingertip, PositionA, Rotation) ||
+		!Joints.GetJoint(HandB, DigitB, Fingertip, PositionB, Rotation))
+	{
+		return false;
+	}
+	OutDistance = FVector::Dist(PositionA, PositionB);
+	return true;
+}
+
+bool FLeapHandQueries::GetFingertipDistances(const FLeapJointCache& Joints, EHandType HandA, EHandType HandB,
+	float OutDistances[FLeapJointCache::NumDigits][FLeapJointCache::NumDigits])
+{
+	const FLeapJointCache::FHand& A = Joints.GetHand(HandA);
+	const FLeapJointCache::FHand& B = Joints.GetHand(HandB);
+	if (!A.bVisible || !B.bVisible)
+	{
+		return false;
+	}
+	for (int32 DigitA = 0; DigitA < FLeapJointCache::NumDigits; DigitA++)
+	{
+		for (int32 DigitB = 0; DigitB < FLeapJointCache::NumDigits; DigitB++)
+		{
+			OutDistances[DigitA][DigitB] =
+				FVector::Dist(A.JointPositions[DigitA][Fingertip], B.JointPositions[DigitB][Fingertip]);
+		}
+	}
+	return true;
+}
@@ -9,6 +9,7 @@
 #include "LeapImage.h"
 
 #include "LeapAsync.h"
+#include "LeapStats.h"
 
 FLeapImage::FLeapImage()
 {
@@ -125,6 +126,8 @@ void FLeapImage::UpdateTextureRegions(UTexture2D* Texture, const LEAP_IMAGE& Ima
 
 void FLeapImage::UpdateTextureOnGameThread(UTexture2D* Texture, uint8* SrcData, const int32 BufferLength)
 {
+	LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapImageUpload);
+	LEAP_LLM_SCOPE(Ultraleap_Images);
 #if ENGINE_MAJOR_VERSION >= 5 
 	uint8* MipData = static_cast<uint8*>(Texture->GetPlatformData()->Mips[0].BulkData.Lock(LOCK_READ_WRITE));
 #else
@@ -142,6 +145,8 @@ void FLeapImage::UpdateTextureOnGameThread(UTexture2D* Texture, uint8* SrcData,
 
 void FLeapImage::OnImage(const LEAP_IMAGE_EVENT* ImageEvent)
 {
+	LEAP_LLM_SCOPE(Ultraleap_Images);
+
 	// Don't schedule more events if we've received quitting signal or we haven't updated the last render
 	if (bIsQuitting || !bRenderDidUpdate)
 	{
@@ -0,0 +1,86 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapJointCache.h"
+
+FLeapJointCache::FHand::FHand()
+{
+	for (int32 Digit = 0; Digit < NumDigits; Digit++)
+	{
+		for (int32 Joint = 0; Joint < NumJoints; Joint++)
+		{
+			JointPositions[Digit][Joint] = FVector::ZeroVector;
+			JointRotations[Digit][Joint] = FRotator::ZeroRotator;
+		}
+	}
+}
+
+void FLeapJointCache::SetFromFrame(const FLeapFrameData& Frame)
+{
+	Hands[0].bVisible = false;
+	Hands[1].bVisible = false;
+
+	for (const FLeapHandData& Hand : Frame.Hands)
+	{
+		FHand& Cached = Hands[Hand.HandType == EHandType::LEAP_HAND_LEFT ? 0 : 1];
+		if (Cached.bVisible)
+		{
+			continue;
+		}
+		Cached.bVisible = true;
+
+		const FLeapDigitData* Digits[NumDigits] = {&Hand.Thumb, &Hand.Index, &Hand.Middle, &Hand.Ring, &Hand.Pinky};
+		for (int32 DigitIndex = 0; DigitIndex < NumDigits; DigitIndex++)
+		{
+			const FLeapDigitData& Digit = *Digits[DigitIndex];
+			FVector* Positions = Cached.JointPositions[DigitIndex];
+			FRotator* Rotations = Cached.JointRotations[DigitIndex];
+
+			Positions[0] = Digit.Metacarpal.PrevJoint;
+			Positions[1] = Digit.Proximal.PrevJoint;
+			Positions[2] = Digit.Intermediate.PrevJoint;
+			Positions[3] = Digit.Distal.PrevJoint;
+			Positions[4] = Digit.Distal.NextJoint;
+
+			Rotations[0] = Digit.Metacarpal.Rotation;
+			Rotations[1] = Digit.Proximal.Rotation;
+			Rotations[2] = Digit.Intermediate.Rotation;
+			Rotations[3] = Digit.Distal.Rotation;
+			Rotations[4] = Digit.Distal.Rotation;
+		}
+
+		Cached.PalmPosition = Hand.Palm.Position;
+		Cached.PalmNormal = Hand.Palm.Normal;
+		Cached.PalmDirection = Hand.Palm.Direction;
+		Cached.PalmOrientation = Hand.Palm.Orientation;
+		Cached.PinchStrength = Hand.PinchStrength;
+		Cached.PinchDistance = Hand.PinchDistance;
+		Cached.GrabStrength = Hand.GrabStrength;
+	}
+
+	// Lost hands are reset to a zeroed FHand rather than left where they were last seen
+	for (FHand& Cached : Hands)
+	{
+		if (!Cached.bVisible)
+		{
+			Cached = FHand();
+		}
+	}
+}
+
+bool FLeapJointCache::GetJoint(EHandType HandType, int32 Digit, int32 Joint, FVector& OutPosition, FRotator& OutRotation) const
+{
+	const FHand& Hand = GetHand(HandType);
+	if (!Hand.bVisible || Digit < 0 || Digit >= NumDigits || Joint < 0 || Joint >= NumJoints)
+	{
+		return false;
+	}
+	OutPosition = Hand.JointPositions[Digit][Joint];
+	OutRotation = Hand.JointRotations[Digit][Joint];
+	return true;
+}
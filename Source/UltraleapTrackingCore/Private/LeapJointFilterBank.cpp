@@ -0,0 +1,255 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapJointFilterBank.h"
+
+#if ENGINE_MAJOR_VERSION >= 5
+typedef VectorRegister4Float FLeapVectorRegister;
+#else
+typedef VectorRegister FLeapVectorRegister;
+#endif
+
+static_assert(FLeapJointFilterBank::JointsPerHand % 4 == 0, "Hand lane ranges must stay aligned to the SIMD width");
+
+// Lane layout within a hand
+#define LANE_PALM 0
+#define LANE_ELBOW 1
+#define LANE_WRIST 2
+#define LANE_FIRST_DIGIT 3
+#define JOINTS_PER_DIGIT 5
+
+FLeapJointFilterBank::FLeapJointFilterBank()
+	: MinCutoff(1.5f), CutoffSlope(0.05f), DeltaCutoff(1.f), bFilterPositions(true), bFilterRotations(false)
+{
+	Reset();
+}
+
+void FLeapJointFilterBank::Init(const float InMinCutoff, const float InCutoffSlope, const float InDeltaCutoff)
+{
+	MinCutoff = InMinCutoff;
+	CutoffSlope = InCutoffSlope;
+	DeltaCutoff = InDeltaCutoff;
+}
+
+void FLeapJointFilterBank::InitRotations(const float InMinCutoff, const float InCutoffSlope, const float InDeltaCutoff)
+{
+	for (int32 Slot = 0; Slot < HandSlots; Slot++)
+	{
+		for (FLeapOneEuroRotationFilter& Filter : RotationFilters[Slot])
+		{
+			Filter.Init(InMinCutoff, InCutoffSlope, InDeltaCutoff);
+		}
+	}
+}
+
+void FLeapJointFilterBank::SetChannels(const bool bInFilterPositions, const bool bInFilterRotations)
+{
+	if (bFilterPositions != bInFilterPositions || bFilterRotations != bInFilterRotations)
+	{
+		Reset();
+	}
+	bFilterPositions = bInFilterPositions;
+	bFilterRotations = bInFilterRotations;
+}
+
+void FLeapJointFilterBank::Reset()
+{
+	for (int32 Slot = 0; Slot < HandSlots; Slot++)
+	{
+		ResetHand(Slot);
+	}
+}
+
+void FLeapJointFilterBank::ResetHand(const int32 HandSlot)
+{
+	check(HandSlot >= 0 && HandSlot < HandSlots);
+
+	const int32 FirstLane = HandSlot * JointsPerHand;
+	for (int32 Axis = 0; Axis < 3; Axis++)
+	{
+		FMemory::Memzero(&PreviousValue[Axis][FirstLane], JointsPerHand * sizeof(float));
+		FMemory::Memzero(&PreviousDelta[Axis][FirstLane], JointsPerHand * sizeof(float));
+	}
+	FMemory::Memzero(&Primed[FirstLane], JointsPerHand * sizeof(float));
+	for (FLeapOneEuroRotationFilter& Filter : RotationFilters[HandSlot])
+	{
+		Filter.Reset();
+	}
+	SlotHandIds[HandSlot] = INDEX_NONE;
+}
+
+void FLeapJointFilterBank::FilterFrame(FLeapFrameData& InOutFrame, const float InDeltaTime)
+{
+	if (InDeltaTime <= 0.f)
+	{
+		return;
+	}
+
+	FLeapHandData* SlotHands[HandSlots] = {nullptr, nullptr};
+	for (FLeapHandData& Hand : InOutFrame.Hands)
+	{
+		const int32 Slot = Hand.HandType == EHandType::LEAP_HAND_LEFT ? 0 : 1;
+		if (SlotHands[Slot] == nullptr)
+		{
+			SlotHands[Slot] = &Hand;
+		}
+	}
+
+	for (int32 Slot = 0; Slot < HandSlots; Slot++)
+	{
+		FLeapHandData* Hand = SlotHands[Slot];
+
+		// A lost or swapped hand must not inherit the previous hand's history
+		if (Hand == nullptr || Hand->Id != SlotHandIds[Slot])
+		{
+			ResetHand(Slot);
+		}
+		if (Hand == nullptr)
+		{
+			continue;
+		}
+		SlotHandIds[Slot] = Hand->Id;
+
+		if (bFilterPositions)
+		{
+			const int32 FirstLane = Slot * JointsPerHand;
+			GatherHand(*Hand, FirstLane);
+			FilterLanes(FirstLane, JointsPerHand, InDeltaTime);
+			ScatterHand(*Hand, FirstLane);
+		}
+		if (bFilterRotations)
+		{
+			FilterRotations(*Hand, Slot, InDeltaTime);
+		}
+	}
+}
+
+void FLeapJointFilterBank::FilterRotations(FLeapHandData& Hand, const int32 HandSlot, const float InDeltaTime)
+{
+	FLeapOneEuroRotationFilter* Filter = RotationFilters[HandSlot];
+
+	Hand.Palm.Orientation = (Filter++)->Filter(Hand.Palm.Orientation.Quaternion(), InDeltaTime).Rotator();
+	Hand.Arm.Rotation = (Filter++)->Filter(Hand.Arm.Rotation.Quaternion(), InDeltaTime).Rotator();
+
+	FLeapDigitData* Digits[5] = {&Hand.Thumb, &Hand.Index, &Hand.Middle, &Hand.Ring, &Hand.Pinky};
+	for (FLeapDigitData* Digit : Digits)
+	{
+		FLeapBoneData* Bones[4] = {&Digit->Metacarpal, &Digit->Proximal, &Digit->Intermediate, &Digit->Distal};
+		for (FLeapBoneData* Bone : Bones)
+		{
+			Bone->Rotation = (Filter++)->Filter(Bone->Rotation.Quaternion(), InDeltaTime).Rotator();
+		}
+	}
+	check(Filter == RotationFilters[HandSlot] + RotationsPerHand);
+}
+
+void FLeapJointFilterBank::FilterLanes(const int32 FirstLane, const int32 NumLanes, const float InDeltaTime)
+{
+	const FLeapVectorRegister One = GlobalVectorConstants::FloatOne;
+	const FLeapVectorRegister InvDeltaTime = VectorSetFloat1(1.f / InDeltaTime);
+	const FLeapVectorRegister MinCutoffV = VectorSetFloat1(MinCutoff);
+	const FLeapVectorRegister CutoffSlopeV = VectorSetFloat1(CutoffSlope);
+
+	// alpha = 1 / (1 + tau / dt) with tau = 1 / (2 * PI * cutoff), rewritten as k / (k + 1) with k = 2 * PI * cutoff * dt
+	const FLeapVectorRegister TwoPiDeltaTime = VectorSetFloat1(2.f * PI * InDeltaTime);
+	const float DeltaK = 2.f * PI * DeltaCutoff * InDeltaTime;
+	const FLeapVectorRegister DeltaAlpha = VectorSetFloat1(DeltaK / (DeltaK + 1.f));
+
+	for (int32 Lane = FirstLane; Lane < FirstLane + NumLanes; Lane += 4)
+	{
+		// Unprimed lanes get a zero derivative and an alpha of one, i.e. the raw value passes through
+		const FLeapVectorRegister IsPrimed = VectorLoad(&Primed[Lane]);
+		const FLeapVectorRegister NotPrimed = VectorSubtract(One, IsPrimed);
+		const FLeapVectorRegister EffectiveDeltaAlpha = VectorMultiplyAdd(DeltaAlpha, IsPrimed, NotPrimed);
+
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			const FLeapVectorRegister Raw = VectorLoad(&Value[Axis][Lane]);
+			const FLeapVectorRegister Previous = VectorLoad(&PreviousValue[Axis][Lane]);
+			const FLeapVectorRegister PreviousD = VectorLoad(&PreviousDelta[Axis][Lane]);
+
+			// Filtered derivative
+			const FLeapVectorRegister Delta = VectorMultiply(VectorMultiply(VectorSubtract(Raw, Previous), InvDeltaTime), IsPrimed);
+			const FLeapVectorRegister Estimated =
+				VectorMultiplyAdd(EffectiveDeltaAlpha, VectorSubtract(Delta, PreviousD), PreviousD);
+
+			// Adaptive cutoff from the derivative
+			const FLeapVectorRegister Cutoff = VectorMultiplyAdd(CutoffSlopeV, VectorAbs(Estimated), MinCutoffV);
+			const FLeapVectorRegister K = VectorMultiply(Cutoff, TwoPiDeltaTime);
+			const FLeapVectorRegister Alpha = VectorMultiplyAdd(VectorDivide(K, VectorAdd(K, One)), IsPrimed, NotPrimed);
+
+			// Low pass the value
+			const FLeapVectorRegister Result = VectorMultiplyAdd(Alpha, VectorSubtract(Raw, Previous), Previous);
+
+			VectorStore(Result, &Value[Axis][Lane]);
+			VectorStore(Result, &PreviousValue[Axis][Lane]);
+			VectorStore(Estimated, &PreviousDelta[Axis][Lane]);
+		}
+
+		VectorStore(One, &Primed[Lane]);
+	}
+}
+
+void FLeapJointFilterBank::SetLane(const int32 Lane, const FVector& InValue)
+{
+	Value[0][Lane] = (float) InValue.X;
+	Value[1][Lane] = (float) InValue.Y;
+	Value[2][Lane] = (float) InValue.Z;
+}
+
+FVector FLeapJointFilterBank::GetLane(const int32 Lane) const
+{
+	return FVector(Value[0][Lane], Value[1][Lane], Value[2][Lane]);
+}
+
+void FLeapJointFilterBank::GatherHand(const FLeapHandData& Hand, const int32 FirstLane)
+{
+	SetLane(FirstLane + LANE_PALM, Hand.Palm.Position);
+	SetLane(FirstLane + LANE_ELBOW, Hand.Arm.PrevJoint);
+	SetLane(FirstLane + LANE_WRIST, Hand.Arm.NextJoint);
+
+	const FLeapDigitData* Digits[5] = {&Hand.Thumb, &Hand.Index, &Hand.Middle, &Hand.Ring, &Hand.Pinky};
+	for (int32 DigitIndex = 0; DigitIndex < 5; DigitIndex++)
+	{
+		const FLeapDigitData& Digit = *Digits[DigitIndex];
+		const int32 Lane = FirstLane + LANE_FIRST_DIGIT + DigitIndex * JOINTS_PER_DIGIT;
+
+		SetLane(Lane + 0, Digit.Metacarpal.PrevJoint);
+		SetLane(Lane + 1, Digit.Proximal.PrevJoint);
+		SetLane(Lane + 2, Digit.Intermediate.PrevJoint);
+		SetLane(Lane + 3, Digit.Distal.PrevJoint);
+		SetLane(Lane + 4, Digit.Distal.NextJoint);
+	}
+}
+
+void FLeapJointFilterBank::ScatterHand(FLeapHandData& Hand, const int32 FirstLane) const
+{
+	Hand.Palm.Position = GetLane(FirstLane + LANE_PALM);
+	Hand.Arm.PrevJoint = GetLane(FirstLane + LANE_ELBOW);
+	Hand.Arm.NextJoint = GetLane(FirstLane + LANE_WRIST);
+
+	FLeapDigitData* Digits[5] = {&Hand.Thumb, &Hand.Index, &Hand.Middle, &Hand.Ring, &Hand.Pinky};
+	for (int32 DigitIndex = 0; DigitIndex < 5; DigitIndex++)
+	{
+		FLeapDigitData& Digit = *Digits[DigitIndex];
+		const int32 Lane = FirstLane + LANE_FIRST_DIGIT + DigitIndex * JOINTS_PER_DIGIT;
+
+		// Shared joints are written to both bones so the chain stays connected
+		Digit.Metacarpal.PrevJoint = GetLane(Lane + 0);
+		Digit.Metacarpal.NextJoint = Digit.Proximal.PrevJoint = GetLane(Lane + 1);
+		Digit.Proximal.NextJoint = Digit.Intermediate.PrevJoint = GetLane(Lane + 2);
+		Digit.Intermediate.NextJoint = Digit.Distal.PrevJoint = GetLane(Lane + 3);
+		Digit.Distal.NextJoint = GetLane(Lane + 4);
+	}
+}
+
+#undef LANE_PALM
+#undef LANE_ELBOW
+#undef LANE_WRIST
+#undef LANE_FIRST_DIGIT
+#undef JOINTS_PER_DIGIT
@@ -0,0 +1,82 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OneEuroFilterComponent.h"
+#include "UltraleapTrackingData.h"
+
+/**
+ * One Euro filter for every joint position of both hands, run in a single pass.
+ *
+ * State is kept per joint ("lane") in structure-of-arrays form so four joints are filtered per SIMD
+ * instruction. Each hand owns a fixed range of lanes; when the hand id in a slot changes (or the hand
+ * is lost) only that range is reset, so the other hand keeps its smoothing history.
+ *
+ * Unlike UOneEuroFilterComponent the derivative is a true velocity (cm/s), so the usual One Euro
+ * parameters from the literature apply directly. Palm, arm and bone orientations can optionally be
+ * smoothed with the quaternion variant, which is scalar per bone but uses the same slot reset rules.
+ */
+class FLeapJointFilterBank
+{
+public:
+	// Palm, elbow, wrist and 5 joints (4 bone bases + tip) for each of the 5 digits
+	static constexpr int32 JointsPerHand = 3 + 5 * 5;
+	static constexpr int32 HandSlots = 2;
+	static constexpr int32 LaneCount = JointsPerHand * HandSlots;
+
+	// Palm, arm and 4 bones for each of the 5 digits
+	static constexpr int32 RotationsPerHand = 2 + 5 * 4;
+
+	FLeapJointFilterBank();
+
+	void Init(const float InMinCutoff, const float InCutoffSlope, const float InDeltaCutoff);
+	void InitRotations(const float InMinCutoff, const float InCutoffSlope, const float InDeltaCutoff);
+
+	/** Choose which channels FilterFrame smooths */
+	void SetChannels(const bool bInFilterPositions, const bool bInFilterRotations);
+
+	/** Reset all lanes, the next frame passes through unfiltered */
+	void Reset();
+
+	/** Reset only the lanes owned by one hand slot */
+	void ResetHand(const int32 HandSlot);
+
+	/** Smooth all joint positions of all hands in the frame in place */
+	void FilterFrame(FLeapFrameData& InOutFrame, const float InDeltaTime);
+
+private:
+	void GatherHand(const FLeapHandData& Hand, const int32 FirstLane);
+	void ScatterHand(FLeapHandData& Hand, const int32 FirstLane) const;
+	void FilterLanes(const int32 FirstLane, const int32 NumLanes, const float InDeltaTime);
+	void FilterRotations(FLeapHandData& Hand, const int32 HandSlot, const float InDeltaTime);
+
+	void SetLane(const int32 Lane, const FVector& Value);
+	FVector GetLane(const int32 Lane) const;
+
+	float MinCutoff;
+	float CutoffSlope;
+	float DeltaCutoff;
+
+	// Per lane state, one row per axis
+	float Value[3][LaneCount];
+	float PreviousValue[3][LaneCount];
+	float PreviousDelta[3][LaneCount];
+
+	/** 1 once a lane has a history, 0 while it should pass the raw value through */
+	float Primed[LaneCount];
+
+	FLeapOneEuroRotationFilter RotationFilters[HandSlots][RotationsPerHand];
+
+	bool bFilterPositions;
+	bool bFilterRotations;
+
+	/** Hand id currently owning each slot, INDEX_NONE when empty */
+	int32 SlotHandIds[HandSlots];
+};
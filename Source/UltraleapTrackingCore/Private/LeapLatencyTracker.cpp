@@ -0,0 +1,316 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapLatencyTracker.h"
+
+#include "HAL/IConsoleManager.h"
+#include "IUltraleapTrackingPlugin.h"
+#include "LeapStats.h"
+#include "LeapUtility.h"
+#include "LeapWrapper.h"
+#include "Misc/CoreDelegates.h"
+#include "RenderingThread.h"
+
+static TAutoConsoleVariable<int32> CVarLeapLatencyEnable(TEXT("leap.Latency.Enable"), 1,
+	TEXT("Measure the age of the hand data at each pipeline stage, see stat UltraleapTracking and leap.Latency.Dump"));
+
+static TAutoConsoleVariable<int32> CVarLeapLatencyTelemetry(TEXT("leap.Latency.Telemetry"), 0,
+	TEXT("Forward the input tick to the tracking service telemetry profiler (LeapTelemetryProfiling)"));
+
+static const TCHAR* LatencyStageNames[] = {TEXT("Service thread"), TEXT("Game thread"), TEXT("Anim evaluation"), TEXT("Render submit")};
+
+static void DumpLatency()
+{
+	if (!IUltraleapTrackingPlugin::IsAvailable())
+	{
+		return;
+	}
+	for (int32 Stage = 0; Stage < UE_ARRAY_COUNT(LatencyStageNames); Stage++)
+	{
+		const FLeapLatencyPercentiles Percentiles = IUltraleapTrackingPlugin::Get().GetLatencyPercentiles((ELeapLatencyStage) Stage);
+		UE_LOG(UltraleapTrackingLog, Log, TEXT("%-16s n=%4d mean=%6.2fms p50=%6.2fms p90=%6.2fms p99=%6.2fms max=%6.2fms"),
+			LatencyStageNames[Stage], Percentiles.SampleCount, Percentiles.MeanMS, Percentiles.P50MS, Percentiles.P90MS,
+			Percentiles.P99MS, Percentiles.MaxMS);
+	}
+}
+
+static FAutoConsoleCommand LeapLatencyDumpCommand(TEXT("leap.Latency.Dump"),
+	TEXT("Log the rolling hand data latency percentiles for each pipeline stage"), FConsoleCommandDelegate::CreateStatic(&DumpLatency));
+
+static int64 CyclesToMicros(uint64 Cycles)
+{
+	return (int64) (FPlatformTime::ToSeconds64(Cycles) * 1000000.0);
+}
+
+// FLeapLatencyHistogram
+
+static int32 BucketForSample(int32 Sample)
+{
+	return FMath::Min(Sample / FLeapLatencyHistogram::BucketWidth, FLeapLatencyHistogram::BucketCount - 1);
+}
+
+FLeapLatencyHistogram::FLeapLatencyHistogram()
+{
+	Reset();
+}
+
+void FLeapLatencyHistogram::AddSample(int64 Microseconds)
+{
+	// Clocks that are rebased can drift a little below the device timestamp
+	const int32 Sample = (int32) FMath::Clamp<int64>(Microseconds, 0, MAX_int32);
+
+	if (NumSamples == WindowSize)
+	{
+		const int32 Evicted = Window[NextSample];
+		Buckets[BucketForSample(Evicted)]--;
+		Sum -= Evicted;
+	}
+	else
+	{
+		NumSamples++;
+	}
+
+	Window[NextSample] = Sample;
+	Buckets[BucketForSample(Sample)]++;
+	Sum += Sample;
+	NextSample = (NextSample + 1) % WindowSize;
+}
+
+void FLeapLatencyHistogram::Reset()
+{
+	FMemory::Memzero(Buckets);
+	FMemory::Memzero(Window);
+	NextSample = 0;
+	NumSamples = 0;
+	Sum = 0;
+}
+
+float FLeapLatencyHistogram::GetPercentileMS(float Percentile) const
+{
+	if (NumSamples == 0)
+	{
+		return 0.f;
+	}
+	const int32 Rank = FMath::Clamp(FMath::CeilToInt(Percentile * NumSamples), 1, NumSamples);
+
+	int32 Count = 0;
+	for (int32 Bucket = 0; Bucket < BucketCount; Bucket++)
+	{
+		Count += Buckets[Bucket];
+		if (Count >= Rank)
+		{
+			return (Bucket + 1) * BucketWidth / 1000.f;
+		}
+	}
+	return BucketCount * BucketWidth / 1000.f;
+}
+
+FLeapLatencyPercentiles FLeapLatencyHistogram::GetPercentiles() const
+{
+	FLeapLatencyPercentiles Percentiles;
+	if (NumSamples == 0)
+	{
+		return Percentiles;
+	}
+
+	int32 Max = 0;
+	for (int32 Index = 0; Index < NumSamples; Index++)
+	{
+		Max = FMath::Max(Max, Window[Index]);
+	}
+
+	Percentiles.SampleCount = NumSamples;
+	Percentiles.MeanMS = Sum / (float) NumSamples / 1000.f;
+	Percentiles.P50MS = GetPercentileMS(0.5f);
+	Percentiles.P90MS = GetPercentileMS(0.9f);
+	Percentiles.P99MS = GetPercentileMS(0.99f);
+	Percentiles.MaxMS = Max / 1000.f;
+	return Percentiles;
+}
+
+// FLeapLatencyTracker
+
+FLeapLatencyTracker::FLeapLatencyTracker()
+	: ClockRebaser(nullptr), LastSampledFrameId(-1), LastDeviceTimestamp(0), LastConsumedCycles(0), LastAnimEvaluationCycles(0)
+{
+	LeapCreateClockRebaser(&ClockRebaser);
+
+	// The delegate is broadcast on the render thread, so only ever touch it there
+	ENQUEUE_RENDER_COMMAND(LeapLatencyBindEndFrame)
+	([this](FRHICommandListImmediate& RHICmdList) {
+		EndFrameHandle = FCoreDelegates::OnEndFrameRT.AddRaw(this, &FLeapLatencyTracker::OnEndFrameRenderThread);
+	});
+}
+
+FLeapLatencyTracker::~FLeapLatencyTracker()
+{
+	ENQUEUE_RENDER_COMMAND(LeapLatencyUnbindEndFrame)
+	([this](FRHICommandListImmediate& RHICmdList) { FCoreDelegates::OnEndFrameRT.Remove(EndFrameHandle); });
+	FlushRenderingCommands();
+
+	if (ClockRebaser)
+	{
+		LeapDestroyClockRebaser(ClockRebaser);
+	}
+}
+
+bool FLeapLatencyTracker::IsEnabled()
+{
+	return CVarLeapLatencyEnable.GetValueOnGameThread() != 0;
+}
+
+void FLeapLatencyTracker::OnFrameConsumed(IHandTrackingWrapper& Wrapper, const LEAP_TRACKING_EVENT& Frame, uint64 AnimEvaluationCycles)
+{
+	const uint64 NowCycles = FPlatformTime::Cycles64();
+	const int64 LeapNow = Wrapper.GetNow();
+	if (ClockRebaser)
+	{
+		LeapUpdateRebase(ClockRebaser, CyclesToMicros(NowCycles), LeapNow);
+	}
+
+	// Stages of earlier frames that other threads have stamped since the last tick
+	for (FRenderSlot& Slot : RenderSlots)
+	{
+		const uint64 RenderCycles = Slot.RenderCycles.exchange(0, std::memory_order_acquire);
+		if (RenderCycles != 0)
+		{
+			Histograms[LEAP_LATENCY_RENDER_SUBMIT].AddSample(CyclesToLeapTime(RenderCycles) - Slot.DeviceTimestamp);
+		}
+	}
+	if (LastConsumedCycles != 0 && AnimEvaluationCycles > LastConsumedCycles && AnimEvaluationCycles != LastAnimEvaluationCycles)
+	{
+		Histograms[LEAP_LATENCY_ANIM_EVALUATION].AddSample(CyclesToLeapTime(AnimEvaluationCycles) - LastDeviceTimestamp);
+	}
+	LastAnimEvaluationCycles = AnimEvaluationCycles;
+
+	// This frame, arrival is only sampled once per device frame as the game can tick faster than the device
+	const int64 DeviceTimestamp = Frame.info.timestamp;
+	if (Frame.tracking_frame_id != LastSampledFrameId)
+	{
+		const int64 ArrivalTime = Wrapper.GetFrameArrivalTime(Frame.tracking_frame_id);
+		if (ArrivalTime != 0)
+		{
+			Histograms[LEAP_LATENCY_SERVICE_THREAD].AddSample(ArrivalTime - DeviceTimestamp);
+		}
+		LastSampledFrameId = Frame.tracking_frame_id;
+	}
+	Histograms[LEAP_LATENCY_GAME_THREAD].AddSample(LeapNow - DeviceTimestamp);
+
+	// The render thread stamps this slot once it has submitted this game frame
+	const uint32 FrameNumber = GFrameNumber;
+	FRenderSlot& Slot = RenderSlots[FrameNumber % RenderSlotCount];
+	Slot.RenderCycles.store(0, std::memory_order_relaxed);
+	Slot.DeviceTimestamp = DeviceTimestamp;
+	Slot.FrameNumber.store(FrameNumber, std::memory_order_release);
+
+	LastDeviceTimestamp = DeviceTimestamp;
+	LastConsumedCycles = NowCycles;
+
+	UpdateStats();
+}
+
+FLeapLatencyPercentiles FLeapLatencyTracker::GetPercentiles(ELeapLatencyStage Stage) const
+{
+	if (Stage < 0 || Stage > LEAP_LATENCY_RENDER_SUBMIT)
+	{
+		return FLeapLatencyPercentiles();
+	}
+	return Histograms[Stage].GetPercentiles();
+}
+
+void FLeapLatencyTracker::Reset()
+{
+	for (FLeapLatencyHistogram& Histogram : Histograms)
+	{
+		Histogram.Reset();
+	}
+	for (FRenderSlot& Slot : RenderSlots)
+	{
+		Slot.RenderCycles.store(0, std::memory_order_relaxed);
+	}
+
+	// A new tracking source can come with a new clock
+	if (ClockRebaser)
+	{
+		LeapDestroyClockRebaser(ClockRebaser);
+		ClockRebaser = nullptr;
+	}
+	LeapCreateClockRebaser(&ClockRebaser);
+
+	LastSampledFrameId = -1;
+	LastDeviceTimestamp = 0;
+	LastConsumedCycles = 0;
+	LastAnimEvaluationCycles = 0;
+}
+
+void FLeapLatencyTracker::OnEndFrameRenderThread()
+{
+	const uint32 FrameNumber = GFrameNumberRenderThread;
+	FRenderSlot& Slot = RenderSlots[FrameNumber % RenderSlotCount];
+	if (Slot.FrameNumber.load(std::memory_order_acquire) == FrameNumber)
+	{
+		Slot.RenderCycles.store(FPlatformTime::Cycles64(), std::memory_order_release);
+	}
+}
+
+int64 FLeapLatencyTracker::CyclesToLeapTime(uint64 Cycles) const
+{
+	int64_t LeapTime = 0;
+	if (ClockRebaser)
+	{
+		LeapRebaseClock(ClockRebaser, CyclesToMicros(Cycles), &LeapTime);
+	}
+	return LeapTime;
+}
+
+void FLeapLatencyTracker::UpdateStats()
+{
+#if STATS
+	if (!FThreadStats::IsCollectingData())
+	{
+		return;
+	}
+	SET_FLOAT_STAT(STAT_LeapLatencyServiceP50, Histograms[LEAP_LATENCY_SERVICE_THREAD].GetPercentileMS(0.5f));
+	SET_FLOAT_STAT(STAT_LeapLatencyServiceP99, Histograms[LEAP_LATENCY_SERVICE_THREAD].GetPercentileMS(0.99f));
+	SET_FLOAT_STAT(STAT_LeapLatencyGameThreadP50, Histograms[LEAP_LATENCY_GAME_THREAD].GetPercentileMS(0.5f));
+	SET_FLOAT_STAT(STAT_LeapLatencyGameThreadP99, Histograms[LEAP_LATENCY_GAME_THREAD].GetPercentileMS(0.99f));
+	SET_FLOAT_STAT(STAT_LeapLatencyAnimP50, Histograms[LEAP_LATENCY_ANIM_EVALUATION].GetPercentileMS(0.5f));
+	SET_FLOAT_STAT(STAT_LeapLatencyAnimP99, Histograms[LEAP_LATENCY_ANIM_EVALUATION].GetPercentileMS(0.99f));
+	SET_FLOAT_STAT(STAT_LeapLatencyRenderP50, Histograms[LEAP_LATENCY_RENDER_SUBMIT].GetPercentileMS(0.5f));
+	SET_FLOAT_STAT(STAT_LeapLatencyRenderP99, Histograms[LEAP_LATENCY_RENDER_SUBMIT].GetPercentileMS(0.99f));
+#endif
+}
+
+// FLeapTelemetryScope
+
+FLeapTelemetryScope::FLeapTelemetryScope(
+	IHandTrackingWrapper* InWrapper, const char* InZoneName, const char* InFileName, uint32 InLineNumber)
+	: Wrapper(nullptr)
+{
+	if (InWrapper == nullptr || CVarLeapLatencyTelemetry.GetValueOnAnyThread() == 0)
+	{
+		return;
+	}
+	Wrapper = InWrapper;
+	Data.thread_id = FPlatformTLS::GetCurrentThreadId();
+	Data.start_time = LeapTelemetryGetNow();
+	Data.end_time = 0;
+	Data.zone_depth = 0;
+	Data.file_name = InFileName;
+	Data.line_number = InLineNumber;
+	Data.zone_name = InZoneName;
+}
+
+FLeapTelemetryScope::~FLeapTelemetryScope()
+{
+	if (Wrapper)
+	{
+		Data.end_time = LeapTelemetryGetNow();
+		Wrapper->ProfileTelemetry(Data);
+	}
+}
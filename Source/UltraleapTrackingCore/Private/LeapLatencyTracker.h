@@ -0,0 +1,116 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeapC.h"
+#include "UltraleapTrackingData.h"
+
+#include <atomic>
+
+class IHandTrackingWrapper;
+
+/**
+ * Rolling histogram over the last WindowSize samples, in microseconds.
+ *
+ * Buckets are BucketWidth wide, anything above the last bucket is counted in it. Percentiles are read from the
+ * buckets and report the upper edge of the bucket, so they never under state a budget.
+ */
+class FLeapLatencyHistogram
+{
+public:
+	static constexpr int32 WindowSize = 1024;
+	static constexpr int32 BucketWidth = 100;
+	static constexpr int32 BucketCount = 1000;
+
+	FLeapLatencyHistogram();
+
+	void AddSample(int64 Microseconds);
+	void Reset();
+
+	int32 Num() const
+	{
+		return NumSamples;
+	}
+
+	/** Percentile in [0, 1] in milliseconds, 0 without samples */
+	float GetPercentileMS(float Percentile) const;
+
+	FLeapLatencyPercentiles GetPercentiles() const;
+
+private:
+	int32 Buckets[BucketCount];
+	int32 Window[WindowSize];
+	int32 NextSample;
+	int32 NumSamples;
+	int64 Sum;
+};
+
+/**
+ * Measures how old the hand data is at each pipeline stage, see ELeapLatencyStage.
+ *
+ * Everything is relative to the device timestamp of the frame the game thread consumed. The service thread and
+ * game thread stages are read on the Leap clock directly. Anim evaluation and render submission happen on other
+ * threads, so they record FPlatformTime::Cycles64() and are mapped to the Leap clock with a LeapC clock rebaser
+ * on the next game thread tick.
+ *
+ * Enabled with leap.Latency.Enable, leap.Latency.Telemetry also forwards the input tick to the service telemetry.
+ */
+class FLeapLatencyTracker
+{
+public:
+	FLeapLatencyTracker();
+	~FLeapLatencyTracker();
+
+	static bool IsEnabled();
+
+	/** Game thread, once per input tick with the frame the tick consumed and the latest anim evaluation cycles */
+	void OnFrameConsumed(IHandTrackingWrapper& Wrapper, const LEAP_TRACKING_EVENT& Frame, uint64 AnimEvaluationCycles);
+
+	FLeapLatencyPercentiles GetPercentiles(ELeapLatencyStage Stage) const;
+	void Reset();
+
+private:
+	static constexpr int32 RenderSlotCount = 8;
+
+	/** One per in flight game frame, the render thread stamps the slot of the frame it finished */
+	struct FRenderSlot
+	{
+		std::atomic<uint32> FrameNumber{0};
+		std::atomic<uint64> RenderCycles{0};
+		int64 DeviceTimestamp = 0;
+	};
+
+	void OnEndFrameRenderThread();
+	int64 CyclesToLeapTime(uint64 Cycles) const;
+	void UpdateStats();
+
+	FLeapLatencyHistogram Histograms[LEAP_LATENCY_RENDER_SUBMIT + 1];
+
+	LEAP_CLOCK_REBASER ClockRebaser;
+	FRenderSlot RenderSlots[RenderSlotCount];
+	FDelegateHandle EndFrameHandle;
+
+	int64 LastSampledFrameId;
+	int64 LastDeviceTimestamp;
+	uint64 LastConsumedCycles;
+	uint64 LastAnimEvaluationCycles;
+};
+
+/** Reports the enclosing scope as a zone to the tracking service telemetry when leap.Latency.Telemetry is set */
+class FLeapTelemetryScope
+{
+public:
+	FLeapTelemetryScope(IHandTrackingWrapper* InWrapper, const char* InZoneName, const char* InFileName, uint32 InLineNumber);
+	~FLeapTelemetryScope();
+
+private:
+	IHandTrackingWrapper* Wrapper;
+	LEAP_TELEMETRY_DATA Data;
+};
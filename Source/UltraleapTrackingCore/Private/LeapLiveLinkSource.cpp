@@ -0,0 +1,300 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapLiveLinkSource.h"
+
+#include "Features/IModularFeatures.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/RunnableThread.h"
+#include "ILiveLinkClient.h"
+#include "LeapStats.h"
+#include "LeapUtility.h"
+#include "Misc/App.h"
+#include "Roles/LiveLinkAnimationRole.h"
+#include "Roles/LiveLinkAnimationTypes.h"
+
+#define LOCTEXT_NAMESPACE "LeapLiveLinkSource"
+
+static TAutoConsoleVariable<int32> CVarLeapLiveLinkSource(TEXT("leap.LiveLink.Source"), 0,
+	TEXT("Add a runtime LiveLink source with one subject per hand, read when the device starts"));
+
+static TAutoConsoleVariable<float> CVarLeapLiveLinkPushRate(TEXT("leap.LiveLink.PushRate"), 60.f,
+	TEXT("Rate in Hz the runtime LiveLink source pushes changed hands at, independent of the game tick"));
+
+// Transforms closer than this are treated as unchanged and not pushed again
+static const float LiveLinkChangeTolerance = 1.e-4f;
+
+bool FLeapLiveLinkSource::IsEnabled()
+{
+	return CVarLeapLiveLinkSource.GetValueOnAnyThread() != 0;
+}
+
+FLeapLiveLinkSource::FLeapLiveLinkSource(UBodyStateSkeleton* Skeleton)
+{
+	InitSubject(Subjects[0], TEXT("Ultraleap Left Hand"), Skeleton, EBodyStateBasicBoneType::BONE_LOWERARM_L,
+		EBodyStateBasicBoneType::BONE_THUMB_2_DISTAL_L);
+	InitSubject(Subjects[1], TEXT("Ultraleap Right Hand"), Skeleton, EBodyStateBasicBoneType::BONE_LOWERARM_R,
+		EBodyStateBasicBoneType::BONE_THUMB_2_DISTAL_R);
+
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+}
+
+FLeapLiveLinkSource::~FLeapLiveLinkSource()
+{
+	StopThread();
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+}
+
+void FLeapLiveLinkSource::InitSubject(FSubject& Subject, const FName& Name, UBodyStateSkeleton* Skeleton,
+	EBodyStateBasicBoneType First, EBodyStateBasicBoneType Last)
+{
+	Subject.Name = Name;
+	for (int32 Type = (int32) First; Type <= (int32) Last; Type++)
+	{
+		Subject.BoneTypes.Add((EBodyStateBasicBoneType) Type);
+	}
+
+	const int32 NumBones = Subject.BoneTypes.Num();
+	Subject.BoneNames.Reserve(NumBones);
+	Subject.BoneParents.Reserve(NumBones);
+	for (const EBodyStateBasicBoneType Type : Subject.BoneTypes)
+	{
+		const UBodyStateBone* Bone = Skeleton ? Skeleton->BoneForEnum(Type) : nullptr;
+		Subject.BoneNames.Add(Bone ? FName(*Bone->Name) : NAME_None);
+
+		// The lower arm parent isn't part of the hand, it becomes the subject root
+		Subject.BoneParents.Add(
+			Bone && Bone->Parent ? Subject.BoneTypes.IndexOfByKey(Bone->Parent->BoneType) : INDEX_NONE);
+	}
+
+	Subject.LastTransforms.SetNum(NumBones);
+	Subject.StagedTransforms.SetNum(NumBones);
+}
+
+void FLeapLiveLinkSource::AddToClient()
+{
+	IModularFeatures& ModularFeatures = IModularFeatures::Get();
+	if (ModularFeatures.IsModularFeatureAvailable(ILiveLinkClient::ModularFeatureName))
+	{
+		ModularFeatures.GetModularFeature<ILiveLinkClient>(ILiveLinkClient::ModularFeatureName).AddSource(AsShared());
+	}
+	else if (!ModularFeatureHandle.IsValid())
+	{
+		// LiveLink may load after the plugin, add the source once its client is there
+		ModularFeatureHandle =
+			ModularFeatures.OnModularFeatureRegistered().AddRaw(this, &FLeapLiveLinkSource::OnModularFeatureRegistered);
+	}
+}
+
+void FLeapLiveLinkSource::RemoveFromClient()
+{
+	if (ModularFeatureHandle.IsValid())
+	{
+		IModularFeatures::Get().OnModularFeatureRegistered().Remove(ModularFeatureHandle);
+		ModularFeatureHandle.Reset();
+	}
+
+	IModularFeatures& ModularFeatures = IModularFeatures::Get();
+	if (bHasClient && ModularFeatures.IsModularFeatureAvailable(ILiveLinkClient::ModularFeatureName))
+	{
+		ModularFeatures.GetModularFeature<ILiveLinkClient>(ILiveLinkClient::ModularFeatureName).RemoveSource(AsShared());
+	}
+	StopThread();
+}
+
+void FLeapLiveLinkSource::OnModularFeatureRegistered(const FName& Type, IModularFeature* Feature)
+{
+	if (Type == ILiveLinkClient::ModularFeatureName)
+	{
+		IModularFeatures::Get().OnModularFeatureRegistered().Remove(ModularFeatureHandle);
+		ModularFeatureHandle.Reset();
+		static_cast<ILiveLinkClient*>(Feature)->AddSource(AsShared());
+	}
+}
+
+void FLeapLiveLinkSource::UpdateFromBodyState(UBodyStateSkeleton* Skeleton)
+{
+	if (!bHasClient)
+	{
+		return;
+	}
+
+	LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapLiveLinkUpdate);
+
+	const double WorldTime = FPlatformTime::Seconds();
+	const TOptional<FQualifiedFrameTime> SceneTime = FApp::GetCurrentFrameTime();
+
+	for (FSubject& Subject : Subjects)
+	{
+		// Nothing new to send while the hand is lost, the client keeps the last frame
+		UBodyStateBone* Root = Skeleton->BoneForEnum(Subject.BoneTypes[0]);
+		if (!Root || !Root->IsTracked())
+		{
+			continue;
+		}
+
+		bool bChanged = false;
+		for (int32 Index = 0; Index < Subject.BoneTypes.Num(); Index++)
+		{
+			UBodyStateBone* Bone = Skeleton->BoneForEnum(Subject.BoneTypes[Index]);
+			FTransform BoneTransform = Bone->Transform();
+
+			// The live link node outputs in local space, so convert from component space here
+			const int32 ParentIndex = Subject.BoneParents[Index];
+			if (ParentIndex != INDEX_NONE)
+			{
+				BoneTransform.SetToRelativeTransform(Skeleton->BoneForEnum(Subject.BoneTypes[ParentIndex])->Transform());
+				BoneTransform.NormalizeRotation();
+			}
+
+			if (!BoneTransform.Equals(Subject.LastTransforms[Index], LiveLinkChangeTolerance))
+			{
+				Subject.LastTransforms[Index] = BoneTransform;
+				bChanged = true;
+			}
+		}
+
+		if (bChanged)
+		{
+			FScopeLock Lock(&StagingLock);
+			FMemory::Memcpy(Subject.StagedTransforms.GetData(), Subject.LastTransforms.GetData(),
+				Subject.LastTransforms.Num() * sizeof(FTransform));
+			Subject.WorldTime = WorldTime;
+			Subject.SceneTime = SceneTime;
+			Subject.Sequence++;
+		}
+	}
+}
+
+void FLeapLiveLinkSource::ReceiveClient(ILiveLinkClient* InClient, FGuid InSourceGuid)
+{
+	Client = InClient;
+	SourceGuid = InSourceGuid;
+
+	for (const FSubject& Subject : Subjects)
+	{
+		PushStaticData(Subject);
+	}
+
+	bStopping = false;
+	bHasClient = true;
+	if (!Thread)
+	{
+		PushTransforms.Reserve(Subjects[0].StagedTransforms.Num());
+		Thread = FRunnableThread::Create(this, TEXT("UltraleapLiveLinkPush"), 0, TPri_AboveNormal);
+	}
+}
+
+bool FLeapLiveLinkSource::IsSourceStillValid() const
+{
+	return bHasClient;
+}
+
+bool FLeapLiveLinkSource::RequestSourceShutdown()
+{
+	StopThread();
+	Client = nullptr;
+	return true;
+}
+
+FText FLeapLiveLinkSource::GetSourceType() const
+{
+	return LOCTEXT("SourceType", "Ultraleap Tracking");
+}
+
+FText FLeapLiveLinkSource::GetSourceMachineName() const
+{
+	return FText::FromString(FPlatformProcess::ComputerName());
+}
+
+FText FLeapLiveLinkSource::GetSourceStatus() const
+{
+	return bHasClient ? FText::Format(LOCTEXT("SourceStatusActive", "Active, {0} Hz"),
+							FText::AsNumber(CVarLeapLiveLinkPushRate.GetValueOnAnyThread()))
+					  : LOCTEXT("SourceStatusStopped", "Stopped");
+}
+
+void FLeapLiveLinkSource::PushStaticData(const FSubject& Subject)
+{
+	FLiveLinkStaticDataStruct StaticData(FLiveLinkSkeletonStaticData::StaticStruct());
+	FLiveLinkSkeletonStaticData& SkeletonData = *StaticData.Cast<FLiveLinkSkeletonStaticData>();
+	SkeletonData.SetBoneNames(Subject.BoneNames);
+	SkeletonData.SetBoneParents(Subject.BoneParents);
+
+	Client->PushSubjectStaticData_AnyThread(
+		FLiveLinkSubjectKey(SourceGuid, Subject.Name), ULiveLinkAnimationRole::StaticClass(), MoveTemp(StaticData));
+}
+
+uint32 FLeapLiveLinkSource::Run()
+{
+	while (!bStopping)
+	{
+		const double Start = FPlatformTime::Seconds();
+		PushChangedSubjects();
+
+		const double Interval = 1.0 / FMath::Max(CVarLeapLiveLinkPushRate.GetValueOnAnyThread(), 1.f);
+		const double Remaining = Interval - (FPlatformTime::Seconds() - Start);
+		if (Remaining > 0.0)
+		{
+			WakeEvent->Wait(FTimespan::FromSeconds(Remaining));
+		}
+	}
+	return 0;
+}
+
+void FLeapLiveLinkSource::Stop()
+{
+	bStopping = true;
+	WakeEvent->Trigger();
+}
+
+void FLeapLiveLinkSource::PushChangedSubjects()
+{
+	for (FSubject& Subject : Subjects)
+	{
+		double WorldTime;
+		TOptional<FQualifiedFrameTime> SceneTime;
+		{
+			FScopeLock Lock(&StagingLock);
+			if (Subject.Sequence == Subject.PushedSequence)
+			{
+				continue;
+			}
+			Subject.PushedSequence = Subject.Sequence;
+			PushTransforms = Subject.StagedTransforms;
+			WorldTime = Subject.WorldTime;
+			SceneTime = Subject.SceneTime;
+		}
+
+		// The client takes ownership of pushed frames, so this is the one allocation per pushed subject
+		FLiveLinkFrameDataStruct FrameData(FLiveLinkAnimationFrameData::StaticStruct());
+		FLiveLinkAnimationFrameData& AnimationData = *FrameData.Cast<FLiveLinkAnimationFrameData>();
+		AnimationData.Transforms = PushTransforms;
+		AnimationData.WorldTime = FLiveLinkWorldTime(WorldTime);
+		if (SceneTime.IsSet())
+		{
+			AnimationData.MetaData.SceneTime = SceneTime.GetValue();
+		}
+
+		Client->PushSubjectFrameData_AnyThread(FLiveLinkSubjectKey(SourceGuid, Subject.Name), MoveTemp(FrameData));
+	}
+}
+
+void FLeapLiveLinkSource::StopThread()
+{
+	bHasClient = false;
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,106 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "ILiveLinkSource.h"
+#include "LiveLinkTypes.h"
+#include "Misc/QualifiedFrameTime.h"
+#include "Skeleton/BodyStateSkeleton.h"
+
+#include <atomic>
+
+class ILiveLinkClient;
+class IModularFeature;
+
+/**
+ * LiveLink source for packaged builds, pushes one subject per hand into the local LiveLink client.
+ *
+ * The game thread stages the local space bone transforms into buffers allocated once at construction and only marks
+ * a subject dirty when a transform changed. A push thread sends the dirty subjects at leap.LiveLink.PushRate,
+ * independent of the game tick. Off unless leap.LiveLink.Source is set, the editor message bus producer is unaffected.
+ */
+class FLeapLiveLinkSource : public ILiveLinkSource, public FRunnable, public TSharedFromThis<FLeapLiveLinkSource>
+{
+public:
+	FLeapLiveLinkSource(UBodyStateSkeleton* Skeleton);
+	virtual ~FLeapLiveLinkSource();
+
+	/** Whether a runtime source should be created on device startup, and while it runs whether it keeps tracking awake */
+	static bool IsEnabled();
+
+	/** Add to the LiveLink client now or once the LiveLink plugin registers it */
+	void AddToClient();
+	void RemoveFromClient();
+
+	/** True once the client accepted the source, until it asks for shutdown */
+	bool HasClient() const
+	{
+		return bHasClient;
+	}
+
+	/** Game thread, copy the hands into the staging buffers. Doesn't allocate */
+	void UpdateFromBodyState(UBodyStateSkeleton* Skeleton);
+
+	// ILiveLinkSource
+	virtual void ReceiveClient(ILiveLinkClient* InClient, FGuid InSourceGuid) override;
+	virtual bool IsSourceStillValid() const override;
+	virtual bool RequestSourceShutdown() override;
+	virtual FText GetSourceType() const override;
+	virtual FText GetSourceMachineName() const override;
+	virtual FText GetSourceStatus() const override;
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	struct FSubject
+	{
+		FName Name;
+		TArray<EBodyStateBasicBoneType> BoneTypes;
+		TArray<FName> BoneNames;
+		TArray<int32> BoneParents;
+
+		// Game thread only, last staged transforms used to detect a change
+		TArray<FTransform> LastTransforms;
+
+		// Guarded by StagingLock
+		TArray<FTransform> StagedTransforms;
+		double WorldTime = 0.0;
+		TOptional<FQualifiedFrameTime> SceneTime;
+		uint32 Sequence = 0;
+
+		// Push thread only
+		uint32 PushedSequence = 0;
+	};
+
+	void InitSubject(FSubject& Subject, const FName& Name, UBodyStateSkeleton* Skeleton, EBodyStateBasicBoneType First,
+		EBodyStateBasicBoneType Last);
+	void PushStaticData(const FSubject& Subject);
+	void PushChangedSubjects();
+	void StopThread();
+	void OnModularFeatureRegistered(const FName& Type, IModularFeature* Feature);
+
+	FSubject Subjects[2];
+
+	// Push thread scratch, reused for every frame
+	TArray<FTransform> PushTransforms;
+
+	FCriticalSection StagingLock;
+	ILiveLinkClient* Client = nullptr;
+	FGuid SourceGuid;
+	FDelegateHandle ModularFeatureHandle;
+
+	FRunnableThread* Thread = nullptr;
+	FEvent* WakeEvent = nullptr;
+	std::atomic<bool> bStopping{false};
+	std::atomic<bool> bHasClient{false};
+};
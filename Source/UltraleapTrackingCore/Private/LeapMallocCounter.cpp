@@ -0,0 +1,123 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapMallocCounter.h"
+
+// No thread has this id, see FPlatformTLS
+#define LEAP_NO_COUNTING_THREAD 0xffffffff
+
+FLeapMallocCounter::FLeapMallocCounter(FMalloc* InInner) : Inner(InInner), CountingThreadId(LEAP_NO_COUNTING_THREAD)
+{
+}
+
+FLeapMallocCounter& FLeapMallocCounter::Install()
+{
+	static FLeapMallocCounter* Counter = nullptr;
+	if (Counter == nullptr)
+	{
+		check(IsInGameThread());
+		Counter = new FLeapMallocCounter(GMalloc);
+		GMalloc = Counter;
+	}
+	return *Counter;
+}
+
+void FLeapMallocCounter::StartCounting()
+{
+	Counts = FCounts();
+	CountingThreadId = FPlatformTLS::GetCurrentThreadId();
+}
+
+void FLeapMallocCounter::StopCounting()
+{
+	CountingThreadId = LEAP_NO_COUNTING_THREAD;
+}
+
+void FLeapMallocCounter::ResumeCounting()
+{
+	CountingThreadId = FPlatformTLS::GetCurrentThreadId();
+}
+
+void* FLeapMallocCounter::Malloc(SIZE_T Count, uint32 Alignment)
+{
+	this->Count(Count);
+	return Inner->Malloc(Count, Alignment);
+}
+
+void* FLeapMallocCounter::Realloc(void* Original, SIZE_T Count, uint32 Alignment)
+{
+	this->Count(Count);
+	return Inner->Realloc(Original, Count, Alignment);
+}
+
+void FLeapMallocCounter::Free(void* Original)
+{
+	Inner->Free(Original);
+}
+
+SIZE_T FLeapMallocCounter::QuantizeSize(SIZE_T Count, uint32 Alignment)
+{
+	return Inner->QuantizeSize(Count, Alignment);
+}
+
+bool FLeapMallocCounter::GetAllocationSize(void* Original, SIZE_T& SizeOut)
+{
+	return Inner->GetAllocationSize(Original, SizeOut);
+}
+
+void FLeapMallocCounter::Trim(bool bTrimThreadCaches)
+{
+	Inner->Trim(bTrimThreadCaches);
+}
+
+void FLeapMallocCounter::SetupTLSCachesOnCurrentThread()
+{
+	Inner->SetupTLSCachesOnCurrentThread();
+}
+
+void FLeapMallocCounter::ClearAndDisableTLSCachesOnCurrentThread()
+{
+	Inner->ClearAndDisableTLSCachesOnCurrentThread();
+}
+
+void FLeapMallocCounter::InitializeStatsMetadata()
+{
+	Inner->InitializeStatsMetadata();
+}
+
+void FLeapMallocCounter::UpdateStats()
+{
+	Inner->UpdateStats();
+}
+
+void FLeapMallocCounter::GetAllocatorStats(FGenericMemoryStats& OutStats)
+{
+	Inner->GetAllocatorStats(OutStats);
+}
+
+void FLeapMallocCounter::DumpAllocatorStats(FOutputDevice& Ar)
+{
+	Inner->DumpAllocatorStats(Ar);
+}
+
+bool FLeapMallocCounter::IsInternallyThreadSafe() const
+{
+	return Inner->IsInternallyThreadSafe();
+}
+
+bool FLeapMallocCounter::ValidateHeap()
+{
+	return Inner->ValidateHeap();
+}
+
+const TCHAR* FLeapMallocCounter::GetDescriptiveName()
+{
+	return Inner->GetDescriptiveName();
+}
+
+#undef LEAP_NO_COUNTING_THREAD
@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/MemoryBase.h"
+
+/**
+ * GMalloc proxy counting the allocations made by one thread.
+ *
+ * Install() wraps the current GMalloc. The proxy keeps no per allocation state, so it is safe to stop
+ * counting at any point; it is never uninstalled because other threads may still be inside it.
+ */
+class FLeapMallocCounter : public FMalloc
+{
+public:
+	struct FCounts
+	{
+		uint64 Allocations = 0;
+		uint64 Bytes = 0;
+	};
+
+	/** Wrap GMalloc once, later calls return the same counter */
+	static FLeapMallocCounter& Install();
+
+	/** Count allocations made from the calling thread from now on */
+	void StartCounting();
+	void StopCounting();
+
+	/** Continue counting on the calling thread after StopCounting(), keeping the counts so far */
+	void ResumeCounting();
+
+	FCounts GetCounts() const
+	{
+		return Counts;
+	}
+
+	// FMalloc
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override;
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override;
+	virtual void Free(void* Original) override;
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override;
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override;
+	virtual void Trim(bool bTrimThreadCaches) override;
+	virtual void SetupTLSCachesOnCurrentThread() override;
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override;
+	virtual void InitializeStatsMetadata() override;
+	virtual void UpdateStats() override;
+	virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override;
+	virtual void DumpAllocatorStats(class FOutputDevice& Ar) override;
+	virtual bool IsInternallyThreadSafe() const override;
+	virtual bool ValidateHeap() override;
+	virtual const TCHAR* GetDescriptiveName() override;
+
+private:
+	explicit FLeapMallocCounter(FMalloc* InInner);
+
+	void Count(const SIZE_T Size)
+	{
+		if (FPlatformTLS::GetCurrentThreadId() == CountingThreadId)
+		{
+			Counts.Allocations++;
+			Counts.Bytes += Size;
+		}
+	}
+
+	FMalloc* Inner;
+
+	/** Only ever written from the counting thread */
+	FCounts Counts;
+	volatile uint32 CountingThreadId;
+};
@@ -0,0 +1,977 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapMotionArchive.h"
+
+#include "Algo/BinarySearch.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/RunnableThread.h"
+#include "LeapStats.h"
+#include "LeapUtility.h"
+#include "Misc/Paths.h"
+
+static TAutoConsoleVariable<FString> CVarLeapArchivePath(TEXT("leap.Archive.Path"), TEXT(""),
+	TEXT("Record every processed frame to this motion archive, relative to the project Saved directory. Empty to not "
+		 "record, read when the device starts"));
+
+namespace
+{
+const uint32 ArchiveMagic = 0x414D4C55;
+const uint16 ArchiveVersion = 1;
+
+const int32 ArchiveHeaderSize = 4 + 2 + 2 + 3 * 4;
+const int32 BlockHeaderSize = 4 + 8 + 8 + 2 + 2;
+const int32 IndexEntrySize = 8 + 4 + 4 + 8 + 8;
+const int32 ArchiveFooterSize = 8 + 4 + 4;
+
+const float RotationStep = 1.f / 16384.f;
+const float StrengthStep = 1.f / 1024.f;
+
+// Bounds the worst case column well inside its uint16 size
+const int32 MinFramesPerBlock = 16;
+const int32 MaxFramesPerBlock = 1024;
+
+// Palm position, palm orientation, a position per joint, pinch and grab
+const int32 ComponentsPerHand = 3 + 4 + FLeapJointCache::NumDigits * FLeapJointCache::NumJoints * 3 + 2;
+const int32 TimeColumn = 0;
+const int32 HandMaskColumn = 1;
+const int32 NumColumns = 2 + LeapMotionArchive::NumHands * ComponentsPerHand;
+
+// Unary quotients this long are followed by the raw value instead, which keeps outliers like a hand appearing cheap
+const uint32 EscapeQuotient = 24;
+const int32 MaxRiceParameter = 30;
+const int32 MaxPredictorOrder = 2;
+
+struct FSteps
+{
+	float Position;
+	float Rotation;
+	float Strength;
+};
+
+template <typename T>
+void Put(uint8*& Cursor, const T Value)
+{
+	FMemory::Memcpy(Cursor, &Value, sizeof(T));
+	Cursor += sizeof(T);
+}
+
+template <typename T>
+T Get(const uint8*& Cursor)
+{
+	T Value;
+	FMemory::Memcpy(&Value, Cursor, sizeof(T));
+	Cursor += sizeof(T);
+	return Value;
+}
+
+uint64 ZigZag(const int64 Value)
+{
+	return (uint64(Value) << 1) ^ uint64(Value >> 63);
+}
+
+int64 UnZigZag(const uint64 Value)
+{
+	return int64(Value >> 1) ^ -int64(Value & 1);
+}
+
+int32 NumComponents(const int32 Channel)
+{
+	return Channel == LeapMotionArchive::PalmOrientationChannel ? 4 : Channel == LeapMotionArchive::StrengthChannel ? 2 : 3;
+}
+
+int32 FirstComponent(const int32 Channel)
+{
+	if (Channel == LeapMotionArchive::PalmPositionChannel)
+	{
+		return 0;
+	}
+	if (Channel == LeapMotionArchive::PalmOrientationChannel)
+	{
+		return 3;
+	}
+	return 7 + (Channel - LeapMotionArchive::FirstJointChannel) * 3;
+}
+
+int32 ColumnIndex(const int32 HandIndex, const int32 Channel, const int32 Component)
+{
+	return 2 + HandIndex * ComponentsPerHand + FirstComponent(Channel) + Component;
+}
+
+int64 Quantize(const FLeapMotionArchiveFrame::FHand& Hand, const int32 Channel, const int32 Component, const FSteps& Steps)
+{
+	if (Channel == LeapMotionArchive::PalmPositionChannel)
+	{
+		return FMath::RoundToInt(float(Hand.PalmPosition[Component] / Steps.Position));
+	}
+	if (Channel == LeapMotionArchive::PalmOrientationChannel)
+	{
+		// q and -q are the same rotation, a positive W keeps consecutive values close
+		const FQuat& Q = Hand.PalmOrientation;
+		const float Sign = Q.W < 0.f ? -1.f : 1.f;
+		const float Values[4] = {float(Q.X), float(Q.Y), float(Q.Z), float(Q.W)};
+		return FMath::RoundToInt(Sign * Values[Component] / Steps.Rotation);
+	}
+	if (Channel == LeapMotionArchive::StrengthChannel)
+	{
+		return FMath::RoundToInt((Component == 0 ? Hand.PinchStrength : Hand.GrabStrength) / Steps.Strength);
+	}
+	const int32 Joint = Channel - LeapMotionArchive::FirstJointChannel;
+	const FVector& Position = Hand.JointPositions[Joint / FLeapJointCache::NumJoints][Joint % FLeapJointCache::NumJoints];
+	return FMath::RoundToInt(float(Position[Component] / Steps.Position));
+}
+
+void Dequantize(
+	FLeapMotionArchiveFrame::FHand& Hand, const int32 Channel, const int32 Component, const int64 Value, const FSteps& Steps)
+{
+	if (Channel == LeapMotionArchive::PalmPositionChannel)
+	{
+		Hand.PalmPosition[Component] = Value * Steps.Position;
+	}
+	else if (Channel == LeapMotionArchive::PalmOrientationChannel)
+	{
+		const float Dequantized = Value * Steps.Rotation;
+		switch (Component)
+		{
+			case 0:
+				Hand.PalmOrientation.X = Dequantized;
+				break;
+			case 1:
+				Hand.PalmOrientation.Y = Dequantized;
+				break;
+			case 2:
+				Hand.PalmOrientation.Z = Dequantized;
+				break;
+			default:
+				Hand.PalmOrientation.W = Dequantized;
+				break;
+		}
+	}
+	else if (Channel == LeapMotionArchive::StrengthChannel)
+	{
+		(Component == 0 ? Hand.PinchStrength : Hand.GrabStrength) = Value * Steps.Strength;
+	}
+	else
+	{
+		const int32 Joint = Channel - LeapMotionArchive::FirstJointChannel;
+		Hand.JointPositions[Joint / FLeapJointCache::NumJoints][Joint % FLeapJointCache::NumJoints][Component] =
+			Value * Steps.Position;
+	}
+}
+
+/**
+ * Value predicted from the previous Order values, the second value only has one before it. Wraps rather than
+ * overflows, the residual still round trips
+ */
+uint64 Predict(const int64* Values, const int32 Index, const int32 Order)
+{
+	if (Order == 1 || Index == 1)
+	{
+		return uint64(Values[Index - 1]);
+	}
+	return 2 * uint64(Values[Index - 1]) - uint64(Values[Index - 2]);
+}
+
+int64 Residual(const int64* Values, const int32 Index, const int32 Order)
+{
+	return int64(uint64(Values[Index]) - Predict(Values, Index, Order));
+}
+
+uint64 RiceBits(const uint64 Value, const int32 K)
+{
+	const uint64 Quotient = Value >> K;
+	return Quotient < EscapeQuotient ? Quotient + 1 + K : EscapeQuotient + 64;
+}
+
+void PutVarint(uint64 Value, TArray<uint8>& Out)
+{
+	while (Value >= 0x80)
+	{
+		Out.Add(uint8(Value) | 0x80);
+		Value >>= 7;
+	}
+	Out.Add(uint8(Value));
+}
+
+bool GetVarint(const uint8* Data, const int32 Size, int32& InOutPos, uint64& OutValue)
+{
+	OutValue = 0;
+	for (int32 Shift = 0; Shift < 64 && InOutPos < Size; Shift += 7)
+	{
+		const uint8 Byte = Data[InOutPos++];
+		OutValue |= uint64(Byte & 0x7F) << Shift;
+		if ((Byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/** Least significant bit first */
+class FRiceEncoder
+{
+public:
+	FRiceEncoder(TArray<uint8>& InOut) : Out(InOut), Bits(0), NumBits(0)
+	{
+	}
+
+	/** Count is at most 32 */
+	void Write(const uint64 Value, const int32 Count)
+	{
+		Bits |= Value << NumBits;
+		NumBits += Count;
+		while (NumBits >= 8)
+		{
+			Out.Add(uint8(Bits));
+			Bits >>= 8;
+			NumBits -= 8;
+		}
+	}
+
+	void WriteOnes(uint32 Count)
+	{
+		for (; Count >= 32; Count -= 32)
+		{
+			Write(0xFFFFFFFF, 32);
+		}
+		if (Count > 0)
+		{
+			Write((uint64(1) << Count) - 1, Count);
+		}
+	}
+
+	void WriteRice(const uint64 Value, const int32 K)
+	{
+		const uint64 Quotient = Value >> K;
+		if (Quotient >= EscapeQuotient)
+		{
+			WriteOnes(EscapeQuotient);
+			Write(Value & 0xFFFFFFFF, 32);
+			Write(Value >> 32, 32);
+			return;
+		}
+		WriteOnes(uint32(Quotient));
+		Write(0, 1);
+		if (K > 0)
+		{
+			Write(Value & ((uint64(1) << K) - 1), K);
+		}
+	}
+
+	void Flush()
+	{
+		if (NumBits > 0)
+		{
+			Out.Add(uint8(Bits));
+			Bits = 0;
+			NumBits = 0;
+		}
+	}
+
+private:
+	TArray<uint8>& Out;
+	uint64 Bits;
+	int32 NumBits;
+};
+
+class FRiceDecoder
+{
+public:
+	FRiceDecoder(const uint8* InData, const int32 InSize) : Data(InData), Size(InSize), Pos(0), Bits(0), NumBits(0)
+	{
+	}
+
+	/** Count is at most 32, reading past the end gives zeros and sets HasOverrun */
+	uint64 Read(const int32 Count)
+	{
+		while (NumBits < Count)
+		{
+			const uint64 Byte = Pos < Size ? Data[Pos] : 0;
+			Pos++;
+			Bits |= Byte << NumBits;
+			NumBits += 8;
+		}
+		const uint64 Value = Bits & ((uint64(1) << Count) - 1);
+		Bits >>= Count;
+		NumBits -= Count;
+		return Value;
+	}
+
+	uint64 ReadRice(const int32 K)
+	{
+		uint32 Quotient = 0;
+		while (Quotient < EscapeQuotient && Read(1))
+		{
+			Quotient++;
+		}
+		if (Quotient == EscapeQuotient)
+		{
+			const uint64 Low = Read(32);
+			return Low | (Read(32) << 32);
+		}
+		return (uint64(Quotient) << K) | (K > 0 ? Read(K) : 0);
+	}
+
+	bool HasOverrun() const
+	{
+		return Pos > Size;
+	}
+
+private:
+	const uint8* Data;
+	int32 Size;
+	int32 Pos;
+	uint64 Bits;
+	int32 NumBits;
+};
+
+/**
+ * Append a column: a byte with the predictor order and Rice parameter, the first value as a varint, then the Rice
+ * coded residuals. The order and parameter are the pair with the fewest bits for this column
+ */
+void EncodeColumn(const int64* Values, const int32 Num, TArray<uint8>& Out)
+{
+	int32 BestOrder = 1;
+	int32 BestK = 0;
+	uint64 BestBits = MAX_uint64;
+	for (int32 Order = 1; Order <= MaxPredictorOrder; Order++)
+	{
+		uint64 Bits[MaxRiceParameter + 1] = {0};
+		for (int32 Index = 1; Index < Num; Index++)
+		{
+			const uint64 Value = ZigZag(Residual(Values, Index, Order));
+			for (int32 K = 0; K <= MaxRiceParameter; K++)
+			{
+				Bits[K] += RiceBits(Value, K);
+			}
+		}
+		for (int32 K = 0; K <= MaxRiceParameter; K++)
+		{
+			if (Bits[K] < BestBits)
+			{
+				BestBits = Bits[K];
+				BestOrder = Order;
+				BestK = K;
+			}
+		}
+	}
+
+	Out.Add(uint8((BestOrder << 5) | BestK));
+	PutVarint(ZigZag(Values[0]), Out);
+	FRiceEncoder Encoder(Out);
+	for (int32 Index = 1; Index < Num; Index++)
+	{
+		Encoder.WriteRice(ZigZag(Residual(Values, Index, BestOrder)), BestK);
+	}
+	Encoder.Flush();
+}
+
+bool DecodeColumn(const uint8* Data, const int32 Size, const int32 Num, int64* OutValues)
+{
+	if (Size < 1 || Num < 1)
+	{
+		return false;
+	}
+	const int32 Order = Data[0] >> 5;
+	const int32 K = Data[0] & 0x1F;
+	int32 Pos = 1;
+	uint64 First;
+	if (Order < 1 || Order > MaxPredictorOrder || K > MaxRiceParameter || !GetVarint(Data, Size, Pos, First))
+	{
+		return false;
+	}
+
+	OutValues[0] = UnZigZag(First);
+	FRiceDecoder Decoder(Data + Pos, Size - Pos);
+	for (int32 Index = 1; Index < Num; Index++)
+	{
+		OutValues[Index] = int64(Predict(OutValues, Index, Order) + uint64(UnZigZag(Decoder.ReadRice(K))));
+	}
+	return !Decoder.HasOverrun();
+}
+
+void PutIndexEntry(uint8*& Cursor, const LeapMotionArchive::FBlockIndexEntry& Entry)
+{
+	Put<uint64>(Cursor, Entry.Offset);
+	Put<uint32>(Cursor, Entry.Size);
+	Put<uint32>(Cursor, Entry.NumFrames);
+	Put<int64>(Cursor, Entry.FirstTime);
+	Put<int64>(Cursor, Entry.LastTime);
+}
+
+LeapMotionArchive::FBlockIndexEntry GetIndexEntry(const uint8*& Cursor)
+{
+	LeapMotionArchive::FBlockIndexEntry Entry;
+	Entry.Offset = Get<uint64>(Cursor);
+	Entry.Size = Get<uint32>(Cursor);
+	Entry.NumFrames = Get<uint32>(Cursor);
+	Entry.FirstTime = Get<int64>(Cursor);
+	Entry.LastTime = Get<int64>(Cursor);
+	return Entry;
+}
+}	 // namespace
+
+FLeapMotionArchiveFrame::FHand::FHand()
+{
+	for (int32 Digit = 0; Digit < FLeapJointCache::NumDigits; Digit++)
+	{
+		for (int32 Joint = 0; Joint < FLeapJointCache::NumJoints; Joint++)
+		{
+			JointPositions[Digit][Joint] = FVector::ZeroVector;
+		}
+	}
+}
+
+void FLeapMotionArchiveFrame::SetFromJoints(const FLeapJointCache& Joints, const int64 InTimeMicros)
+{
+	TimeMicros = InTimeMicros;
+	for (int32 HandIndex = 0; HandIndex < LeapMotionArchive::NumHands; HandIndex++)
+	{
+		const FLeapJointCache::FHand& Source =
+			Joints.GetHand(HandIndex == 0 ? EHandType::LEAP_HAND_LEFT : EHandType::LEAP_HAND_RIGHT);
+		FHand& Hand = Hands[HandIndex];
+		Hand.bVisible = Source.bVisible;
+		Hand.PalmPosition = Source.PalmPosition;
+		Hand.PalmOrientation = Source.PalmOrientation.Quaternion();
+		FMemory::Memcpy(Hand.JointPositions, Source.JointPositions, sizeof(Hand.JointPositions));
+		Hand.PinchStrength = Source.PinchStrength;
+		Hand.GrabStrength = Source.GrabStrength;
+	}
+}
+
+FLeapMotionArchiveWriter::FLeapMotionArchiveWriter()
+	: Archive(nullptr), FramesPerBlock(0), PositionStep(0.f), bWriteFailed(false), Thread(nullptr)
+{
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+}
+
+FLeapMotionArchiveWriter::~FLeapMotionArchiveWriter()
+{
+	Close();
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+}
+
+FString FLeapMotionArchiveWriter::GetConfiguredPath()
+{
+	const FString Path = CVarLeapArchivePath.GetValueOnAnyThread();
+	if (Path.IsEmpty())
+	{
+		return Path;
+	}
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir(), Path);
+}
+
+bool FLeapMotionArchiveWriter::Open(const FString& Path, const int32 InFramesPerBlock, const float InPositionStep)
+{
+	LEAP_LLM_SCOPE(Ultraleap_Frames);
+
+	Close();
+	Archive = IFileManager::Get().CreateFileWriter(*Path);
+	if (!Archive)
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("Couldn't open motion archive %s for writing"), *Path);
+		return false;
+	}
+
+	FramesPerBlock = FMath::Clamp(InFramesPerBlock, MinFramesPerBlock, MaxFramesPerBlock);
+	PositionStep = FMath::Max(InPositionStep, KINDA_SMALL_NUMBER);
+	for (TArray<FLeapMotionArchiveFrame>& Block : Blocks)
+	{
+		Block.Reset(FramesPerBlock);
+	}
+	ColumnValues.SetNumUninitialized(FramesPerBlock);
+	Index.Reset();
+	NumProduced = 0;
+	NumConsumed = 0;
+	NumDroppedFrames = 0;
+	bStopping = false;
+	bWriteFailed = false;
+
+	uint8 Header[ArchiveHeaderSize];
+	uint8* Cursor = Header;
+	Put<uint32>(Cursor, ArchiveMagic);
+	Put<uint16>(Cursor, ArchiveVersion);
+	Put<uint16>(Cursor, (uint16) FramesPerBlock);
+	Put<float>(Cursor, PositionStep);
+	Put<float>(Cursor, RotationStep);
+	Put<float>(Cursor, StrengthStep);
+	Archive->Serialize(Header, ArchiveHeaderSize);
+	BytesWritten = ArchiveHeaderSize;
+
+	Thread = FRunnableThread::Create(this, TEXT("UltraleapMotionArchive"), 0, TPri_BelowNormal);
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("Recording motion archive %s"), *Path);
+	return true;
+}
+
+void FLeapMotionArchiveWriter::Close()
+{
+	if (!Archive)
+	{
+		return;
+	}
+
+	// Hand the partial block to the writer thread, unless every buffer is still waiting to be written
+	const uint32 Produced = NumProduced;
+	if (Produced - NumConsumed < NumBlockBuffers && Blocks[Produced % NumBlockBuffers].Num() > 0)
+	{
+		NumProduced = Produced + 1;
+	}
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	if (!bWriteFailed)
+	{
+		TArray<uint8> Footer;
+		Footer.SetNumUninitialized(Index.Num() * IndexEntrySize + ArchiveFooterSize);
+		uint8* Cursor = Footer.GetData();
+		for (const LeapMotionArchive::FBlockIndexEntry& Entry : Index)
+		{
+			PutIndexEntry(Cursor, Entry);
+		}
+		Put<uint64>(Cursor, (uint64) BytesWritten);
+		Put<uint32>(Cursor, (uint32) Index.Num());
+		Put<uint32>(Cursor, ArchiveMagic);
+		Archive->Serialize(Footer.GetData(), Footer.Num());
+		BytesWritten += Footer.Num();
+	}
+
+	Archive->Close();
+	delete Archive;
+	Archive = nullptr;
+
+	uint32 NumFrames = 0;
+	for (const LeapMotionArchive::FBlockIndexEntry& Entry : Index)
+	{
+		NumFrames += Entry.NumFrames;
+	}
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("Motion archive closed, %u frames in %lld bytes, %d frames dropped"), NumFrames,
+		(int64) BytesWritten, (int32) NumDroppedFrames);
+}
+
+void FLeapMotionArchiveWriter::AddFrame(const FLeapMotionArchiveFrame& Frame)
+{
+	if (!Archive)
+	{
+		return;
+	}
+	const uint32 Produced = NumProduced;
+	if (Produced - NumConsumed >= NumBlockBuffers)
+	{
+		NumDroppedFrames++;
+		return;
+	}
+
+	TArray<FLeapMotionArchiveFrame>& Block = Blocks[Produced % NumBlockBuffers];
+	Block.Add(Frame);
+	if (Block.Num() >= FramesPerBlock)
+	{
+		NumProduced = Produced + 1;
+		WakeEvent->Trigger();
+	}
+}
+
+uint32 FLeapMotionArchiveWriter::Run()
+{
+	for (;;)
+	{
+		// Read before draining so blocks handed over together with the stop request are still written
+		const bool bStop = bStopping;
+		while (NumConsumed != NumProduced)
+		{
+			TArray<FLeapMotionArchiveFrame>& Block = Blocks[NumConsumed % NumBlockBuffers];
+			WriteBlock(Block);
+			Block.Reset();
+			NumConsumed++;
+		}
+		if (bStop)
+		{
+			break;
+		}
+		WakeEvent->Wait();
+	}
+	return 0;
+}
+
+void FLeapMotionArchiveWriter::Stop()
+{
+	bStopping = true;
+	WakeEvent->Trigger();
+}
+
+void FLeapMotionArchiveWriter::WriteBlock(const TArray<FLeapMotionArchiveFrame>& Frames)
+{
+	const int32 Num = Frames.Num();
+	if (Num == 0 || bWriteFailed)
+	{
+		return;
+	}
+
+	const FSteps Steps = {PositionStep, RotationStep, StrengthStep};
+	const int32 ColumnSizesOffset = BlockHeaderSize;
+	BlockBuffer.Reset();
+	BlockBuffer.AddZeroed(BlockHeaderSize + NumColumns * sizeof(uint16));
+	int64* Values = ColumnValues.GetData();
+	int32 Column = 0;
+
+	auto EncodeValues = [this, Num, Values, ColumnSizesOffset, &Column]() {
+		const int32 Start = BlockBuffer.Num();
+		EncodeColumn(Values, Num, BlockBuffer);
+		uint8* Cursor = BlockBuffer.GetData() + ColumnSizesOffset + Column * sizeof(uint16);
+		Put<uint16>(Cursor, (uint16)(BlockBuffer.Num() - Start));
+		Column++;
+	};
+
+	for (int32 Frame = 0; Frame < Num; Frame++)
+	{
+		Values[Frame] = Frames[Frame].TimeMicros;
+	}
+	EncodeValues();
+
+	for (int32 Frame = 0; Frame < Num; Frame++)
+	{
+		Values[Frame] = (Frames[Frame].Hands[0].bVisible ? 1 : 0) | (Frames[Frame].Hands[1].bVisible ? 2 : 0);
+	}
+	EncodeValues();
+
+	for (int32 HandIndex = 0; HandIndex < LeapMotionArchive::NumHands; HandIndex++)
+	{
+		// Hidden frames repeat the nearest visible value so they cost a bit each and don't break the prediction
+		int32 FirstVisible = INDEX_NONE;
+		for (int32 Frame = 0; Frame < Num && FirstVisible == INDEX_NONE; Frame++)
+		{
+			FirstVisible = Frames[Frame].Hands[HandIndex].bVisible ? Frame : INDEX_NONE;
+		}
+
+		for (int32 Channel = 0; Channel < LeapMotionArchive::NumChannelsPerHand; Channel++)
+		{
+			for (int32 Component = 0; Component < NumComponents(Channel); Component++)
+			{
+				for (int32 Frame = 0; Frame < Num; Frame++)
+				{
+					const FLeapMotionArchiveFrame::FHand& Hand = Frames[Frame].Hands[HandIndex];
+					if (Hand.bVisible)
+					{
+						Values[Frame] = Quantize(Hand, Channel, Component, Steps);
+					}
+					else if (Frame > 0)
+					{
+						Values[Frame] = Values[Frame - 1];
+					}
+					else
+					{
+						Values[Frame] = FirstVisible == INDEX_NONE
+											? 0
+											: Quantize(Frames[FirstVisible].Hands[HandIndex], Channel, Component, Steps);
+					}
+				}
+				EncodeValues();
+			}
+		}
+	}
+	check(Column == NumColumns);
+
+	LeapMotionArchive::FBlockIndexEntry Entry;
+	Entry.Offset = BytesWritten;
+	Entry.Size = BlockBuffer.Num();
+	Entry.NumFrames = Num;
+	Entry.FirstTime = Frames[0].TimeMicros;
+	Entry.LastTime = Frames.Last().TimeMicros;
+
+	uint8* Cursor = BlockBuffer.GetData();
+	Put<uint32>(Cursor, Entry.Size);
+	Put<int64>(Cursor, Entry.FirstTime);
+	Put<int64>(Cursor, Entry.LastTime);
+	Put<uint16>(Cursor, (uint16) Num);
+	Put<uint16>(Cursor, (uint16) NumColumns);
+
+	Archive->Serialize(BlockBuffer.GetData(), BlockBuffer.Num());
+	if (Archive->IsError())
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("Writing the motion archive failed, recording stopped"));
+		bWriteFailed = true;
+		return;
+	}
+	Index.Add(Entry);
+	BytesWritten += Entry.Size;
+}
+
+FLeapMotionArchiveReader::FLeapMotionArchiveReader()
+	: Archive(nullptr), PositionStep(0.f), RotationStep(0.f), StrengthStep(0.f)
+{
+}
+
+FLeapMotionArchiveReader::~FLeapMotionArchiveReader()
+{
+	Close();
+}
+
+bool FLeapMotionArchiveReader::Open(const FString& Path)
+{
+	Close();
+	Archive = IFileManager::Get().CreateFileReader(*Path);
+	if (!Archive)
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("Couldn't open motion archive %s"), *Path);
+		return false;
+	}
+
+	const int64 FileSize = Archive->TotalSize();
+	uint8 Header[ArchiveHeaderSize];
+	if (FileSize < ArchiveHeaderSize)
+	{
+		Close();
+		return false;
+	}
+	Archive->Serialize(Header, ArchiveHeaderSize);
+	const uint8* Cursor = Header;
+	const uint32 FileMagic = Get<uint32>(Cursor);
+	const uint16 FileVersion = Get<uint16>(Cursor);
+	Get<uint16>(Cursor);
+	PositionStep = Get<float>(Cursor);
+	RotationStep = Get<float>(Cursor);
+	StrengthStep = Get<float>(Cursor);
+	if (FileMagic != ArchiveMagic || FileVersion != ArchiveVersion)
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("%s is not a version %d motion archive"), *Path, ArchiveVersion);
+		Close();
+		return false;
+	}
+
+	if (!ReadIndex(FileSize))
+	{
+		RebuildIndex(FileSize);
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("Motion archive %s has no index, found %d blocks"), *Path, Index.Num());
+	}
+	return true;
+}
+
+void FLeapMotionArchiveReader::Close()
+{
+	if (Archive)
+	{
+		Archive->Close();
+		delete Archive;
+		Archive = nullptr;
+	}
+	Index.Reset();
+}
+
+int32 FLeapMotionArchiveReader::GetNumFrames() const
+{
+	int32 NumFrames = 0;
+	for (const LeapMotionArchive::FBlockIndexEntry& Entry : Index)
+	{
+		NumFrames += Entry.NumFrames;
+	}
+	return NumFrames;
+}
+
+int64 FLeapMotionArchiveReader::GetStartTime() const
+{
+	return Index.Num() > 0 ? Index[0].FirstTime : 0;
+}
+
+int64 FLeapMotionArchiveReader::GetEndTime() const
+{
+	return Index.Num() > 0 ? Index.Last().LastTime : 0;
+}
+
+bool FLeapMotionArchiveReader::ReadIndex(const int64 FileSize)
+{
+	if (FileSize < ArchiveHeaderSize + ArchiveFooterSize)
+	{
+		return false;
+	}
+	uint8 Footer[ArchiveFooterSize];
+	Archive->Seek(FileSize - ArchiveFooterSize);
+	Archive->Serialize(Footer, ArchiveFooterSize);
+	const uint8* Cursor = Footer;
+	const uint64 IndexOffset = Get<uint64>(Cursor);
+	const uint32 NumBlocks = Get<uint32>(Cursor);
+	if (Get<uint32>(Cursor) != ArchiveMagic ||
+		IndexOffset + uint64(NumBlocks) * IndexEntrySize != uint64(FileSize - ArchiveFooterSize))
+	{
+		return false;
+	}
+
+	TArray<uint8> Entries;
+	Entries.SetNumUninitialized(NumBlocks * IndexEntrySize);
+	Archive->Seek(IndexOffset);
+	Archive->Serialize(Entries.GetData(), Entries.Num());
+	Cursor = Entries.GetData();
+	Index.Reset(NumBlocks);
+	for (uint32 Block = 0; Block < NumBlocks; Block++)
+	{
+		const LeapMotionArchive::FBlockIndexEntry Entry = GetIndexEntry(Cursor);
+		if (Entry.Offset + Entry.Size > IndexOffset)
+		{
+			Index.Reset();
+			return false;
+		}
+		Index.Add(Entry);
+	}
+	return !Archive->IsError();
+}
+
+bool FLeapMotionArchiveReader::RebuildIndex(const int64 FileSize)
+{
+	Index.Reset();
+	Archive->ClearError();
+	uint64 Offset = ArchiveHeaderSize;
+	uint8 BlockHeader[BlockHeaderSize];
+	while (Offset + BlockHeaderSize <= uint64(FileSize))
+	{
+		Archive->Seek(Offset);
+		Archive->Serialize(BlockHeader, BlockHeaderSize);
+		const uint8* Cursor = BlockHeader;
+		LeapMotionArchive::FBlockIndexEntry Entry;
+		Entry.Offset = Offset;
+		Entry.Size = Get<uint32>(Cursor);
+		Entry.FirstTime = Get<int64>(Cursor);
+		Entry.LastTime = Get<int64>(Cursor);
+		Entry.NumFrames = Get<uint16>(Cursor);
+
+		// A block cut short by the end of the file is dropped
+		if (Archive->IsError() || Entry.Size < BlockHeaderSize || Offset + Entry.Size > uint64(FileSize))
+		{
+			break;
+		}
+		Index.Add(Entry);
+		Offset += Entry.Size;
+	}
+	Archive->ClearError();
+	return Index.Num() > 0;
+}
+
+bool FLeapMotionArchiveReader::Read(
+	const int64 StartTime, const int64 EndTime, const uint64 ChannelMask, TArray<FLeapMotionArchiveFrame>& OutFrames)
+{
+	OutFrames.Reset();
+	if (!Archive)
+	{
+		return false;
+	}
+
+	// Blocks are in time order, skip straight to the first one that ends at or after StartTime
+	const auto GetLastTime = [](const LeapMotionArchive::FBlockIndexEntry& Entry) { return Entry.LastTime; };
+	for (int32 Block = Algo::LowerBoundBy(Index, StartTime, GetLastTime);
+		 Block < Index.Num() && Index[Block].FirstTime <= EndTime; Block++)
+	{
+		if (!DecodeBlock(Index[Block], StartTime, EndTime, ChannelMask, OutFrames))
+		{
+			UE_LOG(UltraleapTrackingLog, Warning, TEXT("Motion archive block %d is corrupt"), Block);
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FLeapMotionArchiveReader::DecodeBlock(const LeapMotionArchive::FBlockIndexEntry& Block, const int64 StartTime,
+	const int64 EndTime, const uint64 ChannelMask, TArray<FLeapMotionArchiveFrame>& OutFrames)
+{
+	if (Block.Size < BlockHeaderSize + NumColumns * sizeof(uint16))
+	{
+		return false;
+	}
+	BlockBuffer.SetNumUninitialized(Block.Size);
+	Archive->Seek(Block.Offset);
+	Archive->Serialize(BlockBuffer.GetData(), Block.Size);
+	if (Archive->IsError())
+	{
+		return false;
+	}
+
+	const uint8* Cursor = BlockBuffer.GetData() + 4 + 8 + 8;
+	const int32 Num = Get<uint16>(Cursor);
+	if (Num < 1 || Get<uint16>(Cursor) != NumColumns)
+	{
+		return false;
+	}
+
+	// Column offsets from their sizes, every column is checked to lie inside the block before any is decoded
+	int32 ColumnOffsets[NumColumns + 1];
+	ColumnOffsets[0] = BlockHeaderSize + NumColumns * sizeof(uint16);
+	for (int32 Column = 0; Column < NumColumns; Column++)
+	{
+		ColumnOffsets[Column + 1] = ColumnOffsets[Column] + Get<uint16>(Cursor);
+	}
+	if (ColumnOffsets[NumColumns] > int32(Block.Size))
+	{
+		return false;
+	}
+	auto Decode = [this, &ColumnOffsets, Num](const int32 Column, TArray<int64>& OutValues) {
+		OutValues.SetNumUninitialized(Num, false);
+		return DecodeColumn(BlockBuffer.GetData() + ColumnOffsets[Column], ColumnOffsets[Column + 1] - ColumnOffsets[Column],
+			Num, OutValues.GetData());
+	};
+
+	if (!Decode(TimeColumn, Times) || !Decode(HandMaskColumn, HandMasks))
+	{
+		return false;
+	}
+	const int32 First = Algo::LowerBound(Times, StartTime);
+	const int32 Last = Algo::UpperBound(Times, EndTime);
+	if (First >= Last)
+	{
+		return true;
+	}
+
+	const int32 OutStart = OutFrames.Num();
+	OutFrames.AddDefaulted(Last - First);
+	FLeapMotionArchiveFrame* Frames = OutFrames.GetData() + OutStart;
+	for (int32 Frame = First; Frame < Last; Frame++)
+	{
+		Frames[Frame - First].TimeMicros = Times[Frame];
+		for (int32 HandIndex = 0; HandIndex < LeapMotionArchive::NumHands; HandIndex++)
+		{
+			Frames[Frame - First].Hands[HandIndex].bVisible = (HandMasks[Frame] & (int64(1) << HandIndex)) != 0;
+		}
+	}
+
+	const FSteps Steps = {PositionStep, RotationStep, StrengthStep};
+	for (int32 HandIndex = 0; HandIndex < LeapMotionArchive::NumHands; HandIndex++)
+	{
+		for (int32 Channel = 0; Channel < LeapMotionArchive::NumChannelsPerHand; Channel++)
+		{
+			if ((ChannelMask & LeapMotionArchive::ChannelBit(HandIndex, Channel)) == 0)
+			{
+				continue;
+			}
+			for (int32 Component = 0; Component < NumComponents(Channel); Component++)
+			{
+				if (!Decode(ColumnIndex(HandIndex, Channel, Component), ColumnValues))
+				{
+					return false;
+				}
+				for (int32 Frame = First; Frame < Last; Frame++)
+				{
+					FLeapMotionArchiveFrame::FHand& Hand = Frames[Frame - First].Hands[HandIndex];
+					if (Hand.bVisible)
+					{
+						Dequantize(Hand, Channel, Component, ColumnValues[Frame], Steps);
+					}
+				}
+			}
+			if (Channel == LeapMotionArchive::PalmOrientationChannel)
+			{
+				for (int32 Frame = 0; Frame < Last - First; Frame++)
+				{
+					Frames[Frame].Hands[HandIndex].PalmOrientation.Normalize();
+				}
+			}
+		}
+	}
+	return true;
+}
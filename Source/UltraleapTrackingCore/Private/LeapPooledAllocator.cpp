@@ -0,0 +1,182 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapPooledAllocator.h"
+
+#include "HAL/IConsoleManager.h"
+#include "LeapStats.h"
+
+static TAutoConsoleVariable<int32> CVarLeapAllocatorPooled(TEXT("leap.Allocator.Pooled"), 1,
+	TEXT("Serve LeapC's image and frame allocations from size class pools, read when the connection opens"));
+
+// Keeps the user pointer 16 byte aligned, more than any eLeapAllocatorType needs
+static const uint32 BlockAlignment = 16;
+static const uint32 HeaderSize = 16;
+
+struct FLeapPooledAllocator::FBlockHeader
+{
+	/** Next block on the free list, only while free */
+	FBlockHeader* NextFree;
+	/** Requested size for unpooled blocks, the class size otherwise */
+	uint32 Size;
+	int32 SizeClass;
+};
+
+bool FLeapPooledAllocator::IsEnabled()
+{
+	return CVarLeapAllocatorPooled.GetValueOnAnyThread() != 0;
+}
+
+FLeapPooledAllocator::FLeapPooledAllocator()
+{
+	static_assert(sizeof(FBlockHeader) <= HeaderSize, "Block header overlaps the user pointer");
+
+	FMemory::Memzero(FreeLists);
+	FMemory::Memzero(FreeCounts);
+	LeapAllocator.allocate = &FLeapPooledAllocator::LeapAllocate;
+	LeapAllocator.deallocate = &FLeapPooledAllocator::LeapDeallocate;
+	LeapAllocator.state = this;
+}
+
+FLeapPooledAllocator::~FLeapPooledAllocator()
+{
+	Trim();
+}
+
+int32 FLeapPooledAllocator::GetSizeClass(uint32 Size)
+{
+	if (Size <= (1u << MinClassShift))
+	{
+		return 0;
+	}
+	const int32 SizeClass = (int32) FMath::CeilLogTwo(Size) - MinClassShift;
+	return FMath::Min(SizeClass, NumClasses);
+}
+
+uint32 FLeapPooledAllocator::GetClassSize(int32 SizeClass)
+{
+	return 1u << (SizeClass + MinClassShift);
+}
+
+void* FLeapPooledAllocator::Allocate(uint32 Size)
+{
+	const int32 SizeClass = GetSizeClass(Size);
+	const uint32 BlockSize = SizeClass < NumClasses ? GetClassSize(SizeClass) : Size;
+
+	FBlockHeader* Block = nullptr;
+	Lock.Lock();
+	if (SizeClass < NumClasses && FreeLists[SizeClass])
+	{
+		Block = FreeLists[SizeClass];
+		FreeLists[SizeClass] = Block->NextFree;
+		FreeCounts[SizeClass]--;
+		Stats.BytesFree -= BlockSize;
+		Stats.Hits++;
+	}
+	else
+	{
+		Stats.Misses++;
+	}
+	Stats.BytesInUse += BlockSize;
+	Stats.BlocksInUse++;
+	const FPoolStats CurrentStats = Stats;
+	Lock.Unlock();
+
+	if (!Block)
+	{
+		LEAP_LLM_SCOPE(Ultraleap_LeapC);
+		Block = (FBlockHeader*) FMemory::Malloc(HeaderSize + BlockSize, BlockAlignment);
+		Block->Size = BlockSize;
+		Block->SizeClass = SizeClass;
+	}
+	Block->NextFree = nullptr;
+
+	PublishStats(CurrentStats);
+	return (uint8*) Block + HeaderSize;
+}
+
+void FLeapPooledAllocator::Deallocate(void* Ptr)
+{
+	if (!Ptr)
+	{
+		return;
+	}
+
+	FBlockHeader* Block = (FBlockHeader*) ((uint8*) Ptr - HeaderSize);
+	const int32 SizeClass = Block->SizeClass;
+	bool bPooled = false;
+
+	Lock.Lock();
+	Stats.BytesInUse -= Block->Size;
+	Stats.BlocksInUse--;
+	if (SizeClass < NumClasses && FreeCounts[SizeClass] < MaxFreeBlocksPerClass)
+	{
+		Block->NextFree = FreeLists[SizeClass];
+		FreeLists[SizeClass] = Block;
+		FreeCounts[SizeClass]++;
+		Stats.BytesFree += Block->Size;
+		bPooled = true;
+	}
+	const FPoolStats CurrentStats = Stats;
+	Lock.Unlock();
+
+	if (!bPooled)
+	{
+		FMemory::Free(Block);
+	}
+	PublishStats(CurrentStats);
+}
+
+void FLeapPooledAllocator::Trim()
+{
+	FBlockHeader* Lists[NumClasses];
+
+	Lock.Lock();
+	FMemory::Memcpy(Lists, FreeLists, sizeof(Lists));
+	FMemory::Memzero(FreeLists);
+	FMemory::Memzero(FreeCounts);
+	Stats.BytesFree = 0;
+	const FPoolStats CurrentStats = Stats;
+	Lock.Unlock();
+
+	for (FBlockHeader* Block : Lists)
+	{
+		while (Block)
+		{
+			FBlockHeader* Next = Block->NextFree;
+			FMemory::Free(Block);
+			Block = Next;
+		}
+	}
+	PublishStats(CurrentStats);
+}
+
+FLeapPooledAllocator::FPoolStats FLeapPooledAllocator::GetStats() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Stats;
+}
+
+void FLeapPooledAllocator::PublishStats(const FPoolStats& CurrentStats) const
+{
+	SET_MEMORY_STAT(STAT_LeapPoolBytesInUse, CurrentStats.BytesInUse);
+	SET_MEMORY_STAT(STAT_LeapPoolBytesFree, CurrentStats.BytesFree);
+	SET_DWORD_STAT(STAT_LeapPoolMisses, (uint32) CurrentStats.Misses);
+	TRACE_COUNTER_SET(LeapPoolBytesInUse, CurrentStats.BytesInUse);
+	TRACE_COUNTER_SET(LeapPoolBytesFree, CurrentStats.BytesFree);
+}
+
+void* FLeapPooledAllocator::LeapAllocate(uint32_t Size, eLeapAllocatorType TypeHint, void* State)
+{
+	return ((FLeapPooledAllocator*) State)->Allocate(Size);
+}
+
+void FLeapPooledAllocator::LeapDeallocate(void* Ptr, void* State)
+{
+	((FLeapPooledAllocator*) State)->Deallocate(Ptr);
+}
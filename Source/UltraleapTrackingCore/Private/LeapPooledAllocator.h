@@ -0,0 +1,84 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeapC.h"
+
+/**
+ * LEAP_ALLOCATOR for LeapSetAllocator, serving LeapC's dynamic allocations (image buffers above all) from power of two
+ * size class pools.
+ *
+ * Every block carries a small header with its size class. Freed blocks go on an intrusive free list for their class,
+ * up to MaxFreeBlocksPerClass, so steady image traffic at device rate reuses the same few buffers instead of going to
+ * the heap. Requests above the largest class are passed straight to FMemory. All memory is tagged Ultraleap/LeapC for
+ * LLM and pool occupancy shows in "stat UltraleapTracking".
+ *
+ * LeapC may allocate and deallocate from its own threads, the free lists are guarded by a lock held only for the list
+ * operation. Disabled with leap.Allocator.Pooled=0, in which case LeapC keeps its own allocations.
+ */
+class FLeapPooledAllocator
+{
+public:
+	/** Smallest class is 64 bytes, largest 8MB */
+	static constexpr int32 MinClassShift = 6;
+	static constexpr int32 NumClasses = 18;
+	static constexpr int32 MaxFreeBlocksPerClass = 4;
+
+	struct FPoolStats
+	{
+		/** Bytes handed out and not yet given back, including unpooled blocks */
+		int64 BytesInUse = 0;
+		/** Bytes sitting on the free lists */
+		int64 BytesFree = 0;
+		int32 BlocksInUse = 0;
+		/** Allocations served from a free list and ones that went to the heap */
+		uint64 Hits = 0;
+		uint64 Misses = 0;
+	};
+
+	FLeapPooledAllocator();
+	~FLeapPooledAllocator();
+
+	/** Whether connections should install the pooled allocator, read when a connection opens */
+	static bool IsEnabled();
+
+	/** Pass to LeapSetAllocator, the allocator must outlive the connection */
+	const LEAP_ALLOCATOR* GetLeapAllocator() const
+	{
+		return &LeapAllocator;
+	}
+
+	void* Allocate(uint32 Size);
+	void Deallocate(void* Ptr);
+
+	/** Return every free block to the heap */
+	void Trim();
+
+	FPoolStats GetStats() const;
+
+private:
+	struct FBlockHeader;
+
+	static void* LeapAllocate(uint32_t Size, eLeapAllocatorType TypeHint, void* State);
+	static void LeapDeallocate(void* Ptr, void* State);
+
+	/** NumClasses for sizes above the largest class */
+	static int32 GetSizeClass(uint32 Size);
+	static uint32 GetClassSize(int32 SizeClass);
+
+	void PublishStats(const FPoolStats& CurrentStats) const;
+
+	mutable FCriticalSection Lock;
+	FBlockHeader* FreeLists[NumClasses];
+	int32 FreeCounts[NumClasses];
+	FPoolStats Stats;
+
+	LEAP_ALLOCATOR LeapAllocator;
+};
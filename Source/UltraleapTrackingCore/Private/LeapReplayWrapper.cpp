@@ -0,0 +1,177 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapReplayWrapper.h"
+
+#include "Algo/BinarySearch.h"
+#include "LeapUtility.h"
+
+FLeapReplayWrapper::FLeapReplayWrapper() : RecordingDuration(0), Now(0), Cycles(0)
+{
+	DeviceInfo = {0};
+	DeviceInfo.size = sizeof(LEAP_DEVICE_INFO);
+	DeviceInfo.serial = (char*) ("ReplayDevice");
+	DeviceInfo.serial_length = strlen(DeviceInfo.serial) + 1;
+	CurrentDeviceInfo = &DeviceInfo;
+
+	Frame = {{0}};
+	InterpolatedFrame = {{0}};
+	FrameHands.SetNumZeroed(FLeapSyntheticHands::MaxHands);
+	InterpolatedHands.SetNumZeroed(FLeapSyntheticHands::MaxHands);
+}
+
+FLeapReplayWrapper::~FLeapReplayWrapper()
+{
+}
+
+bool FLeapReplayWrapper::LoadRecording(const FString& Path)
+{
+	RecordedFrames.Reset();
+	RecordingDuration = 0;
+
+	LEAP_RECORDING Recording = nullptr;
+	LEAP_RECORDING_PARAMETERS Params;
+	Params.mode = eLeapRecordingFlags_Reading;
+
+	eLeapRS Result = LeapRecordingOpen(&Recording, TCHAR_TO_UTF8(*Path), Params);
+	if (Result != eLeapRS_Success)
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("FLeapReplayWrapper couldn't open recording %s (%x)"), *Path, (int32) Result);
+		return false;
+	}
+
+	// Read everything up front so replay cost doesn't include file IO
+	TArray<uint8> Buffer;
+	uint64_t FrameSize = 0;
+	while (LeapRecordingReadSize(Recording, &FrameSize) == eLeapRS_Success && FrameSize > 0)
+	{
+		Buffer.SetNumUninitialized(FrameSize, false);
+		LEAP_TRACKING_EVENT* Event = (LEAP_TRACKING_EVENT*) Buffer.GetData();
+		if (LeapRecordingRead(Recording, Event, FrameSize) != eLeapRS_Success)
+		{
+			break;
+		}
+
+		FRecordedFrame& Recorded = RecordedFrames.AddDefaulted_GetRef();
+		Recorded.Event = *Event;
+		Recorded.Hands.Append(Event->pHands, Event->nHands);
+		Recorded.Event.pHands = nullptr;
+	}
+	LeapRecordingClose(&Recording);
+
+	if (RecordedFrames.Num() == 0)
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("FLeapReplayWrapper recording %s has no frames"), *Path);
+		return false;
+	}
+
+	// Rebase to zero so the recording lines up with the replay clock
+	const int64 FirstTimeStamp = RecordedFrames[0].Event.info.timestamp;
+	for (FRecordedFrame& Recorded : RecordedFrames)
+	{
+		Recorded.Event.info.timestamp -= FirstTimeStamp;
+	}
+	RecordingDuration = RecordedFrames.Last().Event.info.timestamp + 1;
+
+	int32 MaxHands = FLeapSyntheticHands::MaxHands;
+	for (const FRecordedFrame& Recorded : RecordedFrames)
+	{
+		MaxHands = FMath::Max(MaxHands, Recorded.Hands.Num());
+	}
+	FrameHands.SetNumZeroed(MaxHands);
+	InterpolatedHands.SetNumZeroed(MaxHands);
+
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("FLeapReplayWrapper loaded %d frames from %s"), RecordedFrames.Num(), *Path);
+	return true;
+}
+
+void FLeapReplayWrapper::UseSyntheticHands(const int32 NumHands, const int32 Seed)
+{
+	RecordedFrames.Reset();
+	RecordingDuration = 0;
+	SyntheticHands = FLeapSyntheticHands(NumHands, Seed);
+}
+
+uint64 FLeapReplayWrapper::ConsumeCycles()
+{
+	const uint64 Ret = Cycles;
+	Cycles = 0;
+	return Ret;
+}
+
+LEAP_CONNECTION* FLeapReplayWrapper::OpenConnection(LeapWrapperCallbackInterface* InCallbackDelegate)
+{
+	CallbackDelegate = InCallbackDelegate;
+	bIsConnected = true;
+
+	if (CallbackDelegate)
+	{
+		CallbackDelegate->OnDeviceFound(&DeviceInfo);
+	}
+	return nullptr;
+}
+
+void FLeapReplayWrapper::CloseConnection()
+{
+	bIsConnected = false;
+	CallbackDelegate = nullptr;
+}
+
+LEAP_TRACKING_EVENT* FLeapReplayWrapper::GetFrame()
+{
+	return SampleAt(Now, Frame, FrameHands);
+}
+
+LEAP_TRACKING_EVENT* FLeapReplayWrapper::GetRecordedFrame(const int32 Index)
+{
+	const FRecordedFrame& Recorded = RecordedFrames[Index];
+	Frame = Recorded.Event;
+	FMemory::Memcpy(FrameHands.GetData(), Recorded.Hands.GetData(), Recorded.Hands.Num() * sizeof(LEAP_HAND));
+	Frame.pHands = FrameHands.GetData();
+	return &Frame;
+}
+
+LEAP_TRACKING_EVENT* FLeapReplayWrapper::GetInterpolatedFrameAtTime(int64 TimeStamp)
+{
+	return SampleAt(TimeStamp, InterpolatedFrame, InterpolatedHands);
+}
+
+LEAP_DEVICE_INFO* FLeapReplayWrapper::GetDeviceProperties()
+{
+	return CurrentDeviceInfo;
+}
+
+LEAP_TRACKING_EVENT* FLeapReplayWrapper::SampleAt(const int64 TimeStamp, LEAP_TRACKING_EVENT& OutFrame, TArray<LEAP_HAND>& OutHands)
+{
+	const uint32 StartCycles = FPlatformTime::Cycles();
+
+	if (RecordedFrames.Num() == 0)
+	{
+		SyntheticHands.Generate(TimeStamp, OutFrame, OutHands.GetData());
+	}
+	else
+	{
+		// Loop the recording, the frame ids keep counting up so nothing downstream sees time going backwards
+		const int64 Loop = FMath::Max<int64>(TimeStamp, 0) / RecordingDuration;
+		const int64 LocalTime = FMath::Max<int64>(TimeStamp, 0) % RecordingDuration;
+
+		const int32 Next = Algo::UpperBoundBy(
+			RecordedFrames, LocalTime, [](const FRecordedFrame& Recorded) { return Recorded.Event.info.timestamp; });
+		const FRecordedFrame& Recorded = RecordedFrames[FMath::Max(Next - 1, 0)];
+
+		OutFrame = Recorded.Event;
+		OutFrame.info.timestamp = TimeStamp;
+		OutFrame.info.frame_id += Loop * RecordedFrames.Num();
+		OutFrame.tracking_frame_id += Loop * RecordedFrames.Num();
+		FMemory::Memcpy(OutHands.GetData(), Recorded.Hands.GetData(), Recorded.Hands.Num() * sizeof(LEAP_HAND));
+		OutFrame.pHands = OutHands.GetData();
+	}
+
+	Cycles += FPlatformTime::Cycles() - StartCycles;
+	return &OutFrame;
+}
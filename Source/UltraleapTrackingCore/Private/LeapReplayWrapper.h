@@ -0,0 +1,85 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeapSyntheticHands.h"
+#include "LeapWrapper.h"
+
+/**
+ * Feeds the input device from a LeapC recording or from synthetic hands instead of the service.
+ *
+ * Time is driven externally with SetNow() so the pipeline can be stepped at a fixed rate.
+ * Recordings are loaded into memory up front and loop; interpolated frames return the recorded
+ * frame at or before the requested time. Synthetic hands are sampled at the exact time requested.
+ */
+class FLeapReplayWrapper : public FLeapWrapperBase
+{
+public:
+	FLeapReplayWrapper();
+	virtual ~FLeapReplayWrapper();
+
+	/** Load a recording made with LeapRecordingWrite, e.g. a .lmt file. Falls back to synthetic hands on failure */
+	bool LoadRecording(const FString& Path);
+
+	/** Replay generated hands, this is the default */
+	void UseSyntheticHands(const int32 NumHands, const int32 Seed);
+
+	/** Set the replay clock, in microseconds */
+	void SetNow(const int64 InNow)
+	{
+		Now = InNow;
+	}
+
+	/** Cycles spent in GetFrame and GetInterpolatedFrameAtTime since the last call */
+	uint64 ConsumeCycles();
+
+	int32 GetNumRecordedFrames() const
+	{
+		return RecordedFrames.Num();
+	}
+
+	/** A recorded frame as loaded, timestamps from 0. Valid until the next call to this or GetFrame */
+	LEAP_TRACKING_EVENT* GetRecordedFrame(const int32 Index);
+
+	// FLeapWrapperBase overrides
+	virtual LEAP_CONNECTION* OpenConnection(LeapWrapperCallbackInterface* InCallbackDelegate) override;
+	virtual void CloseConnection() override;
+	virtual LEAP_TRACKING_EVENT* GetFrame() override;
+	virtual LEAP_TRACKING_EVENT* GetInterpolatedFrameAtTime(int64 TimeStamp) override;
+	virtual LEAP_DEVICE_INFO* GetDeviceProperties() override;
+	virtual int64_t GetNow() override
+	{
+		return Now;
+	}
+
+private:
+	struct FRecordedFrame
+	{
+		LEAP_TRACKING_EVENT Event;
+		TArray<LEAP_HAND> Hands;
+	};
+
+	LEAP_TRACKING_EVENT* SampleAt(const int64 TimeStamp, LEAP_TRACKING_EVENT& OutFrame, TArray<LEAP_HAND>& OutHands);
+
+	TArray<FRecordedFrame> RecordedFrames;
+	int64 RecordingDuration;
+
+	FLeapSyntheticHands SyntheticHands;
+
+	LEAP_TRACKING_EVENT Frame;
+	TArray<LEAP_HAND> FrameHands;
+	LEAP_TRACKING_EVENT InterpolatedFrame;
+	TArray<LEAP_HAND> InterpolatedHands;
+
+	LEAP_DEVICE_INFO DeviceInfo;
+
+	int64 Now;
+	uint64 Cycles;
+};
@@ -0,0 +1,608 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapSessionAnalytics.h"
+
+#include "Dom/JsonObject.h"
+#include "LeapReplayWrapper.h"
+#include "LeapUtility.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+// Octave bands of the jitter spectrum, bins outside them are left out
+const float JitterBandEdges[] = {0.5f, 1.f, 2.f, 4.f, 8.f, 16.f, 32.f, 64.f, 128.f};
+const int32 NumJitterBands = UE_ARRAY_COUNT(JitterBandEdges) - 1;
+
+// Sessions are read in chunks of this many microseconds, the frame interval comes from the first
+const int64 ChunkMicros = 10 * 1000000;
+
+const TCHAR* HandNames[LeapMotionArchive::NumHands] = {TEXT("left"), TEXT("right")};
+
+/** Upper edge of the histogram bin the percentile falls in */
+double GetHistogramPercentile(const TArray<int64>& Histogram, const double BinWidth, const double Percentile)
+{
+	int64 Total = 0;
+	for (const int64 Count : Histogram)
+	{
+		Total += Count;
+	}
+	int64 Cumulative = 0;
+	for (int32 Bin = 0; Bin < Histogram.Num(); Bin++)
+	{
+		Cumulative += Histogram[Bin];
+		if (Total > 0 && Cumulative >= Percentile * Total)
+		{
+			return (Bin + 1) * BinWidth;
+		}
+	}
+	return 0.0;
+}
+
+TArray<TSharedPtr<FJsonValue>> ToJsonArray(const TArray<int64>& Values)
+{
+	TArray<TSharedPtr<FJsonValue>> Array;
+	for (const int64 Value : Values)
+	{
+		Array.Add(MakeShared<FJsonValueNumber>(Value));
+	}
+	return Array;
+}
+
+FString GetBandName(const int32 Band)
+{
+	return FString::Printf(TEXT("%g_%ghz"), JitterBandEdges[Band], JitterBandEdges[Band + 1]);
+}
+
+/** Column names and values in one place so the CSV header always matches the rows */
+void GetCsvFields(
+	const FLeapSessionStats& Stats, const FLeapSessionAnalyticsSettings& Settings, TArray<TPair<FString, FString>>& OutFields)
+{
+	auto Add = [&OutFields](const FString& Name, const FString& Value) { OutFields.Emplace(Name, Value); };
+	auto Number = [](const double Value) { return FString::Printf(TEXT("%g"), Value); };
+
+	Add(TEXT("source"), FString::Printf(TEXT("\"%s\""), *Stats.Source.Replace(TEXT("\""), TEXT("\"\""))));
+	Add(TEXT("sessions"), Number(Stats.NumSessions));
+	Add(TEXT("frames"), Number(Stats.NumFrames));
+	Add(TEXT("duration_s"), Number(Stats.DurationSeconds));
+	Add(TEXT("frame_rate_hz"), Number(Stats.DurationSeconds > 0.0 ? Stats.NumFrames / Stats.DurationSeconds : 0.0));
+	const bool bDropouts = EnumHasAnyFlags(Settings.Metrics, ELeapSessionMetrics::Dropouts);
+	if (bDropouts)
+	{
+		Add(TEXT("dropped_frames"), Number(Stats.DroppedFrames));
+	}
+
+	for (int32 HandIndex = 0; HandIndex < LeapMotionArchive::NumHands; HandIndex++)
+	{
+		const FLeapSessionStats::FHand& Hand = Stats.Hands[HandIndex];
+		const FString Prefix = FString(HandNames[HandIndex]) + TEXT("_");
+		if (bDropouts)
+		{
+			Add(Prefix + TEXT("visible_fraction"),
+				Number(Stats.NumFrames > 0 ? (double) Hand.VisibleFrames / Stats.NumFrames : 0.0));
+			Add(Prefix + TEXT("dropouts"), Number(Hand.Dropouts));
+			Add(Prefix + TEXT("dropouts_per_minute"),
+				Number(Stats.DurationSeconds > 0.0 ? Hand.Dropouts * 60.0 / Stats.DurationSeconds : 0.0));
+			Add(Prefix + TEXT("mean_dropout_s"), Number(Hand.Dropouts > 0 ? Hand.DropoutSeconds / Hand.Dropouts : 0.0));
+			Add(Prefix + TEXT("longest_dropout_s"), Number(Hand.LongestDropoutSeconds));
+		}
+		if (EnumHasAnyFlags(Settings.Metrics, ELeapSessionMetrics::Jitter))
+		{
+			Add(Prefix + TEXT("jitter_rms_cm"),
+				Number(Hand.JitterSamples > 0 ? FMath::Sqrt(Hand.JitterSquaredSum / Hand.JitterSamples) : 0.0));
+			for (int32 Band = 0; Band < NumJitterBands; Band++)
+			{
+				Add(Prefix + TEXT("jitter_") + GetBandName(Band) + TEXT("_cm2"),
+					Number(Hand.JitterWindows > 0 ? Hand.JitterBandPower[Band] / Hand.JitterWindows : 0.0));
+			}
+		}
+		if (EnumHasAnyFlags(Settings.Metrics, ELeapSessionMetrics::Pinch))
+		{
+			Add(Prefix + TEXT("pinch_mean"), Number(Hand.VisibleFrames > 0 ? Hand.PinchSum / Hand.VisibleFrames : 0.0));
+			for (int32 Bin = 0; Bin < Hand.PinchHistogram.Num(); Bin++)
+			{
+				Add(Prefix + FString::Printf(TEXT("pinch_%02d"), Bin), Number(Hand.PinchHistogram[Bin]));
+			}
+		}
+		if (EnumHasAnyFlags(Settings.Metrics, ELeapSessionMetrics::Velocity))
+		{
+			const double BinWidth = Settings.VelocityBinWidth;
+			Add(Prefix + TEXT("speed_p50_cm_s"), Number(GetHistogramPercentile(Hand.VelocityHistogram, BinWidth, 0.5)));
+			Add(Prefix + TEXT("speed_p95_cm_s"), Number(GetHistogramPercentile(Hand.VelocityHistogram, BinWidth, 0.95)));
+			for (int32 Bin = 0; Bin < Hand.VelocityHistogram.Num(); Bin++)
+			{
+				Add(Prefix + FString::Printf(TEXT("speed_%02d"), Bin), Number(Hand.VelocityHistogram[Bin]));
+			}
+		}
+	}
+}
+}	 // namespace
+
+bool FLeapSessionAnalyticsSettings::ParseMetrics(const FString& Names, ELeapSessionMetrics& OutMetrics)
+{
+	TArray<FString> Parsed;
+	Names.ParseIntoArray(Parsed, TEXT(","));
+	OutMetrics = ELeapSessionMetrics::None;
+	for (const FString& Name : Parsed)
+	{
+		const FString Trimmed = Name.TrimStartAndEnd();
+		if (Trimmed == TEXT("jitter"))
+		{
+			OutMetrics |= ELeapSessionMetrics::Jitter;
+		}
+		else if (Trimmed == TEXT("pinch"))
+		{
+			OutMetrics |= ELeapSessionMetrics::Pinch;
+		}
+		else if (Trimmed == TEXT("dropouts"))
+		{
+			OutMetrics |= ELeapSessionMetrics::Dropouts;
+		}
+		else if (Trimmed == TEXT("velocity"))
+		{
+			OutMetrics |= ELeapSessionMetrics::Velocity;
+		}
+		else if (Trimmed == TEXT("all"))
+		{
+			OutMetrics |= ELeapSessionMetrics::All;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return OutMetrics != ELeapSessionMetrics::None;
+}
+
+void FLeapSessionStats::Reset(const FLeapSessionAnalyticsSettings& Settings)
+{
+	*this = FLeapSessionStats();
+	for (FHand& Hand : Hands)
+	{
+		Hand.JitterBandPower.SetNumZeroed(NumJitterBands);
+		Hand.PinchHistogram.SetNumZeroed(Settings.NumPinchBins);
+		Hand.VelocityHistogram.SetNumZeroed(Settings.NumVelocityBins);
+	}
+}
+
+void FLeapSessionStats::Accumulate(const FLeapSessionStats& Other)
+{
+	NumSessions += Other.NumSessions;
+	NumFrames += Other.NumFrames;
+	DroppedFrames += Other.DroppedFrames;
+	DurationSeconds += Other.DurationSeconds;
+
+	auto AddArray = [](auto& To, const auto& From) {
+		for (int32 Index = 0; Index < FMath::Min(To.Num(), From.Num()); Index++)
+		{
+			To[Index] += From[Index];
+		}
+	};
+	for (int32 HandIndex = 0; HandIndex < LeapMotionArchive::NumHands; HandIndex++)
+	{
+		FHand& To = Hands[HandIndex];
+		const FHand& From = Other.Hands[HandIndex];
+		To.VisibleFrames += From.VisibleFrames;
+		To.Dropouts += From.Dropouts;
+		To.DropoutSeconds += From.DropoutSeconds;
+		To.LongestDropoutSeconds = FMath::Max(To.LongestDropoutSeconds, From.LongestDropoutSeconds);
+		AddArray(To.JitterBandPower, From.JitterBandPower);
+		To.JitterWindows += From.JitterWindows;
+		To.JitterSquaredSum += From.JitterSquaredSum;
+		To.JitterSamples += From.JitterSamples;
+		AddArray(To.PinchHistogram, From.PinchHistogram);
+		To.PinchSum += From.PinchSum;
+		AddArray(To.VelocityHistogram, From.VelocityHistogram);
+	}
+}
+
+TSharedRef<FJsonObject> FLeapSessionStats::ToJson(const FLeapSessionAnalyticsSettings& Settings) const
+{
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	if (!Source.IsEmpty())
+	{
+		Json->SetStringField(TEXT("source"), Source);
+	}
+	Json->SetNumberField(TEXT("sessions"), NumSessions);
+	Json->SetNumberField(TEXT("frames"), NumFrames);
+	Json->SetNumberField(TEXT("duration_s"), DurationSeconds);
+	Json->SetNumberField(TEXT("frame_rate_hz"), DurationSeconds > 0.0 ? NumFrames / DurationSeconds : 0.0);
+	const bool bDropouts = EnumHasAnyFlags(Settings.Metrics, ELeapSessionMetrics::Dropouts);
+	if (bDropouts)
+	{
+		Json->SetNumberField(TEXT("dropped_frames"), DroppedFrames);
+	}
+
+	TSharedRef<FJsonObject> HandsJson = MakeShared<FJsonObject>();
+	for (int32 HandIndex = 0; HandIndex < LeapMotionArchive::NumHands; HandIndex++)
+	{
+		const FHand& Hand = Hands[HandIndex];
+		TSharedRef<FJsonObject> HandJson = MakeShared<FJsonObject>();
+		if (bDropouts)
+		{
+			HandJson->SetNumberField(TEXT("visible_fraction"), NumFrames > 0 ? (double) Hand.VisibleFrames / NumFrames : 0.0);
+			HandJson->SetNumberField(TEXT("dropouts"), Hand.Dropouts);
+			HandJson->SetNumberField(
+				TEXT("dropouts_per_minute"), DurationSeconds > 0.0 ? Hand.Dropouts * 60.0 / DurationSeconds : 0.0);
+			HandJson->SetNumberField(TEXT("mean_dropout_s"), Hand.Dropouts > 0 ? Hand.DropoutSeconds / Hand.Dropouts : 0.0);
+			HandJson->SetNumberField(TEXT("longest_dropout_s"), Hand.LongestDropoutSeconds);
+		}
+		if (EnumHasAnyFlags(Settings.Metrics, ELeapSessionMetrics::Jitter))
+		{
+			HandJson->SetNumberField(
+				TEXT("jitter_rms_cm"), Hand.JitterSamples > 0 ? FMath::Sqrt(Hand.JitterSquaredSum / Hand.JitterSamples) : 0.0);
+			TArray<TSharedPtr<FJsonValue>> Bands;
+			for (int32 Band = 0; Band < NumJitterBands; Band++)
+			{
+				TSharedRef<FJsonObject> BandJson = MakeShared<FJsonObject>();
+				BandJson->SetNumberField(TEXT("low_hz"), JitterBandEdges[Band]);
+				BandJson->SetNumberField(TEXT("high_hz"), JitterBandEdges[Band + 1]);
+				BandJson->SetNumberField(
+					TEXT("power_cm2"), Hand.JitterWindows > 0 ? Hand.JitterBandPower[Band] / Hand.JitterWindows : 0.0);
+				Bands.Add(MakeShared<FJsonValueObject>(BandJson));
+			}
+			HandJson->SetArrayField(TEXT("jitter_bands"), Bands);
+		}
+		if (EnumHasAnyFlags(Settings.Metrics, ELeapSessionMetrics::Pinch))
+		{
+			HandJson->SetNumberField(TEXT("pinch_mean"), Hand.VisibleFrames > 0 ? Hand.PinchSum / Hand.VisibleFrames : 0.0);
+			HandJson->SetArrayField(TEXT("pinch_histogram"), ToJsonArray(Hand.PinchHistogram));
+		}
+		if (EnumHasAnyFlags(Settings.Metrics, ELeapSessionMetrics::Velocity))
+		{
+			HandJson->SetNumberField(TEXT("speed_bin_cm_s"), Settings.VelocityBinWidth);
+			HandJson->SetNumberField(
+				TEXT("speed_p50_cm_s"), GetHistogramPercentile(Hand.VelocityHistogram, Settings.VelocityBinWidth, 0.5));
+			HandJson->SetNumberField(
+				TEXT("speed_p95_cm_s"), GetHistogramPercentile(Hand.VelocityHistogram, Settings.VelocityBinWidth, 0.95));
+			HandJson->SetArrayField(TEXT("speed_histogram"), ToJsonArray(Hand.VelocityHistogram));
+		}
+		HandsJson->SetObjectField(HandNames[HandIndex], HandJson);
+	}
+	Json->SetObjectField(TEXT("hands"), HandsJson);
+	return Json;
+}
+
+FString FLeapSessionStats::GetCsvHeader(const FLeapSessionAnalyticsSettings& Settings)
+{
+	FLeapSessionStats Empty;
+	Empty.Reset(Settings);
+	TArray<TPair<FString, FString>> Fields;
+	GetCsvFields(Empty, Settings, Fields);
+
+	FString Header;
+	for (const TPair<FString, FString>& Field : Fields)
+	{
+		Header += (Header.IsEmpty() ? TEXT("") : TEXT(",")) + Field.Key;
+	}
+	return Header;
+}
+
+FString FLeapSessionStats::ToCsvRow(const FLeapSessionAnalyticsSettings& Settings) const
+{
+	TArray<TPair<FString, FString>> Fields;
+	GetCsvFields(*this, Settings, Fields);
+
+	FString Row;
+	for (const TPair<FString, FString>& Field : Fields)
+	{
+		Row += (Row.IsEmpty() ? TEXT("") : TEXT(",")) + Field.Value;
+	}
+	return Row;
+}
+
+FLeapSessionAnalyzer::FLeapSessionAnalyzer(const FLeapSessionAnalyticsSettings& InSettings, const int64 InFrameMicros)
+	: Settings(InSettings), FrameMicros(InFrameMicros), FirstTime(0), LastTime(0), WindowPower(0.f)
+{
+	Settings.JitterWindow = FMath::Max(Settings.JitterWindow, 8);
+	Settings.NumPinchBins = FMath::Max(Settings.NumPinchBins, 1);
+	Settings.NumVelocityBins = FMath::Max(Settings.NumVelocityBins, 1);
+	Settings.VelocityBinWidth = FMath::Max(Settings.VelocityBinWidth, KINDA_SMALL_NUMBER);
+	Stats.Reset(Settings);
+
+	const int32 N = Settings.JitterWindow;
+	Window.SetNumUninitialized(N);
+	Cosines.SetNumUninitialized(N);
+	Sines.SetNumUninitialized(N);
+	Detrended.SetNumUninitialized(N);
+	for (int32 Index = 0; Index < N; Index++)
+	{
+		Window[Index] = 0.5f - 0.5f * FMath::Cos(2.f * PI * Index / (N - 1));
+		WindowPower += Window[Index] * Window[Index];
+		Cosines[Index] = FMath::Cos(2.f * PI * Index / N);
+		Sines[Index] = FMath::Sin(2.f * PI * Index / N);
+	}
+
+	// Bin k of an N sample window is at k * Rate / N
+	const double Rate = FrameMicros > 0 ? 1000000.0 / FrameMicros : 0.0;
+	BinBands.Init(INDEX_NONE, N / 2 + 1);
+	for (int32 Bin = 1; Bin <= N / 2; Bin++)
+	{
+		const double Frequency = Bin * Rate / N;
+		for (int32 Band = 0; Band < NumJitterBands; Band++)
+		{
+			if (Frequency >= JitterBandEdges[Band] && Frequency < JitterBandEdges[Band + 1])
+			{
+				BinBands[Bin] = Band;
+			}
+		}
+	}
+
+	for (FHandState& State : HandStates)
+	{
+		State.Run.Reserve(N);
+	}
+}
+
+void FLeapSessionAnalyzer::AddFrame(const FLeapMotionArchiveFrame& Frame)
+{
+	bool bContiguous = false;
+	if (Stats.NumFrames == 0)
+	{
+		FirstTime = Frame.TimeMicros;
+	}
+	else
+	{
+		const int64 Delta = Frame.TimeMicros - LastTime;
+		bContiguous = FrameMicros <= 0 || Delta <= FrameMicros * 3 / 2;
+		if (!bContiguous)
+		{
+			Stats.DroppedFrames += FMath::Max<int64>((Delta + FrameMicros / 2) / FrameMicros - 1, 0);
+		}
+	}
+	Stats.NumFrames++;
+	LastTime = Frame.TimeMicros;
+
+	for (int32 HandIndex = 0; HandIndex < LeapMotionArchive::NumHands; HandIndex++)
+	{
+		AddHand(HandIndex, Frame.Hands[HandIndex], Frame.TimeMicros, bContiguous);
+	}
+}
+
+void FLeapSessionAnalyzer::AddHand(
+	const int32 HandIndex, const FLeapMotionArchiveFrame::FHand& Hand, const int64 Time, const bool bContiguous)
+{
+	FHandState& State = HandStates[HandIndex];
+	FLeapSessionStats::FHand& HandStats = Stats.Hands[HandIndex];
+
+	if (!Hand.bVisible)
+	{
+		// Only losing a hand that was seen counts, not one that hasn't turned up yet
+		if (State.bWasVisible)
+		{
+			HandStats.Dropouts++;
+			State.DropoutStart = Time;
+		}
+		State.bWasVisible = false;
+		State.RunLength = 0;
+		State.Run.Reset();
+		return;
+	}
+
+	if (State.bSeen && !State.bWasVisible)
+	{
+		EndDropout(HandIndex, Time);
+	}
+	State.bSeen = true;
+	State.bWasVisible = true;
+	HandStats.VisibleFrames++;
+	if (!bContiguous)
+	{
+		State.RunLength = 0;
+		State.Run.Reset();
+	}
+
+	const int32 PinchBin =
+		FMath::Clamp(FMath::FloorToInt(Hand.PinchStrength * Settings.NumPinchBins), 0, Settings.NumPinchBins - 1);
+	HandStats.PinchHistogram[PinchBin]++;
+	HandStats.PinchSum += Hand.PinchStrength;
+
+	const FVector Position = Hand.PalmPosition;
+	if (EnumHasAnyFlags(Settings.Metrics, ELeapSessionMetrics::Velocity) && State.RunLength >= 1 && Time > State.LastTime)
+	{
+		const double Speed = FVector::Dist(Position, State.LastPosition) * 1000000.0 / (Time - State.LastTime);
+		const int32 SpeedBin =
+			FMath::Min(FMath::FloorToInt(float(Speed / Settings.VelocityBinWidth)), Settings.NumVelocityBins - 1);
+		HandStats.VelocityHistogram[SpeedBin]++;
+	}
+
+	if (EnumHasAnyFlags(Settings.Metrics, ELeapSessionMetrics::Jitter))
+	{
+		// Second difference, how far the middle of three frames is from the line through its neighbours
+		if (State.RunLength >= 2)
+		{
+			HandStats.JitterSquaredSum += (State.Run.Last() - (State.Run.Last(1) + Position) * 0.5f).SizeSquared();
+			HandStats.JitterSamples++;
+		}
+		State.Run.Add(Position);
+		if (State.Run.Num() == Settings.JitterWindow)
+		{
+			AddJitterWindow(HandStats, State.Run);
+			State.Run.RemoveAt(0, Settings.JitterWindow / 2, false);
+		}
+	}
+
+	State.LastPosition = Position;
+	State.LastTime = Time;
+	State.RunLength++;
+}
+
+void FLeapSessionAnalyzer::AddJitterWindow(FLeapSessionStats::FHand& HandStats, const TArray<FVector>& Positions)
+{
+	const int32 N = Positions.Num();
+	const float Middle = (N - 1) * 0.5f;
+	float IndexVariance = 0.f;
+	for (int32 Index = 0; Index < N; Index++)
+	{
+		IndexVariance += FMath::Square(Index - Middle);
+	}
+
+	for (int32 Axis = 0; Axis < 3; Axis++)
+	{
+		// Remove the least squares line so slow reaching movements don't leak into the jitter bands
+		float Mean = 0.f;
+		for (int32 Index = 0; Index < N; Index++)
+		{
+			Mean += Positions[Index][Axis];
+		}
+		Mean /= N;
+		float Slope = 0.f;
+		for (int32 Index = 0; Index < N; Index++)
+		{
+			Slope += (Index - Middle) * (Positions[Index][Axis] - Mean);
+		}
+		Slope /= IndexVariance;
+		for (int32 Index = 0; Index < N; Index++)
+		{
+			Detrended[Index] = (Positions[Index][Axis] - Mean - Slope * (Index - Middle)) * Window[Index];
+		}
+
+		// Normalized by the window's power so the bins of a band sum to the mean square of its motion
+		for (int32 Bin = 1; Bin <= N / 2; Bin++)
+		{
+			if (BinBands[Bin] == INDEX_NONE)
+			{
+				continue;
+			}
+			float Real = 0.f;
+			float Imaginary = 0.f;
+			for (int32 Index = 0; Index < N; Index++)
+			{
+				const int32 Phase = (Bin * Index) % N;
+				Real += Detrended[Index] * Cosines[Phase];
+				Imaginary -= Detrended[Index] * Sines[Phase];
+			}
+			HandStats.JitterBandPower[BinBands[Bin]] += 2.f * (Real * Real + Imaginary * Imaginary) / (N * WindowPower);
+		}
+	}
+	HandStats.JitterWindows++;
+}
+
+void FLeapSessionAnalyzer::EndDropout(const int32 HandIndex, const int64 Time)
+{
+	FLeapSessionStats::FHand& HandStats = Stats.Hands[HandIndex];
+	const double Seconds = (Time - HandStates[HandIndex].DropoutStart) / 1000000.0;
+	HandStats.DropoutSeconds += Seconds;
+	HandStats.LongestDropoutSeconds = FMath::Max(HandStats.LongestDropoutSeconds, Seconds);
+}
+
+void FLeapSessionAnalyzer::Finish(FLeapSessionStats& OutStats)
+{
+	// A hand still missing at the end was missing until the end
+	const int64 EndTime = LastTime + FMath::Max<int64>(FrameMicros, 0);
+	for (int32 HandIndex = 0; HandIndex < LeapMotionArchive::NumHands; HandIndex++)
+	{
+		if (HandStates[HandIndex].bSeen && !HandStates[HandIndex].bWasVisible)
+		{
+			EndDropout(HandIndex, EndTime);
+		}
+	}
+	Stats.NumSessions = 1;
+	Stats.DurationSeconds = Stats.NumFrames > 0 ? (EndTime - FirstTime) / 1000000.0 : 0.0;
+	OutStats = MoveTemp(Stats);
+}
+
+int64 FLeapSessionAnalyzer::GetMedianFrameMicros(const TArray<FLeapMotionArchiveFrame>& Frames)
+{
+	TArray<int64> Deltas;
+	for (int32 Index = 1; Index < Frames.Num(); Index++)
+	{
+		Deltas.Add(Frames[Index].TimeMicros - Frames[Index - 1].TimeMicros);
+	}
+	if (Deltas.Num() == 0)
+	{
+		return 0;
+	}
+	Deltas.Sort();
+	return Deltas[Deltas.Num() / 2];
+}
+
+uint64 FLeapSessionAnalyzer::GetChannelMask(const ELeapSessionMetrics Metrics)
+{
+	uint64 Mask = 0;
+	for (int32 HandIndex = 0; HandIndex < LeapMotionArchive::NumHands; HandIndex++)
+	{
+		if (EnumHasAnyFlags(Metrics, ELeapSessionMetrics::Jitter | ELeapSessionMetrics::Velocity))
+		{
+			Mask |= LeapMotionArchive::ChannelBit(HandIndex, LeapMotionArchive::PalmPositionChannel);
+		}
+		if (EnumHasAnyFlags(Metrics, ELeapSessionMetrics::Pinch))
+		{
+			Mask |= LeapMotionArchive::ChannelBit(HandIndex, LeapMotionArchive::StrengthChannel);
+		}
+	}
+	return Mask;
+}
+
+bool FLeapSessionAnalyzer::AnalyzeFile(
+	const FString& Path, const FLeapSessionAnalyticsSettings& Settings, FLeapSessionStats& OutStats)
+{
+	TUniquePtr<FLeapSessionAnalyzer> Analyzer;
+	TArray<FLeapMotionArchiveFrame> Frames;
+	auto AddChunk = [&Analyzer, &Frames, &Settings]() {
+		if (!Analyzer.IsValid())
+		{
+			Analyzer = MakeUnique<FLeapSessionAnalyzer>(Settings, GetMedianFrameMicros(Frames));
+		}
+		for (const FLeapMotionArchiveFrame& Frame : Frames)
+		{
+			Analyzer->AddFrame(Frame);
+		}
+	};
+
+	if (FPaths::GetExtension(Path).Equals(TEXT("ulma"), ESearchCase::IgnoreCase))
+	{
+		// Only the channels the metrics use are decoded
+		FLeapMotionArchiveReader Reader;
+		if (!Reader.Open(Path))
+		{
+			return false;
+		}
+		const uint64 ChannelMask = GetChannelMask(Settings.Metrics);
+		for (int64 Start = Reader.GetStartTime(); Reader.GetNumFrames() > 0 && Start <= Reader.GetEndTime(); Start += ChunkMicros)
+		{
+			if (!Reader.Read(Start, Start + ChunkMicros - 1, ChannelMask, Frames))
+			{
+				return false;
+			}
+			AddChunk();
+		}
+	}
+	else
+	{
+		// LeapC recordings are loaded whole by the replay wrapper, only the converted frames are chunked
+		FLeapReplayWrapper Replay;
+		if (!Replay.LoadRecording(Path))
+		{
+			return false;
+		}
+		FLeapFrameData LeapFrame;
+		FLeapJointCache Joints;
+		const int32 NumRecordedFrames = Replay.GetNumRecordedFrames();
+		for (int32 Index = 0; Index < NumRecordedFrames; Index++)
+		{
+			LEAP_TRACKING_EVENT* Event = Replay.GetRecordedFrame(Index);
+			LeapFrame.SetFromLeapFrame(Event);
+			Joints.SetFromFrame(LeapFrame);
+			Frames.AddDefaulted_GetRef().SetFromJoints(Joints, Event->info.timestamp);
+			if (Frames.Num() == 1024 || Index == NumRecordedFrames - 1)
+			{
+				AddChunk();
+				Frames.Reset();
+			}
+		}
+	}
+
+	if (!Analyzer.IsValid())
+	{
+		Analyzer = MakeUnique<FLeapSessionAnalyzer>(Settings, 0);
+	}
+	Analyzer->Finish(OutStats);
+	OutStats.Source = Path;
+	return true;
+}
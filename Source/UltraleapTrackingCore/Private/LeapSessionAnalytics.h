@@ -0,0 +1,135 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeapMotionArchive.h"
+
+class FJsonObject;
+
+enum class ELeapSessionMetrics : uint8
+{
+	None = 0,
+	/** Palm position spectrum in octave bands and second difference RMS */
+	Jitter = 1 << 0,
+	/** Pinch strength histogram */
+	Pinch = 1 << 1,
+	/** Hand visibility, hand dropouts and frame gaps */
+	Dropouts = 1 << 2,
+	/** Palm speed histogram */
+	Velocity = 1 << 3,
+	All = Jitter | Pinch | Dropouts | Velocity
+};
+ENUM_CLASS_FLAGS(ELeapSessionMetrics);
+
+struct FLeapSessionAnalyticsSettings
+{
+	ELeapSessionMetrics Metrics = ELeapSessionMetrics::All;
+	/** Frames per jitter spectrum window, windows overlap by half */
+	int32 JitterWindow = 64;
+	int32 NumPinchBins = 20;
+	/** Palm speed histogram bins in cm/s, the last bin holds everything faster */
+	float VelocityBinWidth = 10.f;
+	int32 NumVelocityBins = 30;
+
+	/** Comma separated jitter, pinch, dropouts and velocity, false on an unknown name */
+	static bool ParseMetrics(const FString& Names, ELeapSessionMetrics& OutMetrics);
+};
+
+/** Sums over one or more sessions, so totals are exact rather than averages of averages */
+struct FLeapSessionStats
+{
+	struct FHand
+	{
+		int64 VisibleFrames = 0;
+		int64 Dropouts = 0;
+		double DropoutSeconds = 0.0;
+		double LongestDropoutSeconds = 0.0;
+
+		TArray<double> JitterBandPower;
+		int64 JitterWindows = 0;
+		double JitterSquaredSum = 0.0;
+		int64 JitterSamples = 0;
+
+		TArray<int64> PinchHistogram;
+		double PinchSum = 0.0;
+
+		TArray<int64> VelocityHistogram;
+	};
+
+	FString Source;
+	int32 NumSessions = 0;
+	int64 NumFrames = 0;
+	int64 DroppedFrames = 0;
+	double DurationSeconds = 0.0;
+	FHand Hands[LeapMotionArchive::NumHands];
+
+	void Reset(const FLeapSessionAnalyticsSettings& Settings);
+	void Accumulate(const FLeapSessionStats& Other);
+
+	TSharedRef<FJsonObject> ToJson(const FLeapSessionAnalyticsSettings& Settings) const;
+	static FString GetCsvHeader(const FLeapSessionAnalyticsSettings& Settings);
+	FString ToCsvRow(const FLeapSessionAnalyticsSettings& Settings) const;
+};
+
+/**
+ * Streams the frames of one session into FLeapSessionStats. FrameMicros is the session's nominal frame interval, longer
+ * gaps count as dropped frames and break the runs the jitter and speed are measured over.
+ */
+class FLeapSessionAnalyzer
+{
+public:
+	FLeapSessionAnalyzer(const FLeapSessionAnalyticsSettings& InSettings, int64 InFrameMicros);
+
+	/** Frames in time order */
+	void AddFrame(const FLeapMotionArchiveFrame& Frame);
+
+	void Finish(FLeapSessionStats& OutStats);
+
+	/** Median interval between the frames, 0 with fewer than two */
+	static int64 GetMedianFrameMicros(const TArray<FLeapMotionArchiveFrame>& Frames);
+
+	/** Channels a motion archive has to decode for the metrics */
+	static uint64 GetChannelMask(ELeapSessionMetrics Metrics);
+
+	/** Analyze a motion archive (.ulma) or a LeapC recording, reading it in chunks */
+	static bool AnalyzeFile(const FString& Path, const FLeapSessionAnalyticsSettings& Settings, FLeapSessionStats& OutStats);
+
+private:
+	struct FHandState
+	{
+		bool bWasVisible = false;
+		bool bSeen = false;
+		int64 DropoutStart = 0;
+		/** Contiguous visible palm positions, for the second differences and the spectrum window */
+		TArray<FVector> Run;
+		int32 RunLength = 0;
+		FVector LastPosition = FVector::ZeroVector;
+		int64 LastTime = 0;
+	};
+
+	void AddHand(int32 HandIndex, const FLeapMotionArchiveFrame::FHand& Hand, int64 Time, bool bContiguous);
+	void AddJitterWindow(FLeapSessionStats::FHand& Stats, const TArray<FVector>& Positions);
+	void EndDropout(int32 HandIndex, int64 Time);
+
+	FLeapSessionAnalyticsSettings Settings;
+	int64 FrameMicros;
+	FLeapSessionStats Stats;
+	FHandState HandStates[LeapMotionArchive::NumHands];
+	int64 FirstTime;
+	int64 LastTime;
+
+	// Spectrum tables for the window size: Hann weights, DFT twiddles and the octave band of each bin
+	TArray<float> Window;
+	float WindowPower;
+	TArray<float> Cosines;
+	TArray<float> Sines;
+	TArray<int32> BinBands;
+	TArray<float> Detrended;
+};
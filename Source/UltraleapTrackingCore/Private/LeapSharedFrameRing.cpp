@@ -0,0 +1,361 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapSharedFrameRing.h"
+
+#include "HAL/IConsoleManager.h"
+#include "LeapUtility.h"
+
+static TAutoConsoleVariable<int32> CVarLeapSharedFramesMode(TEXT("leap.SharedFrames.Mode"), 0,
+	TEXT("Share tracking frames between processes on this machine. 0 off, 1 publish the device's frames, 2 consume frames "
+		 "published by another process instead of connecting to the service. Read when the tracking source starts"));
+
+static TAutoConsoleVariable<FString> CVarLeapSharedFramesName(
+	TEXT("leap.SharedFrames.Name"), TEXT("UltraleapSharedFrames"), TEXT("Name of the shared memory frame ring"));
+
+namespace
+{
+const uint32 RingMagic = 0x4C465255;	// 'URFL'
+const uint32 RingVersion = 1;
+
+// A reader that loses this many races in a row against the publisher gives up for this call
+const int32 MaxReadAttempts = 4;
+}	 // namespace
+
+struct FLeapSharedFrameRing::FRingHeader
+{
+	uint32 Magic;
+	uint32 Version;
+	uint32 NumSlots;
+	uint32 SlotSize;
+	/** Catches processes built against different LeapC headers */
+	uint32 HandSize;
+	uint32 Padding;
+
+	/** Frames published so far, the newest is in slot (WriteIndex - 1) % NumSlots */
+	std::atomic<uint64> WriteIndex;
+	/** Publisher LeapGetNow() minus the machine wide monotonic clock, in microseconds */
+	std::atomic<int64> ClockOffset;
+	/** Monotonic clock of the last publish, in microseconds */
+	std::atomic<int64> LastPublishMicros;
+
+	/** Seqlock for the device info */
+	std::atomic<uint32> DeviceSequence;
+	uint32 DeviceStatus;
+	uint32 DeviceCaps;
+	uint32 DevicePid;
+	uint32 DeviceBaseline;
+	float DeviceHFov;
+	float DeviceVFov;
+	uint32 DeviceRange;
+	char DeviceSerial[64];
+};
+
+struct alignas(64) FLeapSharedFrameRing::FSlot
+{
+	/** Odd while the publisher writes the slot */
+	std::atomic<uint32> Sequence;
+	uint32 NumHands;
+	LEAP_TRACKING_EVENT Event;
+	LEAP_HAND Hands[MaxHands];
+};
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+	"The shared frame ring needs lock free atomics, they are shared between processes");
+
+FLeapSharedFrameRing::FLeapSharedFrameRing() : Region(nullptr), Header(nullptr), Slots(nullptr), NextIndex(0)
+{
+}
+
+FLeapSharedFrameRing::~FLeapSharedFrameRing()
+{
+	Close();
+}
+
+ELeapSharedFrameMode FLeapSharedFrameRing::GetConfiguredMode()
+{
+	return (ELeapSharedFrameMode) FMath::Clamp(CVarLeapSharedFramesMode.GetValueOnAnyThread(), 0, 2);
+}
+
+FString FLeapSharedFrameRing::GetConfiguredName()
+{
+	return CVarLeapSharedFramesName.GetValueOnAnyThread();
+}
+
+int64 FLeapSharedFrameRing::GetLocalMicros()
+{
+	// QueryPerformanceCounter / CLOCK_MONOTONIC, the same for every process on the machine
+	return (int64) (FPlatformTime::Cycles64() * FPlatformTime::GetSecondsPerCycle64() * 1000000.0);
+}
+
+bool FLeapSharedFrameRing::Create(const FString& Name)
+{
+	if (!Map(Name, true))
+	{
+		return false;
+	}
+
+	FMemory::Memzero(Header, sizeof(FRingHeader));
+	FMemory::Memzero(Slots, NumSlots * sizeof(FSlot));
+	Header->NumSlots = NumSlots;
+	Header->SlotSize = sizeof(FSlot);
+	Header->HandSize = sizeof(LEAP_HAND);
+	Header->Version = RingVersion;
+
+	// Consumers only trust the region once the layout is filled in
+	std::atomic_thread_fence(std::memory_order_release);
+	Header->Magic = RingMagic;
+	NextIndex = 0;
+
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("Publishing tracking frames to shared memory %s"), *Name);
+	return true;
+}
+
+bool FLeapSharedFrameRing::Open(const FString& Name)
+{
+	if (!Map(Name, false))
+	{
+		return false;
+	}
+
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (Header->Magic != RingMagic || Header->Version != RingVersion || Header->NumSlots != NumSlots ||
+		Header->SlotSize != sizeof(FSlot) || Header->HandSize != sizeof(LEAP_HAND))
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("Shared memory %s has an incompatible frame layout"), *Name);
+		Close();
+		return false;
+	}
+
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("Consuming tracking frames from shared memory %s"), *Name);
+	return true;
+}
+
+bool FLeapSharedFrameRing::Map(const FString& Name, const bool bCreate)
+{
+	Close();
+
+	const SIZE_T Size = Align(sizeof(FRingHeader), alignof(FSlot)) + NumSlots * sizeof(FSlot);
+	const uint32 Access = bCreate ? FPlatformMemory::ESharedMemoryAccess::Read | FPlatformMemory::ESharedMemoryAccess::Write
+								  : FPlatformMemory::ESharedMemoryAccess::Read;
+	Region = FPlatformMemory::MapNamedSharedMemoryRegion(Name, bCreate, Access, Size);
+	if (!Region)
+	{
+		return false;
+	}
+	if (Region->GetSize() < Size)
+	{
+		Close();
+		return false;
+	}
+
+	Header = (FRingHeader*) Region->GetAddress();
+	Slots = (uint8*) Region->GetAddress() + Align(sizeof(FRingHeader), alignof(FSlot));
+	return true;
+}
+
+void FLeapSharedFrameRing::Close()
+{
+	if (Region)
+	{
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+	}
+	Region = nullptr;
+	Header = nullptr;
+	Slots = nullptr;
+}
+
+FLeapSharedFrameRing::FSlot& FLeapSharedFrameRing::GetSlot(const uint64 Index) const
+{
+	return ((FSlot*) Slots)[Index % NumSlots];
+}
+
+void FLeapSharedFrameRing::Publish(const LEAP_TRACKING_EVENT& Event, const int64 Now)
+{
+	if (!Header)
+	{
+		return;
+	}
+
+	FSlot& Slot = GetSlot(NextIndex);
+	const uint32 Sequence = Slot.Sequence.load(std::memory_order_relaxed);
+	Slot.Sequence.store(Sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	Slot.NumHands = FMath::Min<uint32>(Event.nHands, MaxHands);
+	Slot.Event = Event;
+	Slot.Event.nHands = Slot.NumHands;
+	Slot.Event.pHands = nullptr;
+	FMemory::Memcpy(Slot.Hands, Event.pHands, Slot.NumHands * sizeof(LEAP_HAND));
+
+	Slot.Sequence.store(Sequence + 2, std::memory_order_release);
+
+	const int64 LocalMicros = GetLocalMicros();
+	Header->ClockOffset.store(Now - LocalMicros, std::memory_order_relaxed);
+	Header->LastPublishMicros.store(LocalMicros, std::memory_order_relaxed);
+	Header->WriteIndex.store(++NextIndex, std::memory_order_release);
+}
+
+void FLeapSharedFrameRing::PublishDeviceInfo(const LEAP_DEVICE_INFO& DeviceInfo)
+{
+	if (!Header)
+	{
+		return;
+	}
+
+	const uint32 Sequence = Header->DeviceSequence.load(std::memory_order_relaxed);
+	Header->DeviceSequence.store(Sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	Header->DeviceStatus = DeviceInfo.status;
+	Header->DeviceCaps = DeviceInfo.caps;
+	Header->DevicePid = (uint32) DeviceInfo.pid;
+	Header->DeviceBaseline = DeviceInfo.baseline;
+	Header->DeviceHFov = DeviceInfo.h_fov;
+	Header->DeviceVFov = DeviceInfo.v_fov;
+	Header->DeviceRange = DeviceInfo.range;
+	FCStringAnsi::Strncpy(Header->DeviceSerial, DeviceInfo.serial ? DeviceInfo.serial : "", sizeof(Header->DeviceSerial));
+
+	Header->DeviceSequence.store(Sequence + 2, std::memory_order_release);
+}
+
+bool FLeapSharedFrameRing::ReadSlot(const uint64 Index, LEAP_TRACKING_EVENT& OutEvent, LEAP_HAND* OutHands) const
+{
+	const FSlot& Slot = GetSlot(Index);
+	for (int32 Attempt = 0; Attempt < MaxReadAttempts; Attempt++)
+	{
+		const uint32 Sequence = Slot.Sequence.load(std::memory_order_acquire);
+		if (Sequence & 1)
+		{
+			FPlatformProcess::Yield();
+			continue;
+		}
+
+		OutEvent = Slot.Event;
+		const uint32 NumHands = FMath::Min<uint32>(Slot.NumHands, MaxHands);
+		FMemory::Memcpy(OutHands, Slot.Hands, NumHands * sizeof(LEAP_HAND));
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (Slot.Sequence.load(std::memory_order_relaxed) == Sequence)
+		{
+			OutEvent.nHands = NumHands;
+			OutEvent.pHands = OutHands;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FLeapSharedFrameRing::ReadSlotTimeStamp(const uint64 Index, int64& OutTimeStamp) const
+{
+	const FSlot& Slot = GetSlot(Index);
+	for (int32 Attempt = 0; Attempt < MaxReadAttempts; Attempt++)
+	{
+		const uint32 Sequence = Slot.Sequence.load(std::memory_order_acquire);
+		if (Sequence & 1)
+		{
+			FPlatformProcess::Yield();
+			continue;
+		}
+
+		OutTimeStamp = Slot.Event.info.timestamp;
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (Slot.Sequence.load(std::memory_order_relaxed) == Sequence)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FLeapSharedFrameRing::ReadLatest(LEAP_TRACKING_EVENT& OutEvent, LEAP_HAND* OutHands) const
+{
+	if (!Header)
+	{
+		return false;
+	}
+	const uint64 WriteIndex = Header->WriteIndex.load(std::memory_order_acquire);
+	return WriteIndex > 0 && ReadSlot(WriteIndex - 1, OutEvent, OutHands);
+}
+
+bool FLeapSharedFrameRing::ReadAt(const int64 TimeStamp, LEAP_TRACKING_EVENT& OutEvent, LEAP_HAND* OutHands) const
+{
+	if (!Header)
+	{
+		return false;
+	}
+	const uint64 WriteIndex = Header->WriteIndex.load(std::memory_order_acquire);
+	if (WriteIndex == 0)
+	{
+		return false;
+	}
+
+	// Walk back from the newest frame, leaving out the slot the publisher may be overwriting next
+	const uint64 Oldest = WriteIndex > NumSlots - 1 ? WriteIndex - (NumSlots - 1) : 0;
+	uint64 Index = WriteIndex - 1;
+	for (; Index > Oldest; Index--)
+	{
+		int64 SlotTimeStamp = 0;
+		if (ReadSlotTimeStamp(Index, SlotTimeStamp) && SlotTimeStamp <= TimeStamp)
+		{
+			break;
+		}
+	}
+	return ReadSlot(Index, OutEvent, OutHands);
+}
+
+bool FLeapSharedFrameRing::ReadDeviceInfo(LEAP_DEVICE_INFO& OutDeviceInfo, char* OutSerial) const
+{
+	if (!Header)
+	{
+		return false;
+	}
+
+	for (int32 Attempt = 0; Attempt < MaxReadAttempts; Attempt++)
+	{
+		const uint32 Sequence = Header->DeviceSequence.load(std::memory_order_acquire);
+		if (Sequence == 0 || (Sequence & 1))
+		{
+			// Nothing published yet, or being written
+			FPlatformProcess::Yield();
+			continue;
+		}
+
+		OutDeviceInfo.size = sizeof(LEAP_DEVICE_INFO);
+		OutDeviceInfo.status = Header->DeviceStatus;
+		OutDeviceInfo.caps = Header->DeviceCaps;
+		OutDeviceInfo.pid = (eLeapDevicePID) Header->DevicePid;
+		OutDeviceInfo.baseline = Header->DeviceBaseline;
+		OutDeviceInfo.h_fov = Header->DeviceHFov;
+		OutDeviceInfo.v_fov = Header->DeviceVFov;
+		OutDeviceInfo.range = Header->DeviceRange;
+		FMemory::Memcpy(OutSerial, Header->DeviceSerial, sizeof(Header->DeviceSerial));
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (Header->DeviceSequence.load(std::memory_order_relaxed) == Sequence)
+		{
+			OutSerial[sizeof(Header->DeviceSerial) - 1] = 0;
+			OutDeviceInfo.serial = OutSerial;
+			OutDeviceInfo.serial_length = FCStringAnsi::Strlen(OutSerial) + 1;
+			return true;
+		}
+	}
+	return false;
+}
+
+int64 FLeapSharedFrameRing::GetPublisherNow() const
+{
+	return Header ? GetLocalMicros() + Header->ClockOffset.load(std::memory_order_relaxed) : 0;
+}
+
+bool FLeapSharedFrameRing::IsPublisherAlive(const double Seconds) const
+{
+	return Header && Header->WriteIndex.load(std::memory_order_acquire) > 0 &&
+		   GetLocalMicros() - Header->LastPublishMicros.load(std::memory_order_relaxed) < (int64) (Seconds * 1000000.0);
+}
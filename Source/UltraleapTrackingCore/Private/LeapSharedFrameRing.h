@@ -0,0 +1,95 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformMemory.h"
+#include "LeapC.h"
+
+#include <atomic>
+
+enum class ELeapSharedFrameMode : int32
+{
+	Off = 0,
+	/** Own the device and write its tracking frames into the ring */
+	Publish = 1,
+	/** Read tracking frames from a ring published by another process, see FLeapSharedFrameWrapper */
+	Consume = 2
+};
+
+/**
+ * Named shared memory ring of raw LeapC tracking frames, for several engine processes on one machine that should all
+ * see identical frames (e.g. a render cluster or a spectator instance) from a single service connection.
+ *
+ * One publisher writes every tracking event from the service thread into the next slot. Each slot is guarded by a
+ * seqlock: its sequence is odd while being written, so readers copy the slot out and retry if the sequence changed.
+ * Readers never block the publisher and there is no lock shared between processes.
+ *
+ * Configured with leap.SharedFrames.Mode and leap.SharedFrames.Name, e.g. in [SystemSettings].
+ */
+class FLeapSharedFrameRing
+{
+public:
+	static constexpr int32 MaxHands = 4;
+	static constexpr int32 NumSlots = 64;
+
+	FLeapSharedFrameRing();
+	~FLeapSharedFrameRing();
+
+	static ELeapSharedFrameMode GetConfiguredMode();
+	static FString GetConfiguredName();
+
+	/** Publisher, creates or takes over the named region */
+	bool Create(const FString& Name);
+
+	/** Consumer, fails until a publisher created the region */
+	bool Open(const FString& Name);
+
+	void Close();
+
+	bool IsOpen() const
+	{
+		return Header != nullptr;
+	}
+
+	/** Publisher, any thread but only one at a time. Now is the publisher's LeapGetNow() */
+	void Publish(const LEAP_TRACKING_EVENT& Event, int64 Now);
+	void PublishDeviceInfo(const LEAP_DEVICE_INFO& DeviceInfo);
+
+	/** Newest frame, OutHands needs MaxHands entries. False if there is none or the publisher kept overwriting it */
+	bool ReadLatest(LEAP_TRACKING_EVENT& OutEvent, LEAP_HAND* OutHands) const;
+
+	/** Newest frame at or before TimeStamp, the oldest frame still in the ring if all are newer */
+	bool ReadAt(int64 TimeStamp, LEAP_TRACKING_EVENT& OutEvent, LEAP_HAND* OutHands) const;
+
+	/** Device info of the publisher, OutSerial must have room for 64 characters */
+	bool ReadDeviceInfo(LEAP_DEVICE_INFO& OutDeviceInfo, char* OutSerial) const;
+
+	/** The publisher's LeapGetNow() clock, valid across processes on the same machine */
+	int64 GetPublisherNow() const;
+
+	/** Whether the publisher wrote a frame within Seconds */
+	bool IsPublisherAlive(double Seconds) const;
+
+private:
+	struct FRingHeader;
+	struct FSlot;
+
+	bool Map(const FString& Name, bool bCreate);
+	bool ReadSlot(uint64 Index, LEAP_TRACKING_EVENT& OutEvent, LEAP_HAND* OutHands) const;
+	bool ReadSlotTimeStamp(uint64 Index, int64& OutTimeStamp) const;
+	FSlot& GetSlot(uint64 Index) const;
+
+	static int64 GetLocalMicros();
+
+	FPlatformMemory::FSharedMemoryRegion* Region;
+	FRingHeader* Header;
+	uint8* Slots;
+	uint64 NextIndex;
+};
@@ -0,0 +1,121 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapSharedFrameWrapper.h"
+
+#include "LeapUtility.h"
+
+namespace
+{
+const double ConnectionCheckInterval = 1.0;
+
+// The service runs at 90Hz and more, a publisher that stayed quiet this long is gone
+const double PublisherTimeout = 2.0;
+}	 // namespace
+
+FLeapSharedFrameWrapper::FLeapSharedFrameWrapper(const FString& InRingName) : RingName(InRingName), LastConnectionCheck(0.0)
+{
+	Frame = {{0}};
+	InterpolatedFrame = {{0}};
+	FMemory::Memzero(FrameHands);
+	FMemory::Memzero(InterpolatedHands);
+	DeviceInfo = {0};
+	FMemory::Memzero(DeviceSerial);
+}
+
+FLeapSharedFrameWrapper::~FLeapSharedFrameWrapper()
+{
+	Ring.Close();
+}
+
+LEAP_CONNECTION* FLeapSharedFrameWrapper::OpenConnection(LeapWrapperCallbackInterface* InCallbackDelegate)
+{
+	CallbackDelegate = InCallbackDelegate;
+	LastConnectionCheck = 0.0;
+	UpdateConnection();
+	return nullptr;
+}
+
+void FLeapSharedFrameWrapper::CloseConnection()
+{
+	bIsConnected = false;
+	CallbackDelegate = nullptr;
+	CurrentDeviceInfo = nullptr;
+	Ring.Close();
+}
+
+void FLeapSharedFrameWrapper::UpdateConnection()
+{
+	const double Now = FPlatformTime::Seconds();
+	if (Now - LastConnectionCheck < ConnectionCheckInterval)
+	{
+		return;
+	}
+	LastConnectionCheck = Now;
+
+	if (!Ring.IsOpen() && !Ring.Open(RingName))
+	{
+		return;
+	}
+
+	const bool bPublisherAlive = Ring.IsPublisherAlive(PublisherTimeout);
+	if (bPublisherAlive && !bIsConnected)
+	{
+		bIsConnected = true;
+		if (CallbackDelegate)
+		{
+			CallbackDelegate->OnConnect();
+		}
+		if (Ring.ReadDeviceInfo(DeviceInfo, DeviceSerial))
+		{
+			CurrentDeviceInfo = &DeviceInfo;
+			if (CallbackDelegate)
+			{
+				CallbackDelegate->OnDeviceFound(&DeviceInfo);
+			}
+		}
+	}
+	else if (!bPublisherAlive && bIsConnected)
+	{
+		bIsConnected = false;
+		CurrentDeviceInfo = nullptr;
+		if (CallbackDelegate)
+		{
+			CallbackDelegate->OnConnectionLost();
+		}
+
+		// The publisher may come back with a new region
+		Ring.Close();
+	}
+}
+
+bool FLeapSharedFrameWrapper::IsConnected()
+{
+	UpdateConnection();
+	return bIsConnected;
+}
+
+LEAP_TRACKING_EVENT* FLeapSharedFrameWrapper::GetFrame()
+{
+	return bIsConnected && Ring.ReadLatest(Frame, FrameHands) ? &Frame : nullptr;
+}
+
+LEAP_TRACKING_EVENT* FLeapSharedFrameWrapper::GetInterpolatedFrameAtTime(int64 TimeStamp)
+{
+	return bIsConnected && Ring.ReadAt(TimeStamp, InterpolatedFrame, InterpolatedHands) ? &InterpolatedFrame : nullptr;
+}
+
+LEAP_DEVICE_INFO* FLeapSharedFrameWrapper::GetDeviceProperties()
+{
+	return CurrentDeviceInfo;
+}
+
+int64_t FLeapSharedFrameWrapper::GetNow()
+{
+	return Ring.GetPublisherNow();
+}
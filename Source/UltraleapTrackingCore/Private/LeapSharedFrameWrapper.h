@@ -0,0 +1,54 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeapSharedFrameRing.h"
+#include "LeapWrapper.h"
+
+/**
+ * Feeds the input device from a shared frame ring published by another process instead of the service.
+ *
+ * Frames are read straight out of the ring into the wrapper's own buffers, the only copy. Interpolated frames return
+ * the published frame at or before the requested time on the publisher's clock rather than interpolating, so every
+ * consumer asking for the same time gets the identical frame. Connects once a publisher is writing frames and
+ * reports the connection lost when it stops.
+ */
+class FLeapSharedFrameWrapper : public FLeapWrapperBase
+{
+public:
+	FLeapSharedFrameWrapper(const FString& InRingName);
+	virtual ~FLeapSharedFrameWrapper();
+
+	// FLeapWrapperBase overrides
+	virtual LEAP_CONNECTION* OpenConnection(LeapWrapperCallbackInterface* InCallbackDelegate) override;
+	virtual void CloseConnection() override;
+	virtual LEAP_TRACKING_EVENT* GetFrame() override;
+	virtual LEAP_TRACKING_EVENT* GetInterpolatedFrameAtTime(int64 TimeStamp) override;
+	virtual LEAP_DEVICE_INFO* GetDeviceProperties() override;
+	virtual bool IsConnected() override;
+	virtual int64_t GetNow() override;
+
+private:
+	/** Track the publisher coming and going, at most once a second */
+	void UpdateConnection();
+
+	FString RingName;
+	FLeapSharedFrameRing Ring;
+
+	LEAP_TRACKING_EVENT Frame;
+	LEAP_HAND FrameHands[FLeapSharedFrameRing::MaxHands];
+	LEAP_TRACKING_EVENT InterpolatedFrame;
+	LEAP_HAND InterpolatedHands[FLeapSharedFrameRing::MaxHands];
+
+	LEAP_DEVICE_INFO DeviceInfo;
+	char DeviceSerial[64];
+
+	double LastConnectionCheck;
+};
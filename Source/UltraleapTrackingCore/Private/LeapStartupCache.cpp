@@ -0,0 +1,169 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapStartupCache.h"
+
+#include "HAL/IConsoleManager.h"
+#include "LeapUtility.h"
+#include "Misc/ConfigCacheIni.h"
+
+static TAutoConsoleVariable<int32> CVarLeapStartupCache(TEXT("leap.Startup.Cache"), 1,
+	TEXT("Remember the last device and the tracking mode the game asked for between sessions, and apply them while the "
+		 "connection opens"));
+
+const TCHAR* FLeapStartupCache::DefaultSection = TEXT("UltraleapTracking.StartupCache");
+
+bool FLeapStartupCache::IsEnabled()
+{
+	return CVarLeapStartupCache.GetValueOnGameThread() != 0;
+}
+
+FLeapStartupCache::FLeapStartupCache()
+	: bHasDevice(false)
+	, Mode(LEAP_MODE_DESKTOP)
+	, bHasMode(false)
+	, ConnectionTime(0)
+	, MapLoadedTime(0)
+	, bWaitingForFirstHand(false)
+	, bWaitingAfterMapLoad(false)
+{
+	Device.Status = 0;
+	Device.Caps = 0;
+	Device.Baseline = 0;
+	Device.HorizontalFOV = 0;
+	Device.VerticalFOV = 0;
+	Device.Range = 0;
+}
+
+bool FLeapStartupCache::Load(const TCHAR* Section)
+{
+	if (!GConfig)
+	{
+		return false;
+	}
+
+	FLeapDevice Loaded = Device;
+	bHasDevice = GConfig->GetString(Section, TEXT("Serial"), Loaded.Serial, GGameUserSettingsIni) && !Loaded.Serial.IsEmpty();
+	if (bHasDevice)
+	{
+		GConfig->GetString(Section, TEXT("PID"), Loaded.PID, GGameUserSettingsIni);
+		GConfig->GetInt(Section, TEXT("Baseline"), Loaded.Baseline, GGameUserSettingsIni);
+		GConfig->GetFloat(Section, TEXT("HorizontalFOV"), Loaded.HorizontalFOV, GGameUserSettingsIni);
+		GConfig->GetFloat(Section, TEXT("VerticalFOV"), Loaded.VerticalFOV, GGameUserSettingsIni);
+		GConfig->GetInt(Section, TEXT("Range"), Loaded.Range, GGameUserSettingsIni);
+		Device = Loaded;
+		LoadedSerial = Loaded.Serial;
+	}
+
+	int32 LoadedMode = 0;
+	bHasMode = GConfig->GetInt(Section, TEXT("TrackingMode"), LoadedMode, GGameUserSettingsIni) && LoadedMode >= LEAP_MODE_VR &&
+			   LoadedMode <= LEAP_MODE_SCREENTOP;
+	if (bHasMode)
+	{
+		Mode = (ELeapMode) LoadedMode;
+	}
+	return bHasDevice || bHasMode;
+}
+
+void FLeapStartupCache::Save(const TCHAR* Section) const
+{
+	if (!GConfig)
+	{
+		return;
+	}
+
+	if (bHasDevice)
+	{
+		GConfig->SetString(Section, TEXT("Serial"), *Device.Serial, GGameUserSettingsIni);
+		GConfig->SetString(Section, TEXT("PID"), *Device.PID, GGameUserSettingsIni);
+		GConfig->SetInt(Section, TEXT("Baseline"), Device.Baseline, GGameUserSettingsIni);
+		GConfig->SetFloat(Section, TEXT("HorizontalFOV"), Device.HorizontalFOV, GGameUserSettingsIni);
+		GConfig->SetFloat(Section, TEXT("VerticalFOV"), Device.VerticalFOV, GGameUserSettingsIni);
+		GConfig->SetInt(Section, TEXT("Range"), Device.Range, GGameUserSettingsIni);
+	}
+	if (bHasMode)
+	{
+		GConfig->SetInt(Section, TEXT("TrackingMode"), (int32) Mode, GGameUserSettingsIni);
+	}
+	GConfig->Flush(false, GGameUserSettingsIni);
+}
+
+bool FLeapStartupCache::SetDevice(const FLeapDevice& InDevice)
+{
+	const bool bChanged = !bHasDevice || Device.Serial != InDevice.Serial || Device.PID != InDevice.PID ||
+						  Device.Baseline != InDevice.Baseline || Device.HorizontalFOV != InDevice.HorizontalFOV ||
+						  Device.VerticalFOV != InDevice.VerticalFOV || Device.Range != InDevice.Range;
+	Device = InDevice;
+	bHasDevice = true;
+	return bChanged;
+}
+
+bool FLeapStartupCache::SetMode(ELeapMode InMode)
+{
+	const bool bChanged = !bHasMode || Mode != InMode;
+	Mode = InMode;
+	bHasMode = true;
+	return bChanged;
+}
+
+void FLeapStartupCache::BeginConnection(double Now)
+{
+	Stats = FLeapStartupStats();
+	ConnectionTime = Now;
+	bWaitingForFirstHand = true;
+}
+
+void FLeapStartupCache::NoteConnected(double Now)
+{
+	if (bWaitingForFirstHand && Stats.ConnectedMS == 0)
+	{
+		Stats.ConnectedMS = ToMS(Now - ConnectionTime);
+	}
+}
+
+void FLeapStartupCache::NoteDeviceFound(double Now, const FString& Serial)
+{
+	if (bWaitingForFirstHand && Stats.DeviceFoundMS == 0)
+	{
+		Stats.DeviceFoundMS = ToMS(Now - ConnectionTime);
+		Stats.bUsedCachedDevice = !LoadedSerial.IsEmpty() && LoadedSerial == Serial;
+	}
+}
+
+void FLeapStartupCache::NoteMapLoaded(double Now)
+{
+	Stats.MapLoadToHandMS = 0;
+	MapLoadedTime = Now;
+	bWaitingAfterMapLoad = true;
+}
+
+void FLeapStartupCache::NoteFrame(double Now, int32 NumHands)
+{
+	if (bWaitingForFirstHand)
+	{
+		if (Stats.FirstFrameMS == 0)
+		{
+			Stats.FirstFrameMS = ToMS(Now - ConnectionTime);
+		}
+		if (NumHands > 0)
+		{
+			bWaitingForFirstHand = false;
+			Stats.FirstHandMS = ToMS(Now - ConnectionTime);
+			UE_LOG(UltraleapTrackingLog, Log,
+				TEXT("Time to first hand %.0f ms: connected %.0f ms, device %.0f ms%s, first frame %.0f ms."), Stats.FirstHandMS,
+				Stats.ConnectedMS, Stats.DeviceFoundMS, Stats.bUsedCachedDevice ? TEXT(" (cached)") : TEXT(""),
+				Stats.FirstFrameMS);
+		}
+	}
+	if (bWaitingAfterMapLoad && NumHands > 0)
+	{
+		bWaitingAfterMapLoad = false;
+		Stats.MapLoadToHandMS = ToMS(Now - MapLoadedTime);
+		UE_LOG(UltraleapTrackingLog, Verbose, TEXT("Hands tracked %.0f ms after the map load."), Stats.MapLoadToHandMS);
+	}
+}
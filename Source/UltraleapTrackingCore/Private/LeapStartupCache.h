@@ -0,0 +1,104 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UltraleapTrackingData.h"
+
+/**
+ * Startup state kept between sessions and the time to first hand, game thread only.
+ *
+ * The last device found and the tracking mode the game last asked for are kept in the user settings (leap.Startup.Cache).
+ * The input device applies them while the connection opens: the device info is known before the service reports it and
+ * the mode is requested as soon as the service connects, so there is no mode switch once the game sets the same options.
+ *
+ * Also times each stage from opening the connection to the first frame with hands, and hands after each map load.
+ */
+class FLeapStartupCache
+{
+public:
+	/** Section of the user settings holding the cache */
+	static const TCHAR* DefaultSection;
+
+	/** Whether the cache is read and written, see leap.Startup.Cache */
+	static bool IsEnabled();
+
+	FLeapStartupCache();
+
+	/** Read the state saved by the last session, false if there was none */
+	bool Load(const TCHAR* Section = DefaultSection);
+
+	/** Write the state to the user settings and flush them, the next session may start after a crash */
+	void Save(const TCHAR* Section = DefaultSection) const;
+
+	bool HasDevice() const
+	{
+		return bHasDevice;
+	}
+	const FLeapDevice& GetDevice() const
+	{
+		return Device;
+	}
+	bool HasMode() const
+	{
+		return bHasMode;
+	}
+	ELeapMode GetMode() const
+	{
+		return Mode;
+	}
+
+	/** Remember the device found, true if it differs from the one cached */
+	bool SetDevice(const FLeapDevice& InDevice);
+
+	/** Remember the mode the game asked for, true if it differs from the one cached */
+	bool SetMode(ELeapMode InMode);
+
+	/** The connection was opened, timing starts over */
+	void BeginConnection(double Now);
+	void NoteConnected(double Now);
+	void NoteDeviceFound(double Now, const FString& Serial);
+
+	/** Time the next frame with hands from the end of a map load */
+	void NoteMapLoaded(double Now);
+
+	/** Whether a frame or hands are still awaited, NoteFrame is only needed while true */
+	bool IsWaitingForFrames() const
+	{
+		return bWaitingForFirstHand || bWaitingAfterMapLoad;
+	}
+
+	/** A frame was captured */
+	void NoteFrame(double Now, int32 NumHands);
+
+	const FLeapStartupStats& GetStats() const
+	{
+		return Stats;
+	}
+
+private:
+	static float ToMS(double Seconds)
+	{
+		return (float) (Seconds * 1000.0);
+	}
+
+	FLeapDevice Device;
+	bool bHasDevice;
+	ELeapMode Mode;
+	bool bHasMode;
+
+	// Serial loaded from the last session, to tell whether the same device came back
+	FString LoadedSerial;
+
+	FLeapStartupStats Stats;
+	double ConnectionTime;
+	double MapLoadedTime;
+	bool bWaitingForFirstHand;
+	bool bWaitingAfterMapLoad;
+};
@@ -0,0 +1,75 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapStats.h"
+
+UE_TRACE_CHANNEL_DEFINE(UltraleapChannel);
+
+#if ENGINE_MAJOR_VERSION >= 5
+LLM_DEFINE_TAG(Ultraleap);
+LLM_DEFINE_TAG(Ultraleap_Service, TEXT("Service"), TEXT("Ultraleap"));
+LLM_DEFINE_TAG(Ultraleap_Frames, TEXT("Frames"), TEXT("Ultraleap"));
+LLM_DEFINE_TAG(Ultraleap_BodyState, TEXT("BodyState"), TEXT("Ultraleap"));
+LLM_DEFINE_TAG(Ultraleap_Images, TEXT("Images"), TEXT("Ultraleap"));
+LLM_DEFINE_TAG(Ultraleap_LiveLink, TEXT("LiveLink"), TEXT("Ultraleap"));
+LLM_DEFINE_TAG(Ultraleap_LeapC, TEXT("LeapC"), TEXT("Ultraleap"));
+#endif
+
+DEFINE_STAT(STAT_LeapInputTick);
+DEFINE_STAT(STAT_LeapGetFrame);
+DEFINE_STAT(STAT_LeapInterpolation);
+DEFINE_STAT(STAT_LeapFrameConversion);
+DEFINE_STAT(STAT_LeapJointSmoothing);
+DEFINE_STAT(STAT_LeapOpenXRConversion);
+DEFINE_STAT(STAT_LeapHMDTransform);
+DEFINE_STAT(STAT_LeapGestureChecks);
+DEFINE_STAT(STAT_LeapGestureRecognition);
+DEFINE_STAT(STAT_LeapDelegateBroadcast);
+
+DEFINE_STAT(STAT_LeapBodyStateTick);
+DEFINE_STAT(STAT_LeapLiveLinkUpdate);
+DEFINE_STAT(STAT_LeapTrackingServer);
+DEFINE_STAT(STAT_LeapImageUpload);
+
+DEFINE_STAT(STAT_LeapServiceTrackingEvent);
+DEFINE_STAT(STAT_LeapServiceFrameProcessing);
+DEFINE_STAT(STAT_LeapServiceConnected);
+DEFINE_STAT(STAT_LeapServiceReconnectAttempts);
+DEFINE_STAT(STAT_LeapServiceConnectionsLost);
+
+DEFINE_STAT(STAT_LeapPoolBytesInUse);
+DEFINE_STAT(STAT_LeapPoolBytesFree);
+DEFINE_STAT(STAT_LeapPoolMisses);
+
+DEFINE_STAT(STAT_LeapFramesReceived);
+DEFINE_STAT(STAT_LeapFramesSkipped);
+DEFINE_STAT(STAT_LeapFramesDropped);
+DEFINE_STAT(STAT_LeapInterpolations);
+DEFINE_STAT(STAT_LeapHandsTracked);
+DEFINE_STAT(STAT_LeapServerFailedSends);
+
+DEFINE_STAT(STAT_LeapLatencyServiceP50);
+DEFINE_STAT(STAT_LeapLatencyServiceP99);
+DEFINE_STAT(STAT_LeapLatencyGameThreadP50);
+DEFINE_STAT(STAT_LeapLatencyGameThreadP99);
+DEFINE_STAT(STAT_LeapLatencyAnimP50);
+DEFINE_STAT(STAT_LeapLatencyAnimP99);
+DEFINE_STAT(STAT_LeapLatencyRenderP50);
+DEFINE_STAT(STAT_LeapLatencyRenderP99);
+
+TRACE_DECLARE_INT_COUNTER(LeapFramesReceived, TEXT("Ultraleap/FramesReceived"));
+TRACE_DECLARE_INT_COUNTER(LeapFramesSkipped, TEXT("Ultraleap/FramesSkipped"));
+TRACE_DECLARE_INT_COUNTER(LeapFramesDropped, TEXT("Ultraleap/FramesDropped"));
+TRACE_DECLARE_INT_COUNTER(LeapInterpolations, TEXT("Ultraleap/Interpolations"));
+TRACE_DECLARE_INT_COUNTER(LeapHandsTracked, TEXT("Ultraleap/HandsTracked"));
+TRACE_DECLARE_INT_COUNTER(LeapServerFailedSends, TEXT("Ultraleap/ServerFailedSends"));
+TRACE_DECLARE_INT_COUNTER(LeapServiceConnected, TEXT("Ultraleap/ServiceConnected"));
+TRACE_DECLARE_INT_COUNTER(LeapServiceReconnectAttempts, TEXT("Ultraleap/ServiceReconnectAttempts"));
+TRACE_DECLARE_INT_COUNTER(LeapServiceConnectionsLost, TEXT("Ultraleap/ServiceConnectionsLost"));
+TRACE_DECLARE_MEMORY_COUNTER(LeapPoolBytesInUse, TEXT("Ultraleap/PoolBytesInUse"));
+TRACE_DECLARE_MEMORY_COUNTER(LeapPoolBytesFree, TEXT("Ultraleap/PoolBytesFree"));
@@ -0,0 +1,121 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+/**
+ * Profiling for the hand tracking pipeline.
+ *
+ * Every stage is a cycle stat in STATGROUP_UltraleapTracking ("stat UltraleapTracking") and a CPU event on
+ * the Ultraleap trace channel, so a capture made with -trace=cpu,ultraleap shows the stages even with
+ * named stat events off. Counters go to both the stat group and Insights.
+ *
+ * Memory is tagged per subsystem for LLM (-llm, stat LLM), under an Ultraleap parent tag.
+ */
+
+DECLARE_STATS_GROUP(TEXT("UltraleapTracking"), STATGROUP_UltraleapTracking, STATCAT_Advanced);
+
+UE_TRACE_CHANNEL_EXTERN(UltraleapChannel);
+
+// Game thread input tick and its stages
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Leap Game Input and Events"), STAT_LeapInputTick, STATGROUP_UltraleapTracking, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Leap Get Frame"), STAT_LeapGetFrame, STATGROUP_UltraleapTracking, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Leap Interpolation"), STAT_LeapInterpolation, STATGROUP_UltraleapTracking, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Leap Frame Conversion"), STAT_LeapFrameConversion, STATGROUP_UltraleapTracking, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Leap Joint Smoothing"), STAT_LeapJointSmoothing, STATGROUP_UltraleapTracking, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Leap OpenXR Conversion"), STAT_LeapOpenXRConversion, STATGROUP_UltraleapTracking, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Leap HMD Transform"), STAT_LeapHMDTransform, STATGROUP_UltraleapTracking, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Leap Gesture Checks"), STAT_LeapGestureChecks, STATGROUP_UltraleapTracking, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Leap Gesture Recognition"), STAT_LeapGestureRecognition, STATGROUP_UltraleapTracking, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Leap Delegate Broadcast"), STAT_LeapDelegateBroadcast, STATGROUP_UltraleapTracking, );
+
+// BodyState, LiveLink, tracking server and images
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Leap BodyState Tick"), STAT_LeapBodyStateTick, STATGROUP_UltraleapTracking, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Leap LiveLink Update"), STAT_LeapLiveLinkUpdate, STATGROUP_UltraleapTracking, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Leap Tracking Server"), STAT_LeapTrackingServer, STATGROUP_UltraleapTracking, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Leap Image Upload"), STAT_LeapImageUpload, STATGROUP_UltraleapTracking, );
+
+// LeapC service thread
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Leap Service Tracking Event"), STAT_LeapServiceTrackingEvent, STATGROUP_UltraleapTracking, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Leap Service Frame Processing"), STAT_LeapServiceFrameProcessing, STATGROUP_UltraleapTracking, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Leap Service Connected"), STAT_LeapServiceConnected, STATGROUP_UltraleapTracking, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(
+	TEXT("Leap Service Reconnect Attempts"), STAT_LeapServiceReconnectAttempts, STATGROUP_UltraleapTracking, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(
+	TEXT("Leap Service Connections Lost"), STAT_LeapServiceConnectionsLost, STATGROUP_UltraleapTracking, );
+
+// LeapC allocations served by FLeapPooledAllocator
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Leap Pool In Use"), STAT_LeapPoolBytesInUse, STATGROUP_UltraleapTracking, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Leap Pool Free"), STAT_LeapPoolBytesFree, STATGROUP_UltraleapTracking, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Leap Pool Misses"), STAT_LeapPoolMisses, STATGROUP_UltraleapTracking, );
+
+// Counters, the stat versions are per frame
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Leap Frames Received"), STAT_LeapFramesReceived, STATGROUP_UltraleapTracking, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Leap Frames Skipped"), STAT_LeapFramesSkipped, STATGROUP_UltraleapTracking, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Leap Frames Dropped"), STAT_LeapFramesDropped, STATGROUP_UltraleapTracking, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Leap Interpolations"), STAT_LeapInterpolations, STATGROUP_UltraleapTracking, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Leap Hands Tracked"), STAT_LeapHandsTracked, STATGROUP_UltraleapTracking, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Leap Server Failed Sends"), STAT_LeapServerFailedSends, STATGROUP_UltraleapTracking, );
+
+// Rolling hand data latency in milliseconds, see FLeapLatencyTracker
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Leap Latency Service P50"), STAT_LeapLatencyServiceP50, STATGROUP_UltraleapTracking, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Leap Latency Service P99"), STAT_LeapLatencyServiceP99, STATGROUP_UltraleapTracking, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Leap Latency Game Thread P50"), STAT_LeapLatencyGameThreadP50, STATGROUP_UltraleapTracking, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Leap Latency Game Thread P99"), STAT_LeapLatencyGameThreadP99, STATGROUP_UltraleapTracking, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Leap Latency Anim P50"), STAT_LeapLatencyAnimP50, STATGROUP_UltraleapTracking, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Leap Latency Anim P99"), STAT_LeapLatencyAnimP99, STATGROUP_UltraleapTracking, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Leap Latency Render P50"), STAT_LeapLatencyRenderP50, STATGROUP_UltraleapTracking, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Leap Latency Render P99"), STAT_LeapLatencyRenderP99, STATGROUP_UltraleapTracking, );
+
+TRACE_DECLARE_INT_COUNTER_EXTERN(LeapFramesReceived);
+TRACE_DECLARE_INT_COUNTER_EXTERN(LeapFramesSkipped);
+TRACE_DECLARE_INT_COUNTER_EXTERN(LeapFramesDropped);
+TRACE_DECLARE_INT_COUNTER_EXTERN(LeapInterpolations);
+TRACE_DECLARE_INT_COUNTER_EXTERN(LeapHandsTracked);
+TRACE_DECLARE_INT_COUNTER_EXTERN(LeapServerFailedSends);
+TRACE_DECLARE_INT_COUNTER_EXTERN(LeapServiceConnected);
+TRACE_DECLARE_INT_COUNTER_EXTERN(LeapServiceReconnectAttempts);
+TRACE_DECLARE_INT_COUNTER_EXTERN(LeapServiceConnectionsLost);
+TRACE_DECLARE_MEMORY_COUNTER_EXTERN(LeapPoolBytesInUse);
+TRACE_DECLARE_MEMORY_COUNTER_EXTERN(LeapPoolBytesFree);
+
+#if ENGINE_MAJOR_VERSION >= 5
+LLM_DECLARE_TAG(Ultraleap);
+LLM_DECLARE_TAG(Ultraleap_Service);
+LLM_DECLARE_TAG(Ultraleap_Frames);
+LLM_DECLARE_TAG(Ultraleap_BodyState);
+LLM_DECLARE_TAG(Ultraleap_Images);
+LLM_DECLARE_TAG(Ultraleap_LiveLink);
+LLM_DECLARE_TAG(Ultraleap_LeapC);
+
+/** Attribute the allocations of the rest of the scope to an Ultraleap LLM tag */
+#define LEAP_LLM_SCOPE(Tag) LLM_SCOPE_BYTAG(Tag)
+#else
+#define LEAP_LLM_SCOPE(Tag)
+#endif
+
+/** Cycle stat and Ultraleap channel trace event for the rest of the scope */
+#define LEAP_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat);         \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, UltraleapChannel)
+
+/** Bump a counter in both the stat group and Insights, Name without the STAT_ prefix */
+#define LEAP_INC_COUNTER(Name) \
+	INC_DWORD_STAT(STAT_##Name); \
+	TRACE_COUNTER_INCREMENT(Name)
+
+#define LEAP_SET_COUNTER(Name, Value)  \
+	SET_DWORD_STAT(STAT_##Name, Value); \
+	TRACE_COUNTER_SET(Name, Value)
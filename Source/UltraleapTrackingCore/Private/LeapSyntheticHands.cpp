@@ -0,0 +1,156 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapSyntheticHands.h"
+
+#include "Math/RandomStream.h"
+#include "UltraleapTrackingData.h"
+
+namespace
+{
+// Rough adult hand in mm, metacarpal to distal
+const float BoneLengths[5][4] = {
+	{0.f, 40.f, 30.f, 25.f},	// thumb, zero length metacarpal as LeapC reports it
+	{65.f, 40.f, 25.f, 20.f},
+	{62.f, 45.f, 28.f, 20.f},
+	{58.f, 42.f, 27.f, 20.f},
+	{52.f, 33.f, 20.f, 18.f},
+};
+
+// Knuckle offsets from the wrist across the palm (x) and towards the fingers (z)
+const float KnuckleOffsets[5][2] = {{-20.f, -20.f}, {-25.f, 0.f}, {-5.f, 0.f}, {15.f, 0.f}, {35.f, 0.f}};
+
+LEAP_VECTOR ToLeap(const FVector& Vector)
+{
+	LEAP_VECTOR Ret;
+	Ret.x = Vector.X;
+	Ret.y = Vector.Y;
+	Ret.z = Vector.Z;
+	return Ret;
+}
+
+LEAP_QUATERNION ToLeap(const FQuat& Quat)
+{
+	LEAP_QUATERNION Ret;
+	Ret.x = Quat.X;
+	Ret.y = Quat.Y;
+	Ret.z = Quat.Z;
+	Ret.w = Quat.W;
+	return Ret;
+}
+}	 // namespace
+
+FLeapSyntheticHands::FLeapSyntheticHands(const int32 InNumHands, const int32 InSeed)
+	: bDropouts(true), DropoutPeriod(5.f), DropoutDuration(0.5f), FrameRate(120.f)
+{
+	NumHands = FMath::Clamp(InNumHands, 0, MaxHands);
+
+	FRandomStream Random(InSeed);
+	for (int32 HandIndex = 0; HandIndex < MaxHands; HandIndex++)
+	{
+		Phase[HandIndex] = Random.FRandRange(0.f, 2.f * PI);
+	}
+}
+
+void FLeapSyntheticHands::Generate(const int64 InTime, LEAP_TRACKING_EVENT& OutEvent, LEAP_HAND* OutHands) const
+{
+	const float Seconds = InTime / 1000000.f;
+
+	OutEvent.info.reserved = nullptr;
+	OutEvent.info.timestamp = InTime;
+	OutEvent.info.frame_id = (int64_t)(Seconds * FrameRate);
+	OutEvent.tracking_frame_id = OutEvent.info.frame_id;
+	OutEvent.framerate = FrameRate;
+	OutEvent.pHands = OutHands;
+	OutEvent.nHands = 0;
+
+	for (int32 HandIndex = 0; HandIndex < NumHands; HandIndex++)
+	{
+		const bool bDroppedOut = bDropouts && HandIndex == 1 && FMath::Fmod(Seconds, DropoutPeriod) < DropoutDuration;
+		if (!bDroppedOut)
+		{
+			GenerateHand(HandIndex, Seconds, OutHands[OutEvent.nHands++]);
+		}
+	}
+}
+
+void FLeapSyntheticHands::GenerateFrame(const int64 InTime, FLeapFrameData& OutFrame) const
+{
+	LEAP_TRACKING_EVENT Event;
+	LEAP_HAND Hands[MaxHands];
+	FMemory::Memzero(Event);
+	Generate(InTime, Event, Hands);
+	OutFrame.SetFromLeapFrame(&Event);
+}
+
+void FLeapSyntheticHands::GenerateHand(const int32 HandIndex, const float Seconds, LEAP_HAND& OutHand) const
+{
+	FMemory::Memzero(OutHand);
+
+	const bool bLeft = HandIndex == 0;
+	const float Side = bLeft ? -1.f : 1.f;
+	const float T = Seconds + Phase[HandIndex];
+
+	// A new id each time the hand comes back, like the service does
+	const int32 Reappearances = (bDropouts && DropoutPeriod > 0.f) ? (int32)(Seconds / DropoutPeriod) : 0;
+	OutHand.id = (HandIndex + 1) * 1000 + (bLeft ? 0 : Reappearances);
+	OutHand.type = bLeft ? eLeapHandType_Left : eLeapHandType_Right;
+	OutHand.confidence = 1.f;
+	OutHand.visible_time = (uint64_t)(Seconds * 1000000.f);
+
+	// 0 open, 1 fist, cycling roughly every two seconds
+	const float Curl = 0.5f + 0.5f * FMath::Sin(T * PI);
+	OutHand.grab_strength = Curl;
+	OutHand.grab_angle = Curl * PI;
+	OutHand.pinch_strength = FMath::Clamp(Curl * 1.2f, 0.f, 1.f);
+	OutHand.pinch_distance = (1.f - OutHand.pinch_strength) * 60.f;
+
+	// Leap space: y up from the device, z towards the user
+	const FVector Wrist(Side * 80.f + 30.f * FMath::Sin(T * 0.7f), 200.f + 25.f * FMath::Sin(T * 1.1f), 40.f * FMath::Cos(T * 0.5f));
+	const FQuat HandRotation(FVector::UpVector, Side * 0.2f * FMath::Sin(T * 0.3f));
+	const FVector Forward = HandRotation.RotateVector(FVector(0.f, 0.f, -1.f));
+	const FVector Across = HandRotation.RotateVector(FVector(Side, 0.f, 0.f));
+
+	OutHand.arm.prev_joint = ToLeap(Wrist - Forward * 250.f);
+	OutHand.arm.next_joint = ToLeap(Wrist);
+	OutHand.arm.rotation = ToLeap(HandRotation);
+	OutHand.arm.width = 60.f;
+
+	const FVector PalmCenter = Wrist + Forward * 50.f;
+	OutHand.palm.position = ToLeap(PalmCenter);
+	OutHand.palm.stabilized_position = OutHand.palm.position;
+	OutHand.palm.normal = ToLeap(FVector(0.f, -1.f, 0.f));
+	OutHand.palm.direction = ToLeap(Forward);
+	OutHand.palm.orientation = ToLeap(HandRotation);
+	OutHand.palm.width = 85.f;
+
+	for (int32 DigitIndex = 0; DigitIndex < 5; DigitIndex++)
+	{
+		LEAP_DIGIT& Digit = OutHand.digits[DigitIndex];
+		Digit.finger_id = OutHand.id * 10 + DigitIndex;
+		Digit.is_extended = Curl < 0.5f;
+
+		FVector Joint = Wrist + Across * KnuckleOffsets[DigitIndex][0] + Forward * KnuckleOffsets[DigitIndex][1];
+		FQuat BoneRotation = HandRotation;
+		for (int32 BoneIndex = 0; BoneIndex < 4; BoneIndex++)
+		{
+			// Metacarpals stay put, the phalanges curl around the across axis
+			if (BoneIndex > 0)
+			{
+				BoneRotation = FQuat(Across, Curl * 0.5f * PI / 3.f) * BoneRotation;
+			}
+
+			LEAP_BONE& Bone = Digit.bones[BoneIndex];
+			Bone.prev_joint = ToLeap(Joint);
+			Joint += BoneRotation.RotateVector(FVector(0.f, 0.f, -BoneLengths[DigitIndex][BoneIndex]));
+			Bone.next_joint = ToLeap(Joint);
+			Bone.rotation = ToLeap(BoneRotation);
+			Bone.width = 15.f;
+		}
+	}
+}
@@ -0,0 +1,54 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeapC.h"
+
+struct FLeapFrameData;
+
+/**
+ * Deterministic LeapC hands for running the pipeline without a device.
+ *
+ * Both hands sway in front of the device while the fingers curl and open, so pinch and grab strengths
+ * sweep their whole range and the gesture code sees real transitions. Optionally the right hand drops
+ * out for a short while every few seconds to exercise the visibility and reset paths.
+ * The output is a pure function of the requested time, so any timestamp can be sampled directly.
+ */
+class FLeapSyntheticHands
+{
+public:
+	static constexpr int32 MaxHands = 2;
+
+	FLeapSyntheticHands(const int32 InNumHands = MaxHands, const int32 InSeed = 0);
+
+	/** Fill OutEvent and OutHands (MaxHands entries) for InTime in microseconds */
+	void Generate(const int64 InTime, LEAP_TRACKING_EVENT& OutEvent, LEAP_HAND* OutHands) const;
+
+	/** Generate for InTime and convert, as the input device would receive the frame */
+	void GenerateFrame(const int64 InTime, FLeapFrameData& OutFrame) const;
+
+	/** Drop the right hand for DropoutDuration every DropoutPeriod */
+	bool bDropouts;
+
+	/** Seconds */
+	float DropoutPeriod;
+	float DropoutDuration;
+
+	/** Reported device frame rate */
+	float FrameRate;
+
+private:
+	void GenerateHand(const int32 HandIndex, const float Seconds, LEAP_HAND& OutHand) const;
+
+	int32 NumHands;
+
+	/** Per hand phase offsets so the hands don't move in lockstep */
+	float Phase[MaxHands];
+};
@@ -0,0 +1,302 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapTrackingServer.h"
+
+#include "Common/UdpSocketBuilder.h"
+#include "HAL/IConsoleManager.h"
+#include "LeapAllocationGuard.h"
+#include "LeapStats.h"
+#include "LeapUtility.h"
+#include "SocketSubsystem.h"
+#include "Sockets.h"
+#include "UltraleapTrackingData.h"
+
+static TAutoConsoleVariable<int32> CVarLeapServerEnable(TEXT("leap.Server.Enable"), 0,
+	TEXT("Publish the processed hands to external processes over UDP, read when the device starts"));
+
+static TAutoConsoleVariable<FString> CVarLeapServerAddress(TEXT("leap.Server.Address"), TEXT("127.0.0.1"),
+	TEXT("Address the tracking server binds to, 0.0.0.0 to accept clients from other machines"));
+
+static TAutoConsoleVariable<int32> CVarLeapServerPort(
+	TEXT("leap.Server.Port"), LeapTrackingProtocol::DefaultPort, TEXT("UDP port of the tracking server"));
+
+static TAutoConsoleVariable<int32> CVarLeapServerMaxRate(TEXT("leap.Server.MaxRate"), 120,
+	TEXT("Highest rate in Hz any tracking server client is sent frames at, clients may ask for less"));
+
+static TAutoConsoleVariable<float> CVarLeapServerClientTimeout(TEXT("leap.Server.ClientTimeout"), 5.f,
+	TEXT("Seconds without a Hello after which a tracking server client is dropped"));
+
+// Frames arrive with the game tick, a little slack keeps e.g. a 30Hz client on a 90Hz tick at every third frame
+static const double RateSlackSeconds = 0.001;
+
+namespace
+{
+void PutJoint(float* Joint, const FVector& Position)
+{
+	Joint[0] = (float) Position.X;
+	Joint[1] = (float) Position.Y;
+	Joint[2] = (float) Position.Z;
+}
+}	 // namespace
+
+bool FLeapTrackingServer::IsEnabled()
+{
+	return CVarLeapServerEnable.GetValueOnAnyThread() != 0;
+}
+
+FLeapTrackingServer::FLeapTrackingServer() : Socket(nullptr), BoundPort(0), FrameSize(0), NumFailedSends(0)
+{
+}
+
+FLeapTrackingServer::~FLeapTrackingServer()
+{
+	Stop();
+}
+
+bool FLeapTrackingServer::Start()
+{
+	return Start(CVarLeapServerAddress.GetValueOnGameThread(), CVarLeapServerPort.GetValueOnGameThread());
+}
+
+bool FLeapTrackingServer::Start(const FString& Address, const int32 Port)
+{
+	Stop();
+
+	FIPv4Address BindAddress;
+	if (!FIPv4Address::Parse(Address, BindAddress))
+	{
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("Tracking server address %s is not a valid IPv4 address"), *Address);
+		return false;
+	}
+
+	Socket = FUdpSocketBuilder(TEXT("UltraleapTrackingServer"))
+				 .AsNonBlocking()
+				 .BoundToAddress(BindAddress)
+				 .BoundToPort(Port)
+				 .WithReceiveBufferSize(64 * 1024)
+				 .WithSendBufferSize(64 * 1024);
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	if (!Socket)
+	{
+		// Not reusable, so another server or application on the port ends up here rather than sharing its datagrams
+		UE_LOG(UltraleapTrackingLog, Error, TEXT("Tracking server couldn't bind %s:%d, %s"), *Address, Port,
+			SocketSubsystem->GetSocketError(SocketSubsystem->GetLastErrorCode()));
+		return false;
+	}
+
+	Sender = SocketSubsystem->CreateInternetAddr();
+	BoundPort = Socket->GetPortNo();
+	Clients.Reserve(8);
+	NumFailedSends = 0;
+
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("Tracking server listening on %s:%d, protocol version %d"), *Address, BoundPort,
+		LeapTrackingProtocol::Version);
+	return true;
+}
+
+void FLeapTrackingServer::Stop()
+{
+	if (!Socket)
+	{
+		return;
+	}
+
+	// Let subscribers know instead of having them time out
+	uint8 Goodbye[LeapTrackingProtocol::PreambleSize];
+	const int32 GoodbyeSize = (int32) LeapTrackingProtocol::WriteGoodbye(Goodbye, sizeof(Goodbye));
+	for (const FClient& Client : Clients)
+	{
+		Send(Goodbye, GoodbyeSize, *Client.Address);
+	}
+	Clients.Empty();
+
+	Socket->Close();
+	ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+	Socket = nullptr;
+	BoundPort = 0;
+}
+
+void FLeapTrackingServer::PublishFrame(const FLeapFrameData& Frame)
+{
+	if (!Socket)
+	{
+		return;
+	}
+
+	LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapTrackingServer);
+	const double Now = FPlatformTime::Seconds();
+	ReceiveMessages(Now);
+
+	// Encode once for whoever is due a frame
+	bool bEncoded = false;
+	for (FClient& Client : Clients)
+	{
+		if (Now - Client.LastSent < Client.Interval - RateSlackSeconds)
+		{
+			continue;
+		}
+		if (!bEncoded)
+		{
+			EncodeFrame(Frame);
+			bEncoded = true;
+		}
+
+		LeapTrackingProtocol::PatchSequence(FrameBuffer, ++Client.Sequence);
+		Send(FrameBuffer, FrameSize, *Client.Address);
+		Client.LastSent = Now;
+	}
+}
+
+void FLeapTrackingServer::ReceiveMessages(const double Now)
+{
+	if (!Socket)
+	{
+		return;
+	}
+
+	int32 BytesRead = 0;
+	while (Socket->RecvFrom(ReceiveBuffer, sizeof(ReceiveBuffer), BytesRead, *Sender))
+	{
+		uint16 Version = 0;
+		switch (LeapTrackingProtocol::ReadPreamble(ReceiveBuffer, BytesRead, Version))
+		{
+			case LeapTrackingProtocol::EMessageType::Hello:
+			{
+				uint16 MaxRateHz = 0;
+				if (Version != LeapTrackingProtocol::Version)
+				{
+					// Tell the client what we speak, it can't make sense of our frames
+					uint8 Goodbye[LeapTrackingProtocol::PreambleSize];
+					Send(Goodbye, (int32) LeapTrackingProtocol::WriteGoodbye(Goodbye, sizeof(Goodbye)), *Sender);
+				}
+				else if (LeapTrackingProtocol::ReadHello(ReceiveBuffer, BytesRead, MaxRateHz))
+				{
+					OnHello(*Sender, MaxRateHz, Now);
+				}
+				break;
+			}
+			case LeapTrackingProtocol::EMessageType::Goodbye:
+				OnGoodbye(*Sender);
+				break;
+			default:
+				break;
+		}
+	}
+
+	const double Timeout = CVarLeapServerClientTimeout.GetValueOnGameThread();
+	for (int32 Index = Clients.Num() - 1; Index >= 0; Index--)
+	{
+		if (Now - Clients[Index].LastSeen > Timeout)
+		{
+			UE_LOG(UltraleapTrackingLog, Log, TEXT("Tracking server client %s timed out"),
+				*Clients[Index].Address->ToString(true));
+			Clients.RemoveAtSwap(Index, 1, false);
+		}
+	}
+}
+
+void FLeapTrackingServer::OnHello(const FInternetAddr& InSender, const uint16 MaxRateHz, const double Now)
+{
+	const int32 MaxRate = FMath::Max(CVarLeapServerMaxRate.GetValueOnGameThread(), 1);
+	const int32 Rate = MaxRateHz > 0 ? FMath::Min((int32) MaxRateHz, MaxRate) : MaxRate;
+
+	const int32 Index = FindClient(InSender);
+	if (Index != INDEX_NONE)
+	{
+		FClient& Client = Clients[Index];
+		Client.Interval = 1.0 / Rate;
+		Client.LastSeen = Now;
+		return;
+	}
+
+	// Subscribing is rare, it may allocate
+	FLeapAllocationGuardExclusion AllocationGuardExclusion;
+	Clients.Add({InSender.Clone(), 1.0 / Rate, 0.0, Now, 0});
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("Tracking server client %s subscribed at %dHz"), *InSender.ToString(true), Rate);
+}
+
+void FLeapTrackingServer::OnGoodbye(const FInternetAddr& InSender)
+{
+	const int32 Index = FindClient(InSender);
+	if (Index != INDEX_NONE)
+	{
+		UE_LOG(UltraleapTrackingLog, Log, TEXT("Tracking server client %s unsubscribed"), *InSender.ToString(true));
+		Clients.RemoveAtSwap(Index, 1, false);
+	}
+}
+
+int32 FLeapTrackingServer::FindClient(const FInternetAddr& InSender) const
+{
+	return Clients.IndexOfByPredicate([&InSender](const FClient& Client) { return *Client.Address == InSender; });
+}
+
+void FLeapTrackingServer::Send(const uint8* Data, const int32 Size, const FInternetAddr& Destination)
+{
+	int32 BytesSent = 0;
+	if (Socket->SendTo(Data, Size, BytesSent, Destination) && BytesSent == Size)
+	{
+		return;
+	}
+
+	// Usually a full send buffer or an unreachable client, log the first and count the rest
+	LEAP_INC_COUNTER(LeapServerFailedSends);
+	if (NumFailedSends++ == 0)
+	{
+		FLeapAllocationGuardExclusion AllocationGuardExclusion;
+		ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+		UE_LOG(UltraleapTrackingLog, Warning, TEXT("Tracking server couldn't send to %s, %s. Further failures are only counted"),
+			*Destination.ToString(true), SocketSubsystem->GetSocketError(SocketSubsystem->GetLastErrorCode()));
+	}
+}
+
+void FLeapTrackingServer::EncodeFrame(const FLeapFrameData& Frame)
+{
+	LeapTrackingProtocol::FFrameHeader Header;
+	Header.Sequence = 0;
+	Header.FrameId = Frame.FrameId;
+	Header.TimestampMicros = Frame.TimeStamp;
+	Header.HandCount = (uint8) FMath::Min(Frame.Hands.Num(), LeapTrackingProtocol::MaxHands);
+
+	for (int32 HandIndex = 0; HandIndex < Header.HandCount; HandIndex++)
+	{
+		const FLeapHandData& Hand = Frame.Hands[HandIndex];
+		LeapTrackingProtocol::FHand& Out = Hands[HandIndex];
+		Out.Id = (uint32) Hand.Id;
+		Out.HandType = (uint8) Hand.HandType;
+		Out.Confidence = Hand.Confidence;
+		Out.GrabStrength = Hand.GrabStrength;
+		Out.PinchStrength = Hand.PinchStrength;
+
+		const FQuat PalmRotation = Hand.Palm.Orientation.Quaternion();
+		Out.PalmRotation[0] = (float) PalmRotation.X;
+		Out.PalmRotation[1] = (float) PalmRotation.Y;
+		Out.PalmRotation[2] = (float) PalmRotation.Z;
+		Out.PalmRotation[3] = (float) PalmRotation.W;
+
+		PutJoint(Out.Joints[0], Hand.Arm.PrevJoint);
+		PutJoint(Out.Joints[1], Hand.Arm.NextJoint);
+		PutJoint(Out.Joints[2], Hand.Palm.Position);
+
+		const FLeapDigitData* Digits[] = {&Hand.Thumb, &Hand.Index, &Hand.Middle, &Hand.Ring, &Hand.Pinky};
+		Out.ExtendedFingers = 0;
+		for (int32 DigitIndex = 0; DigitIndex < UE_ARRAY_COUNT(Digits); DigitIndex++)
+		{
+			const FLeapDigitData& Digit = *Digits[DigitIndex];
+			float(*Joints)[3] = &Out.Joints[3 + DigitIndex * 5];
+			PutJoint(Joints[0], Digit.Metacarpal.PrevJoint);
+			PutJoint(Joints[1], Digit.Metacarpal.NextJoint);
+			PutJoint(Joints[2], Digit.Proximal.NextJoint);
+			PutJoint(Joints[3], Digit.Intermediate.NextJoint);
+			PutJoint(Joints[4], Digit.Distal.NextJoint);
+			Out.ExtendedFingers |= Digit.IsExtended ? (1 << DigitIndex) : 0;
+		}
+	}
+
+	FrameSize = (int32) LeapTrackingProtocol::WriteFrame(FrameBuffer, sizeof(FrameBuffer), Header, Hands);
+}
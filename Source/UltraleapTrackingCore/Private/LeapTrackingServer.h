@@ -0,0 +1,96 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IPAddress.h"
+#include "LeapTrackingProtocol.h"
+
+class FSocket;
+struct FLeapFrameData;
+
+/**
+ * Publishes the processed, HMD compensated hands to external processes over UDP, see LeapTrackingProtocol.h.
+ *
+ * Clients subscribe with a Hello and get every frame the plugin produces, limited to the lower of their requested rate
+ * and leap.Server.MaxRate. Everything runs on the game thread from the input tick: incoming datagrams are polled
+ * without blocking, the frame is encoded once into a fixed buffer and only its sequence number is patched per client.
+ * Enabled with leap.Server.Enable, binds leap.Server.Address:leap.Server.Port which defaults to loopback only.
+ */
+class FLeapTrackingServer
+{
+public:
+	FLeapTrackingServer();
+	~FLeapTrackingServer();
+
+	/** Whether the device should start a server, read once on device startup */
+	static bool IsEnabled();
+
+	/** Start with the leap.Server.* settings */
+	bool Start();
+
+	/** Port 0 picks a free port, see GetPort */
+	bool Start(const FString& Address, int32 Port);
+	void Stop();
+
+	bool IsRunning() const
+	{
+		return Socket != nullptr;
+	}
+
+	int32 GetPort() const
+	{
+		return BoundPort;
+	}
+
+	int32 GetNumClients() const
+	{
+		return Clients.Num();
+	}
+
+	/** Datagrams the socket didn't take since Start, see also STAT_LeapServerFailedSends */
+	int64 GetNumFailedSends() const
+	{
+		return NumFailedSends;
+	}
+
+	/** Game thread, handles subscriptions and sends the frame to every client that is due one */
+	void PublishFrame(const FLeapFrameData& Frame);
+
+	/** Game thread, handles subscriptions only. Called by PublishFrame */
+	void ReceiveMessages(double Now);
+
+private:
+	struct FClient
+	{
+		TSharedRef<FInternetAddr> Address;
+		double Interval;
+		double LastSent;
+		double LastSeen;
+		uint32 Sequence;
+	};
+
+	void OnHello(const FInternetAddr& Sender, uint16 MaxRateHz, double Now);
+	void OnGoodbye(const FInternetAddr& Sender);
+	int32 FindClient(const FInternetAddr& Sender) const;
+	void EncodeFrame(const FLeapFrameData& Frame);
+	void Send(const uint8* Data, int32 Size, const FInternetAddr& Destination);
+
+	FSocket* Socket;
+	int32 BoundPort;
+	TArray<FClient> Clients;
+	TSharedPtr<FInternetAddr> Sender;
+	int32 FrameSize;
+	int64 NumFailedSends;
+
+	// Encoding scratch, sized for the largest frame so publishing doesn't allocate
+	LeapTrackingProtocol::FHand Hands[LeapTrackingProtocol::MaxHands];
+	uint8 FrameBuffer[LeapTrackingProtocol::MaxFrameSize];
+	uint8 ReceiveBuffer[LeapTrackingProtocol::MaxFrameSize];
+};
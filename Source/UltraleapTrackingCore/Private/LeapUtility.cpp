@@ -26,8 +26,23 @@ FQuat FLeapUtility::LeapMountRotationOffset = FQuat(FRotator(0, 0, 0));
 FQuat FLeapUtility::FacingAdjustQuat = FQuat(FRotator(90.f, 0.f, 0.f));
 FQuat FLeapUtility::LeapRotationOffset = FQuat(FRotator(90.f, 0.f, 180.f));
 
+namespace
+{
+// Set by FLeapUtility::FScopedWorldScale, 0 while the calling thread has none
+thread_local float ThreadWorldScale = 0.f;
+}	 // namespace
+
 // Todo: use and verify this for all values
 float LeapGetWorldScaleFactor()
+{
+	if (ThreadWorldScale > 0.f)
+	{
+		return ThreadWorldScale;
+	}
+	return IsInGameThread() ? FLeapUtility::GetWorldScaleFactor() : 1.f;
+}
+
+float FLeapUtility::GetWorldScaleFactor()
 {
 	if (GEngine != nullptr && GEngine->GetWorld() != nullptr)
 	{
@@ -35,6 +50,16 @@ float LeapGetWorldScaleFactor()
 	}
 	return 1.f;
 }
+
+FLeapUtility::FScopedWorldScale::FScopedWorldScale(float WorldScale) : PreviousWorldScale(ThreadWorldScale)
+{
+	ThreadWorldScale = WorldScale;
+}
+
+FLeapUtility::FScopedWorldScale::~FScopedWorldScale()
+{
+	ThreadWorldScale = PreviousWorldScale;
+}
 void FLeapUtility::LogRotation(const FString& Text, const FRotator& Rotation)
 {
 	if (GEngine)
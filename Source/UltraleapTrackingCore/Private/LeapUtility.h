@@ -22,6 +22,23 @@ public:
 
 	static void SetLeapGlobalOffsets(const FVector& TranslationOffset, const FRotator& RotationOffset);
 
+	/** WorldToMeters of the current world over 100, game thread only */
+	static float GetWorldScaleFactor();
+
+	/**
+	 * Conversions on the calling thread use this world scale instead of reading the world while in scope. Threads other
+	 * than the game thread must not touch the world, without one of these their conversions use a scale of 1
+	 */
+	class FScopedWorldScale
+	{
+	public:
+		explicit FScopedWorldScale(float WorldScale);
+		~FScopedWorldScale();
+
+	private:
+		float PreviousWorldScale;
+	};
+
 	// Conversion
 	// To ue
 	static FVector ConvertLeapVectorToFVector(const LEAP_VECTOR& LeapVector);
@@ -8,10 +8,59 @@
 
 #include "LeapWrapper.h"
 
+#include "HAL/IConsoleManager.h"
+#include "HAL/RunnableThread.h"
 #include "LeapAsync.h"
+#include "LeapStats.h"
 #include "LeapUtility.h"
 #include "Runtime/Core/Public/Misc/Timespan.h"
 
+static TAutoConsoleVariable<int32> CVarLeapServiceThreadPriority(TEXT("leap.Service.ThreadPriority"), 1,
+	TEXT("Priority of the thread polling the tracking service: 0 normal, 1 above normal, 2 highest, 3 time critical. "
+		 "Read when the connection opens"));
+
+static TAutoConsoleVariable<FString> CVarLeapServiceAffinityMask(TEXT("leap.Service.AffinityMask"), TEXT("0"),
+	TEXT("Cores the service thread may run on as a bit mask, e.g. 0x30 for cores 4 and 5. 0 leaves placement to the OS. "
+		 "Read when the connection opens"));
+
+static TAutoConsoleVariable<int32> CVarLeapServicePollTimeout(TEXT("leap.Service.PollTimeoutMs"), 50,
+	TEXT("Longest wait for a message from the tracking service. LeapC can't interrupt a poll so closing the connection "
+		 "takes up to this long"));
+
+static TAutoConsoleVariable<float> CVarLeapServiceReconnectMinDelay(TEXT("leap.Service.ReconnectMinDelay"), 0.1f,
+	TEXT("Seconds to wait after the first failed poll while the tracking service is unreachable"));
+
+static TAutoConsoleVariable<float> CVarLeapServiceReconnectMaxDelay(TEXT("leap.Service.ReconnectMaxDelay"), 2.0f,
+	TEXT("Longest wait between polls while the tracking service is unreachable, the wait doubles up to this"));
+
+namespace
+{
+// Reconnect waits vary by this fraction either way so several clients don't retry in lockstep
+const double ReconnectJitter = 0.2;
+
+EThreadPriority GetConfiguredServiceThreadPriority()
+{
+	switch (CVarLeapServiceThreadPriority.GetValueOnAnyThread())
+	{
+		case 0:
+			return TPri_Normal;
+		case 2:
+			return TPri_Highest;
+		case 3:
+			return TPri_TimeCritical;
+		default:
+			return TPri_AboveNormal;
+	}
+}
+
+uint64 GetConfiguredServiceAffinityMask()
+{
+	// Base 0 takes decimal or 0x prefixed hex
+	const uint64 Mask = FCString::Strtoui64(*CVarLeapServiceAffinityMask.GetValueOnAnyThread(), nullptr, 0);
+	return Mask ? Mask : FPlatformAffinity::GetNoAffinityMask();
+}
+}	 // namespace
+
 #pragma region LeapC Wrapper
 
 FLeapWrapper::FLeapWrapper() : bIsRunning(false)
@@ -19,22 +68,25 @@ FLeapWrapper::FLeapWrapper() : bIsRunning(false)
 	InterpolatedFrame = nullptr;
 	InterpolatedFrameSize = 0;
 	DataLock = new FCriticalSection();
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
 }
 
 FLeapWrapper::~FLeapWrapper()
 {
+	// Joins the service thread before anything it uses goes away
+	if (ServiceThread)
+	{
+		CloseConnection();
+	}
+
 	delete DataLock;
 	DataLock = nullptr;
-	
-	bIsRunning = false;
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+
 	CallbackDelegate = nullptr;
 	LatestFrame = nullptr;
 	ConnectionHandle = nullptr;
-
-	if (bIsConnected)
-	{
-		CloseConnection();
-	}
 	if (ImageDescription != NULL)
 	{
 		if (ImageDescription->pBuffer != NULL)
@@ -43,6 +95,11 @@ FLeapWrapper::~FLeapWrapper()
 		}
 		delete ImageDescription;
 	}
+	if (InterpolatedFrame)
+	{
+		FMemory::Free(InterpolatedFrame);
+		InterpolatedFrame = nullptr;
+	}
 }
 
 void FLeapWrapper::SetCallbackDelegate(LeapWrapperCallbackInterface* InCallbackDelegate)
@@ -53,6 +110,10 @@ void FLeapWrapper::SetCallbackDelegate(LeapWrapperCallbackInterface* InCallbackD
 LEAP_CONNECTION* FLeapWrapper::OpenConnection(LeapWrapperCallbackInterface* InCallbackDelegate)
 {
 	SetCallbackDelegate(InCallbackDelegate);
+	if (ServiceThread)
+	{
+		return &ConnectionHandle;
+	}
 
 	// Don't use config for now
 	LEAP_CONNECTION_CONFIG Config;
@@ -63,19 +124,28 @@ LEAP_CONNECTION* FLeapWrapper::OpenConnection(LeapWrapperCallbackInterface* InCa
 	eLeapRS result = LeapCreateConnection(&Config, &ConnectionHandle);
 	if (result == eLeapRS_Success)
 	{
+		if (FLeapPooledAllocator::IsEnabled())
+		{
+			const eLeapRS AllocatorResult = LeapSetAllocator(ConnectionHandle, Allocator.GetLeapAllocator());
+			if (AllocatorResult != eLeapRS_Success)
+			{
+				UE_LOG(UltraleapTrackingLog, Warning, TEXT("LeapSetAllocator failed %s."),
+					UTF8_TO_TCHAR(ResultString(AllocatorResult)));
+			}
+		}
 		result = LeapOpenConnection(ConnectionHandle);
 		if (result == eLeapRS_Success)
 		{
 			bIsRunning = true;
+			WakeEvent->Reset();
 
-			LEAP_CONNECTION* Handle = &ConnectionHandle;
-			ProducerLambdaFuture = FLeapAsync::RunLambdaOnBackGroundThread([&, Handle] {
-				UE_LOG(UltraleapTrackingLog, Log, TEXT("ServiceMessageLoop started."));
-				ServiceMessageLoop();
-				UE_LOG(UltraleapTrackingLog, Log, TEXT("ServiceMessageLoop stopped."));
+			DataLock->Lock();
+			ConnectionStats = FLeapServiceConnectionStats();
+			ConnectionStateTime = FPlatformTime::Seconds();
+			DataLock->Unlock();
 
-				CloseConnectionHandle(Handle);
-			});
+			ServiceThread = FRunnableThread::Create(
+				this, TEXT("UltraleapService"), 0, GetConfiguredServiceThreadPriority(), GetConfiguredServiceAffinityMask());
 		}
 	}
 	return &ConnectionHandle;
@@ -83,21 +153,28 @@ LEAP_CONNECTION* FLeapWrapper::OpenConnection(LeapWrapperCallbackInterface* InCa
 
 void FLeapWrapper::CloseConnection()
 {
-	if (!bIsConnected)
+	if (!ServiceThread)
 	{
 		// Not connected, already done
 		UE_LOG(UltraleapTrackingLog, Log, TEXT("Attempt at closing an already closed connection."));
 		return;
 	}
+
+	// Stop() wakes a reconnect wait at once, a poll in progress returns within leap.Service.PollTimeoutMs
+	ServiceThread->Kill(true);
+	delete ServiceThread;
+	ServiceThread = nullptr;
+
 	bIsConnected = false;
-	bIsRunning = false;
 	CleanupLastDevice();
+	ConfigRequests.FailAll();
 
-	// Wait for thread to exit - Blocking call, but it should be very quick.
-	FTimespan ExitWaitTimeSpan = FTimespan::FromSeconds(3);
-
-	ProducerLambdaFuture.WaitFor(ExitWaitTimeSpan);
-	ProducerLambdaFuture.Reset();
+	DataLock->Lock();
+	ConnectionStats.bIsConnected = false;
+	ConnectionStats.ReconnectBackoffSeconds = 0;
+	ConnectionStateTime = FPlatformTime::Seconds();
+	DataLock->Unlock();
+	LEAP_SET_COUNTER(LeapServiceConnected, 0);
 
 	// Nullify the callback delegate. Any outstanding task graphs will not run if the delegate is nullified.
 	CallbackDelegate = nullptr;
@@ -133,6 +210,103 @@ void FLeapWrapper::SetPolicyFlagFromBoolean(eLeapPolicyFlag Flag, bool ShouldSet
 	}
 }
 
+bool FLeapWrapper::SetPaused(bool bPause)
+{
+	if (!bIsConnected)
+	{
+		return false;
+	}
+
+	// Pausing needs the policy, which the service applies asynchronously. Until it has, LeapSetPause fails and the
+	// caller tries again later
+	if (bPause)
+	{
+		LeapSetPolicyFlags(ConnectionHandle, eLeapPolicyFlag_AllowPauseResume, 0);
+	}
+	const eLeapRS Result = LeapSetPause(ConnectionHandle, bPause);
+	if (Result != eLeapRS_Success)
+	{
+		UE_LOG(UltraleapTrackingLog, Verbose, TEXT("LeapSetPause(%d) failed %s."), bPause, UTF8_TO_TCHAR(ResultString(Result)));
+		return false;
+	}
+	return true;
+}
+
+TFuture<FLeapConfigResult> FLeapWrapper::RequestConfigValue(const FString& Key)
+{
+	if (!bIsConnected)
+	{
+		return IUltraleapTrackingPlugin::MakeFailedConfigResult(Key);
+	}
+
+	const FTCHARToUTF8 KeyUTF8(*Key);
+	const double Deadline = FPlatformTime::Seconds() + FLeapConfigRequests::GetConfiguredTimeout();
+	return ConfigRequests.Issue(Key, nullptr, Deadline, [this, &Key, &KeyUTF8](uint32& OutRequestId) {
+		const eLeapRS Result = LeapRequestConfigValue(ConnectionHandle, KeyUTF8.Get(), &OutRequestId);
+		if (Result != eLeapRS_Success)
+		{
+			UE_LOG(UltraleapTrackingLog, Warning, TEXT("LeapRequestConfigValue(%s) failed %s."), *Key,
+				UTF8_TO_TCHAR(ResultString(Result)));
+			return false;
+		}
+		return true;
+	});
+}
+
+TFuture<FLeapConfigResult> FLeapWrapper::SaveConfigValue(const FString& Key, const FLeapConfigValue& Value)
+{
+	if (!bIsConnected)
+	{
+		return IUltraleapTrackingPlugin::MakeFailedConfigResult(Key);
+	}
+
+	// Both strings must outlive the LeapC call
+	const FTCHARToUTF8 KeyUTF8(*Key);
+	const FTCHARToUTF8 StringUTF8(*Value.StringValue);
+
+	LEAP_VARIANT Variant;
+	FMemory::Memzero(Variant);
+	switch (Value.Type)
+	{
+		case ELeapConfigValueType::LEAP_CONFIG_BOOL:
+			Variant.type = eLeapValueType_Boolean;
+			Variant.boolValue = Value.BoolValue;
+			break;
+		case ELeapConfigValueType::LEAP_CONFIG_INT:
+			Variant.type = eLeapValueType_Int32;
+			Variant.iValue = Value.IntValue;
+			break;
+		case ELeapConfigValueType::LEAP_CONFIG_FLOAT:
+			Variant.type = eLeapValueType_Float;
+			Variant.fValue = Value.FloatValue;
+			break;
+		case ELeapConfigValueType::LEAP_CONFIG_STRING:
+			Variant.type = eLeapValueType_String;
+			Variant.strValue = StringUTF8.Get();
+			break;
+		default:
+			UE_LOG(UltraleapTrackingLog, Warning, TEXT("SaveConfigValue(%s) needs a typed value."), *Key);
+			return IUltraleapTrackingPlugin::MakeFailedConfigResult(Key);
+	}
+
+	const double Deadline = FPlatformTime::Seconds() + FLeapConfigRequests::GetConfiguredTimeout();
+	return ConfigRequests.Issue(Key, &Value, Deadline, [this, &Key, &KeyUTF8, &Variant](uint32& OutRequestId) {
+		const eLeapRS Result = LeapSaveConfigValue(ConnectionHandle, KeyUTF8.Get(), &Variant, &OutRequestId);
+		if (Result != eLeapRS_Success)
+		{
+			UE_LOG(UltraleapTrackingLog, Warning, TEXT("LeapSaveConfigValue(%s) failed %s."), *Key,
+				UTF8_TO_TCHAR(ResultString(Result)));
+			return false;
+		}
+		return true;
+	});
+}
+
+bool FLeapWrapper::GetCachedConfigValue(const FString& Key, FLeapConfigValue& OutValue)
+{
+	return ConfigRequests.GetCachedValue(Key, OutValue);
+}
+
 /** Close the connection and let message thread function end. */
 void FLeapWrapper::CloseConnectionHandle(LEAP_CONNECTION* InConnectionHandle)
 {
@@ -158,20 +332,16 @@ LEAP_TRACKING_EVENT* FLeapWrapper::GetInterpolatedFrameAtTime(int64 TimeStamp)
 	// Check validity of frame size
 	if (FrameSize > 0)
 	{
-		// Different frame?
-		if (FrameSize != InterpolatedFrameSize)
+		// Only ever grow the buffer, the size changes with the number of hands and this is called twice a tick
+		if (FrameSize > InterpolatedFrameSize)
 		{
-			// If we already have an allocated frame, free it
-			if (InterpolatedFrame)
-			{
-				free(InterpolatedFrame);
-			}
-			InterpolatedFrame = (LEAP_TRACKING_EVENT*) malloc(FrameSize);
+			LEAP_LLM_SCOPE(Ultraleap_Frames);
+			InterpolatedFrame = (LEAP_TRACKING_EVENT*) FMemory::Realloc(InterpolatedFrame, FrameSize);
+			InterpolatedFrameSize = FrameSize;
 		}
-		InterpolatedFrameSize = FrameSize;
 
 		// Grab the new frame
-		LeapInterpolateFrame(ConnectionHandle, TimeStamp, InterpolatedFrame, InterpolatedFrameSize);
+		LeapInterpolateFrame(ConnectionHandle, TimeStamp, InterpolatedFrame, FrameSize);
 	}
 
 	return InterpolatedFrame;
@@ -291,6 +461,8 @@ void FLeapWrapper::CleanupLastDevice()
 
 void FLeapWrapper::SetFrame(const LEAP_TRACKING_EVENT* Frame)
 {
+	const int64_t ArrivalTime = LeapGetNow();
+
 	DataLock->Lock();
 
 	if (!LatestFrame)
@@ -299,14 +471,65 @@ void FLeapWrapper::SetFrame(const LEAP_TRACKING_EVENT* Frame)
 	}
 
 	*LatestFrame = *Frame;
+	LatestFrameArrivalTime = ArrivalTime;
+
+	DataLock->Unlock();
+}
+
+int64_t FLeapWrapper::GetFrameArrivalTime(int64_t TrackingFrameId)
+{
+	int64_t ArrivalTime = 0;
+	DataLock->Lock();
+	if (LatestFrame && LatestFrame->tracking_frame_id == TrackingFrameId)
+	{
+		ArrivalTime = LatestFrameArrivalTime;
+	}
+	DataLock->Unlock();
+	return ArrivalTime;
+}
+
+void FLeapWrapper::ProfileTelemetry(const LEAP_TELEMETRY_DATA& TelemetryData)
+{
+	if (bIsConnected)
+	{
+		LeapTelemetryProfiling(ConnectionHandle, &TelemetryData);
+	}
+}
+
+void FLeapWrapper::GetConnectionStats(FLeapServiceConnectionStats& OutStats)
+{
+	DataLock->Lock();
+	OutStats = ConnectionStats;
+	OutStats.SecondsInState = ConnectionStateTime > 0 ? (float) (FPlatformTime::Seconds() - ConnectionStateTime) : 0.f;
+	DataLock->Unlock();
+}
 
+void FLeapWrapper::SetConnectionState(bool bConnected)
+{
+	DataLock->Lock();
+	ConnectionStats.bIsConnected = bConnected;
+	if (bConnected)
+	{
+		ConnectionStats.Connections++;
+		ConnectionStats.ReconnectBackoffSeconds = 0;
+	}
+	else
+	{
+		ConnectionStats.ConnectionsLost++;
+	}
+	ConnectionStateTime = FPlatformTime::Seconds();
+	const int32 ConnectionsLost = ConnectionStats.ConnectionsLost;
 	DataLock->Unlock();
+
+	bIsConnected = bConnected;
+	LEAP_SET_COUNTER(LeapServiceConnected, bConnected ? 1 : 0);
+	LEAP_SET_COUNTER(LeapServiceConnectionsLost, ConnectionsLost);
 }
 
 /** Called by ServiceMessageLoop() when a connection event is returned by LeapPollConnection(). */
 void FLeapWrapper::HandleConnectionEvent(const LEAP_CONNECTION_EVENT* ConnectionEvent)
 {
-	bIsConnected = true;
+	SetConnectionState(true);
 	if (CallbackDelegate)
 	{
 		CallbackDelegate->OnConnect();
@@ -316,9 +539,12 @@ void FLeapWrapper::HandleConnectionEvent(const LEAP_CONNECTION_EVENT* Connection
 /** Called by ServiceMessageLoop() when a connection lost event is returned by LeapPollConnection(). */
 void FLeapWrapper::HandleConnectionLostEvent(const LEAP_CONNECTION_LOST_EVENT* ConnectionLostEvent)
 {
-	bIsConnected = false;
+	SetConnectionState(false);
 	CleanupLastDevice();
 
+	// The service won't answer requests sent on the lost connection
+	ConfigRequests.FailAll();
+
 	if (CallbackDelegate)
 	{
 		CallbackDelegate->OnConnectionLost();
@@ -416,6 +642,8 @@ void FLeapWrapper::HandleDeviceFailureEvent(const LEAP_DEVICE_FAILURE_EVENT* Dev
 /** Called by ServiceMessageLoop() when a tracking event is returned by LeapPollConnection(). */
 void FLeapWrapper::HandleTrackingEvent(const LEAP_TRACKING_EVENT* TrackingEvent)
 {
+	LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapServiceTrackingEvent);
+
 	// temp disable
 	/*if (DeviceId == 2) {
 		return;
@@ -494,12 +722,17 @@ void FLeapWrapper::HandleTrackingModeEvent(const LEAP_TRACKING_MODE_EVENT* Track
 /** Called by ServiceMessageLoop() when a config change event is returned by LeapPollConnection(). */
 void FLeapWrapper::HandleConfigChangeEvent(const LEAP_CONFIG_CHANGE_EVENT* ConfigChangeEvent)
 {
+	// Copied now, the event is only valid until the next poll
+	const uint32_t RequestID = ConfigChangeEvent->requestID;
+	const bool bSuccess = ConfigChangeEvent->status;
+	ConfigRequests.HandleChange(RequestID, bSuccess);
+
 	if (CallbackDelegate)
 	{
-		TaskRefConfigChange = FLeapAsync::RunShortLambdaOnGameThread([ConfigChangeEvent, this] {
+		TaskRefConfigChange = FLeapAsync::RunShortLambdaOnGameThread([RequestID, bSuccess, this] {
 			if (CallbackDelegate)
 			{
-				CallbackDelegate->OnConfigChange(ConfigChangeEvent->requestID, ConfigChangeEvent->status);
+				CallbackDelegate->OnConfigChange(RequestID, bSuccess);
 			}
 		});
 	}
@@ -508,28 +741,82 @@ void FLeapWrapper::HandleConfigChangeEvent(const LEAP_CONFIG_CHANGE_EVENT* Confi
 /** Called by ServiceMessageLoop() when a config response event is returned by LeapPollConnection(). */
 void FLeapWrapper::HandleConfigResponseEvent(const LEAP_CONFIG_RESPONSE_EVENT* ConfigResponseEvent)
 {
+	const uint32_t RequestID = ConfigResponseEvent->requestID;
+	FLeapConfigValue Value;
+	Value.SetFromLeapVariant(&ConfigResponseEvent->value);
+	ConfigRequests.HandleResponse(RequestID, Value);
+
 	if (CallbackDelegate)
 	{
-		TaskRefConfigResponse = FLeapAsync::RunShortLambdaOnGameThread([ConfigResponseEvent, this] {
+		// LeapC's string goes away at the next poll, the game thread callback points at a copy
+		const LEAP_VARIANT Variant = ConfigResponseEvent->value;
+		TArray<ANSICHAR> String;
+		if (Variant.type == eLeapValueType_String && Variant.strValue)
+		{
+			String.Append(Variant.strValue, FCStringAnsi::Strlen(Variant.strValue) + 1);
+		}
+		TaskRefConfigResponse = FLeapAsync::RunShortLambdaOnGameThread([RequestID, Variant, String, this] {
 			if (CallbackDelegate)
 			{
-				CallbackDelegate->OnConfigResponse(ConfigResponseEvent->requestID, ConfigResponseEvent->value);
+				LEAP_VARIANT CallbackVariant = Variant;
+				if (CallbackVariant.type == eLeapValueType_String)
+				{
+					CallbackVariant.strValue = String.Num() > 0 ? String.GetData() : nullptr;
+				}
+				CallbackDelegate->OnConfigResponse(RequestID, CallbackVariant);
 			}
 		});
 	}
 }
 
+uint32 FLeapWrapper::Run()
+{
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("ServiceMessageLoop started."));
+	ServiceMessageLoop();
+	UE_LOG(UltraleapTrackingLog, Log, TEXT("ServiceMessageLoop stopped."));
+
+	CloseConnectionHandle(&ConnectionHandle);
+	return 0;
+}
+
+void FLeapWrapper::Stop()
+{
+	bIsRunning = false;
+	WakeEvent->Trigger();
+}
+
+/** Wait before polling an unreachable service again, doubling the delay each time up to the configured maximum */
+void FLeapWrapper::WaitToReconnect(double& InOutDelay, FRandomStream& Jitter)
+{
+	const double MinDelay = FMath::Max(CVarLeapServiceReconnectMinDelay.GetValueOnAnyThread(), 0.001f);
+	const double MaxDelay = FMath::Max((double) CVarLeapServiceReconnectMaxDelay.GetValueOnAnyThread(), MinDelay);
+	InOutDelay = InOutDelay > 0 ? FMath::Min(InOutDelay * 2, MaxDelay) : MinDelay;
+	const double Delay = InOutDelay * (1.0 + ReconnectJitter * (2.0 * Jitter.GetFraction() - 1.0));
+
+	DataLock->Lock();
+	ConnectionStats.ReconnectAttempts++;
+	ConnectionStats.ReconnectBackoffSeconds = (float) Delay;
+	const int32 ReconnectAttempts = ConnectionStats.ReconnectAttempts;
+	DataLock->Unlock();
+	LEAP_SET_COUNTER(LeapServiceReconnectAttempts, ReconnectAttempts);
+
+	WakeEvent->Wait(FTimespan::FromSeconds(Delay));
+}
+
 /**
  * Services the LeapC message pump by calling LeapPollConnection().
  * The average polling time is determined by the framerate of the Leap Motion service.
  */
 void FLeapWrapper::ServiceMessageLoop(void* Unused)
 {
+	LEAP_LLM_SCOPE(Ultraleap_Service);
 	eLeapRS Result;
 	LEAP_CONNECTION_MESSAGE Msg;
 	LEAP_CONNECTION Handle = ConnectionHandle;	  // copy handle so it doesn't get released from under us on game thread
 
-	unsigned int Timeout = 200;
+	const unsigned int Timeout = FMath::Max(CVarLeapServicePollTimeout.GetValueOnAnyThread(), 1);
+	FRandomStream Jitter((int32) FPlatformTime::Cycles());
+	double ReconnectDelay = 0;
 	while (bIsRunning)
 	{
 		Result = LeapPollConnection(Handle, Timeout, &Msg);
@@ -539,6 +826,7 @@ void FLeapWrapper::ServiceMessageLoop(void* Unused)
 		{
 			break;
 		}
+		ConfigRequests.ExpireRequests(FPlatformTime::Seconds());
 
 		if (Result != eLeapRS_Success)
 		{
@@ -546,14 +834,11 @@ void FLeapWrapper::ServiceMessageLoop(void* Unused)
 			// UTF8_TO_TCHAR(ResultString(result)));
 			if (!bIsConnected)
 			{
-				FPlatformProcess::Sleep(0.1f);
-				continue;
-			}
-			else
-			{
-				continue;
+				WaitToReconnect(ReconnectDelay, Jitter);
 			}
+			continue;
 		}
+		ReconnectDelay = 0;
 
 		switch (Msg.type)
 		{
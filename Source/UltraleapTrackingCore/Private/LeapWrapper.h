@@ -9,8 +9,11 @@
 #pragma once
 #include "Async/Async.h"
 #include "CoreMinimal.h"
+#include "HAL/Runnable.h"
 #include "HAL/ThreadSafeBool.h"
 #include "LeapC.h"
+#include "LeapConfigRequests.h"
+#include "LeapPooledAllocator.h"
 #include "UltraleapTrackingData.h"
 
 /** Interface for the passed callback delegate receiving game thread LeapC callbacks */
@@ -66,8 +69,32 @@ public:
 
 	virtual int64_t GetNow() = 0;
 
+	/** GetNow() time at which the frame with this id reached the wrapper, 0 if unknown or no longer the latest frame */
+	virtual int64_t GetFrameArrivalTime(int64_t TrackingFrameId) = 0;
+
+	/** Forward a profiling zone to the tracking service's telemetry, if the source has one */
+	virtual void ProfileTelemetry(const LEAP_TELEMETRY_DATA& TelemetryData) = 0;
+
 	virtual void SetSwizzles(
 		ELeapQuatSwizzleAxisB ToX, ELeapQuatSwizzleAxisB ToY, ELeapQuatSwizzleAxisB ToZ, ELeapQuatSwizzleAxisB ToW) = 0;
+
+	/** Connection state of the source, only the service connection has reconnects to report */
+	virtual void GetConnectionStats(FLeapServiceConnectionStats& OutStats) = 0;
+
+	/** Pause or resume the device, true once applied or if the source has nothing to pause */
+	virtual bool SetPaused(bool bPause) = 0;
+
+	/**
+	 * Read a tracking service setting without blocking. The future completes on the service thread once the service
+	 * answers, or fails after leap.Config.Timeout seconds or if the source has no service
+	 */
+	virtual TFuture<FLeapConfigResult> RequestConfigValue(const FString& Key) = 0;
+
+	/** Write a tracking service setting without blocking, the future completes once the service has applied it */
+	virtual TFuture<FLeapConfigResult> SaveConfigValue(const FString& Key, const FLeapConfigValue& Value) = 0;
+
+	/** Last value read or successfully written for the key, without asking the service */
+	virtual bool GetCachedConfigValue(const FString& Key, FLeapConfigValue& OutValue) = 0;
 };
 
 class FLeapWrapperBase : public IHandTrackingWrapper
@@ -134,17 +161,59 @@ public:
 		CurrentWorld = World;
 	}
 
+	virtual int64_t GetFrameArrivalTime(int64_t TrackingFrameId) override
+	{
+		return 0;
+	}
+
+	virtual void ProfileTelemetry(const LEAP_TELEMETRY_DATA& TelemetryData) override
+	{
+	}
+
 	virtual void SetSwizzles(
 		ELeapQuatSwizzleAxisB ToX, ELeapQuatSwizzleAxisB ToY, ELeapQuatSwizzleAxisB ToZ, ELeapQuatSwizzleAxisB ToW) override
 	{
 	}
 
+	virtual void GetConnectionStats(FLeapServiceConnectionStats& OutStats) override
+	{
+		OutStats.bIsConnected = IsConnected();
+	}
+
+	virtual bool SetPaused(bool bPause) override
+	{
+		return true;
+	}
+
+	virtual TFuture<FLeapConfigResult> RequestConfigValue(const FString& Key) override
+	{
+		return IUltraleapTrackingPlugin::MakeFailedConfigResult(Key);
+	}
+
+	virtual TFuture<FLeapConfigResult> SaveConfigValue(const FString& Key, const FLeapConfigValue& Value) override
+	{
+		return IUltraleapTrackingPlugin::MakeFailedConfigResult(Key);
+	}
+
+	virtual bool GetCachedConfigValue(const FString& Key, FLeapConfigValue& OutValue) override
+	{
+		return false;
+	}
+
 protected:
 	LeapWrapperCallbackInterface* CallbackDelegate = nullptr;
 	UWorld* CurrentWorld = nullptr;
 };
-/** Wraps LeapC API into a threaded and event driven delegate callback format */
-class FLeapWrapper : public FLeapWrapperBase
+/**
+ * Wraps LeapC API into a threaded and event driven delegate callback format.
+ *
+ * LeapPollConnection runs on a dedicated "UltraleapService" thread whose priority and core affinity come from
+ * leap.Service.ThreadPriority and leap.Service.AffinityMask. While the service is unreachable the thread backs off
+ * exponentially with jitter between leap.Service.ReconnectMinDelay and leap.Service.ReconnectMaxDelay.
+ *
+ * Config reads and writes are asynchronous, their futures complete when the service thread polls the answering event.
+ */
+class FLeapWrapper : public FLeapWrapperBase, public FRunnable
 {
 public:
 	// LeapC Vars
@@ -190,6 +259,18 @@ public:
 		return LeapGetNow();
 	}
 
+	virtual int64_t GetFrameArrivalTime(int64_t TrackingFrameId) override;
+	virtual void ProfileTelemetry(const LEAP_TELEMETRY_DATA& TelemetryData) override;
+	virtual void GetConnectionStats(FLeapServiceConnectionStats& OutStats) override;
+	virtual bool SetPaused(bool bPause) override;
+	virtual TFuture<FLeapConfigResult> RequestConfigValue(const FString& Key) override;
+	virtual TFuture<FLeapConfigResult> SaveConfigValue(const FString& Key, const FLeapConfigValue& Value) override;
+	virtual bool GetCachedConfigValue(const FString& Key, FLeapConfigValue& OutValue) override;
+
+	// FRunnable, the service thread
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
 private:
 	void CloseConnectionHandle(LEAP_CONNECTION* ConnectionHandle);
 	void Millisleep(int Milliseconds);
@@ -197,11 +278,26 @@ private:
 	// Frame and handle data
 	LEAP_DEVICE DeviceHandle;
 	LEAP_TRACKING_EVENT* LatestFrame = NULL;
+	int64_t LatestFrameArrivalTime = 0;
 
 	// Threading variables
 	FCriticalSection* DataLock;
-	TFuture<void> ProducerLambdaFuture;
+	FRunnableThread* ServiceThread = nullptr;
+
+	// Cuts a reconnect backoff short on Stop()
+	FEvent* WakeEvent;
+
+	// Service thread writes, any thread reads under DataLock
+	FLeapServiceConnectionStats ConnectionStats;
+	double ConnectionStateTime = 0;
+
+	// Config reads and writes awaiting their ConfigResponse or ConfigChange event
+	FLeapConfigRequests ConfigRequests;
+
+	// Installed with LeapSetAllocator, outlives the connection which is destroyed on the service thread
+	FLeapPooledAllocator Allocator;
 
+	// Grows to the largest interpolated frame seen, InterpolatedFrameSize is its capacity
 	LEAP_TRACKING_EVENT* InterpolatedFrame;
 	uint64 InterpolatedFrameSize;
 
@@ -225,6 +321,8 @@ private:
 	void CleanupLastDevice();
 
 	void ServiceMessageLoop(void* unused = nullptr);
+	void SetConnectionState(bool bConnected);
+	void WaitToReconnect(double& InOutDelay, FRandomStream& Jitter);
 
 	// Received LeapC callbacks converted into game thread events
 	void HandleConnectionEvent(const LEAP_CONNECTION_EVENT* ConnectionEvent);
@@ -18,6 +18,9 @@ UOneEuroFilterComponent::UOneEuroFilterComponent()
 	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
 	// off to improve performance if you don't need them.
 	PrimaryComponentTick.bCanEverTick = false;
+
+	// Angular speed is in rad/s, so the rotation filter doesn't share the position slope
+	RotationFilter.CutoffSlope = 0.5f;
 }
 
 // Called when the game starts
@@ -58,11 +61,76 @@ FVector UOneEuroFilterComponent::FLowpassFilter::GetPrevious() const
 	return Previous;
 }
 
+FLeapOneEuroRotationFilter::FLeapOneEuroRotationFilter()
+	: MinCutoff(1.f), CutoffSlope(0.f), DeltaCutoff(1.f), Previous(FQuat::Identity), PreviousSpeed(0.f), bFirstTime(true)
+{
+}
+
+void FLeapOneEuroRotationFilter::Init(const float InMinCutoff, const float InCutoffSlope, const float InDeltaCutoff)
+{
+	MinCutoff = InMinCutoff;
+	CutoffSlope = InCutoffSlope;
+	DeltaCutoff = InDeltaCutoff;
+}
+
+FQuat FLeapOneEuroRotationFilter::Filter(const FQuat& InRaw, const float InDeltaTime)
+{
+	FQuat Raw = InRaw.GetNormalized();
+
+	if (bFirstTime || InDeltaTime <= 0.f)
+	{
+		if (bFirstTime)
+		{
+			Previous = Raw;
+			PreviousSpeed = 0.f;
+			bFirstTime = false;
+		}
+		return Previous;
+	}
+
+	// Stay on the same hemisphere so the speed and slerp take the short way round
+	if ((Raw | Previous) < 0.f)
+	{
+		Raw = Raw * -1.f;
+	}
+
+	// Filter the angular speed to get the estimated
+	const float Speed = Previous.AngularDistance(Raw) / InDeltaTime;
+	const float Estimated = PreviousSpeed + CalculateAlpha(DeltaCutoff, InDeltaTime) * (Speed - PreviousSpeed);
+
+	// Use the estimated to calculate the cutoff
+	const float Cutoff = MinCutoff + CutoffSlope * Estimated;
+
+	// Low pass by slerping from the previous filtered rotation
+	Previous = FQuat::Slerp(Previous, Raw, CalculateAlpha(Cutoff, InDeltaTime)).GetNormalized();
+	PreviousSpeed = Estimated;
+	return Previous;
+}
+
+void FLeapOneEuroRotationFilter::Reset()
+{
+	Previous = FQuat::Identity;
+	PreviousSpeed = 0.f;
+	bFirstTime = true;
+}
+
+bool FLeapOneEuroRotationFilter::IsFirstTime() const
+{
+	return bFirstTime;
+}
+
+float FLeapOneEuroRotationFilter::CalculateAlpha(const float InCutoff, const float InDeltaTime)
+{
+	const float tau = 1.0 / (2 * PI * InCutoff);
+	return 1.0 / (1.0 + tau / InDeltaTime);
+}
+
 void UOneEuroFilterComponent::Init(const float InMinCutoff, const float InCutoffSlope, const float InDeltaCutoff)
 {
 	MinCutoff = InMinCutoff;
 	CutoffSlope = InCutoffSlope;
 	DeltaCutoff = InDeltaCutoff;
+	RotationFilter.Init(InMinCutoff, RotationFilter.CutoffSlope, InDeltaCutoff);
 }
 
 FVector UOneEuroFilterComponent::Filter(const FVector& InRaw, const float InDeltaTime)
@@ -80,9 +148,15 @@ FVector UOneEuroFilterComponent::Filter(const FVector& InRaw, const float InDelt
 	return RawFilter.Filter(InRaw, CalculateAlpha(Cutoff, InDeltaTime));
 }
 
+FRotator UOneEuroFilterComponent::FilterRotation(const FRotator& InRaw, const float InDeltaTime)
+{
+	return RotationFilter.Filter(InRaw.Quaternion(), InDeltaTime).Rotator();
+}
+
 void UOneEuroFilterComponent::SetMinCutoff(const float InMinCutoff)
 {
 	MinCutoff = InMinCutoff;
+	RotationFilter.MinCutoff = InMinCutoff;
 }
 
 void UOneEuroFilterComponent::SetCutoffSlope(const float InCutoffSlope)
@@ -90,9 +164,15 @@ void UOneEuroFilterComponent::SetCutoffSlope(const float InCutoffSlope)
 	CutoffSlope = InCutoffSlope;
 }
 
+void UOneEuroFilterComponent::SetRotationCutoffSlope(const float InRotationCutoffSlope)
+{
+	RotationFilter.CutoffSlope = InRotationCutoffSlope;
+}
+
 void UOneEuroFilterComponent::SetDeltaCutoff(const float InDeltaCutoff)
 {
 	DeltaCutoff = InDeltaCutoff;
+	RotationFilter.DeltaCutoff = InDeltaCutoff;
 }
 
 const FVector UOneEuroFilterComponent::CalculateCutoff(const FVector& InValue)
@@ -0,0 +1,131 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "OpenXRHandPredictor.h"
+
+FOpenXRHandPredictor::FOpenXRHandPredictor()
+	: MaxHorizon(50000), ConfidenceDecayTime(40000.f), VelocityBlend(0.5f), SampleTime(0), bHasSample(false), bHasVelocity(false)
+{
+}
+
+void FOpenXRHandPredictor::AddSample(const TArray<FVector>& InPositions, const TArray<FQuat>& InRotations, const int64 InTime)
+{
+	const int32 NumKeypoints = FMath::Min(InPositions.Num(), InRotations.Num());
+
+	// A different layout can't be differenced against the history
+	if (bHasSample && Positions.Num() != NumKeypoints)
+	{
+		Reset();
+	}
+
+	if (!bHasSample)
+	{
+		Positions = InPositions;
+		Rotations = InRotations;
+		LinearVelocities.Init(FVector::ZeroVector, NumKeypoints);
+		AngularVelocities.Init(FVector::ZeroVector, NumKeypoints);
+		SampleTime = InTime;
+		bHasSample = true;
+		return;
+	}
+
+	// Same sample polled twice in a tick, nothing new to learn
+	const int64 DeltaMicros = InTime - SampleTime;
+	if (DeltaMicros <= 0)
+	{
+		return;
+	}
+	const float DeltaSeconds = DeltaMicros / 1000000.f;
+
+	// The first measured velocity is taken as is, later ones are blended to damp jitter
+	const float Blend = bHasVelocity ? VelocityBlend : 1.f;
+
+	for (int32 Keypoint = 0; Keypoint < NumKeypoints; Keypoint++)
+	{
+		const FVector MeasuredLinear = (InPositions[Keypoint] - Positions[Keypoint]) / DeltaSeconds;
+
+		FQuat Delta = InRotations[Keypoint] * Rotations[Keypoint].Inverse();
+		if (Delta.W < 0.f)
+		{
+			Delta = Delta * -1.f;
+		}
+		FVector Axis;
+		float Angle;
+		Delta.ToAxisAndAngle(Axis, Angle);
+		const FVector MeasuredAngular = Axis * (Angle / DeltaSeconds);
+
+		LinearVelocities[Keypoint] = FMath::Lerp(LinearVelocities[Keypoint], MeasuredLinear, Blend);
+		AngularVelocities[Keypoint] = FMath::Lerp(AngularVelocities[Keypoint], MeasuredAngular, Blend);
+
+		Positions[Keypoint] = InPositions[Keypoint];
+		Rotations[Keypoint] = InRotations[Keypoint];
+	}
+
+	SampleTime = InTime;
+	bHasVelocity = true;
+}
+
+void FOpenXRHandPredictor::Reset()
+{
+	bHasSample = false;
+	bHasVelocity = false;
+	SampleTime = 0;
+}
+
+float FOpenXRHandPredictor::Predict(const int64 InTime, TArray<FVector>& OutPositions, TArray<FQuat>& OutRotations) const
+{
+	const int32 NumKeypoints = Positions.Num();
+	OutPositions.SetNumUninitialized(NumKeypoints, false);
+	OutRotations.SetNumUninitialized(NumKeypoints, false);
+
+	if (!bHasSample)
+	{
+		return 0.f;
+	}
+
+	const int64 Horizon = FMath::Clamp(InTime - SampleTime, -MaxHorizon, MaxHorizon);
+	const float HorizonSeconds = Horizon / 1000000.f;
+
+	for (int32 Keypoint = 0; Keypoint < NumKeypoints; Keypoint++)
+	{
+		ExtrapolateKeypoint(Keypoint, HorizonSeconds, OutPositions[Keypoint], OutRotations[Keypoint]);
+	}
+
+	if (ConfidenceDecayTime <= 0.f)
+	{
+		return 1.f;
+	}
+	return FMath::Exp(-FMath::Abs((float) Horizon) / ConfidenceDecayTime);
+}
+
+bool FOpenXRHandPredictor::PredictKeypoint(const int32 Keypoint, const int64 InTime, FVector& OutPosition, FQuat& OutRotation) const
+{
+	if (!bHasSample || !Positions.IsValidIndex(Keypoint))
+	{
+		return false;
+	}
+	ExtrapolateKeypoint(Keypoint, GetHorizonSeconds(InTime), OutPosition, OutRotation);
+	return true;
+}
+
+void FOpenXRHandPredictor::ExtrapolateKeypoint(
+	const int32 Keypoint, const float HorizonSeconds, FVector& OutPosition, FQuat& OutRotation) const
+{
+	OutPosition = Positions[Keypoint] + LinearVelocities[Keypoint] * HorizonSeconds;
+
+	const FVector AngularStep = AngularVelocities[Keypoint] * HorizonSeconds;
+	const float Angle = AngularStep.Size();
+	if (Angle > KINDA_SMALL_NUMBER)
+	{
+		OutRotation = FQuat(AngularStep / Angle, Angle) * Rotations[Keypoint];
+	}
+	else
+	{
+		OutRotation = Rotations[Keypoint];
+	}
+}
@@ -0,0 +1,76 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Per-joint constant velocity model for one OpenXR hand.
+ *
+ * Each keypoint sample updates smoothed linear and angular velocities, Predict() then extrapolates every
+ * keypoint to a requested time. The horizon is clamped and the returned confidence decays with the
+ * distance from the last real sample, so stale predictions are visibly less trusted.
+ */
+class FOpenXRHandPredictor
+{
+public:
+	FOpenXRHandPredictor();
+
+	/** Add a keypoint sample, InTime in microseconds */
+	void AddSample(const TArray<FVector>& InPositions, const TArray<FQuat>& InRotations, const int64 InTime);
+
+	/** Forget the history, e.g. when the hand is lost */
+	void Reset();
+
+	bool HasSample() const
+	{
+		return bHasSample;
+	}
+
+	int64 GetSampleTime() const
+	{
+		return SampleTime;
+	}
+
+	/** Extrapolate all keypoints to InTime (microseconds). Returns the prediction confidence in [0, 1] */
+	float Predict(const int64 InTime, TArray<FVector>& OutPositions, TArray<FQuat>& OutRotations) const;
+
+	/** Extrapolate a single keypoint to InTime (microseconds), false if there is no sample for it */
+	bool PredictKeypoint(const int32 Keypoint, const int64 InTime, FVector& OutPosition, FQuat& OutRotation) const;
+
+	/** Furthest we extrapolate in either direction, in microseconds */
+	int64 MaxHorizon;
+
+	/** Time constant of the confidence decay, in microseconds */
+	float ConfidenceDecayTime;
+
+	/** Weight of the newest velocity measurement, lower is smoother */
+	float VelocityBlend;
+
+private:
+	void ExtrapolateKeypoint(const int32 Keypoint, const float HorizonSeconds, FVector& OutPosition, FQuat& OutRotation) const;
+
+	float GetHorizonSeconds(const int64 InTime) const
+	{
+		return FMath::Clamp(InTime - SampleTime, -MaxHorizon, MaxHorizon) / 1000000.f;
+	}
+
+	TArray<FVector> Positions;
+	TArray<FQuat> Rotations;
+
+	/** cm/s */
+	TArray<FVector> LinearVelocities;
+
+	/** Rotation axis scaled by rad/s */
+	TArray<FVector> AngularVelocities;
+
+	int64 SampleTime;
+	bool bHasSample;
+	bool bHasVelocity;
+};
@@ -13,6 +13,7 @@
 #include "IXRTrackingSystem.h"
 #include "Kismet/GameplayStatics.h"
 #include "LeapBlueprintFunctionLibrary.h"
+#include "LeapStats.h"
 #include "LeapUtility.h"
 #include "Runtime/Engine/Classes/Engine/World.h"
 
@@ -37,6 +38,21 @@ FOpenXRToLeapWrapper::FOpenXRToLeapWrapper()
 
 	DummyLeapFrame.framerate = 90;
 	DummyLeapFrame.pHands = DummyLeapHands;
+
+	PredictedLeapHands[0] = DummyLeapHands[0];
+	PredictedLeapHands[1] = DummyLeapHands[1];
+	PredictedLeapFrame = DummyLeapFrame;
+	PredictedLeapFrame.pHands = PredictedLeapHands;
+
+	// Keypoint buffers are reused every frame
+	for (int32 HandIndex = 0; HandIndex < 2; HandIndex++)
+	{
+		KeypointPositions[HandIndex].Reserve(EHandKeypointCount);
+		KeypointRotations[HandIndex].Reserve(EHandKeypointCount);
+		KeypointRadii[HandIndex].Reserve(EHandKeypointCount);
+	}
+	PredictedPositions.Reserve(EHandKeypointCount);
+	PredictedRotations.Reserve(EHandKeypointCount);
 }
 
 FOpenXRToLeapWrapper::~FOpenXRToLeapWrapper()
@@ -124,192 +140,197 @@ LEAP_VECTOR ConvertFVectorToLeapVector(const FVector& UEVector)
 	return Ret;
 }
 
-void FOpenXRToLeapWrapper::ConvertToLeapSpace(LEAP_HAND& LeapHand, const TArray<FVector>& Positions, const TArray<FQuat>& Rotations)
+// Where each OpenXR keypoint lands in a LEAP_HAND. Joints shared between two bones are written to both.
+struct FOpenXRKeypointTargets
+{
+	uint8 NumPositions;
+	uint8 NumRotations;
+	uint16 Positions[3];
+	uint16 Rotations[2];
+};
+
+#define LEAP_HAND_OFFSET(Member) ((uint16) STRUCT_OFFSET(LEAP_HAND, Member))
+
+#define LEAP_FINGER_TARGETS(Digit)                                                                         \
+	{1, 1, {LEAP_HAND_OFFSET(Digit.metacarpal.prev_joint)}, {LEAP_HAND_OFFSET(Digit.metacarpal.rotation)}}, \
+	{2, 1, {LEAP_HAND_OFFSET(Digit.proximal.prev_joint), LEAP_HAND_OFFSET(Digit.metacarpal.next_joint)},   \
+		{LEAP_HAND_OFFSET(Digit.proximal.rotation)}},                                                      \
+	{2, 1, {LEAP_HAND_OFFSET(Digit.intermediate.prev_joint), LEAP_HAND_OFFSET(Digit.proximal.next_joint)}, \
+		{LEAP_HAND_OFFSET(Digit.intermediate.rotation)}},                                                  \
+	{2, 1, {LEAP_HAND_OFFSET(Digit.distal.prev_joint), LEAP_HAND_OFFSET(Digit.intermediate.next_joint)},   \
+		{LEAP_HAND_OFFSET(Digit.distal.rotation)}},                                                        \
+	{1, 0, {LEAP_HAND_OFFSET(Digit.distal.next_joint)}, {}}
+
+static_assert(EHandKeypointCount == 26, "OpenXR keypoint layout changed, update KeypointTargets");
+
+// Indexed by EHandKeypoint
+static const FOpenXRKeypointTargets KeypointTargets[EHandKeypointCount] = {
+	// Palm, wrist orientation comes from palm orientation in bodystate
+	{1, 1, {LEAP_HAND_OFFSET(palm.position)}, {LEAP_HAND_OFFSET(palm.orientation)}},
+	// Wrist, comes from arm next joint in bodystate
+	{2, 1, {LEAP_HAND_OFFSET(arm.prev_joint), LEAP_HAND_OFFSET(arm.next_joint)}, {LEAP_HAND_OFFSET(arm.rotation)}},
+
+	/** Thumb, from the leap data header
+	 *
+	 * For thumbs, this bone is set to have zero length and width, an identity basis matrix,
+	 * and its joint positions are equal.
+	 * Note that this is anatomically incorrect; in anatomical terms, the intermediate phalange
+	 * is absent in a real thumb, rather than the metacarpal bone. In the Leap Motion model,
+	 * however, we use a "zero" metacarpal bone instead for ease of programming.
+	 * @since 3.0.0
+	 */
+	{2, 2, {LEAP_HAND_OFFSET(thumb.metacarpal.prev_joint), LEAP_HAND_OFFSET(thumb.proximal.prev_joint)},
+		{LEAP_HAND_OFFSET(thumb.metacarpal.rotation), LEAP_HAND_OFFSET(thumb.proximal.rotation)}},
+	{3, 1,
+		{LEAP_HAND_OFFSET(thumb.intermediate.prev_joint), LEAP_HAND_OFFSET(thumb.metacarpal.next_joint),
+			LEAP_HAND_OFFSET(thumb.proximal.next_joint)},
+		{LEAP_HAND_OFFSET(thumb.intermediate.rotation)}},
+	{2, 1, {LEAP_HAND_OFFSET(thumb.distal.prev_joint), LEAP_HAND_OFFSET(thumb.intermediate.next_joint)},
+		{LEAP_HAND_OFFSET(thumb.distal.rotation)}},
+	// tip is next of distal
+	{1, 0, {LEAP_HAND_OFFSET(thumb.distal.next_joint)}, {}},
+
+	LEAP_FINGER_TARGETS(index),
+	LEAP_FINGER_TARGETS(middle),
+	LEAP_FINGER_TARGETS(ring),
+	LEAP_FINGER_TARGETS(pinky),
+};
+
+#undef LEAP_FINGER_TARGETS
+#undef LEAP_HAND_OFFSET
+
+void FOpenXRToLeapWrapper::ConvertKeypointToLeap(const FTransform& InTrackingToWorld, const FVector& Position,
+	const FQuat& Rotation, LEAP_VECTOR& OutPosition, LEAP_QUATERNION& OutRotation)
+{
+	// additional rotate all to get into Leap rotation space
+	// see FLeapUtility::LeapRotationOffset()
+	static const FQuat RotateToLeap = FRotator(90, 0, 180).Quaternion();
+
+	// Take out the player transform, this isn't valid as we want Leap Space which knows nothing about
+	// the player world position
+	OutPosition = ConvertPositionToLeap(RotateToLeap.RotateVector(InTrackingToWorld.InverseTransformPosition(Position)));
+	OutRotation = ConvertOrientationToLeap(RotateToLeap * InTrackingToWorld.InverseTransformRotation(Rotation));
+}
+
+void FOpenXRToLeapWrapper::ConvertToLeapSpace(
+	LEAP_HAND& LeapHand, const FTransform& InTrackingToWorld, const TArray<FVector>& Positions, const TArray<FQuat>& Rotations)
 {
-	if (!XRTrackingSystem)
+	uint8* HandBase = (uint8*) &LeapHand;
+	const int32 NumKeypoints = FMath::Min3(Positions.Num(), Rotations.Num(), (int32) EHandKeypointCount);
+
+	for (int32 KeyPoint = 0; KeyPoint < NumKeypoints; KeyPoint++)
 	{
-		return;
+		LEAP_VECTOR LeapPosition;
+		LEAP_QUATERNION LeapRotation;
+		ConvertKeypointToLeap(InTrackingToWorld, Positions[KeyPoint], Rotations[KeyPoint], LeapPosition, LeapRotation);
+
+		const FOpenXRKeypointTargets& Targets = KeypointTargets[KeyPoint];
+		for (int32 Index = 0; Index < Targets.NumPositions; Index++)
+		{
+			*(LEAP_VECTOR*) (HandBase + Targets.Positions[Index]) = LeapPosition;
+		}
+		for (int32 Index = 0; Index < Targets.NumRotations; Index++)
+		{
+			*(LEAP_QUATERNION*) (HandBase + Targets.Rotations[Index]) = LeapRotation;
+		}
 	}
-	// Enums for each bone are in EHandKeypoint
-	uint8 KeyPoint = 0;
-	for (auto Position : Positions)
+	LeapHand.arm.width = 10;
+}
+
+bool FOpenXRToLeapWrapper::GetHandPose(
+	const int32 HandIndex, const bool bPredict, const int64 FingerTime, const int64 HandTime, FOpenXRHandPose& OutPose)
+{
+	check(HandIndex >= 0 && HandIndex < 2);
+
+	if (HandTracker == nullptr || !HandStatus[HandIndex])
 	{
-		auto Rotation = Rotations[KeyPoint];
+		return false;
+	}
 
-		// Take out the player transform, this isn't valid as we want Leap Space which knows nothing about
-		// the player world position
-		const FTransform& TrackingToWorldTransform = XRTrackingSystem->GetTrackingToWorldTransform();
-		Position = TrackingToWorldTransform.InverseTransformPosition(Position);
-		Rotation = TrackingToWorldTransform.InverseTransformRotation(Rotation);
+	const TArray<FVector>* Positions = &KeypointPositions[HandIndex];
+	const TArray<FQuat>* Rotations = &KeypointRotations[HandIndex];
+	if (bPredict)
+	{
+		if (!HandPredictors[HandIndex].HasSample())
+		{
+			return false;
+		}
+		HandPredictors[HandIndex].Predict(FingerTime, PredictedPositions, PredictedRotations);
+		Positions = &PredictedPositions;
+		Rotations = &PredictedRotations;
+	}
+
+	// Same chain as LEAP_HAND -> FLeapHandData, minus the intermediate structures
+	const int32 NumKeypoints = FMath::Min3(Positions->Num(), Rotations->Num(), (int32) EHandKeypointCount);
+	OutPose.Positions.SetNumUninitialized(NumKeypoints, false);
+	OutPose.Rotations.SetNumUninitialized(NumKeypoints, false);
+
+	LEAP_VECTOR LeapPosition;
+	LEAP_QUATERNION LeapRotation;
+	for (int32 KeyPoint = 0; KeyPoint < NumKeypoints; KeyPoint++)
+	{
+		ConvertKeypointToLeap(TrackingToWorld, (*Positions)[KeyPoint], (*Rotations)[KeyPoint], LeapPosition, LeapRotation);
 
-		// additional rotate all to get into Leap rotation space
-		// see FLeapUtility::LeapRotationOffset()
-		FTransform RotateToLeap;
-		RotateToLeap.SetRotation(FRotator(90, 0, 180).Quaternion());
+		OutPose.Positions[KeyPoint] = FLeapUtility::ConvertAndScaleLeapVectorToFVectorWithHMDOffsets(LeapPosition);
+		OutPose.Rotations[KeyPoint] = FLeapUtility::ConvertToFQuatWithHMDOffsets(LeapRotation).Rotator();
 
-		Position = RotateToLeap.TransformPosition(Position);
-		Rotation = RotateToLeap.TransformRotation(Rotation);
+		if (KeyPoint == (int32) EHandKeypoint::Palm)
+		{
+			OutPose.PalmOrientation = FLeapUtility::ConvertLeapQuatToFQuat(LeapRotation).Rotator();
+		}
+	}
 
-		EHandKeypoint eKeyPoint = (EHandKeypoint) KeyPoint;
-		switch (eKeyPoint)
+	// The hand frame only overrides arm and palm positions, see FLeapHandData::SetArmPartialsFromLeapHand()
+	if (bPredict)
+	{
+		const int32 PartialKeypoints[] = {(int32) EHandKeypoint::Palm, (int32) EHandKeypoint::Wrist};
+		for (const int32 KeyPoint : PartialKeypoints)
 		{
-			case EHandKeypoint::Palm:
-				// wrist orientation comes from palm orientation in bodystate
-				// palm orientation is calculated from palm direction in LeapHandData
-				{
-					LeapHand.palm.orientation = ConvertOrientationToLeap(Rotation);
-					LeapHand.palm.position = ConvertPositionToLeap(Position);
-				}
-				break;
-			case EHandKeypoint::Wrist:
-				// wrist comes from arm next joint in bodystate
-				LeapHand.arm.prev_joint = LeapHand.arm.next_joint = ConvertPositionToLeap(Position);
-				// set arm rotation from Wrist
-				LeapHand.arm.rotation = ConvertOrientationToLeap(Rotation);
-				LeapHand.arm.width = 10;
-				break;
-				// Thumb ////////////////////////////////////////////////////
-				/** From the leap data header
-				 *
-				 * For thumbs, this bone is set to have zero length and width, an identity basis matrix,
-				 * and its joint positions are equal.
-				 * Note that this is anatomically incorrect; in anatomical terms, the intermediate phalange
-				 * is absent in a real thumb, rather than the metacarpal bone. In the Leap Motion model,
-				 * however, we use a "zero" metacarpal bone instead for ease of programming.
-				 * @since 3.0.0
-				 */
-			case EHandKeypoint::ThumbMetacarpal:
-				LeapHand.thumb.metacarpal.prev_joint = LeapHand.thumb.proximal.prev_joint = ConvertPositionToLeap(Position);
-				LeapHand.thumb.metacarpal.rotation = LeapHand.thumb.proximal.rotation = ConvertOrientationToLeap(Rotation);
-
-				break;
-			case EHandKeypoint::ThumbProximal:
-				LeapHand.thumb.intermediate.prev_joint = LeapHand.thumb.metacarpal.next_joint = LeapHand.thumb.proximal.next_joint =
-					ConvertPositionToLeap(Position);
-				LeapHand.thumb.intermediate.rotation = ConvertOrientationToLeap(Rotation);
-				break;
-			case EHandKeypoint::ThumbDistal:
-				LeapHand.thumb.distal.prev_joint = LeapHand.thumb.intermediate.next_joint = ConvertPositionToLeap(Position);
-				LeapHand.thumb.distal.rotation = ConvertOrientationToLeap(Rotation);
-				break;
-			case EHandKeypoint::ThumbTip:
-				// tip is next of distal
-				LeapHand.thumb.distal.next_joint = ConvertPositionToLeap(Position);
-				break;
-
-			// Index ////////////////////////////////////////////////////
-			case EHandKeypoint::IndexMetacarpal:
-				LeapHand.index.metacarpal.prev_joint = ConvertPositionToLeap(Position);
-				LeapHand.index.metacarpal.rotation = ConvertOrientationToLeap(Rotation);
-
-				break;
-			case EHandKeypoint::IndexProximal:
-				LeapHand.index.proximal.prev_joint = LeapHand.index.metacarpal.next_joint = ConvertPositionToLeap(Position);
-				LeapHand.index.proximal.rotation = ConvertOrientationToLeap(Rotation);
-
-				break;
-			case EHandKeypoint::IndexIntermediate:
-				LeapHand.index.intermediate.prev_joint = LeapHand.index.proximal.next_joint = ConvertPositionToLeap(Position);
-				LeapHand.index.intermediate.rotation = ConvertOrientationToLeap(Rotation);
-
-				break;
-			case EHandKeypoint::IndexDistal:
-				LeapHand.index.distal.prev_joint = LeapHand.index.intermediate.next_joint = ConvertPositionToLeap(Position);
-				LeapHand.index.distal.rotation = ConvertOrientationToLeap(Rotation);
-
-				break;
-			case EHandKeypoint::IndexTip:
-				LeapHand.index.distal.next_joint = ConvertPositionToLeap(Position);
-
-				break;
-			// Middle ////////////////////////////////////////////////////
-			case EHandKeypoint::MiddleMetacarpal:
-				LeapHand.middle.metacarpal.prev_joint = ConvertPositionToLeap(Position);
-				LeapHand.middle.metacarpal.rotation = ConvertOrientationToLeap(Rotation);
-
-				break;
-			case EHandKeypoint::MiddleProximal:
-				LeapHand.middle.proximal.prev_joint = LeapHand.middle.metacarpal.next_joint = ConvertPositionToLeap(Position);
-				LeapHand.middle.proximal.rotation = ConvertOrientationToLeap(Rotation);
-
-				break;
-			case EHandKeypoint::MiddleIntermediate:
-				LeapHand.middle.intermediate.prev_joint = LeapHand.middle.proximal.next_joint = ConvertPositionToLeap(Position);
-				LeapHand.middle.intermediate.rotation = ConvertOrientationToLeap(Rotation);
-
-				break;
-			case EHandKeypoint::MiddleDistal:
-				LeapHand.middle.distal.prev_joint = LeapHand.middle.intermediate.next_joint = ConvertPositionToLeap(Position);
-				LeapHand.middle.distal.rotation = ConvertOrientationToLeap(Rotation);
-
-				break;
-			case EHandKeypoint::MiddleTip:
-				LeapHand.middle.distal.next_joint = ConvertPositionToLeap(Position);
-
-				break;
-			// Ring ////////////////////////////////////////////////////
-			case EHandKeypoint::RingMetacarpal:
-				LeapHand.ring.metacarpal.prev_joint = ConvertPositionToLeap(Position);
-				LeapHand.ring.metacarpal.rotation = ConvertOrientationToLeap(Rotation);
-
-				break;
-			case EHandKeypoint::RingProximal:
-				LeapHand.ring.proximal.prev_joint = LeapHand.ring.metacarpal.next_joint = ConvertPositionToLeap(Position);
-				LeapHand.ring.proximal.rotation = ConvertOrientationToLeap(Rotation);
-
-				break;
-			case EHandKeypoint::RingIntermediate:
-				LeapHand.ring.intermediate.prev_joint = LeapHand.ring.proximal.next_joint = ConvertPositionToLeap(Position);
-				LeapHand.ring.intermediate.rotation = ConvertOrientationToLeap(Rotation);
-
-				break;
-			case EHandKeypoint::RingDistal:
-				LeapHand.ring.distal.prev_joint = LeapHand.ring.intermediate.next_joint = ConvertPositionToLeap(Position);
-				LeapHand.ring.distal.rotation = ConvertOrientationToLeap(Rotation);
-
-				break;
-			case EHandKeypoint::RingTip:
-				LeapHand.ring.distal.next_joint = ConvertPositionToLeap(Position);
-
-				break;
-
-			// Little/pinky ////////////////////////////////////////////////////
-			case EHandKeypoint::LittleMetacarpal:
-				LeapHand.pinky.metacarpal.prev_joint = ConvertPositionToLeap(Position);
-				LeapHand.pinky.metacarpal.rotation = ConvertOrientationToLeap(Rotation);
-
-				break;
-			case EHandKeypoint::LittleProximal:
-				LeapHand.pinky.proximal.prev_joint = LeapHand.pinky.metacarpal.next_joint = ConvertPositionToLeap(Position);
-				LeapHand.pinky.proximal.rotation = ConvertOrientationToLeap(Rotation);
-
-				break;
-			case EHandKeypoint::LittleIntermediate:
-				LeapHand.pinky.intermediate.prev_joint = LeapHand.pinky.proximal.next_joint = ConvertPositionToLeap(Position);
-				LeapHand.pinky.intermediate.rotation = ConvertOrientationToLeap(Rotation);
-
-				break;
-			case EHandKeypoint::LittleDistal:
-				LeapHand.pinky.distal.prev_joint = LeapHand.pinky.intermediate.next_joint = ConvertPositionToLeap(Position);
-				LeapHand.pinky.distal.rotation = ConvertOrientationToLeap(Rotation);
-
-				break;
-			case EHandKeypoint::LittleTip:
-				LeapHand.pinky.distal.next_joint = ConvertPositionToLeap(Position);
-
-				break;
-			default:
-				UE_LOG(UltraleapTrackingLog, Log,
-					TEXT("FOpenXRToLeapWrapper::ConvertToLeapSpace() - Unknown keypoint found in OpenXR data"));
-				break;
+			FVector Position;
+			FQuat Rotation;
+			if (KeyPoint < NumKeypoints && HandPredictors[HandIndex].PredictKeypoint(KeyPoint, HandTime, Position, Rotation))
+			{
+				ConvertKeypointToLeap(TrackingToWorld, Position, Rotation, LeapPosition, LeapRotation);
+				OutPose.Positions[KeyPoint] = FLeapUtility::ConvertAndScaleLeapVectorToFVectorWithHMDOffsets(LeapPosition);
+			}
 		}
-		KeyPoint++;
 	}
+
+	return NumKeypoints == EHandKeypointCount;
 }
 
+// Extrapolates the last OpenXR samples with the per hand motion models, GetFrame() must have been called this tick
 LEAP_TRACKING_EVENT* FOpenXRToLeapWrapper::GetInterpolatedFrameAtTime(int64 TimeStamp)
 {
-	return GetFrame();
+	if (HandTracker == nullptr)
+	{
+		return &DummyLeapFrame;
+	}
+	LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapOpenXRConversion);
+
+	PredictedLeapFrame.info = DummyLeapFrame.info;
+	PredictedLeapFrame.info.timestamp = TimeStamp;
+	PredictedLeapFrame.tracking_frame_id = DummyLeapFrame.tracking_frame_id;
+	PredictedLeapFrame.framerate = DummyLeapFrame.framerate;
+	PredictedLeapFrame.nHands = 0;
+
+	for (int32 HandIndex = 0; HandIndex < 2; HandIndex++)
+	{
+		if (!HandStatus[HandIndex] || !HandPredictors[HandIndex].HasSample())
+		{
+			continue;
+		}
+		LEAP_HAND& PredictedHand = PredictedLeapHands[PredictedLeapFrame.nHands];
+		PredictedHand = DummyLeapHands[HandIndex];
+
+		const float Confidence = HandPredictors[HandIndex].Predict(TimeStamp, PredictedPositions, PredictedRotations);
+		ConvertToLeapSpace(PredictedHand, TrackingToWorld, PredictedPositions, PredictedRotations);
+		PredictedHand.confidence = Confidence;
+
+		PredictedLeapFrame.nHands++;
+	}
+
+	return &PredictedLeapFrame;
 }
 void FOpenXRToLeapWrapper::UpdateHandState()
 {
@@ -326,9 +347,10 @@ LEAP_TRACKING_EVENT* FOpenXRToLeapWrapper::GetFrame()
 	{
 		return &DummyLeapFrame;
 	}
-	TArray<FVector> OutPositions[2];
-	TArray<FQuat> OutRotations[2];
-	TArray<float> OutRadii[2];
+	LEAP_SCOPE_CYCLE_COUNTER(STAT_LeapOpenXRConversion);
+	TArray<FVector>* OutPositions = KeypointPositions;
+	TArray<FQuat>* OutRotations = KeypointRotations;
+	TArray<float>* OutRadii = KeypointRadii;
 
 	// status only true when the hand is being tracked/visible to the tracking device
 	// these are in world space
@@ -337,6 +359,12 @@ LEAP_TRACKING_EVENT* FOpenXRToLeapWrapper::GetFrame()
 	bool StatusLeft = HandTracker->GetAllKeypointStates(EControllerHand::Left, OutPositions[0], OutRotations[0], OutRadii[0]);
 	bool StatusRight = HandTracker->GetAllKeypointStates(EControllerHand::Right, OutPositions[1], OutRotations[1], OutRadii[1]);
 
+	// One fetch per frame, shared by both hands and by the predicted frames
+	if (XRTrackingSystem)
+	{
+		TrackingToWorld = XRTrackingSystem->GetTrackingToWorldTransform();
+	}
+
 	DummyLeapFrame.nHands = StatusLeft + StatusRight;
 	DummyLeapFrame.info.frame_id++;
 	UWorld* World = nullptr;
@@ -356,25 +384,35 @@ LEAP_TRACKING_EVENT* FOpenXRToLeapWrapper::GetFrame()
 
 	if (StatusLeft)
 	{
-		ConvertToLeapSpace(DummyLeapHands[0], OutPositions[0], OutRotations[0]);
+		ConvertToLeapSpace(DummyLeapHands[0], TrackingToWorld, OutPositions[0], OutRotations[0]);
 	}
 	if (StatusRight)
 	{
-		ConvertToLeapSpace(DummyLeapHands[1], OutPositions[1], OutRotations[1]);
+		ConvertToLeapSpace(DummyLeapHands[1], TrackingToWorld, OutPositions[1], OutRotations[1]);
+	}
+
+	// Feed the motion models, a lost hand starts over so it doesn't fly off with stale velocity
+	HandStatus[0] = StatusLeft;
+	HandStatus[1] = StatusRight;
+	for (int32 HandIndex = 0; HandIndex < 2; HandIndex++)
+	{
+		DummyLeapHands[HandIndex].confidence = HandStatus[HandIndex] ? 1.f : 0.f;
+		if (HandStatus[HandIndex])
+		{
+			HandPredictors[HandIndex].AddSample(OutPositions[HandIndex], OutRotations[HandIndex], DummyLeapFrame.info.timestamp);
+		}
+		else
+		{
+			HandPredictors[HandIndex].Reset();
+		}
 	}
 
 	return &DummyLeapFrame;
 }
 int64_t FOpenXRToLeapWrapper::GetDummyLeapTime()
 {
-	// time in microseconds
-	if (!CurrentWorld)
-	{
-		return 0;
-	}
-	{
-		return CurrentWorld->GetTimeSeconds() * 1000000.0f;
-	}
+	// time in microseconds, real time so prediction keeps pace while the game is paused or dilated
+	return (int64_t)(FPlatformTime::Seconds() * 1000000.0);
 }
 void FOpenXRToLeapWrapper::SetWorld(UWorld* World)
 {
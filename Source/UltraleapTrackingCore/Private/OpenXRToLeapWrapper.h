@@ -10,7 +10,22 @@
 
 #include "CoreMinimal.h"
 #include "LeapWrapper.h"
+#include "OpenXRHandPredictor.h"
 #include "SceneManagement.h"
+
+/** One hand's OpenXR keypoints already in BodyState space, same conventions as FLeapHandData */
+struct FOpenXRHandPose
+{
+	/** Indexed by EHandKeypoint */
+	TArray<FVector> Positions;
+
+	/** Bone rotations with the mount offsets applied, indexed by EHandKeypoint */
+	TArray<FRotator> Rotations;
+
+	/** Palm orientation as in FLeapPalmData, i.e. without the mount offsets */
+	FRotator PalmOrientation;
+};
+
 /**
  *
  */
@@ -44,6 +59,18 @@ public:
 	}
 	virtual void SetTrackingMode(eLeapTrackingMode TrackingMode) override;
 
+	/** Convert world space OpenXR keypoints (indexed by EHandKeypoint) into Leap space bones */
+	void ConvertToLeapSpace(
+		LEAP_HAND& LeapHand, const FTransform& InTrackingToWorld, const TArray<FVector>& Positions, const TArray<FQuat>& Rotations);
+
+	/**
+	 * Convert the last sampled keypoints of one hand straight to BodyState space, skipping LEAP_HAND and FLeapHandData.
+	 * With bPredict the keypoints are extrapolated to FingerTime and the wrist position to HandTime, matching the two
+	 * interpolated frames the input device requests. GetFrame() must have been called this tick.
+	 * Returns false if the hand isn't tracked.
+	 */
+	bool GetHandPose(const int32 HandIndex, const bool bPredict, const int64 FingerTime, const int64 HandTime, FOpenXRHandPose& OutPose);
+
 private:
 	class IXRTrackingSystem* XRTrackingSystem = nullptr;
 	class IHandTracker* HandTracker = nullptr;
@@ -52,8 +79,23 @@ private:
 	LEAP_HAND DummyLeapHands[2];
 	LEAP_DEVICE_INFO DummyDeviceInfo;
 
+	// Prediction, one model per hand fed from GetFrame()
+	FOpenXRHandPredictor HandPredictors[2];
+	bool HandStatus[2] = {false, false};
+	LEAP_TRACKING_EVENT PredictedLeapFrame;
+	LEAP_HAND PredictedLeapHands[2];
+	TArray<FVector> PredictedPositions;
+	TArray<FQuat> PredictedRotations;
+
+	// Persistent keypoint buffers, sized once for EHandKeypointCount
+	TArray<FVector> KeypointPositions[2];
+	TArray<FQuat> KeypointRotations[2];
+	TArray<float> KeypointRadii[2];
+	FTransform TrackingToWorld;
+
 	LEAP_QUATERNION ConvertOrientationToLeap(const FQuat& FromOpenXR);
-	void ConvertToLeapSpace(LEAP_HAND& LeapHand, const TArray<FVector>& Positions, const TArray<FQuat>& Rotations);
+	void ConvertKeypointToLeap(const FTransform& InTrackingToWorld, const FVector& Position, const FQuat& Rotation,
+		LEAP_VECTOR& OutPosition, LEAP_QUATERNION& OutRotation);
 	int64_t GetDummyLeapTime();
 
 	ELeapQuatSwizzleAxisB SwizzleX = ELeapQuatSwizzleAxisB::MinusY;
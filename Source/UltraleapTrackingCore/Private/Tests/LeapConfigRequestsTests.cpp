@@ -0,0 +1,139 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LeapConfigRequests.h"
+#include "Misc/AutomationTest.h"
+
+namespace
+{
+/** Stands in for the LeapC call, hands out request ids the way the service does */
+struct FFakeConfigService
+{
+	uint32 NextRequestId = 1;
+	bool bFail = false;
+
+	TFunction<bool(uint32&)> Sender()
+	{
+		return [this](uint32& OutRequestId) {
+			OutRequestId = NextRequestId++;
+			return !bFail;
+		};
+	}
+};
+}	 // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapConfigRequestsReadTest, "UltraleapTracking.ConfigRequests.Read",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapConfigRequestsReadTest::RunTest(const FString& Parameters)
+{
+	FLeapConfigRequests Requests;
+	FFakeConfigService Service;
+
+	TFuture<FLeapConfigResult> First = Requests.Issue(TEXT("first"), nullptr, 10.0, Service.Sender());
+	TFuture<FLeapConfigResult> Second = Requests.Issue(TEXT("second"), nullptr, 10.0, Service.Sender());
+	TestEqual(TEXT("Both pending"), Requests.GetNumPending(), 2);
+
+	// Answers arrive out of order and are matched by request id
+	TestTrue(TEXT("Second answered"), Requests.HandleResponse(2, FLeapConfigValue::MakeString(TEXT("value"))));
+	TestTrue(TEXT("Second complete"), Second.IsReady());
+	TestFalse(TEXT("First still waiting"), First.IsReady());
+	TestTrue(TEXT("First answered"), Requests.HandleResponse(1, FLeapConfigValue::MakeFloat(0.5f)));
+
+	const FLeapConfigResult& FirstResult = First.Get();
+	TestTrue(TEXT("First succeeded"), FirstResult.bSuccess);
+	TestEqual(TEXT("First key"), FirstResult.Key, FString(TEXT("first")));
+	TestTrue(TEXT("First value"), FirstResult.Value == FLeapConfigValue::MakeFloat(0.5f));
+	TestEqual(TEXT("Second value"), Second.Get().Value.StringValue, FString(TEXT("value")));
+
+	FLeapConfigValue Cached;
+	TestTrue(TEXT("First cached"), Requests.GetCachedValue(TEXT("first"), Cached) && Cached == FLeapConfigValue::MakeFloat(0.5f));
+
+	// Answers to requests made elsewhere, or answered twice, are ignored
+	TestFalse(TEXT("Unknown id ignored"), Requests.HandleResponse(7, FLeapConfigValue::MakeBool(true)));
+	TestFalse(TEXT("Duplicate ignored"), Requests.HandleResponse(1, FLeapConfigValue::MakeBool(true)));
+	TestEqual(TEXT("Nothing pending"), Requests.GetNumPending(), 0);
+
+	// The service answers a key it doesn't know with an untyped value
+	TFuture<FLeapConfigResult> Missing = Requests.Issue(TEXT("missing"), nullptr, 10.0, Service.Sender());
+	Requests.HandleResponse(3, FLeapConfigValue());
+	TestFalse(TEXT("Unknown key fails"), Missing.Get().bSuccess);
+	TestFalse(TEXT("Unknown key not cached"), Requests.GetCachedValue(TEXT("missing"), Cached));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapConfigRequestsWriteTest, "UltraleapTracking.ConfigRequests.Write",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapConfigRequestsWriteTest::RunTest(const FString& Parameters)
+{
+	FLeapConfigRequests Requests;
+	FFakeConfigService Service;
+
+	const FLeapConfigValue Saved = FLeapConfigValue::MakeInt(3);
+	TFuture<FLeapConfigResult> Write = Requests.Issue(TEXT("key"), &Saved, 10.0, Service.Sender());
+
+	// A read answer with the same id doesn't complete a write
+	TestFalse(TEXT("Response doesn't match a write"), Requests.HandleResponse(1, Saved));
+	TestTrue(TEXT("Change matches the write"), Requests.HandleChange(1, true));
+	TestTrue(TEXT("Write succeeded"), Write.Get().bSuccess);
+	TestTrue(TEXT("Write reports the saved value"), Write.Get().Value == Saved);
+
+	FLeapConfigValue Cached;
+	TestTrue(TEXT("Written value cached"), Requests.GetCachedValue(TEXT("key"), Cached) && Cached == Saved);
+
+	// A refused write leaves the last known value
+	const FLeapConfigValue Refused = FLeapConfigValue::MakeInt(4);
+	TFuture<FLeapConfigResult> RefusedWrite = Requests.Issue(TEXT("key"), &Refused, 10.0, Service.Sender());
+	Requests.HandleChange(2, false);
+	TestFalse(TEXT("Refused write fails"), RefusedWrite.Get().bSuccess);
+	TestTrue(TEXT("Cache keeps the last value"), Requests.GetCachedValue(TEXT("key"), Cached) && Cached == Saved);
+
+	// A failing LeapC call fails the future at once and leaves nothing pending
+	Service.bFail = true;
+	TFuture<FLeapConfigResult> Unsent = Requests.Issue(TEXT("key"), &Saved, 10.0, Service.Sender());
+	TestTrue(TEXT("Unsent request fails at once"), Unsent.IsReady() && !Unsent.Get().bSuccess);
+	TestEqual(TEXT("Nothing pending"), Requests.GetNumPending(), 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapConfigRequestsExpiryTest, "UltraleapTracking.ConfigRequests.Expiry",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapConfigRequestsExpiryTest::RunTest(const FString& Parameters)
+{
+	FLeapConfigRequests Requests;
+	FFakeConfigService Service;
+
+	TFuture<FLeapConfigResult> Early = Requests.Issue(TEXT("early"), nullptr, 5.0, Service.Sender());
+	TFuture<FLeapConfigResult> Late = Requests.Issue(TEXT("late"), nullptr, 8.0, Service.Sender());
+
+	AddExpectedError(TEXT("didn't answer"), EAutomationExpectedErrorFlags::Contains, 1);
+	Requests.ExpireRequests(4.0);
+	TestEqual(TEXT("Nothing expires before its deadline"), Requests.GetNumPending(), 2);
+	Requests.ExpireRequests(6.0);
+	TestTrue(TEXT("Early request expired"), Early.IsReady() && !Early.Get().bSuccess);
+	TestFalse(TEXT("Late request still waiting"), Late.IsReady());
+
+	// An answer after the deadline finds nothing
+	TestFalse(TEXT("Late answer ignored"), Requests.HandleResponse(1, FLeapConfigValue::MakeBool(true)));
+
+	// Losing the connection fails whatever is left, continuations see the failure
+	bool bContinuationRan = false;
+	TFuture<void> Continuation = Late.Next([&bContinuationRan](const FLeapConfigResult& Result) {
+		bContinuationRan = !Result.bSuccess && Result.Key == TEXT("late");
+	});
+	Requests.FailAll();
+	Continuation.Wait();
+	TestTrue(TEXT("Continuation saw the failure"), bContinuationRan);
+	TestEqual(TEXT("Nothing pending"), Requests.GetNumPending(), 0);
+	return true;
+}
+
+#endif
@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LeapConsumerTracker.h"
+#include "Misc/AutomationTest.h"
+
+namespace
+{
+FLeapConsumerTracker::FSettings MakeConsumerSettings()
+{
+	FLeapConsumerTracker::FSettings Settings;
+	Settings.bEnabled = true;
+	Settings.PauseDelay = 2.0;
+	Settings.WarmupFrames = 3;
+	Settings.bPauseInBackground = false;
+	return Settings;
+}
+}	 // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapConsumerTrackerPauseTest, "UltraleapTracking.ConsumerTracker.Pause",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapConsumerTrackerPauseTest::RunTest(const FString& Parameters)
+{
+	FLeapConsumerTracker Tracker;
+	Tracker.SetSettings(MakeConsumerSettings());
+
+	// Startup gets a full delay for consumers to register
+	TestFalse(TEXT("Not paused at startup"), Tracker.Update(100.0, false));
+	TestFalse(TEXT("Not paused within the delay"), Tracker.Update(101.5, false) || Tracker.IsPaused());
+	TestTrue(TEXT("Pauses after the delay"), Tracker.Update(102.0, false) && Tracker.IsPaused());
+
+	// Any consumer type resumes at once
+	Tracker.SetCount(ELeapConsumerType::Subscriber, 1);
+	TestTrue(TEXT("Resumes for a subscriber"), Tracker.Update(103.0, false) && !Tracker.IsPaused());
+	TestEqual(TEXT("One consumer"), Tracker.GetNumConsumers(103.0), 1);
+
+	// Consumers going away briefly, e.g. components recreated on a level load, don't pause
+	Tracker.SetCount(ELeapConsumerType::Subscriber, 0);
+	TestFalse(TEXT("No pause within the delay"), Tracker.Update(104.0, false));
+	Tracker.SetCount(ELeapConsumerType::Component, 2);
+	TestFalse(TEXT("Still running"), Tracker.Update(104.5, false) || Tracker.IsPaused());
+	Tracker.SetCount(ELeapConsumerType::Component, 0);
+	TestTrue(TEXT("Pauses once the last consumer is gone for the delay"), Tracker.Update(106.5, false) && Tracker.IsPaused());
+
+	// Polls count for the delay after the last one
+	Tracker.NotePoll(107.0);
+	TestTrue(TEXT("Resumes for a poll"), Tracker.Update(107.0, false) && !Tracker.IsPaused());
+	TestFalse(TEXT("Poll still counts"), Tracker.Update(108.5, false));
+	TestTrue(TEXT("Pauses after polling stops"), Tracker.Update(110.6, false) && Tracker.IsPaused());
+
+	// Explicit references
+	Tracker.AddReference();
+	TestTrue(TEXT("Resumes for a reference"), Tracker.Update(111.0, false) && !Tracker.IsPaused());
+	Tracker.RemoveReference();
+	TestTrue(TEXT("Pauses after the reference is released"), Tracker.Update(113.0, false) && Tracker.IsPaused());
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapConsumerTrackerSettingsTest, "UltraleapTracking.ConsumerTracker.Settings",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapConsumerTrackerSettingsTest::RunTest(const FString& Parameters)
+{
+	FLeapConsumerTracker::FSettings Settings = MakeConsumerSettings();
+	Settings.bEnabled = false;
+	FLeapConsumerTracker Disabled;
+	Disabled.SetSettings(Settings);
+	Disabled.Update(0.0, true);
+	TestFalse(TEXT("Never pauses when disabled"), Disabled.Update(100.0, true) || Disabled.IsPaused());
+
+	Settings = MakeConsumerSettings();
+	Settings.bPauseInBackground = true;
+	FLeapConsumerTracker Background;
+	Background.SetSettings(Settings);
+	Background.SetCount(ELeapConsumerType::AnimInstance, 1);
+	TestFalse(TEXT("Running in the foreground"), Background.Update(0.0, false));
+	TestTrue(TEXT("Pauses in the background despite consumers"), Background.Update(0.5, true) && Background.IsPaused());
+	TestTrue(TEXT("Resumes in the foreground"), Background.Update(1.0, false) && !Background.IsPaused());
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapConsumerTrackerWarmupTest, "UltraleapTracking.ConsumerTracker.Warmup",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapConsumerTrackerWarmupTest::RunTest(const FString& Parameters)
+{
+	FLeapConsumerTracker Tracker;
+	Tracker.SetSettings(MakeConsumerSettings());
+	TestFalse(TEXT("No warm-up before any pause"), Tracker.ConsumeWarmupFrame(1));
+
+	Tracker.Update(0.0, false);
+	Tracker.Update(2.0, false);
+	Tracker.SetCount(ELeapConsumerType::LiveLink, 1);
+	Tracker.Update(3.0, false);
+
+	// The game ticking faster than the device repeats frames, only new ones count towards the warm-up
+	TestTrue(TEXT("Frame 10 warms up"), Tracker.ConsumeWarmupFrame(10));
+	TestTrue(TEXT("Repeated frame 10 warms up"), Tracker.ConsumeWarmupFrame(10));
+	TestTrue(TEXT("Frame 11 warms up"), Tracker.ConsumeWarmupFrame(11));
+	TestTrue(TEXT("Frame 12 warms up"), Tracker.ConsumeWarmupFrame(12));
+	TestFalse(TEXT("Frame 13 fires events"), Tracker.ConsumeWarmupFrame(13));
+	return true;
+}
+
+#endif
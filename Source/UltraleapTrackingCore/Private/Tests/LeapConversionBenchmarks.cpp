@@ -0,0 +1,283 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapPerformanceReport.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Dom/JsonObject.h"
+#include "LeapSyntheticHands.h"
+#include "LeapUtility.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UltraleapTrackingData.h"
+
+/**
+ * Microbenchmarks of the per joint conversions, each one run in isolation over a fixed input set.
+ *
+ * Every benchmark cycles through the same seeded inputs, writing each result to an output array so nothing is
+ * optimised away. One batch warms up, then NumBatches batches are timed and the fastest and median batch are
+ * reported as ns per call and calls per second. Needs no world, device or tracking service:
+ *   UnrealEditor-Cmd <Project> -nullrhi -ExecCmds="Automation RunTests UltraleapTracking.Microbenchmark; Quit"
+ * Results also go to <Saved>/Automation/UltraleapPerformance/Microbenchmark.<Name>.json and .csv
+ */
+namespace
+{
+const int32 NumInputs = 4096;
+const int32 NumHandInputs = 256;
+const int32 NumBatches = 16;
+
+/** Fixed inputs shared by every benchmark */
+struct FConversionInputs
+{
+	TArray<LEAP_VECTOR> Vectors;
+	TArray<LEAP_QUATERNION> Quats;
+	TArray<FRotator> Rotators;
+	TArray<LEAP_HAND> Hands;
+
+	FConversionInputs()
+	{
+		FRandomStream Random(0);
+		Vectors.SetNumUninitialized(NumInputs);
+		Quats.SetNumUninitialized(NumInputs);
+		Rotators.SetNumUninitialized(NumInputs);
+		for (int32 Index = 0; Index < NumInputs; Index++)
+		{
+			const FVector Vector = Random.GetUnitVector() * Random.FRandRange(0.f, 500.f);
+			Vectors[Index].x = Vector.X;
+			Vectors[Index].y = Vector.Y;
+			Vectors[Index].z = Vector.Z;
+
+			const FQuat Quat(Random.GetUnitVector(), Random.FRandRange(-PI, PI));
+			Quats[Index].x = Quat.X;
+			Quats[Index].y = Quat.Y;
+			Quats[Index].z = Quat.Z;
+			Quats[Index].w = Quat.W;
+
+			Rotators[Index] = FRotator(Random.FRandRange(-90.f, 90.f), Random.FRandRange(-180.f, 180.f), Random.FRandRange(-180.f, 180.f));
+		}
+
+		// Both hands of NumHandInputs / 2 synthetic frames, without dropouts so every slot is a hand
+		FLeapSyntheticHands SyntheticHands;
+		SyntheticHands.bDropouts = false;
+		Hands.SetNumZeroed(NumHandInputs);
+		for (int32 Index = 0; Index < NumHandInputs; Index += FLeapSyntheticHands::MaxHands)
+		{
+			LEAP_TRACKING_EVENT Event;
+			SyntheticHands.Generate((int64) Index * 11111, Event, &Hands[Index]);
+		}
+	}
+};
+
+struct FMicrobenchmarkResult
+{
+	int32 CallsPerBatch = 0;
+	double MinNanoseconds = 0.0;
+	double MedianNanoseconds = 0.0;
+
+	double GetCallsPerSecond() const
+	{
+		return MedianNanoseconds > 0.0 ? 1000000000.0 / MedianNanoseconds : 0.0;
+	}
+};
+
+/** Call Function(Index) CallsPerBatch times per batch, Index cycling through NumCycleInputs, a power of two */
+template <typename FunctionType>
+FMicrobenchmarkResult Run(const int32 CallsPerBatch, const int32 NumCycleInputs, FunctionType&& Function)
+{
+	check(FMath::IsPowerOfTwo(NumCycleInputs));
+	const int32 Mask = NumCycleInputs - 1;
+
+	TArray<double, TInlineAllocator<NumBatches>> BatchNanoseconds;
+	for (int32 Batch = -1; Batch < NumBatches; Batch++)
+	{
+		const uint64 Start = FPlatformTime::Cycles64();
+		for (int32 Call = 0; Call < CallsPerBatch; Call++)
+		{
+			Function(Call & Mask);
+		}
+		const uint64 Cycles = FPlatformTime::Cycles64() - Start;
+
+		if (Batch >= 0)
+		{
+			BatchNanoseconds.Add(FPlatformTime::ToMilliseconds64(Cycles) * 1000000.0 / CallsPerBatch);
+		}
+	}
+	BatchNanoseconds.Sort();
+
+	FMicrobenchmarkResult Result;
+	Result.CallsPerBatch = CallsPerBatch;
+	Result.MinNanoseconds = BatchNanoseconds[0];
+	Result.MedianNanoseconds = BatchNanoseconds[NumBatches / 2];
+	return Result;
+}
+
+FMicrobenchmarkResult BenchmarkConvertAndScaleLeapVector(FConversionInputs& Inputs)
+{
+	TArray<FVector> Out;
+	Out.SetNumUninitialized(NumInputs);
+	return Run(1 << 18, NumInputs, [&Inputs, &Out](const int32 Index) {
+		Out[Index] = FLeapUtility::ConvertAndScaleLeapVectorToFVectorWithHMDOffsets(Inputs.Vectors[Index]);
+	});
+}
+
+FMicrobenchmarkResult BenchmarkConvertLeapQuat(FConversionInputs& Inputs)
+{
+	TArray<FQuat> Out;
+	Out.SetNumUninitialized(NumInputs);
+	return Run(1 << 18, NumInputs,
+		[&Inputs, &Out](const int32 Index) { Out[Index] = FLeapUtility::ConvertLeapQuatToFQuat(Inputs.Quats[Index]); });
+}
+
+FMicrobenchmarkResult BenchmarkConvertLeapQuatWithHMDOffsets(FConversionInputs& Inputs)
+{
+	TArray<FQuat> Out;
+	Out.SetNumUninitialized(NumInputs);
+	return Run(1 << 18, NumInputs,
+		[&Inputs, &Out](const int32 Index) { Out[Index] = FLeapUtility::ConvertToFQuatWithHMDOffsets(Inputs.Quats[Index]); });
+}
+
+FMicrobenchmarkResult BenchmarkCombineRotators(FConversionInputs& Inputs)
+{
+	TArray<FRotator> Out;
+	Out.SetNumUninitialized(NumInputs);
+	const int32 Mask = NumInputs - 1;
+	return Run(1 << 17, NumInputs, [&Inputs, &Out, Mask](const int32 Index) {
+		Out[Index] = FLeapUtility::CombineRotators(Inputs.Rotators[Index], Inputs.Rotators[(Index + 1) & Mask]);
+	});
+}
+
+FMicrobenchmarkResult BenchmarkSetFromLeapBone(FConversionInputs& Inputs)
+{
+	TArray<FLeapBoneData> Out;
+	Out.SetNum(NumHandInputs);
+	return Run(1 << 17, NumHandInputs, [&Inputs, &Out](const int32 Index) {
+		Out[Index].SetFromLeapBone(&Inputs.Hands[Index].digits[Index % 5].bones[Index % 4]);
+	});
+}
+
+FMicrobenchmarkResult BenchmarkSetFromLeapPalm(FConversionInputs& Inputs)
+{
+	TArray<FLeapPalmData> Out;
+	Out.SetNum(NumHandInputs);
+	return Run(1 << 17, NumHandInputs,
+		[&Inputs, &Out](const int32 Index) { Out[Index].SetFromLeapPalm(&Inputs.Hands[Index].palm); });
+}
+
+FMicrobenchmarkResult BenchmarkSetFromLeapDigit(FConversionInputs& Inputs)
+{
+	TArray<FLeapDigitData> Out;
+	Out.SetNum(NumHandInputs);
+	return Run(1 << 15, NumHandInputs,
+		[&Inputs, &Out](const int32 Index) { Out[Index].SetFromLeapDigit(&Inputs.Hands[Index].digits[Index % 5]); });
+}
+
+FMicrobenchmarkResult BenchmarkSetFromLeapHand(FConversionInputs& Inputs)
+{
+	TArray<FLeapHandData> Out;
+	Out.SetNum(NumHandInputs);
+	return Run(1 << 13, NumHandInputs, [&Inputs, &Out](const int32 Index) { Out[Index].SetFromLeapHand(&Inputs.Hands[Index]); });
+}
+
+FMicrobenchmarkResult BenchmarkSetArmPartialsFromLeapHand(FConversionInputs& Inputs)
+{
+	// Partials update a hand that was already filled, as the input device does for the second interpolated frame
+	TArray<FLeapHandData> Out;
+	Out.SetNum(NumHandInputs);
+	for (int32 Index = 0; Index < NumHandInputs; Index++)
+	{
+		Out[Index].SetFromLeapHand(&Inputs.Hands[Index]);
+	}
+	return Run(1 << 15, NumHandInputs,
+		[&Inputs, &Out](const int32 Index) { Out[Index].SetArmPartialsFromLeapHand(&Inputs.Hands[Index]); });
+}
+
+struct FMicrobenchmark
+{
+	const TCHAR* Name;
+	FMicrobenchmarkResult (*Function)(FConversionInputs&);
+};
+
+const FMicrobenchmark Microbenchmarks[] = {
+	{TEXT("ConvertAndScaleLeapVectorToFVectorWithHMDOffsets"), &BenchmarkConvertAndScaleLeapVector},
+	{TEXT("ConvertLeapQuatToFQuat"), &BenchmarkConvertLeapQuat},
+	{TEXT("ConvertToFQuatWithHMDOffsets"), &BenchmarkConvertLeapQuatWithHMDOffsets},
+	{TEXT("CombineRotators"), &BenchmarkCombineRotators},
+	{TEXT("SetFromLeapBone"), &BenchmarkSetFromLeapBone},
+	{TEXT("SetFromLeapPalm"), &BenchmarkSetFromLeapPalm},
+	{TEXT("SetFromLeapDigit"), &BenchmarkSetFromLeapDigit},
+	{TEXT("SetFromLeapHand"), &BenchmarkSetFromLeapHand},
+	{TEXT("SetArmPartialsFromLeapHand"), &BenchmarkSetArmPartialsFromLeapHand},
+};
+
+void WriteResult(FAutomationTestBase& Test, const FString& Name, const FMicrobenchmarkResult& Result)
+{
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetNumberField(TEXT("calls_per_batch"), Result.CallsPerBatch);
+	Json->SetNumberField(TEXT("batches"), NumBatches);
+	Json->SetNumberField(TEXT("min_ns_per_call"), Result.MinNanoseconds);
+	Json->SetNumberField(TEXT("median_ns_per_call"), Result.MedianNanoseconds);
+	Json->SetNumberField(TEXT("calls_per_second"), Result.GetCallsPerSecond());
+
+	FString JsonText;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonText);
+	FJsonSerializer::Serialize(Json, Writer);
+
+	const FString Csv = FString(TEXT("name,calls_per_batch,batches,min_ns_per_call,median_ns_per_call,calls_per_second")) +
+						LINE_TERMINATOR +
+						FString::Printf(TEXT("%s,%d,%d,%.3f,%.3f,%.0f"), *Name, Result.CallsPerBatch, NumBatches,
+							Result.MinNanoseconds, Result.MedianNanoseconds, Result.GetCallsPerSecond()) +
+						LINE_TERMINATOR;
+
+	const FString BasePath = FPaths::Combine(FLeapPerformanceReport::GetOutputDir(), TEXT("Microbenchmark.") + Name);
+	if (!FFileHelper::SaveStringToFile(JsonText, *(BasePath + TEXT(".json"))) ||
+		!FFileHelper::SaveStringToFile(Csv, *(BasePath + TEXT(".csv"))))
+	{
+		Test.AddWarning(FString::Printf(TEXT("Couldn't write the results to %s"), *BasePath));
+	}
+}
+}	 // namespace
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(
+	FLeapConversionMicrobenchmark, "UltraleapTracking.Microbenchmark", LEAP_PERFORMANCE_TEST_FLAGS)
+
+void FLeapConversionMicrobenchmark::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const FMicrobenchmark& Microbenchmark : Microbenchmarks)
+	{
+		OutBeautifiedNames.Add(Microbenchmark.Name);
+		OutTestCommands.Add(Microbenchmark.Name);
+	}
+}
+
+bool FLeapConversionMicrobenchmark::RunTest(const FString& Parameters)
+{
+	for (const FMicrobenchmark& Microbenchmark : Microbenchmarks)
+	{
+		if (Parameters != Microbenchmark.Name)
+		{
+			continue;
+		}
+
+		FConversionInputs Inputs;
+		const FMicrobenchmarkResult Result = Microbenchmark.Function(Inputs);
+
+		AddInfo(FString::Printf(TEXT("%s: %.2f ns per call (fastest batch %.2f ns), %.2f M calls/s"), Microbenchmark.Name,
+			Result.MedianNanoseconds, Result.MinNanoseconds, Result.GetCallsPerSecond() / 1000000.0));
+		WriteResult(*this, Microbenchmark.Name, Result);
+		return true;
+	}
+
+	AddError(FString::Printf(TEXT("Unknown microbenchmark %s"), *Parameters));
+	return false;
+}
+
+#endif
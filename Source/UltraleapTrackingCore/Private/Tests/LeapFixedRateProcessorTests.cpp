@@ -0,0 +1,137 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Async/Async.h"
+#include "LeapFixedRateProcessor.h"
+#include "LeapSyntheticHands.h"
+#include "Misc/AutomationTest.h"
+
+namespace
+{
+// 90Hz in microseconds
+const int64 FixedRateFrameInterval = 11111;
+
+void ProcessFixedRateFrames(FLeapFixedRateProcessor& Processor, const int32 First, const int32 Num)
+{
+	const FLeapSyntheticHands SyntheticHands;
+	LEAP_TRACKING_EVENT Event;
+	LEAP_HAND Hands[FLeapSyntheticHands::MaxHands];
+	for (int32 Index = First; Index < First + Num; Index++)
+	{
+		FMemory::Memzero(Event);
+		SyntheticHands.Generate((Index + 1) * FixedRateFrameInterval, Event, Hands);
+		Processor.ProcessFrame(Event);
+	}
+}
+}	 // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapFixedRateQueueTest, "UltraleapTracking.FixedRate.Queue",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapFixedRateQueueTest::RunTest(const FString& Parameters)
+{
+	FLeapFixedRateProcessor Processor;
+	TArray<FLeapFrameData> Frames;
+
+	ProcessFixedRateFrames(Processor, 0, 3);
+	TestFalse(TEXT("Nothing processed while disabled"), Processor.HasProcessedFrames());
+	TestEqual(TEXT("Nothing queued while disabled"), Processor.TakeFrames(Frames), 0);
+
+	// Every frame comes out once, oldest first, when the game ticks slower than the device
+	Processor.SetEnabled(true);
+	ProcessFixedRateFrames(Processor, 0, 3);
+	TestTrue(TEXT("Processed"), Processor.HasProcessedFrames());
+	TestEqual(TEXT("All frames taken"), Processor.TakeFrames(Frames), 3);
+	for (int32 Index = 0; Index < 3; Index++)
+	{
+		TestEqual(TEXT("Oldest first"), Frames[Index].TimeStamp, (Index + 1) * FixedRateFrameInterval);
+		TestEqual(TEXT("Hands converted"), Frames[Index].NumberOfHandsVisible, FLeapSyntheticHands::MaxHands);
+	}
+	TestEqual(TEXT("Nothing new when the game ticks faster"), Processor.TakeFrames(Frames), 0);
+
+	// A stalled game thread keeps the newest frames
+	const int32 NumStalled = FLeapFixedRateProcessor::MaxQueuedFrames + 2;
+	ProcessFixedRateFrames(Processor, 3, NumStalled);
+	TestEqual(TEXT("Queue bounded"), Processor.TakeFrames(Frames), FLeapFixedRateProcessor::MaxQueuedFrames);
+	TestEqual(TEXT("Oldest dropped"), Frames[0].TimeStamp, (3 + 2 + 1) * FixedRateFrameInterval);
+	TestEqual(TEXT("Newest kept"), Frames[FLeapFixedRateProcessor::MaxQueuedFrames - 1].TimeStamp,
+		(3 + NumStalled) * FixedRateFrameInterval);
+
+	// Disabling drops whatever is queued
+	ProcessFixedRateFrames(Processor, 20, 2);
+	Processor.SetEnabled(false);
+	TestFalse(TEXT("Disabling resets"), Processor.HasProcessedFrames());
+	TestEqual(TEXT("Queue dropped"), Processor.TakeFrames(Frames), 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapFixedRateFilterTest, "UltraleapTracking.FixedRate.Filter",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapFixedRateFilterTest::RunTest(const FString& Parameters)
+{
+	FLeapFixedRateProcessor Raw;
+	FLeapFixedRateProcessor Filtered;
+	FLeapFixedRateProcessor::FSettings Settings;
+	Settings.bFilterPositions = true;
+	Filtered.SetSettings(Settings);
+	Raw.SetEnabled(true);
+	Filtered.SetEnabled(true);
+
+	// The first frame seeds the filters, later ones lag behind the moving synthetic hands
+	ProcessFixedRateFrames(Raw, 0, 4);
+	ProcessFixedRateFrames(Filtered, 0, 4);
+	TArray<FLeapFrameData> RawFrames;
+	TArray<FLeapFrameData> FilteredFrames;
+	TestEqual(TEXT("Raw frames"), Raw.TakeFrames(RawFrames), 4);
+	TestEqual(TEXT("Filtered frames"), Filtered.TakeFrames(FilteredFrames), 4);
+	TestTrue(TEXT("First frame passes through"),
+		RawFrames[0].Hands[0].Palm.Position.Equals(FilteredFrames[0].Hands[0].Palm.Position));
+	TestFalse(TEXT("Later frames smoothed"),
+		RawFrames[3].Hands[0].Palm.Position.Equals(FilteredFrames[3].Hands[0].Palm.Position, 0.001f));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapFixedRateWorldScaleTest, "UltraleapTracking.FixedRate.WorldScale",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapFixedRateWorldScaleTest::RunTest(const FString& Parameters)
+{
+	FLeapFixedRateProcessor Unscaled;
+	FLeapFixedRateProcessor Scaled;
+	FLeapFixedRateProcessor::FSettings Settings;
+	Unscaled.SetSettings(Settings);
+	Settings.WorldScale = 2.f;
+	Scaled.SetSettings(Settings);
+	Unscaled.SetEnabled(true);
+	Scaled.SetEnabled(true);
+
+	// Converted off the game thread, as on the service thread, with the scale given rather than the world's
+	Async(EAsyncExecution::Thread, [&Unscaled, &Scaled]() {
+		ProcessFixedRateFrames(Unscaled, 0, 1);
+		ProcessFixedRateFrames(Scaled, 0, 1);
+	}).Wait();
+
+	TArray<FLeapFrameData> UnscaledFrames;
+	TArray<FLeapFrameData> ScaledFrames;
+	TestEqual(TEXT("Unscaled frame"), Unscaled.TakeFrames(UnscaledFrames), 1);
+	TestEqual(TEXT("Scaled frame"), Scaled.TakeFrames(ScaledFrames), 1);
+	TestTrue(TEXT("Positions scaled by the snapshot"),
+		(UnscaledFrames[0].Hands[0].Palm.Position * 2.f).Equals(ScaledFrames[0].Hands[0].Palm.Position, 0.001f));
+
+	// A refreshed snapshot applies to the next frame
+	Scaled.SetWorldScale(1.f);
+	Async(EAsyncExecution::Thread, [&Scaled]() { ProcessFixedRateFrames(Scaled, 0, 1); }).Wait();
+	TestEqual(TEXT("Rescaled frame"), Scaled.TakeFrames(ScaledFrames), 1);
+	TestTrue(TEXT("Positions use the refreshed scale"),
+		UnscaledFrames[0].Hands[0].Palm.Position.Equals(ScaledFrames[0].Hands[0].Palm.Position, 0.001f));
+	return true;
+}
+
+#endif
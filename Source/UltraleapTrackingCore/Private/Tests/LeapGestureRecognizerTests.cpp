@@ -0,0 +1,200 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LeapGestureRecognizer.h"
+#include "Misc/AutomationTest.h"
+
+namespace
+{
+using FGestureSample = FLeapGestureRecognizer::FSample;
+
+const FVector GestureCenter(30.f, 0.f, 20.f);
+
+FGestureSample MakeGestureSample(const double Time, const FVector& Palm)
+{
+	FGestureSample Sample;
+	Sample.Time = Time;
+	Sample.Points[0] = Palm;
+	for (int32 Digit = 0; Digit < FLeapJointCache::NumDigits; Digit++)
+	{
+		Sample.Points[1 + Digit] = Palm + FVector(8.f, -4.f + 2.f * Digit, 2.f);
+	}
+	return Sample;
+}
+
+/** Palm positions for the gestures, Alpha from 0 to 1 over the gesture */
+FVector GestureCircle(const float Alpha, const float Radius)
+{
+	return GestureCenter + FVector(0.f, Radius * FMath::Cos(2.f * PI * Alpha), Radius * FMath::Sin(2.f * PI * Alpha));
+}
+
+FVector GestureSwipe(const float Alpha, const float Length)
+{
+	return GestureCenter + FVector(0.f, Length * FMath::SmoothStep(0.f, 1.f, Alpha), 0.f);
+}
+
+template <typename PalmFunction>
+TArray<FGestureSample> RecordGesture(PalmFunction&& Palm, const double Duration)
+{
+	// Recorded at 120Hz, performed at 90Hz
+	TArray<FGestureSample> Recorded;
+	const int32 NumRecordedFrames = FMath::RoundToInt(Duration * 120.0);
+	for (int32 Frame = 0; Frame <= NumRecordedFrames; Frame++)
+	{
+		Recorded.Add(MakeGestureSample(Frame / 120.0, Palm(float(Frame) / NumRecordedFrames)));
+	}
+	return Recorded;
+}
+
+struct FGesturePerformance
+{
+	FLeapGestureRecognizer& Recognizer;
+	TArray<FLeapGestureMatch> Matches;
+	TArray<double> MatchTimes;
+	double Time = 0.0;
+	int32 MaxEvaluationsInAFrame = 0;
+
+	explicit FGesturePerformance(FLeapGestureRecognizer& InRecognizer) : Recognizer(InRecognizer)
+	{
+	}
+
+	/** The right hand follows Palm for Duration seconds at 90Hz, with a little tracking noise */
+	template <typename PalmFunction>
+	void Perform(PalmFunction&& Palm, const double Duration)
+	{
+		const int32 NumPerformedFrames = FMath::RoundToInt(Duration * 90.0);
+		for (int32 Frame = 1; Frame <= NumPerformedFrames; Frame++)
+		{
+			Time += 1.0 / 90.0;
+			const FVector Noise(0.05f * FMath::Sin(Time * 37.0), 0.05f * FMath::Sin(Time * 53.0 + 1.0),
+				0.05f * FMath::Sin(Time * 71.0 + 2.0));
+			Recognizer.AddHand(EHandType::LEAP_HAND_LEFT, false, FGestureSample());
+			const FVector PalmPosition = Palm(float(Frame) / NumPerformedFrames) + Noise;
+			Recognizer.AddHand(EHandType::LEAP_HAND_RIGHT, true, MakeGestureSample(Time, PalmPosition));
+
+			const int64 EvaluationsBefore = Recognizer.GetStats().Evaluations;
+			const int32 NumMatchesBefore = Matches.Num();
+			Recognizer.EndFrame(Time, Matches);
+			const int32 NumEvaluations = int32(Recognizer.GetStats().Evaluations - EvaluationsBefore);
+			MaxEvaluationsInAFrame = FMath::Max(MaxEvaluationsInAFrame, NumEvaluations);
+			for (int32 Match = NumMatchesBefore; Match < Matches.Num(); Match++)
+			{
+				MatchTimes.Add(Time);
+			}
+		}
+	}
+
+	/** Still, then a circle, a pause and a swipe. Returns when each gesture ends */
+	void PerformCircleAndSwipe(double& OutCircleEnd, double& OutSwipeEnd)
+	{
+		const FVector Start = GestureCircle(0.f, 14.f);
+		Perform([Start](float) { return Start; }, 1.0);
+		Perform([](float Alpha) { return GestureCircle(Alpha, 14.f); }, 1.15);
+		OutCircleEnd = Time;
+		Perform([Start](float Alpha) { return FMath::Lerp(Start, GestureCenter, Alpha); }, 0.5);
+		Perform([](float) { return GestureCenter; }, 1.0);
+		Perform([](float Alpha) { return GestureSwipe(Alpha, 25.f); }, 0.7);
+		OutSwipeEnd = Time;
+		Perform([](float) { return GestureSwipe(1.f, 25.f); }, 0.5);
+	}
+};
+
+bool AddGestureTemplates(FLeapGestureRecognizer& Recognizer, const int32 NumDistractors)
+{
+	FLeapGestureTemplate CircleTemplate;
+	FLeapGestureTemplate SwipeTemplate;
+	const TArray<FGestureSample> CircleRecording = RecordGesture([](float Alpha) { return GestureCircle(Alpha, 10.f); }, 1.0);
+	const TArray<FGestureSample> SwipeRecording = RecordGesture([](float Alpha) { return GestureSwipe(Alpha, 30.f); }, 0.6);
+	bool bAdded = Recognizer.MakeTemplate(TEXT("Circle"), CircleRecording, CircleTemplate);
+	bAdded &= Recognizer.MakeTemplate(TEXT("Swipe"), SwipeRecording, SwipeTemplate);
+	bAdded &= Recognizer.AddTemplate(CircleTemplate) && Recognizer.AddTemplate(SwipeTemplate);
+
+	// Zigzags that nothing performed should match
+	for (int32 Index = 0; Index < NumDistractors; Index++)
+	{
+		const float Cycles = Index + 2.f;
+		auto Zigzag = [Cycles](float Alpha)
+		{ return GestureCenter + FVector(0.f, 10.f * FMath::Sin(2.f * PI * Alpha * Cycles), 10.f * Alpha); };
+		FLeapGestureTemplate ZigzagTemplate;
+		bAdded &= Recognizer.MakeTemplate(TEXT("Zigzag"), RecordGesture(Zigzag, 0.8), ZigzagTemplate);
+		bAdded &= Recognizer.AddTemplate(ZigzagTemplate);
+	}
+	return bAdded;
+}
+}	 // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapGestureRecognizerRecognizeTest, "UltraleapTracking.GestureRecognizer.Recognize",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapGestureRecognizerRecognizeTest::RunTest(const FString& Parameters)
+{
+	FLeapGestureRecognizer Recognizer;
+	TestTrue(TEXT("Templates made"), AddGestureTemplates(Recognizer, 0));
+
+	FLeapGestureTemplate Still;
+	const TArray<FGestureSample> StillRecording = RecordGesture([](float) { return GestureCenter; }, 1.0);
+	TestFalse(TEXT("No template from a still hand"), Recognizer.MakeTemplate(TEXT("Still"), StillRecording, Still));
+
+	FGesturePerformance Performance(Recognizer);
+	double CircleEnd = 0.0;
+	double SwipeEnd = 0.0;
+	Performance.PerformCircleAndSwipe(CircleEnd, SwipeEnd);
+
+	const TArray<FLeapGestureMatch>& Matches = Performance.Matches;
+	TestEqual(TEXT("Two gestures"), Matches.Num(), 2);
+	if (Matches.Num() == 2)
+	{
+		TestEqual(TEXT("Circle first"), Matches[0].Name.ToString(), FString(TEXT("Circle")));
+		TestEqual(TEXT("Then swipe"), Matches[1].Name.ToString(), FString(TEXT("Swipe")));
+		TestTrue(TEXT("Right hand"), Matches[0].Hand == LEAP_HAND_RIGHT && Matches[1].Hand == LEAP_HAND_RIGHT);
+		TestTrue(TEXT("Confident circle"), Matches[0].Confidence > 0.5f && Matches[0].Confidence <= 1.f);
+		TestTrue(TEXT("Confident swipe"), Matches[1].Confidence > 0.5f && Matches[1].Confidence <= 1.f);
+
+		// Reported once they've stopped improving, soon after each gesture ends
+		const TArray<double>& Times = Performance.MatchTimes;
+		TestTrue(TEXT("Circle reported after it ends"), Times[0] >= CircleEnd && Times[0] < CircleEnd + 0.3);
+		TestTrue(TEXT("Swipe reported after it ends"), Times[1] >= SwipeEnd && Times[1] < SwipeEnd + 0.3);
+	}
+
+	const FLeapGestureSearchStats& Stats = Recognizer.GetStats();
+	AddInfo(FString::Printf(
+		TEXT("%lld comparisons: %lld pruned by extent, %lld by LB_Kim, %lld by LB_Keogh, %lld DTWs abandoned, %lld completed"),
+		Stats.Evaluations, Stats.PrunedByExtent, Stats.PrunedByKim, Stats.PrunedByKeogh, Stats.AbandonedDtw, Stats.CompletedDtw));
+	TestTrue(TEXT("Most comparisons pruned before DTW"), (Stats.AbandonedDtw + Stats.CompletedDtw) * 4 < Stats.Evaluations);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapGestureRecognizerBudgetTest, "UltraleapTracking.GestureRecognizer.Budget",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapGestureRecognizerBudgetTest::RunTest(const FString& Parameters)
+{
+	// 25 templates, 75 window lengths per hand, compared 8 a frame
+	FLeapGestureRecognizerSettings Settings;
+	Settings.MaxEvaluationsPerFrame = 8;
+	FLeapGestureRecognizer Recognizer(Settings);
+	TestTrue(TEXT("Templates made"), AddGestureTemplates(Recognizer, 23));
+
+	FGesturePerformance Performance(Recognizer);
+	double CircleEnd = 0.0;
+	double SwipeEnd = 0.0;
+	Performance.PerformCircleAndSwipe(CircleEnd, SwipeEnd);
+
+	TestEqual(TEXT("Within the budget every frame"), Performance.MaxEvaluationsInAFrame, Settings.MaxEvaluationsPerFrame);
+	TestEqual(TEXT("Both gestures still found"), Performance.Matches.Num(), 2);
+	if (Performance.Matches.Num() == 2)
+	{
+		TestEqual(TEXT("Circle"), Performance.Matches[0].Name.ToString(), FString(TEXT("Circle")));
+		TestEqual(TEXT("Swipe"), Performance.Matches[1].Name.ToString(), FString(TEXT("Swipe")));
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,99 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LeapHandQueries.h"
+#include "LeapSyntheticHands.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapHandQueriesNearestTest, "UltraleapTracking.HandQueries.Nearest",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapHandQueriesNearestTest::RunTest(const FString& Parameters)
+{
+	FLeapJointCache Joints;
+	FLeapJointQueryResult Result;
+	TestFalse(TEXT("Nothing without hands"), FLeapHandQueries::FindNearestJoint(Joints, FVector::ZeroVector, false, Result));
+
+	FLeapFrameData Frame;
+	FLeapSyntheticHands(2).GenerateFrame(1000000, Frame);
+	Joints.SetFromFrame(Frame);
+	const FLeapJointCache::FHand& Right = Joints.GetHand(EHandType::LEAP_HAND_RIGHT);
+
+	// A point on a joint finds that joint
+	const FVector IndexTip = Right.JointPositions[1][4];
+	TestTrue(TEXT("Found"), FLeapHandQueries::FindNearestJoint(Joints, IndexTip, false, Result));
+	TestTrue(TEXT("Right index tip"), Result.Hand == EHandType::LEAP_HAND_RIGHT && Result.Digit == 1 && Result.Joint == 4);
+	TestEqual(TEXT("On the joint"), Result.Distance, 0.f, KINDA_SMALL_NUMBER);
+
+	// Fingertips only skips the nearer knuckle
+	const FVector Knuckle = Right.JointPositions[2][1];
+	TestTrue(TEXT("Fingertip found"), FLeapHandQueries::FindNearestJoint(Joints, Knuckle, true, Result));
+	TestEqual(TEXT("Only fingertips"), Result.Joint, 4);
+
+	// Segment distance matches brute force over the hand's joints
+	const FVector Start(0, 0, 0);
+	const FVector End(0, 0, 50);
+	float Expected = MAX_flt;
+	for (int32 Digit = 0; Digit < FLeapJointCache::NumDigits; Digit++)
+	{
+		for (int32 Joint = 0; Joint < FLeapJointCache::NumJoints; Joint++)
+		{
+			Expected = FMath::Min(Expected, (float) FMath::PointDistToSegment(Right.JointPositions[Digit][Joint], Start, End));
+		}
+	}
+	TestTrue(TEXT("Segment"), FLeapHandQueries::GetHandDistanceToSegment(Joints, EHandType::LEAP_HAND_RIGHT, Start, End, Result));
+	TestEqual(TEXT("Segment distance"), Result.Distance, Expected, 0.01f);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapHandQueriesVolumeTest, "UltraleapTracking.HandQueries.Volume",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapHandQueriesVolumeTest::RunTest(const FString& Parameters)
+{
+	FLeapJointCache Joints;
+	FLeapFrameData Frame;
+	FLeapSyntheticHands(1).GenerateFrame(1000000, Frame);
+	Joints.SetFromFrame(Frame);
+	const EHandType Visible =
+		Joints.GetHand(EHandType::LEAP_HAND_LEFT).bVisible ? EHandType::LEAP_HAND_LEFT : EHandType::LEAP_HAND_RIGHT;
+	const EHandType Missing = Visible == EHandType::LEAP_HAND_LEFT ? EHandType::LEAP_HAND_RIGHT : EHandType::LEAP_HAND_LEFT;
+	const FVector Tip = Joints.GetHand(Visible).JointPositions[0][4];
+
+	// A small box on a fingertip, rotated, holds it and a huge one holds every joint of the visible hand
+	TArray<FLeapJointQueryResult> Results;
+	const FTransform Small(FRotator(30, 45, 0), Tip);
+	TestTrue(TEXT("Tip in small box"), FLeapHandQueries::FindJointsInBox(Joints, Small, FVector(0.1f), Results) >= 1);
+	TestTrue(TEXT("Hand in small box"), FLeapHandQueries::IsHandInBox(Joints, Visible, Small, FVector(0.1f)));
+	TestFalse(TEXT("Missing hand in no box"), FLeapHandQueries::IsHandInBox(Joints, Missing, Small, FVector(10000)));
+
+	Results.Reset();
+	const int32 NumJoints = FLeapJointCache::NumDigits * FLeapJointCache::NumJoints;
+	TestEqual(TEXT("Every joint in a huge box"),
+		FLeapHandQueries::FindJointsInBox(Joints, FTransform::Identity, FVector(100000), Results), NumJoints);
+	Results.Reset();
+	TestEqual(TEXT("Every joint in a huge sphere"),
+		FLeapHandQueries::FindJointsInSphere(Joints, FVector::ZeroVector, 100000, Results), NumJoints);
+	Results.Reset();
+	TestEqual(TEXT("None far away"), FLeapHandQueries::FindJointsInSphere(Joints, FVector(100000), 1, Results), 0);
+
+	// Fingertip spreads of one hand are symmetric with a zero diagonal
+	float Distances[FLeapJointCache::NumDigits][FLeapJointCache::NumDigits];
+	TestTrue(TEXT("Spreads"), FLeapHandQueries::GetFingertipDistances(Joints, Visible, Visible, Distances));
+	TestEqual(TEXT("Diagonal"), Distances[2][2], 0.f);
+	TestEqual(TEXT("Symmetric"), Distances[0][1], Distances[1][0]);
+	float ThumbToIndex = 0;
+	TestTrue(TEXT("Pair"), FLeapHandQueries::GetFingertipDistance(Joints, Visible, 0, Visible, 1, ThumbToIndex));
+	TestEqual(TEXT("Pair matches the matrix"), ThumbToIndex, Distances[0][1]);
+	TestFalse(TEXT("No spreads with a missing hand"), FLeapHandQueries::GetFingertipDistances(Joints, Visible, Missing, Distances));
+	return true;
+}
+
+#endif
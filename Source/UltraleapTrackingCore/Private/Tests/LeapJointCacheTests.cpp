@@ -0,0 +1,62 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LeapJointCache.h"
+#include "LeapSyntheticHands.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapJointCacheTest, "UltraleapTracking.JointCache.Flatten",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapJointCacheTest::RunTest(const FString& Parameters)
+{
+	FLeapFrameData Frame;
+	FLeapSyntheticHands(2).GenerateFrame(1000000, Frame);
+	FLeapJointCache Cache;
+	Cache.SetFromFrame(Frame);
+
+	for (const FLeapHandData& Hand : Frame.Hands)
+	{
+		const EHandType Side = Hand.HandType;
+		const FLeapJointCache::FHand& Cached = Cache.GetHand(Side);
+		TestTrue(TEXT("Visible"), Cached.bVisible);
+		TestEqual(TEXT("Palm"), Cached.PalmPosition, Hand.Palm.Position);
+		TestEqual(TEXT("Pinch"), Cached.PinchStrength, Hand.PinchStrength);
+
+		FVector Position;
+		FRotator Rotation;
+		TestTrue(TEXT("Index tip"), Cache.GetJoint(Side, 1, 4, Position, Rotation));
+		TestEqual(TEXT("Index tip position"), Position, Hand.Index.Distal.NextJoint);
+		TestTrue(TEXT("Tip takes the distal rotation"), Rotation.Equals(Hand.Index.Distal.Rotation));
+		TestTrue(TEXT("Thumb base"), Cache.GetJoint(Side, 0, 0, Position, Rotation));
+		TestEqual(TEXT("Thumb base position"), Position, Hand.Thumb.Metacarpal.PrevJoint);
+		TestTrue(TEXT("Pinky knuckle"), Cache.GetJoint(Side, 4, 1, Position, Rotation));
+		TestEqual(TEXT("Pinky knuckle position"), Position, Hand.Pinky.Proximal.PrevJoint);
+
+		TestFalse(TEXT("Digit out of range"), Cache.GetJoint(Side, 5, 0, Position, Rotation));
+		TestFalse(TEXT("Joint out of range"), Cache.GetJoint(Side, 0, -1, Position, Rotation));
+	}
+
+	// A hand lost in the next frame reads as invisible and zero
+	FLeapSyntheticHands(1).GenerateFrame(1000000, Frame);
+	Cache.SetFromFrame(Frame);
+	const EHandType Lost =
+		Frame.Hands[0].HandType == EHandType::LEAP_HAND_LEFT ? EHandType::LEAP_HAND_RIGHT : EHandType::LEAP_HAND_LEFT;
+	FVector Position;
+	FRotator Rotation;
+	TestFalse(TEXT("Lost hand has no joints"), Cache.GetJoint(Lost, 1, 4, Position, Rotation));
+	TestEqual(TEXT("Lost hand palm cleared"), Cache.GetHand(Lost).PalmPosition, FVector::ZeroVector);
+	TestEqual(TEXT("Lost hand joints cleared"), Cache.GetHand(Lost).JointPositions[1][4], FVector::ZeroVector);
+	TestTrue(TEXT("Other hand still visible"), Cache.GetHand(Frame.Hands[0].HandType).bVisible);
+	return true;
+}
+
+#endif
@@ -0,0 +1,175 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LeapJointFilterBank.h"
+#include "LeapSyntheticHands.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+
+namespace
+{
+// 90Hz, starting after the right hand's first dropout
+const float FilterBankDeltaTime = 1.f / 90.f;
+const int64 FilterBankStartMicros = 1000000;
+
+int64 GetFilterBankFrameTime(const int32 FrameIndex)
+{
+	return FilterBankStartMicros + (int64) (FrameIndex * FilterBankDeltaTime * 1000000.f);
+}
+
+/** Every position the bank filters, in its lane order */
+void GetFilterBankJoints(const FLeapHandData& Hand, TArray<FVector>& OutJoints)
+{
+	OutJoints.Reset();
+	OutJoints.Add(Hand.Palm.Position);
+	OutJoints.Add(Hand.Arm.PrevJoint);
+	OutJoints.Add(Hand.Arm.NextJoint);
+	const FLeapDigitData* Digits[5] = {&Hand.Thumb, &Hand.Index, &Hand.Middle, &Hand.Ring, &Hand.Pinky};
+	for (const FLeapDigitData* Digit : Digits)
+	{
+		OutJoints.Add(Digit->Metacarpal.PrevJoint);
+		OutJoints.Add(Digit->Proximal.PrevJoint);
+		OutJoints.Add(Digit->Intermediate.PrevJoint);
+		OutJoints.Add(Digit->Distal.PrevJoint);
+		OutJoints.Add(Digit->Distal.NextJoint);
+	}
+}
+
+/** Whether the hand of this side has the same joints in both frames, false if either frame lacks it */
+bool AreFilterBankHandsEqual(const FLeapFrameData& A, const FLeapFrameData& B, const EHandType HandType, const float Tolerance)
+{
+	auto IsSide = [HandType](const FLeapHandData& Hand) { return Hand.HandType == HandType; };
+	const FLeapHandData* HandA = A.Hands.FindByPredicate(IsSide);
+	const FLeapHandData* HandB = B.Hands.FindByPredicate(IsSide);
+	if (!HandA || !HandB)
+	{
+		return false;
+	}
+
+	TArray<FVector> JointsA;
+	TArray<FVector> JointsB;
+	GetFilterBankJoints(*HandA, JointsA);
+	GetFilterBankJoints(*HandB, JointsB);
+	for (int32 Joint = 0; Joint < JointsA.Num(); Joint++)
+	{
+		if (!JointsA[Joint].Equals(JointsB[Joint], Tolerance))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+}	 // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapJointFilterBankScalarTest, "UltraleapTracking.JointFilterBank.MatchesScalar",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapJointFilterBankScalarTest::RunTest(const FString& Parameters)
+{
+	const float MinCutoff = 1.5f;
+	const float CutoffSlope = 0.05f;
+	const float DeltaCutoff = 1.f;
+	FLeapJointFilterBank Bank;
+	Bank.Init(MinCutoff, CutoffSlope, DeltaCutoff);
+	Bank.SetChannels(true, false);
+
+	// One scalar filter per lane. Its derivative is the change times the time step rather than a velocity, so at a
+	// fixed step the same cutoffs need the slope divided by the step squared
+	UOneEuroFilterComponent* Scalar[FLeapJointFilterBank::HandSlots][FLeapJointFilterBank::JointsPerHand];
+	for (int32 Slot = 0; Slot < FLeapJointFilterBank::HandSlots; Slot++)
+	{
+		for (int32 Lane = 0; Lane < FLeapJointFilterBank::JointsPerHand; Lane++)
+		{
+			Scalar[Slot][Lane] = NewObject<UOneEuroFilterComponent>(GetTransientPackage());
+			Scalar[Slot][Lane]->Init(MinCutoff, CutoffSlope / (FilterBankDeltaTime * FilterBankDeltaTime), DeltaCutoff);
+		}
+	}
+
+	const FLeapSyntheticHands SyntheticHands(2);
+	FLeapFrameData Frame;
+	TArray<FVector> Filtered;
+	int32 Mismatches = 0;
+	for (int32 FrameIndex = 0; FrameIndex < 60; FrameIndex++)
+	{
+		SyntheticHands.GenerateFrame(GetFilterBankFrameTime(FrameIndex), Frame);
+		TArray<TArray<FVector>> RawHands;
+		for (const FLeapHandData& Hand : Frame.Hands)
+		{
+			GetFilterBankJoints(Hand, RawHands.AddDefaulted_GetRef());
+		}
+
+		Bank.FilterFrame(Frame, FilterBankDeltaTime);
+		for (int32 HandIndex = 0; HandIndex < Frame.Hands.Num(); HandIndex++)
+		{
+			const int32 Slot = Frame.Hands[HandIndex].HandType == EHandType::LEAP_HAND_LEFT ? 0 : 1;
+			GetFilterBankJoints(Frame.Hands[HandIndex], Filtered);
+			for (int32 Lane = 0; Lane < FLeapJointFilterBank::JointsPerHand; Lane++)
+			{
+				const FVector Expected = Scalar[Slot][Lane]->Filter(RawHands[HandIndex][Lane], FilterBankDeltaTime);
+				Mismatches += Expected.Equals(Filtered[Lane], 0.01f) ? 0 : 1;
+			}
+		}
+	}
+	TestEqual(TEXT("Every lane matches the scalar filter"), Mismatches, 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapJointFilterBankResetTest, "UltraleapTracking.JointFilterBank.Reset",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapJointFilterBankResetTest::RunTest(const FString& Parameters)
+{
+	FLeapJointFilterBank Bank;
+	FLeapJointFilterBank Reference;
+	Bank.SetChannels(true, false);
+	Reference.SetChannels(true, false);
+
+	const FLeapSyntheticHands SyntheticHands(2);
+	FLeapFrameData Frame;
+	FLeapFrameData ReferenceFrame;
+	for (int32 FrameIndex = 0; FrameIndex < 10; FrameIndex++)
+	{
+		SyntheticHands.GenerateFrame(GetFilterBankFrameTime(FrameIndex), Frame);
+		Bank.FilterFrame(Frame, FilterBankDeltaTime);
+		SyntheticHands.GenerateFrame(GetFilterBankFrameTime(FrameIndex), ReferenceFrame);
+		Reference.FilterFrame(ReferenceFrame, FilterBankDeltaTime);
+	}
+
+	// The right hand comes back as a new hand, only its lanes start over
+	SyntheticHands.GenerateFrame(GetFilterBankFrameTime(10), Frame);
+	FLeapHandData* NewRight = Frame.Hands.FindByPredicate(
+		[](const FLeapHandData& Hand) { return Hand.HandType == EHandType::LEAP_HAND_RIGHT; });
+	if (!TestNotNull(TEXT("Right hand"), NewRight))
+	{
+		return false;
+	}
+	NewRight->Id++;
+	const FLeapFrameData Raw = Frame;
+	Bank.FilterFrame(Frame, FilterBankDeltaTime);
+	SyntheticHands.GenerateFrame(GetFilterBankFrameTime(10), ReferenceFrame);
+	Reference.FilterFrame(ReferenceFrame, FilterBankDeltaTime);
+
+	const EHandType Left = EHandType::LEAP_HAND_LEFT;
+	const EHandType Right = EHandType::LEAP_HAND_RIGHT;
+	TestTrue(TEXT("New hand passes through"), AreFilterBankHandsEqual(Frame, Raw, Right, 0.0001f));
+	TestFalse(TEXT("Other hand still smoothed"), AreFilterBankHandsEqual(Frame, Raw, Left, 0.001f));
+	TestTrue(TEXT("Other hand keeps its history"), AreFilterBankHandsEqual(Frame, ReferenceFrame, Left, 0.0001f));
+
+	// After a full reset the next frame passes through for both hands
+	Bank.Reset();
+	SyntheticHands.GenerateFrame(GetFilterBankFrameTime(11), Frame);
+	const FLeapFrameData AfterReset = Frame;
+	Bank.FilterFrame(Frame, FilterBankDeltaTime);
+	TestTrue(TEXT("Left passes through after a reset"), AreFilterBankHandsEqual(Frame, AfterReset, Left, 0.0001f));
+	TestTrue(TEXT("Right passes through after a reset"), AreFilterBankHandsEqual(Frame, AfterReset, Right, 0.0001f));
+	return true;
+}
+
+#endif
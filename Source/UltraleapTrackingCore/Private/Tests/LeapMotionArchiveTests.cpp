@@ -0,0 +1,211 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/FileManager.h"
+#include "LeapMotionArchive.h"
+#include "LeapSyntheticHands.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+const float ArchivePositionStep = 0.01f;
+const int32 ArchiveFramesPerBlock = 64;
+
+// Six seconds at 120Hz, the right hand drops out for the first and the last half second
+const int32 NumArchiveFrames = 720;
+const int64 ArchiveFrameMicros = 8333;
+
+// Time, both hands' channels as floats
+const int32 RawArchiveFrameBytes = 8 + LeapMotionArchive::NumHands * (3 + 4 + 75 + 2) * 4;
+
+FString GetArchiveTestPath(const TCHAR* Name)
+{
+	return FPaths::Combine(FPaths::AutomationTransientDir(), Name);
+}
+
+void MakeArchiveFrames(TArray<FLeapMotionArchiveFrame>& OutFrames)
+{
+	const FLeapSyntheticHands SyntheticHands(2);
+	FLeapFrameData Frame;
+	FLeapJointCache Joints;
+
+	OutFrames.SetNum(NumArchiveFrames);
+	for (int32 FrameIndex = 0; FrameIndex < NumArchiveFrames; FrameIndex++)
+	{
+		const int64 Time = FrameIndex * ArchiveFrameMicros;
+		SyntheticHands.GenerateFrame(Time, Frame);
+		Joints.SetFromFrame(Frame);
+		OutFrames[FrameIndex].SetFromJoints(Joints, Time);
+	}
+}
+
+bool WriteTestArchive(const FString& Path, const TArray<FLeapMotionArchiveFrame>& Frames, int64& OutBytes)
+{
+	FLeapMotionArchiveWriter Writer;
+	if (!Writer.Open(Path, ArchiveFramesPerBlock, ArchivePositionStep))
+	{
+		return false;
+	}
+	for (const FLeapMotionArchiveFrame& Frame : Frames)
+	{
+		Writer.AddFrame(Frame);
+	}
+	Writer.Close();
+	OutBytes = Writer.GetBytesWritten();
+	return Writer.GetNumDroppedFrames() == 0;
+}
+
+bool IsArchivedHandClose(const FLeapMotionArchiveFrame::FHand& A, const FLeapMotionArchiveFrame::FHand& B)
+{
+	// Half a step, plus float rounding
+	const float Tolerance = ArchivePositionStep * 0.5f + 0.001f;
+	bool bClose = A.bVisible == B.bVisible && A.PalmPosition.Equals(B.PalmPosition, Tolerance) &&
+				  A.PalmOrientation.Equals(B.PalmOrientation, 0.001f) &&
+				  FMath::IsNearlyEqual(A.PinchStrength, B.PinchStrength, 0.001f) &&
+				  FMath::IsNearlyEqual(A.GrabStrength, B.GrabStrength, 0.001f);
+	for (int32 Digit = 0; Digit < FLeapJointCache::NumDigits; Digit++)
+	{
+		for (int32 Joint = 0; Joint < FLeapJointCache::NumJoints; Joint++)
+		{
+			bClose &= A.JointPositions[Digit][Joint].Equals(B.JointPositions[Digit][Joint], Tolerance);
+		}
+	}
+	return bClose;
+}
+}	 // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapMotionArchiveRoundTripTest, "UltraleapTracking.MotionArchive.RoundTrip",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapMotionArchiveRoundTripTest::RunTest(const FString& Parameters)
+{
+	TArray<FLeapMotionArchiveFrame> Frames;
+	MakeArchiveFrames(Frames);
+	const FString Path = GetArchiveTestPath(TEXT("RoundTrip.ulma"));
+	int64 Bytes = 0;
+	TestTrue(TEXT("Written"), WriteTestArchive(Path, Frames, Bytes));
+
+	FLeapMotionArchiveReader Reader;
+	TestTrue(TEXT("Opened"), Reader.Open(Path));
+	TestEqual(TEXT("Frames"), Reader.GetNumFrames(), NumArchiveFrames);
+	TestEqual(TEXT("Blocks"), Reader.GetNumBlocks(), FMath::DivideAndRoundUp(NumArchiveFrames, ArchiveFramesPerBlock));
+	TestEqual(TEXT("Start"), Reader.GetStartTime(), Frames[0].TimeMicros);
+	TestEqual(TEXT("End"), Reader.GetEndTime(), Frames.Last().TimeMicros);
+
+	TArray<FLeapMotionArchiveFrame> Decoded;
+	TestTrue(TEXT("Read"), Reader.Read(0, MAX_int64, LeapMotionArchive::AllChannels, Decoded));
+	TestEqual(TEXT("Read every frame"), Decoded.Num(), NumArchiveFrames);
+	int32 NumMismatched = 0;
+	for (int32 FrameIndex = 0; FrameIndex < FMath::Min(Decoded.Num(), NumArchiveFrames); FrameIndex++)
+	{
+		const bool bSameTime = Decoded[FrameIndex].TimeMicros == Frames[FrameIndex].TimeMicros;
+		const bool bLeftClose = IsArchivedHandClose(Decoded[FrameIndex].Hands[0], Frames[FrameIndex].Hands[0]);
+		const bool bRightClose = IsArchivedHandClose(Decoded[FrameIndex].Hands[1], Frames[FrameIndex].Hands[1]);
+		NumMismatched += (bSameTime && bLeftClose && bRightClose) ? 0 : 1;
+	}
+	TestEqual(TEXT("Every frame within the quantization step"), NumMismatched, 0);
+	TestFalse(TEXT("Right hand drops out"), Decoded[0].Hands[1].bVisible);
+
+	AddInfo(FString::Printf(TEXT("%lld bytes, %.1f bytes per frame, %.1fx smaller than floats"), Bytes,
+		(float) Bytes / NumArchiveFrames, (float) (RawArchiveFrameBytes * NumArchiveFrames) / Bytes));
+	TestTrue(TEXT("Smaller than half the floats"), Bytes * 2 < RawArchiveFrameBytes * NumArchiveFrames);
+
+	Reader.Close();
+	IFileManager::Get().Delete(*Path);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapMotionArchiveSeekTest, "UltraleapTracking.MotionArchive.Seek",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapMotionArchiveSeekTest::RunTest(const FString& Parameters)
+{
+	TArray<FLeapMotionArchiveFrame> Frames;
+	MakeArchiveFrames(Frames);
+	const FString Path = GetArchiveTestPath(TEXT("Seek.ulma"));
+	int64 Bytes = 0;
+	TestTrue(TEXT("Written"), WriteTestArchive(Path, Frames, Bytes));
+
+	FLeapMotionArchiveReader Reader;
+	TestTrue(TEXT("Opened"), Reader.Open(Path));
+
+	// A range across a block boundary, with bounds between frames
+	const int32 First = ArchiveFramesPerBlock - 10;
+	const int32 Last = ArchiveFramesPerBlock * 2 + 5;
+	const uint64 RightIndexTip = LeapMotionArchive::ChannelBit(1, LeapMotionArchive::JointChannel(1, 4));
+	TArray<FLeapMotionArchiveFrame> Decoded;
+	TestTrue(TEXT("Read"), Reader.Read(Frames[First].TimeMicros - 1, Frames[Last].TimeMicros + 1, RightIndexTip, Decoded));
+	TestEqual(TEXT("Frames in range"), Decoded.Num(), Last - First + 1);
+	if (Decoded.Num() == Last - First + 1)
+	{
+		TestEqual(TEXT("First frame"), Decoded[0].TimeMicros, Frames[First].TimeMicros);
+		TestEqual(TEXT("Last frame"), Decoded.Last().TimeMicros, Frames[Last].TimeMicros);
+
+		const FLeapMotionArchiveFrame& Frame = Decoded[Last - First];
+		const FLeapMotionArchiveFrame::FHand& Right = Frame.Hands[1];
+		TestTrue(TEXT("Right visible"), Right.bVisible);
+		TestTrue(TEXT("Index tip decoded"), Right.JointPositions[1][4].Equals(Frames[Last].Hands[1].JointPositions[1][4], 0.01f));
+		TestEqual(TEXT("Other joints skipped"), Right.JointPositions[1][3], FVector::ZeroVector);
+		TestEqual(TEXT("Palm skipped"), Right.PalmPosition, FVector::ZeroVector);
+		TestTrue(TEXT("Left visibility still decoded"), Frame.Hands[0].bVisible);
+		TestEqual(TEXT("Left skipped"), Frame.Hands[0].JointPositions[1][4], FVector::ZeroVector);
+	}
+
+	TestTrue(TEXT("Read past the end"), Reader.Read(MAX_int64 - 1, MAX_int64, LeapMotionArchive::AllChannels, Decoded));
+	TestEqual(TEXT("Nothing past the end"), Decoded.Num(), 0);
+
+	Reader.Close();
+	IFileManager::Get().Delete(*Path);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapMotionArchiveRecoveryTest, "UltraleapTracking.MotionArchive.Recovery",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapMotionArchiveRecoveryTest::RunTest(const FString& Parameters)
+{
+	TArray<FLeapMotionArchiveFrame> Frames;
+	MakeArchiveFrames(Frames);
+	const FString Path = GetArchiveTestPath(TEXT("Recovery.ulma"));
+	int64 Bytes = 0;
+	TestTrue(TEXT("Written"), WriteTestArchive(Path, Frames, Bytes));
+
+	TArray<uint8> Contents;
+	TestTrue(TEXT("Loaded"), FFileHelper::LoadFileToArray(Contents, *Path));
+	const int32 NumBlocks = FMath::DivideAndRoundUp(NumArchiveFrames, ArchiveFramesPerBlock);
+
+	// As if the session ended before the index was written
+	const int32 IndexSize = NumBlocks * (8 + 4 + 4 + 8 + 8) + 16;
+	Contents.SetNum(Contents.Num() - IndexSize);
+	TestTrue(TEXT("Saved without index"), FFileHelper::SaveArrayToFile(Contents, *Path));
+
+	FLeapMotionArchiveReader Reader;
+	TestTrue(TEXT("Opened without index"), Reader.Open(Path));
+	TestEqual(TEXT("Every block found"), Reader.GetNumBlocks(), NumBlocks);
+	TArray<FLeapMotionArchiveFrame> Decoded;
+	TestTrue(TEXT("Read without index"), Reader.Read(0, MAX_int64, LeapMotionArchive::AllChannels, Decoded));
+	TestEqual(TEXT("Every frame"), Decoded.Num(), NumArchiveFrames);
+	Reader.Close();
+
+	// And in the middle of writing a block
+	Contents.SetNum(Contents.Num() - 10);
+	TestTrue(TEXT("Saved cut short"), FFileHelper::SaveArrayToFile(Contents, *Path));
+	TestTrue(TEXT("Opened cut short"), Reader.Open(Path));
+	TestEqual(TEXT("Partial block dropped"), Reader.GetNumBlocks(), NumBlocks - 1);
+	TestTrue(TEXT("Read cut short"), Reader.Read(0, MAX_int64, LeapMotionArchive::AllChannels, Decoded));
+	TestEqual(TEXT("Frames of the whole blocks"), Decoded.Num(), (NumBlocks - 1) * ArchiveFramesPerBlock);
+
+	Reader.Close();
+	IFileManager::Get().Delete(*Path);
+	return true;
+}
+
+#endif
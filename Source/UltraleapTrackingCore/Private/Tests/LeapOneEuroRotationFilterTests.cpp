@@ -0,0 +1,100 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "OneEuroFilterComponent.h"
+
+namespace
+{
+// 90Hz
+const float RotationFilterDeltaTime = 1.f / 90.f;
+
+FQuat MakeYaw(const float Degrees)
+{
+	return FRotator(0.f, Degrees, 0.f).Quaternion();
+}
+}	 // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapOneEuroRotationWrapTest, "UltraleapTracking.OneEuroRotation.Wraparound",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapOneEuroRotationWrapTest::RunTest(const FString& Parameters)
+{
+	// Yaw turning through 180, Euler angles jump from 180 to -180 and the quaternion changes hemisphere
+	FLeapOneEuroRotationFilter Filter;
+	Filter.Init(1.f, 0.5f, 1.f);
+	const float StepDegrees = 2.f;
+	FQuat Previous = Filter.Filter(MakeYaw(160.f), RotationFilterDeltaTime);
+	float LargestStep = 0.f;
+	float LargestLag = 0.f;
+	for (int32 Index = 1; Index <= 20; Index++)
+	{
+		const FQuat Raw = MakeYaw(FRotator::NormalizeAxis(160.f + StepDegrees * Index));
+		const FQuat Filtered = Filter.Filter(Raw, RotationFilterDeltaTime);
+		LargestStep = FMath::Max(LargestStep, FMath::RadiansToDegrees(Previous.AngularDistance(Filtered)));
+		LargestLag = FMath::Max(LargestLag, FMath::RadiansToDegrees(Raw.AngularDistance(Filtered)));
+		Previous = Filtered;
+	}
+	// The adaptive cutoff can catch up slightly faster than the input moves, the long way round would be a jump
+	TestTrue(TEXT("No jump"), LargestStep < StepDegrees * 1.5f);
+	TestTrue(TEXT("Follows the short way round"), LargestLag < 20.f);
+
+	// The same rotation with its sign flipped every other sample is the same input
+	FLeapOneEuroRotationFilter Plain;
+	FLeapOneEuroRotationFilter Flipped;
+	float LargestDifference = 0.f;
+	for (int32 Index = 0; Index < 30; Index++)
+	{
+		const FQuat Raw = FQuat(FVector(1.f, 1.f, 0.f).GetSafeNormal(), 0.05f * Index);
+		const FQuat PlainFiltered = Plain.Filter(Raw, RotationFilterDeltaTime);
+		const FQuat FlippedFiltered = Flipped.Filter(Index % 2 ? Raw * -1.f : Raw, RotationFilterDeltaTime);
+		LargestDifference = FMath::Max(LargestDifference, PlainFiltered.AngularDistance(FlippedFiltered));
+	}
+	TestTrue(TEXT("Hemisphere flips ignored"), LargestDifference < 0.001f);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapOneEuroRotationRestTest, "UltraleapTracking.OneEuroRotation.Rest",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapOneEuroRotationRestTest::RunTest(const FString& Parameters)
+{
+	FLeapOneEuroRotationFilter Filter;
+	Filter.Init(1.f, 0.5f, 1.f);
+	TestTrue(TEXT("Not seeded"), Filter.IsFirstTime());
+	TestTrue(TEXT("First sample passes through"),
+		Filter.Filter(MakeYaw(0.f), RotationFilterDeltaTime).AngularDistance(MakeYaw(0.f)) < KINDA_SMALL_NUMBER);
+
+	// Held still after a jump, the output settles on it
+	const FQuat Rest = FRotator(20.f, 90.f, -30.f).Quaternion();
+	FQuat Filtered = FQuat::Identity;
+	for (int32 Index = 0; Index < 180; Index++)
+	{
+		Filtered = Filter.Filter(Rest, RotationFilterDeltaTime);
+	}
+	TestTrue(TEXT("Converges at rest"), Filtered.AngularDistance(Rest) < 0.001f);
+
+	// No time passed, nothing changes
+	const FQuat Other = MakeYaw(-45.f);
+	TestTrue(TEXT("Zero time step keeps the previous value"),
+		Filter.Filter(Other, 0.f).AngularDistance(Filtered) < KINDA_SMALL_NUMBER);
+	TestTrue(TEXT("Negative time step keeps the previous value"),
+		Filter.Filter(Other, -RotationFilterDeltaTime).AngularDistance(Filtered) < KINDA_SMALL_NUMBER);
+
+	// A reset forgets the history, the next sample seeds the filter again
+	Filter.Reset();
+	TestTrue(TEXT("Reset"), Filter.IsFirstTime());
+	TestTrue(TEXT("Re-seeded"), Filter.Filter(Other, RotationFilterDeltaTime).AngularDistance(Other) < KINDA_SMALL_NUMBER);
+	TestFalse(TEXT("Seeded"), Filter.IsFirstTime());
+	TestTrue(TEXT("Filtering from the new seed"), Filter.Filter(Rest, RotationFilterDeltaTime).AngularDistance(Rest) > 0.01f);
+	return true;
+}
+
+#endif
@@ -0,0 +1,153 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapPerformanceReport.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Dom/JsonObject.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace
+{
+const TCHAR* CsvFields[] = {TEXT("mean_us"), TEXT("p50_us"), TEXT("p90_us"), TEXT("p99_us"), TEXT("max_us"),
+	TEXT("allocations_per_frame"), TEXT("max_allocations"), TEXT("allocated_bytes_per_frame")};
+
+FString GetBaselinePath()
+{
+	FString Path;
+	if (FParse::Value(FCommandLine::Get(), TEXT("LeapPerfBaseline="), Path))
+	{
+		return Path;
+	}
+	TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(FString("UltraleapTracking"));
+	return Plugin.IsValid() ? FPaths::Combine(Plugin->GetBaseDir(), TEXT("Config/PerformanceBaseline.json")) : FString();
+}
+}	 // namespace
+
+FString FLeapPerformanceReport::GetOutputDir()
+{
+	return FPaths::Combine(FPaths::AutomationDir(), TEXT("UltraleapPerformance"));
+}
+
+FLeapPerformanceReport::FLeapPerformanceReport(FAutomationTestBase& InTest, const FString& InTestName)
+	: Test(InTest), TestName(InTestName)
+{
+}
+
+void FLeapPerformanceReport::AddStage(const FLeapBenchmarkStage& Stage)
+{
+	Stages.Add(&Stage);
+}
+
+bool FLeapPerformanceReport::WriteAndCompare()
+{
+	Write();
+	return Compare();
+}
+
+void FLeapPerformanceReport::Write() const
+{
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	FString Csv = TEXT("stage");
+	for (const TCHAR* Field : CsvFields)
+	{
+		Csv += TEXT(",");
+		Csv += Field;
+	}
+	Csv += LINE_TERMINATOR;
+
+	for (const FLeapBenchmarkStage* Stage : Stages)
+	{
+		const TSharedRef<FJsonObject> StageJson = Stage->ToJson();
+		Report->SetObjectField(Stage->Name, StageJson);
+
+		Csv += Stage->Name;
+		for (const TCHAR* Field : CsvFields)
+		{
+			Csv += FString::Printf(TEXT(",%.3f"), StageJson->GetNumberField(Field));
+		}
+		Csv += LINE_TERMINATOR;
+	}
+
+	FString Json;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Report, Writer);
+
+	const FString BasePath = FPaths::Combine(GetOutputDir(), TestName);
+	if (!FFileHelper::SaveStringToFile(Json, *(BasePath + TEXT(".json"))) ||
+		!FFileHelper::SaveStringToFile(Csv, *(BasePath + TEXT(".csv"))))
+	{
+		Test.AddWarning(FString::Printf(TEXT("Couldn't write the results to %s"), *BasePath));
+	}
+	Test.AddInfo(FString::Printf(TEXT("%s: %s"), *TestName, *Json));
+}
+
+bool FLeapPerformanceReport::Compare() const
+{
+	const FString BaselinePath = GetBaselinePath();
+	FString BaselineText;
+	TSharedPtr<FJsonObject> Baseline;
+	if (!FFileHelper::LoadFileToString(BaselineText, *BaselinePath) ||
+		!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineText), Baseline) || !Baseline.IsValid())
+	{
+		Test.AddWarning(FString::Printf(TEXT("No performance baseline at %s, results are not compared"), *BaselinePath));
+		return true;
+	}
+
+	double Tolerance = Baseline->HasField(TEXT("tolerance")) ? Baseline->GetNumberField(TEXT("tolerance")) : 0.0;
+	FParse::Value(FCommandLine::Get(), TEXT("LeapPerfTolerance="), Tolerance);
+	const double SlackMicros = Baseline->HasField(TEXT("slack_us")) ? Baseline->GetNumberField(TEXT("slack_us")) : 0.0;
+
+	const TSharedPtr<FJsonObject>* Tests = nullptr;
+	const TSharedPtr<FJsonObject>* TestBaseline = nullptr;
+	if (!Baseline->TryGetObjectField(TEXT("tests"), Tests) || !(*Tests)->TryGetObjectField(TestName, TestBaseline))
+	{
+		Test.AddWarning(FString::Printf(TEXT("%s has no entry in %s, results are not compared"), *TestName, *BaselinePath));
+		return true;
+	}
+
+	bool bWithinBudget = true;
+	for (const FLeapBenchmarkStage* Stage : Stages)
+	{
+		const TSharedPtr<FJsonObject>* StageBaseline = nullptr;
+		if (!(*TestBaseline)->TryGetObjectField(Stage->Name, StageBaseline))
+		{
+			Test.AddWarning(FString::Printf(TEXT("%s.%s has no baseline"), *TestName, Stage->Name));
+			continue;
+		}
+
+		const TSharedRef<FJsonObject> Measured = Stage->ToJson();
+		for (const auto& Budget : (*StageBaseline)->Values)
+		{
+			double Value = 0.0;
+			if (!Measured->TryGetNumberField(Budget.Key, Value))
+			{
+				Test.AddWarning(FString::Printf(TEXT("%s.%s has an unknown baseline field %s"), *TestName, Stage->Name, *Budget.Key));
+				continue;
+			}
+
+			const bool bTime = Budget.Key.EndsWith(TEXT("_us"));
+			const double Limit = Budget.Value->AsNumber() * (1.0 + Tolerance) + (bTime ? SlackMicros : 0.0);
+			if (Value > Limit)
+			{
+				Test.AddError(FString::Printf(TEXT("%s.%s %s is %.3f, over the budget of %.3f (baseline %.3f)"), *TestName,
+					Stage->Name, *Budget.Key, Value, Limit, Budget.Value->AsNumber()));
+				bWithinBudget = false;
+			}
+		}
+	}
+	return bWithinBudget;
+}
+
+#endif
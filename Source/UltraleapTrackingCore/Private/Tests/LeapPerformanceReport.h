@@ -0,0 +1,56 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LeapBenchmark.h"
+#include "Misc/AutomationTest.h"
+
+/** Performance tests run on any target, they only need the engine loop, not a world, device or GPU */
+#define LEAP_PERFORMANCE_TEST_FLAGS (EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+/**
+ * Collects the stages of one performance test, writes them out and checks them against the stored baseline.
+ *
+ * Results go to <Saved>/Automation/UltraleapPerformance/<Test>.json and .csv. The JSON has the same shape as a
+ * test entry of the baseline, Config/PerformanceBaseline.json in the plugin, so updating the baseline is a copy.
+ * -LeapPerfBaseline=<file> compares against another baseline, -LeapPerfTolerance=<fraction> overrides its
+ * tolerance e.g. on a slower agent.
+ *
+ * Every value in a baseline stage is a budget. Times (*_us) may exceed it by the tolerance plus slack_us, which
+ * keeps stages of a few microseconds from failing on noise. Allocation counts may exceed it by the tolerance only,
+ * so a zero allocation budget stays zero.
+ */
+class FLeapPerformanceReport
+{
+public:
+	FLeapPerformanceReport(FAutomationTestBase& InTest, const FString& InTestName);
+
+	/** The stage must outlive the report */
+	void AddStage(const FLeapBenchmarkStage& Stage);
+
+	/** Write the results and add a test error for every budget exceeded, false if any was */
+	bool WriteAndCompare();
+
+	/** <Saved>/Automation/UltraleapPerformance */
+	static FString GetOutputDir();
+
+private:
+	void Write() const;
+	bool Compare() const;
+
+	FAutomationTestBase& Test;
+	FString TestName;
+	TArray<const FLeapBenchmarkStage*> Stages;
+};
+
+#endif
@@ -0,0 +1,298 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "LeapPerformanceReport.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "FUltraleapTrackingInputDevice.h"
+#include "HAL/IConsoleManager.h"
+#include "LeapMallocCounter.h"
+#include "LeapReplayWrapper.h"
+#include "LeapSyntheticHands.h"
+#include "OpenXRToLeapWrapper.h"
+#include "Skeleton/BodyStateSkeleton.h"
+#include "UltraleapTrackingData.h"
+
+/**
+ * Per stage time and allocation budgets of the tracking pipeline, run against deterministic synthetic hands.
+ *
+ * Each test steps its stage NumUnmeasuredFrames warm up frames and then NumMeasuredFrames measured ones at 90Hz,
+ * see FLeapPerformanceReport for where the results go and how they are compared. Everything runs on the game thread
+ * without a tracking service, HMD or GPU, e.g.
+ *   UnrealEditor-Cmd <Project> -nullrhi -ExecCmds="Automation RunTests UltraleapTracking.Performance; Quit"
+ */
+namespace
+{
+const int32 NumMeasuredFrames = 2000;
+const int32 NumUnmeasuredFrames = 120;
+const float FrameStep = 1.f / 90.f;
+
+/** Time one call and count its allocations into Stage, only once warmed up */
+template <typename FunctionType>
+void Measure(FLeapBenchmarkStage& Stage, const int32 Frame, FunctionType&& Function)
+{
+	FLeapMallocCounter& MallocCounter = FLeapMallocCounter::Install();
+	MallocCounter.StartCounting();
+	const uint64 Start = FPlatformTime::Cycles64();
+	Function();
+	const uint64 Cycles = FPlatformTime::Cycles64() - Start;
+	MallocCounter.StopCounting();
+
+	if (Frame >= NumUnmeasuredFrames)
+	{
+		Stage.Add(Cycles, MallocCounter.GetCounts());
+	}
+}
+
+/** Synthetic hands through a replay wrapper into a fresh input device */
+bool CreatePipeline(FAutomationTestBase& Test, FLeapBenchmarkPipeline& Pipeline)
+{
+	TSharedPtr<FLeapReplayWrapper> Replay = MakeShareable(new FLeapReplayWrapper);
+	Replay->UseSyntheticHands(FLeapSyntheticHands::MaxHands, 0);
+	if (!Pipeline.Create(Replay, false, false))
+	{
+		Test.AddError(TEXT("The input device has no BodyState skeleton"));
+		return false;
+	}
+	return true;
+}
+
+/** Run the device stages that aren't measured by the test */
+void StepPipeline(FLeapBenchmarkPipeline& Pipeline, const bool bParseEvents, const bool bUpdateSkeleton)
+{
+	Pipeline.Advance(FrameStep);
+	const bool bCaptured = Pipeline.Device->CaptureFrame();
+	if (bCaptured && bParseEvents)
+	{
+		Pipeline.Device->ParseEvents();
+	}
+	if (bUpdateSkeleton)
+	{
+		Pipeline.Device->UpdateInput(Pipeline.Device->GetBodyStateDeviceId(), Pipeline.Skeleton);
+	}
+}
+}	 // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FLeapFrameConversionPerformanceTest, "UltraleapTracking.Performance.FrameConversion", LEAP_PERFORMANCE_TEST_FLAGS)
+
+bool FLeapFrameConversionPerformanceTest::RunTest(const FString& Parameters)
+{
+	// Generate every frame up front so only the conversion is measured
+	const int32 NumSourceFrames = 512;
+	FLeapSyntheticHands SyntheticHands;
+	TArray<LEAP_TRACKING_EVENT> Events;
+	TArray<LEAP_HAND> Hands;
+	Events.SetNumZeroed(NumSourceFrames);
+	Hands.SetNumZeroed(NumSourceFrames * FLeapSyntheticHands::MaxHands);
+	for (int32 Index = 0; Index < NumSourceFrames; Index++)
+	{
+		LEAP_HAND* FrameHands = &Hands[Index * FLeapSyntheticHands::MaxHands];
+		SyntheticHands.Generate((int64) (Index * FrameStep * 1000000.0), Events[Index], FrameHands);
+	}
+
+	FLeapBenchmarkStage ConversionStage(TEXT("SetFromLeapFrame"));
+	FLeapBenchmarkStage TransformStage(TEXT("TransformFrame"));
+	FLeapFrameData FrameData;
+	const FRotator HMDRotation(10.f, 30.f, 0.f);
+	const FVector HMDTranslation(20.f, 0.f, 160.f);
+
+	for (int32 Frame = 0; Frame < NumUnmeasuredFrames + NumMeasuredFrames; Frame++)
+	{
+		LEAP_TRACKING_EVENT* Event = &Events[Frame % NumSourceFrames];
+		Measure(ConversionStage, Frame, [&FrameData, Event] { FrameData.SetFromLeapFrame(Event); });
+		Measure(TransformStage, Frame, [&] {
+			FrameData.RotateFrame(HMDRotation);
+			FrameData.TranslateFrame(HMDTranslation);
+		});
+	}
+
+	FLeapPerformanceReport Report(*this, TEXT("FrameConversion"));
+	Report.AddStage(ConversionStage);
+	Report.AddStage(TransformStage);
+	return Report.WriteAndCompare();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FLeapGestureEvaluationPerformanceTest, "UltraleapTracking.Performance.GestureEvaluation", LEAP_PERFORMANCE_TEST_FLAGS)
+
+bool FLeapGestureEvaluationPerformanceTest::RunTest(const FString& Parameters)
+{
+	FLeapBenchmarkPipeline Pipeline;
+	if (!CreatePipeline(*this, Pipeline))
+	{
+		return false;
+	}
+
+	// Pinch, grab and the right hand dropping out all happen within the measured frames
+	FLeapBenchmarkStage ParseStage(TEXT("ParseEvents"));
+	for (int32 Frame = 0; Frame < NumUnmeasuredFrames + NumMeasuredFrames; Frame++)
+	{
+		Pipeline.Advance(FrameStep);
+		if (Pipeline.Device->CaptureFrame())
+		{
+			Measure(ParseStage, Frame, [&Pipeline] { Pipeline.Device->ParseEvents(); });
+		}
+	}
+	Pipeline.Destroy();
+
+	FLeapPerformanceReport Report(*this, TEXT("GestureEvaluation"));
+	Report.AddStage(ParseStage);
+	return Report.WriteAndCompare();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FLeapSkeletonMergePerformanceTest, "UltraleapTracking.Performance.SkeletonMerge", LEAP_PERFORMANCE_TEST_FLAGS)
+
+bool FLeapSkeletonMergePerformanceTest::RunTest(const FString& Parameters)
+{
+	FLeapBenchmarkPipeline Pipeline;
+	if (!CreatePipeline(*this, Pipeline))
+	{
+		return false;
+	}
+
+	// Same steps as FBodyStateSkeletonStorage::UpdateMergeSkeletonData() for one device, into a skeleton of our own
+	UBodyStateSkeleton* MergedSkeleton = NewObject<UBodyStateSkeleton>();
+	MergedSkeleton->AddToRoot();
+	MergedSkeleton->bTrackingActive = true;
+
+	FLeapBenchmarkStage UpdateStage(TEXT("UpdateInput"));
+	FLeapBenchmarkStage MergeStage(TEXT("MergeFromOtherSkeleton"));
+	for (int32 Frame = 0; Frame < NumUnmeasuredFrames + NumMeasuredFrames; Frame++)
+	{
+		StepPipeline(Pipeline, true, false);
+		Measure(UpdateStage, Frame,
+			[&Pipeline] { Pipeline.Device->UpdateInput(Pipeline.Device->GetBodyStateDeviceId(), Pipeline.Skeleton); });
+		Measure(MergeStage, Frame, [&Pipeline, MergedSkeleton] {
+			MergedSkeleton->ClearConfidence();
+			FScopeLock ScopeLock(&MergedSkeleton->BoneDataLock);
+			MergedSkeleton->MergeFromOtherSkeleton(Pipeline.Skeleton);
+		});
+	}
+
+	MergedSkeleton->RemoveFromRoot();
+	Pipeline.Destroy();
+
+	FLeapPerformanceReport Report(*this, TEXT("SkeletonMerge"));
+	Report.AddStage(UpdateStage);
+	Report.AddStage(MergeStage);
+	return Report.WriteAndCompare();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FLeapRetargetingPerformanceTest, "UltraleapTracking.Performance.Retargeting", LEAP_PERFORMANCE_TEST_FLAGS)
+
+bool FLeapRetargetingPerformanceTest::RunTest(const FString& Parameters)
+{
+	FLeapBenchmarkPipeline Pipeline;
+	if (!CreatePipeline(*this, Pipeline))
+	{
+		return false;
+	}
+
+	// Evaluate anim on this thread so the whole evaluation is measured
+	IConsoleVariable* ParallelAnim = IConsoleManager::Get().FindConsoleVariable(TEXT("a.ParallelAnimEvaluation"));
+	const int32 ParallelAnimValue = ParallelAnim ? ParallelAnim->GetInt() : 0;
+	if (ParallelAnim)
+	{
+		ParallelAnim->Set(0);
+	}
+
+	// The low poly hand shipped with the plugin, retargeted by the BodyState mapped bones node
+	FLeapBenchmarkAnimScene AnimScene;
+	if (!AnimScene.Create(TEXT("/UltraleapTracking/Mesh/LowPoly_Rigged_Hand_Left.LowPoly_Rigged_Hand_Left"),
+			TEXT("/UltraleapTracking/BodyState/BSLowPolyLeftAnimBP.BSLowPolyLeftAnimBP_C")))
+	{
+		AddError(TEXT("Couldn't create the retargeting scene from the plugin content"));
+		Pipeline.Destroy();
+		return false;
+	}
+
+	FLeapBenchmarkStage AnimStage(TEXT("AnimEvaluation"));
+	for (int32 Frame = 0; Frame < NumUnmeasuredFrames + NumMeasuredFrames; Frame++)
+	{
+		StepPipeline(Pipeline, true, true);
+		Measure(AnimStage, Frame, [&AnimScene] { AnimScene.Evaluate(FrameStep); });
+	}
+
+	AnimScene.Destroy();
+	Pipeline.Destroy();
+	if (ParallelAnim)
+	{
+		ParallelAnim->Set(ParallelAnimValue);
+	}
+
+	FLeapPerformanceReport Report(*this, TEXT("Retargeting"));
+	Report.AddStage(AnimStage);
+	return Report.WriteAndCompare();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FLeapOpenXRConversionPerformanceTest, "UltraleapTracking.Performance.OpenXRConversion", LEAP_PERFORMANCE_TEST_FLAGS)
+
+bool FLeapOpenXRConversionPerformanceTest::RunTest(const FString& Parameters)
+{
+	// Keypoints laid out like the OpenXR hand tracker's, taken from the synthetic left hand. Only the cost of the
+	// conversion is measured so the space they are in doesn't matter
+	const int32 NumSourceFrames = 512;
+	FLeapSyntheticHands SyntheticHands(1, 0);
+	TArray<TArray<FVector>> Positions;
+	TArray<TArray<FQuat>> Rotations;
+	Positions.SetNum(NumSourceFrames);
+	Rotations.SetNum(NumSourceFrames);
+	for (int32 Index = 0; Index < NumSourceFrames; Index++)
+	{
+		LEAP_TRACKING_EVENT Event;
+		LEAP_HAND Hand;
+		SyntheticHands.Generate((int64) (Index * FrameStep * 1000000.0), Event, &Hand);
+
+		Positions[Index].Init(FVector::ZeroVector, EHandKeypointCount);
+		Rotations[Index].Init(FQuat::Identity, EHandKeypointCount);
+		Positions[Index][(int32) EHandKeypoint::Palm] = FVector(Hand.palm.position.x, Hand.palm.position.y, Hand.palm.position.z);
+		Positions[Index][(int32) EHandKeypoint::Wrist] = FVector(Hand.arm.next_joint.x, Hand.arm.next_joint.y, Hand.arm.next_joint.z);
+		for (int32 DigitIndex = 0; DigitIndex < 5; DigitIndex++)
+		{
+			// The zero length LeapC thumb metacarpal has no keypoint, the thumb has 4 keypoints and the other digits 5
+			const int32 FirstKeypoint = DigitIndex == 0 ? (int32) EHandKeypoint::ThumbMetacarpal
+													   : (int32) EHandKeypoint::IndexMetacarpal + (DigitIndex - 1) * 5;
+			const int32 FirstBone = DigitIndex == 0 ? 1 : 0;
+			for (int32 BoneIndex = FirstBone; BoneIndex < 4; BoneIndex++)
+			{
+				const LEAP_BONE& Bone = Hand.digits[DigitIndex].bones[BoneIndex];
+				const int32 Keypoint = FirstKeypoint + BoneIndex - FirstBone;
+				Positions[Index][Keypoint] = FVector(Bone.prev_joint.x, Bone.prev_joint.y, Bone.prev_joint.z);
+				Rotations[Index][Keypoint] = FQuat(Bone.rotation.x, Bone.rotation.y, Bone.rotation.z, Bone.rotation.w);
+			}
+			const LEAP_BONE& Distal = Hand.digits[DigitIndex].bones[3];
+			Positions[Index][FirstKeypoint + 4 - FirstBone] = FVector(Distal.next_joint.x, Distal.next_joint.y, Distal.next_joint.z);
+			Rotations[Index][FirstKeypoint + 4 - FirstBone] =
+				FQuat(Distal.rotation.x, Distal.rotation.y, Distal.rotation.z, Distal.rotation.w);
+		}
+	}
+
+	FOpenXRToLeapWrapper Wrapper;
+	const FTransform TrackingToWorld(FRotator(0.f, 90.f, 0.f), FVector(0.f, 0.f, 100.f));
+	LEAP_HAND LeapHand;
+	FMemory::Memzero(LeapHand);
+
+	FLeapBenchmarkStage ConvertStage(TEXT("ConvertToLeapSpace"));
+	for (int32 Frame = 0; Frame < NumUnmeasuredFrames + NumMeasuredFrames; Frame++)
+	{
+		const int32 Index = Frame % NumSourceFrames;
+		Measure(ConvertStage, Frame,
+			[&] { Wrapper.ConvertToLeapSpace(LeapHand, TrackingToWorld, Positions[Index], Rotations[Index]); });
+	}
+
+	FLeapPerformanceReport Report(*this, TEXT("OpenXRConversion"));
+	Report.AddStage(ConvertStage);
+	return Report.WriteAndCompare();
+}
+
+#endif
@@ -0,0 +1,149 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Async/Async.h"
+#include "LeapPooledAllocator.h"
+#include "Misc/AutomationTest.h"
+
+namespace
+{
+// One 640x240 8 bit stereo pair, the size of a typical image event
+const uint32 ImageSize = 640 * 240 * 2;
+
+void* LeapAllocate(const LEAP_ALLOCATOR* Allocator, uint32 Size)
+{
+	return Allocator->allocate(Size, eLeapAllocatorType_Uint8, Allocator->state);
+}
+
+void LeapDeallocate(const LEAP_ALLOCATOR* Allocator, void* Ptr)
+{
+	Allocator->deallocate(Ptr, Allocator->state);
+}
+}	 // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapPooledAllocatorReuseTest, "UltraleapTracking.PooledAllocator.Reuse",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapPooledAllocatorReuseTest::RunTest(const FString& Parameters)
+{
+	FLeapPooledAllocator Pool;
+	const LEAP_ALLOCATOR* Allocator = Pool.GetLeapAllocator();
+
+	// Double buffered image traffic at device rate
+	void* Images[2] = {LeapAllocate(Allocator, ImageSize), LeapAllocate(Allocator, ImageSize)};
+	TestTrue(TEXT("16 byte aligned"), IsAligned(Images[0], 16) && IsAligned(Images[1], 16));
+	FMemory::Memset(Images[0], 0xAB, ImageSize);
+	FMemory::Memset(Images[1], 0xCD, ImageSize);
+	for (int32 Frame = 0; Frame < 100; Frame++)
+	{
+		const int32 Slot = Frame % 2;
+		LeapDeallocate(Allocator, Images[Slot]);
+		Images[Slot] = LeapAllocate(Allocator, ImageSize - Frame);
+	}
+
+	FLeapPooledAllocator::FPoolStats Stats = Pool.GetStats();
+	TestEqual(TEXT("Only the first two allocations went to the heap"), (int64) Stats.Misses, (int64) 2);
+	TestEqual(TEXT("Every later allocation reused a block"), (int64) Stats.Hits, (int64) 100);
+	TestEqual(TEXT("Blocks in use"), Stats.BlocksInUse, 2);
+
+	LeapDeallocate(Allocator, Images[0]);
+	LeapDeallocate(Allocator, Images[1]);
+	Stats = Pool.GetStats();
+	TestEqual(TEXT("Nothing in use"), Stats.BytesInUse, (int64) 0);
+	TestTrue(TEXT("Both blocks pooled"), Stats.BytesFree >= 2 * (int64) ImageSize);
+
+	Pool.Trim();
+	TestEqual(TEXT("Trim empties the pools"), Pool.GetStats().BytesFree, (int64) 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapPooledAllocatorLimitsTest, "UltraleapTracking.PooledAllocator.Limits",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapPooledAllocatorLimitsTest::RunTest(const FString& Parameters)
+{
+	FLeapPooledAllocator Pool;
+	const LEAP_ALLOCATOR* Allocator = Pool.GetLeapAllocator();
+
+	// Free lists keep at most MaxFreeBlocksPerClass blocks, the rest go back to the heap
+	const int32 NumBlocks = FLeapPooledAllocator::MaxFreeBlocksPerClass + 3;
+	TArray<void*> Blocks;
+	for (int32 Index = 0; Index < NumBlocks; Index++)
+	{
+		Blocks.Add(LeapAllocate(Allocator, 1000));
+	}
+	for (void* Block : Blocks)
+	{
+		LeapDeallocate(Allocator, Block);
+	}
+	const int64 MaxPooledBytes = (int64) FLeapPooledAllocator::MaxFreeBlocksPerClass * 1024;
+	TestEqual(TEXT("Pooled bytes are capped"), Pool.GetStats().BytesFree, MaxPooledBytes);
+
+	// Above the largest class nothing is pooled
+	const uint32 HugeSize = (1u << (FLeapPooledAllocator::MinClassShift + FLeapPooledAllocator::NumClasses)) + 1;
+	void* Huge = LeapAllocate(Allocator, HugeSize);
+	TestEqual(TEXT("Huge block in use"), Pool.GetStats().BytesInUse, (int64) HugeSize);
+	LeapDeallocate(Allocator, Huge);
+	TestEqual(TEXT("Huge block not pooled"), Pool.GetStats().BytesFree, MaxPooledBytes);
+
+	// LeapC may hand back null
+	LeapDeallocate(Allocator, nullptr);
+	TestEqual(TEXT("Nothing in use"), Pool.GetStats().BlocksInUse, 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapPooledAllocatorThreadsTest, "UltraleapTracking.PooledAllocator.Threads",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapPooledAllocatorThreadsTest::RunTest(const FString& Parameters)
+{
+	FLeapPooledAllocator Pool;
+	const LEAP_ALLOCATOR* Allocator = Pool.GetLeapAllocator();
+
+	// LeapC allocates and frees from its own threads, mixed sizes across a few classes
+	const int32 NumThreads = 4;
+	const int32 Iterations = 20000;
+	TArray<TFuture<bool>> Threads;
+	for (int32 ThreadIndex = 0; ThreadIndex < NumThreads; ThreadIndex++)
+	{
+		Threads.Add(Async(EAsyncExecution::Thread, [Allocator, ThreadIndex]() {
+			const uint8 Pattern = (uint8) (ThreadIndex + 1);
+			for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+			{
+				const uint32 Size = 64u << (Iteration % 5);
+				uint8* Block = (uint8*) LeapAllocate(Allocator, Size);
+				FMemory::Memset(Block, Pattern, Size);
+				for (uint32 Byte = 0; Byte < Size; Byte++)
+				{
+					if (Block[Byte] != Pattern)
+					{
+						return false;
+					}
+				}
+				LeapDeallocate(Allocator, Block);
+			}
+			return true;
+		}));
+	}
+
+	bool bAllIntact = true;
+	for (TFuture<bool>& Thread : Threads)
+	{
+		bAllIntact &= Thread.Get();
+	}
+	TestTrue(TEXT("No block written by two threads at once"), bAllIntact);
+
+	const FLeapPooledAllocator::FPoolStats Stats = Pool.GetStats();
+	TestEqual(TEXT("Nothing in use"), Stats.BlocksInUse, 0);
+	TestEqual(TEXT("Every allocation counted"), (int64) (Stats.Hits + Stats.Misses), (int64) NumThreads * Iterations);
+	AddInfo(FString::Printf(TEXT("%llu of %d allocations went to the heap"), Stats.Misses, NumThreads * Iterations));
+	return true;
+}
+
+#endif
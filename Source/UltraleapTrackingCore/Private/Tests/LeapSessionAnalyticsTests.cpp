@@ -0,0 +1,166 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LeapSessionAnalytics.h"
+#include "LeapSyntheticHands.h"
+#include "Misc/AutomationTest.h"
+
+namespace
+{
+// Twelve seconds at 120Hz
+const int32 NumSessionFrames = 1440;
+const int64 SessionFrameMicros = 8333;
+
+/** Left hand only, its palm at Position(Seconds) */
+template <typename PositionFunction>
+void AddSessionPalmFrames(FLeapSessionAnalyzer& Analyzer, PositionFunction&& Position)
+{
+	FLeapMotionArchiveFrame Frame;
+	Frame.Hands[0].bVisible = true;
+	for (int32 FrameIndex = 0; FrameIndex < NumSessionFrames; FrameIndex++)
+	{
+		Frame.TimeMicros = FrameIndex * SessionFrameMicros;
+		Frame.Hands[0].PalmPosition = Position(Frame.TimeMicros / 1000000.0);
+		Analyzer.AddFrame(Frame);
+	}
+}
+}	 // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapSessionAnalyticsDropoutsTest, "UltraleapTracking.SessionAnalytics.Dropouts",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapSessionAnalyticsDropoutsTest::RunTest(const FString& Parameters)
+{
+	const FLeapSessionAnalyticsSettings Settings;
+	FLeapSessionAnalyzer Analyzer(Settings, SessionFrameMicros);
+
+	const FLeapSyntheticHands SyntheticHands(2);
+	FLeapFrameData LeapFrame;
+	FLeapJointCache Joints;
+	FLeapMotionArchiveFrame Frame;
+	for (int32 FrameIndex = 0; FrameIndex < NumSessionFrames; FrameIndex++)
+	{
+		SyntheticHands.GenerateFrame(FrameIndex * SessionFrameMicros, LeapFrame);
+		Joints.SetFromFrame(LeapFrame);
+		Frame.SetFromJoints(Joints, FrameIndex * SessionFrameMicros);
+		Analyzer.AddFrame(Frame);
+	}
+	FLeapSessionStats Stats;
+	Analyzer.Finish(Stats);
+
+	TestEqual(TEXT("Frames"), Stats.NumFrames, (int64) NumSessionFrames);
+	TestEqual(TEXT("No gaps"), Stats.DroppedFrames, (int64) 0);
+	TestEqual(TEXT("Duration"), Stats.DurationSeconds, 12.0, 0.01);
+
+	// The right hand is missing for the first half second of every five, the first doesn't count as a dropout
+	const FLeapSessionStats::FHand& Left = Stats.Hands[0];
+	const FLeapSessionStats::FHand& Right = Stats.Hands[1];
+	TestEqual(TEXT("Left always visible"), Left.VisibleFrames, (int64) NumSessionFrames);
+	TestEqual(TEXT("Left never lost"), Left.Dropouts, (int64) 0);
+	TestEqual(TEXT("Right dropouts"), Right.Dropouts, (int64) 2);
+	TestEqual(TEXT("Right visible fraction"), (double) Right.VisibleFrames / NumSessionFrames, 10.5 / 12.0, 0.01);
+	TestEqual(TEXT("Right mean dropout"), Right.DropoutSeconds / Right.Dropouts, 0.5, 0.02);
+	TestEqual(TEXT("Right longest dropout"), Right.LongestDropoutSeconds, 0.5, 0.02);
+
+	int64 PinchTotal = 0;
+	for (const int64 Count : Right.PinchHistogram)
+	{
+		PinchTotal += Count;
+	}
+	TestEqual(TEXT("A pinch sample per visible frame"), PinchTotal, Right.VisibleFrames);
+
+	// Totals are sums, the rates come out the same
+	FLeapSessionStats Total;
+	Total.Reset(Settings);
+	Total.Accumulate(Stats);
+	Total.Accumulate(Stats);
+	TestEqual(TEXT("Total sessions"), Total.NumSessions, 2);
+	TestEqual(TEXT("Total dropouts"), Total.Hands[1].Dropouts, (int64) 4);
+	TestEqual(TEXT("Total duration"), Total.DurationSeconds, Stats.DurationSeconds * 2.0, 0.001);
+
+	TArray<FString> Header;
+	TArray<FString> Row;
+	FLeapSessionStats::GetCsvHeader(Settings).ParseIntoArray(Header, TEXT(","));
+	Total.ToCsvRow(Settings).ParseIntoArray(Row, TEXT(","), false);
+	TestEqual(TEXT("A CSV value per column"), Row.Num(), Header.Num());
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapSessionAnalyticsJitterTest, "UltraleapTracking.SessionAnalytics.Jitter",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapSessionAnalyticsJitterTest::RunTest(const FString& Parameters)
+{
+	FLeapSessionAnalyticsSettings Settings;
+	Settings.Metrics = ELeapSessionMetrics::Jitter;
+	FLeapSessionAnalyzer Analyzer(Settings, SessionFrameMicros);
+
+	// A millimetre tremor at 10Hz on top of a slow reach, which the detrending should take out
+	const float Amplitude = 0.1f;
+	AddSessionPalmFrames(Analyzer, [Amplitude](const double Seconds) {
+		return FVector(20.f + Amplitude * float(FMath::Sin(2.0 * PI * 10.0 * Seconds)), float(5.0 * Seconds), 0.f);
+	});
+	FLeapSessionStats Stats;
+	Analyzer.Finish(Stats);
+
+	const FLeapSessionStats::FHand& Left = Stats.Hands[0];
+	TestTrue(TEXT("Windows"), Left.JitterWindows > 0);
+	double TotalPower = 0.0;
+	for (const double Power : Left.JitterBandPower)
+	{
+		TotalPower += Power / Left.JitterWindows;
+	}
+	const double TremorPower = Left.JitterBandPower[4] / Left.JitterWindows;
+	AddInfo(FString::Printf(TEXT("8-16Hz %g cm2 of %g cm2"), TremorPower, TotalPower));
+	const double TremorMeanSquare = Amplitude * Amplitude * 0.5;
+	TestEqual(TEXT("8-16Hz band holds the tremor's mean square"), TremorPower, TremorMeanSquare, 0.15 * TremorMeanSquare);
+	TestTrue(TEXT("Most power in the tremor band"), TremorPower > 0.9 * TotalPower);
+	TestTrue(TEXT("Second difference RMS"), Left.JitterSamples > 0 && Left.JitterSquaredSum > 0.0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapSessionAnalyticsVelocityTest, "UltraleapTracking.SessionAnalytics.Velocity",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapSessionAnalyticsVelocityTest::RunTest(const FString& Parameters)
+{
+	FLeapSessionAnalyticsSettings Settings;
+	Settings.Metrics = ELeapSessionMetrics::Velocity | ELeapSessionMetrics::Dropouts;
+	FLeapSessionAnalyzer Analyzer(Settings, SessionFrameMicros);
+
+	// 25cm/s is in the third 10cm/s bin, with three frames missing in the middle
+	FLeapMotionArchiveFrame Frame;
+	Frame.Hands[0].bVisible = true;
+	for (int32 FrameIndex = 0; FrameIndex < NumSessionFrames; FrameIndex++)
+	{
+		if (FrameIndex >= 700 && FrameIndex < 703)
+		{
+			continue;
+		}
+		Frame.TimeMicros = FrameIndex * SessionFrameMicros;
+		Frame.Hands[0].PalmPosition = FVector(float(25.0 * Frame.TimeMicros / 1000000.0), 0.f, 0.f);
+		Analyzer.AddFrame(Frame);
+	}
+	FLeapSessionStats Stats;
+	Analyzer.Finish(Stats);
+
+	TestEqual(TEXT("Dropped frames"), Stats.DroppedFrames, (int64) 3);
+	const TArray<int64>& Histogram = Stats.Hands[0].VelocityHistogram;
+	// A speed between every pair of consecutive frames, except across the gap
+	TestEqual(TEXT("Speed bin"), Histogram[2], (int64) NumSessionFrames - 3 - 2);
+	int64 Total = 0;
+	for (const int64 Count : Histogram)
+	{
+		Total += Count;
+	}
+	TestEqual(TEXT("Every speed in one bin"), Total, Histogram[2]);
+	return true;
+}
+
+#endif
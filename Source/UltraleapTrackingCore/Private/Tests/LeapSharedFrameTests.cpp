@@ -0,0 +1,199 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Async/Async.h"
+#include "LeapSharedFrameRing.h"
+#include "LeapSharedFrameWrapper.h"
+#include "LeapSyntheticHands.h"
+#include "Misc/AutomationTest.h"
+
+namespace
+{
+// 90Hz in microseconds
+const int64 SharedFrameInterval = 11111;
+
+FString MakeRingName()
+{
+	return FString::Printf(TEXT("UltraleapTest%s"), *FGuid::NewGuid().ToString(EGuidFormats::Digits));
+}
+
+struct FSharedTestFrame
+{
+	LEAP_TRACKING_EVENT Event;
+	LEAP_HAND Hands[FLeapSharedFrameRing::MaxHands];
+};
+
+bool IsSamePublishedFrame(const LEAP_TRACKING_EVENT& Read, const FSharedTestFrame& Published)
+{
+	return Read.info.frame_id == Published.Event.info.frame_id && Read.info.timestamp == Published.Event.info.timestamp &&
+		   Read.nHands == Published.Event.nHands &&
+		   FMemory::Memcmp(Read.pHands, Published.Hands, Read.nHands * sizeof(LEAP_HAND)) == 0;
+}
+}	 // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapSharedFrameRingTest, "UltraleapTracking.SharedFrames.Ring",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapSharedFrameRingTest::RunTest(const FString& Parameters)
+{
+	const FString Name = MakeRingName();
+	FLeapSharedFrameRing Publisher;
+	FLeapSharedFrameRing Consumer;
+	if (!TestTrue(TEXT("Publisher created"), Publisher.Create(Name)) || !TestTrue(TEXT("Consumer opened"), Consumer.Open(Name)))
+	{
+		return false;
+	}
+
+	FSharedTestFrame Read;
+	TestFalse(TEXT("Nothing to read before the first publish"), Consumer.ReadLatest(Read.Event, Read.Hands));
+
+	// Wrap the ring more than once, keep every frame to compare with
+	const FLeapSyntheticHands SyntheticHands(2, 7);
+	const int32 NumFrames = FLeapSharedFrameRing::NumSlots * 2 + 10;
+	TArray<FSharedTestFrame> Published;
+	Published.SetNum(NumFrames);
+	for (int32 Index = 0; Index < NumFrames; Index++)
+	{
+		FMemory::Memzero(Published[Index]);
+		SyntheticHands.Generate((Index + 1) * SharedFrameInterval, Published[Index].Event, Published[Index].Hands);
+		Publisher.Publish(Published[Index].Event, (Index + 1) * SharedFrameInterval);
+	}
+
+	TestTrue(TEXT("Latest read"), Consumer.ReadLatest(Read.Event, Read.Hands));
+	TestTrue(TEXT("Latest is the last published frame"), IsSamePublishedFrame(Read.Event, Published.Last()));
+	TestTrue(TEXT("Hands point at the reader's buffer"), Read.Event.pHands == Read.Hands);
+
+	// Between two frames gives the earlier one
+	const int32 Recent = NumFrames - 5;
+	const int64 BetweenFrames = (Recent + 1) * SharedFrameInterval + SharedFrameInterval / 2;
+	TestTrue(TEXT("Read at time"), Consumer.ReadAt(BetweenFrames, Read.Event, Read.Hands));
+	TestTrue(TEXT("Frame at or before the time"), IsSamePublishedFrame(Read.Event, Published[Recent]));
+
+	// Older than the ring gives the oldest frame that can't be overwritten next
+	TestTrue(TEXT("Read before the ring"), Consumer.ReadAt(0, Read.Event, Read.Hands));
+	TestTrue(TEXT("Oldest frame"), IsSamePublishedFrame(Read.Event, Published[NumFrames - (FLeapSharedFrameRing::NumSlots - 1)]));
+
+	TestTrue(TEXT("Publisher alive"), Consumer.IsPublisherAlive(1.0));
+	TestEqual(TEXT("Publisher clock"), (double) Consumer.GetPublisherNow(), (double) (NumFrames * SharedFrameInterval), 100000.0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapSharedFrameWrapperTest, "UltraleapTracking.SharedFrames.Wrapper",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapSharedFrameWrapperTest::RunTest(const FString& Parameters)
+{
+	const FString Name = MakeRingName();
+	FLeapSharedFrameWrapper Wrapper(Name);
+	Wrapper.OpenConnection(nullptr);
+	TestFalse(TEXT("Not connected without a publisher"), Wrapper.IsConnected());
+
+	FLeapSharedFrameRing Publisher;
+	if (!TestTrue(TEXT("Publisher created"), Publisher.Create(Name)))
+	{
+		return false;
+	}
+	char Serial[] = "SharedTestDevice";
+	LEAP_DEVICE_INFO DeviceInfo = {0};
+	DeviceInfo.size = sizeof(LEAP_DEVICE_INFO);
+	DeviceInfo.serial = Serial;
+	DeviceInfo.serial_length = sizeof(Serial);
+	DeviceInfo.baseline = 40;
+	Publisher.PublishDeviceInfo(DeviceInfo);
+
+	const FLeapSyntheticHands SyntheticHands(2, 3);
+	FSharedTestFrame Published;
+	FMemory::Memzero(Published);
+	SyntheticHands.Generate(SharedFrameInterval, Published.Event, Published.Hands);
+	Publisher.Publish(Published.Event, SharedFrameInterval);
+
+	// Reconnect right away instead of after the one second check interval
+	Wrapper.OpenConnection(nullptr);
+	if (!TestTrue(TEXT("Connected once a publisher is writing"), Wrapper.IsConnected()))
+	{
+		return false;
+	}
+
+	LEAP_DEVICE_INFO* ReadDeviceInfo = Wrapper.GetDeviceProperties();
+	if (TestNotNull(TEXT("Device info"), ReadDeviceInfo))
+	{
+		TestEqual(TEXT("Serial"), FString(ANSI_TO_TCHAR(ReadDeviceInfo->serial)), FString(TEXT("SharedTestDevice")));
+		TestEqual(TEXT("Baseline"), (int32) ReadDeviceInfo->baseline, 40);
+	}
+
+	LEAP_TRACKING_EVENT* Frame = Wrapper.GetFrame();
+	TestTrue(TEXT("Identical frame"), Frame && IsSamePublishedFrame(*Frame, Published));
+	LEAP_TRACKING_EVENT* Interpolated = Wrapper.GetInterpolatedFrameAtTime(Wrapper.GetNow());
+	TestTrue(TEXT("Identical interpolated frame"), Interpolated && IsSamePublishedFrame(*Interpolated, Published));
+
+	Wrapper.CloseConnection();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapSharedFrameTornReadTest, "UltraleapTracking.SharedFrames.TornReads",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapSharedFrameTornReadTest::RunTest(const FString& Parameters)
+{
+	const FString Name = MakeRingName();
+	FLeapSharedFrameRing Publisher;
+	FLeapSharedFrameRing Consumer;
+	if (!TestTrue(TEXT("Publisher created"), Publisher.Create(Name)) || !TestTrue(TEXT("Consumer opened"), Consumer.Open(Name)))
+	{
+		return false;
+	}
+
+	// Every byte of every hand carries the frame id, a read mixing two frames shows up as a mismatch
+	std::atomic<bool> bStop{false};
+	TFuture<void> PublisherThread = Async(EAsyncExecution::Thread, [&Publisher, &bStop]() {
+		FSharedTestFrame Frame;
+		FMemory::Memzero(Frame);
+		Frame.Event.nHands = FLeapSharedFrameRing::MaxHands;
+		Frame.Event.pHands = Frame.Hands;
+		for (uint32 FrameId = 1; !bStop; FrameId++)
+		{
+			Frame.Event.info.frame_id = FrameId;
+			Frame.Event.info.timestamp = FrameId;
+			FMemory::Memset(Frame.Hands, (uint8) FrameId, sizeof(Frame.Hands));
+			Publisher.Publish(Frame.Event, FrameId);
+		}
+	});
+
+	int32 Reads = 0;
+	int32 TornReads = 0;
+	FSharedTestFrame Read;
+	const double End = FPlatformTime::Seconds() + 0.5;
+	while (FPlatformTime::Seconds() < End)
+	{
+		if (!Consumer.ReadLatest(Read.Event, Read.Hands))
+		{
+			continue;
+		}
+		Reads++;
+		const uint8 Expected = (uint8) Read.Event.info.frame_id;
+		const uint8* Bytes = (const uint8*) Read.Hands;
+		for (int32 Byte = 0; Byte < Read.Event.nHands * (int32) sizeof(LEAP_HAND); Byte++)
+		{
+			if (Bytes[Byte] != Expected)
+			{
+				TornReads++;
+				break;
+			}
+		}
+	}
+	bStop = true;
+	PublisherThread.Wait();
+
+	AddInfo(FString::Printf(TEXT("%d reads against a publisher writing as fast as it can"), Reads));
+	TestTrue(TEXT("Some reads succeeded"), Reads > 0);
+	TestEqual(TEXT("Torn reads"), TornReads, 0);
+	return true;
+}
+
+#endif
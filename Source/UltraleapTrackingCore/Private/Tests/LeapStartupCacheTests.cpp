@@ -0,0 +1,108 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LeapStartupCache.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/ConfigCacheIni.h"
+
+namespace
+{
+const TCHAR* StartupCacheSection = TEXT("UltraleapTracking.StartupCacheTest");
+
+FLeapDevice MakeCachedDevice(const FString& Serial)
+{
+	FLeapDevice Device;
+	Device.Status = 0;
+	Device.Caps = 0;
+	Device.PID = TEXT("Stereo IR 170");
+	Device.Baseline = 64000;
+	Device.Serial = Serial;
+	Device.HorizontalFOV = 2.3f;
+	Device.VerticalFOV = 2.f;
+	Device.Range = 750000;
+	return Device;
+}
+}	 // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapStartupCachePersistTest, "UltraleapTracking.StartupCache.Persist",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapStartupCachePersistTest::RunTest(const FString& Parameters)
+{
+	GConfig->EmptySection(StartupCacheSection, GGameUserSettingsIni);
+
+	FLeapStartupCache Empty;
+	TestFalse(TEXT("Nothing cached yet"), Empty.Load(StartupCacheSection));
+
+	FLeapStartupCache Saved;
+	TestTrue(TEXT("New device changes the cache"), Saved.SetDevice(MakeCachedDevice(TEXT("LP123"))));
+	TestFalse(TEXT("Same device doesn't"), Saved.SetDevice(MakeCachedDevice(TEXT("LP123"))));
+	TestTrue(TEXT("New mode changes the cache"), Saved.SetMode(LEAP_MODE_VR));
+	Saved.Save(StartupCacheSection);
+
+	FLeapStartupCache Loaded;
+	TestTrue(TEXT("Loaded"), Loaded.Load(StartupCacheSection));
+	TestTrue(TEXT("Device loaded"), Loaded.HasDevice());
+	TestEqual(TEXT("Serial"), Loaded.GetDevice().Serial, FString(TEXT("LP123")));
+	TestEqual(TEXT("PID"), Loaded.GetDevice().PID, FString(TEXT("Stereo IR 170")));
+	TestEqual(TEXT("Range"), Loaded.GetDevice().Range, 750000);
+	TestEqual(TEXT("FOV"), Loaded.GetDevice().HorizontalFOV, 2.3f);
+	TestTrue(TEXT("Mode loaded"), Loaded.HasMode() && Loaded.GetMode() == LEAP_MODE_VR);
+
+	// The device found is compared with the one loaded
+	Loaded.BeginConnection(0);
+	Loaded.NoteDeviceFound(0.1, TEXT("LP123"));
+	TestTrue(TEXT("Same device used the cache"), Loaded.GetStats().bUsedCachedDevice);
+	Loaded.BeginConnection(1);
+	Loaded.NoteDeviceFound(1.1, TEXT("LP456"));
+	TestFalse(TEXT("Another device didn't"), Loaded.GetStats().bUsedCachedDevice);
+
+	GConfig->EmptySection(StartupCacheSection, GGameUserSettingsIni);
+	GConfig->Flush(false, GGameUserSettingsIni);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapStartupCacheTimingTest, "UltraleapTracking.StartupCache.Timing",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapStartupCacheTimingTest::RunTest(const FString& Parameters)
+{
+	FLeapStartupCache Cache;
+	TestFalse(TEXT("Nothing awaited before connecting"), Cache.IsWaitingForFrames());
+
+	Cache.BeginConnection(10.0);
+	Cache.NoteConnected(10.1);
+	Cache.NoteDeviceFound(10.2, TEXT("LP123"));
+	Cache.NoteFrame(10.3, 0);
+	TestTrue(TEXT("Frames without hands keep waiting"), Cache.IsWaitingForFrames());
+	Cache.NoteFrame(10.5, 1);
+	TestFalse(TEXT("Done once hands arrive"), Cache.IsWaitingForFrames());
+
+	const FLeapStartupStats& Stats = Cache.GetStats();
+	TestEqual(TEXT("Connected"), Stats.ConnectedMS, 100.f, 0.01f);
+	TestEqual(TEXT("Device"), Stats.DeviceFoundMS, 200.f, 0.01f);
+	TestEqual(TEXT("First frame"), Stats.FirstFrameMS, 300.f, 0.01f);
+	TestEqual(TEXT("First hand"), Stats.FirstHandMS, 500.f, 0.01f);
+
+	// Reconnects and later frames leave the first times alone
+	Cache.NoteConnected(30.0);
+	Cache.NoteFrame(30.0, 2);
+	TestEqual(TEXT("First hand kept"), Cache.GetStats().FirstHandMS, 500.f, 0.01f);
+
+	Cache.NoteMapLoaded(40.0);
+	Cache.NoteFrame(40.05, 0);
+	TestTrue(TEXT("Waiting for hands after the map load"), Cache.IsWaitingForFrames());
+	Cache.NoteFrame(40.1, 2);
+	TestEqual(TEXT("Map load to hand"), Cache.GetStats().MapLoadToHandMS, 100.f, 0.01f);
+	TestEqual(TEXT("Startup times kept"), Cache.GetStats().FirstHandMS, 500.f, 0.01f);
+	return true;
+}
+
+#endif
@@ -0,0 +1,258 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Common/UdpSocketBuilder.h"
+#include "LeapSyntheticHands.h"
+#include "LeapTrackingServer.h"
+#include "Misc/AutomationTest.h"
+#include "SocketSubsystem.h"
+#include "Sockets.h"
+#include "UltraleapTrackingData.h"
+
+namespace
+{
+// Loopback delivery is near immediate, this only guards against a busy agent
+const double ReceiveTimeoutSeconds = 1.0;
+
+/** Minimal client, the same steps as Extras/LeapTrackingClient */
+struct FTestClient
+{
+	FSocket* Socket = nullptr;
+	TSharedPtr<FInternetAddr> Server;
+
+	bool Create(const int32 ServerPort)
+	{
+		Socket = FUdpSocketBuilder(TEXT("UltraleapTrackingTestClient"))
+					 .AsNonBlocking()
+					 .BoundToAddress(FIPv4Address(127, 0, 0, 1))
+					 .BoundToPort(0);
+		Server = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+		Server->SetIp(FIPv4Address(127, 0, 0, 1).Value);
+		Server->SetPort(ServerPort);
+		return Socket != nullptr;
+	}
+
+	~FTestClient()
+	{
+		if (Socket)
+		{
+			ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		}
+	}
+
+	void SendHello(const uint16 RateHz, const uint16 Version = LeapTrackingProtocol::Version)
+	{
+		uint8 Buffer[LeapTrackingProtocol::HelloSize];
+		int32 BytesSent = 0;
+		Socket->SendTo(Buffer, (int32) LeapTrackingProtocol::WriteHello(Buffer, sizeof(Buffer), RateHz, Version), BytesSent,
+			*Server);
+	}
+
+	void SendGoodbye()
+	{
+		uint8 Buffer[LeapTrackingProtocol::PreambleSize];
+		int32 BytesSent = 0;
+		Socket->SendTo(Buffer, (int32) LeapTrackingProtocol::WriteGoodbye(Buffer, sizeof(Buffer)), BytesSent, *Server);
+	}
+
+	/** Next datagram, or 0 bytes once nothing arrived within the timeout */
+	int32 Receive(uint8* Buffer, const int32 Size, const double Timeout = ReceiveTimeoutSeconds)
+	{
+		const double End = FPlatformTime::Seconds() + Timeout;
+		int32 BytesRead = 0;
+		do
+		{
+			if (Socket->Recv(Buffer, Size, BytesRead) && BytesRead > 0)
+			{
+				return BytesRead;
+			}
+			FPlatformProcess::Sleep(0.001f);
+		} while (FPlatformTime::Seconds() < End);
+		return 0;
+	}
+};
+
+/** Poll until the server picked up the subscriptions, it only reads them from the input tick */
+bool WaitForClients(FLeapTrackingServer& Server, const int32 NumClients)
+{
+	const double End = FPlatformTime::Seconds() + ReceiveTimeoutSeconds;
+	while (Server.GetNumClients() != NumClients && FPlatformTime::Seconds() < End)
+	{
+		Server.ReceiveMessages(FPlatformTime::Seconds());
+		FPlatformProcess::Sleep(0.001f);
+	}
+	return Server.GetNumClients() == NumClients;
+}
+}	 // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapTrackingServerRoundTripTest, "UltraleapTracking.TrackingServer.RoundTrip",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapTrackingServerRoundTripTest::RunTest(const FString& Parameters)
+{
+	FLeapTrackingServer Server;
+	FTestClient Client;
+	if (!TestTrue(TEXT("Server started"), Server.Start(TEXT("127.0.0.1"), 0)) ||
+		!TestTrue(TEXT("Client created"), Client.Create(Server.GetPort())))
+	{
+		return false;
+	}
+
+	Client.SendHello(1000);
+	if (!TestTrue(TEXT("Client subscribed"), WaitForClients(Server, 1)))
+	{
+		return false;
+	}
+
+	FLeapFrameData Frame;
+	FLeapSyntheticHands(2).GenerateFrame(1000000, Frame);
+	for (uint32 ExpectedSequence = 1; ExpectedSequence <= 3; ExpectedSequence++)
+	{
+		// Stay clear of the rate limit, leap.Server.MaxRate defaults to 120Hz
+		FPlatformProcess::Sleep(0.01f);
+		Server.PublishFrame(Frame);
+
+		uint8 Buffer[LeapTrackingProtocol::MaxFrameSize];
+		const int32 BytesRead = Client.Receive(Buffer, sizeof(Buffer));
+		uint16 Version = 0;
+		const int32 ExpectedSize = (int32) (LeapTrackingProtocol::FrameHeaderSize + 2 * LeapTrackingProtocol::HandSize);
+		TestEqual(TEXT("Datagram size"), BytesRead, ExpectedSize);
+		TestTrue(TEXT("Frame message"),
+			LeapTrackingProtocol::ReadPreamble(Buffer, BytesRead, Version) == LeapTrackingProtocol::EMessageType::Frame);
+		TestEqual(TEXT("Version"), (int32) Version, (int32) LeapTrackingProtocol::Version);
+
+		LeapTrackingProtocol::FFrameHeader Header;
+		LeapTrackingProtocol::FHand Hands[LeapTrackingProtocol::MaxHands];
+		if (!TestTrue(TEXT("Frame decodes"), LeapTrackingProtocol::ReadFrame(Buffer, BytesRead, Header, Hands)))
+		{
+			return false;
+		}
+		TestEqual(TEXT("Sequence"), (int64) Header.Sequence, (int64) ExpectedSequence);
+		TestEqual(TEXT("Frame id"), Header.FrameId, Frame.FrameId);
+		TestEqual(TEXT("Timestamp"), (int64) Header.TimestampMicros, Frame.TimeStamp);
+		TestEqual(TEXT("Hand count"), (int32) Header.HandCount, 2);
+
+		const LeapTrackingProtocol::FHand& Right = Hands[1];
+		const FLeapHandData& Expected = Frame.Hands[1];
+		TestEqual(TEXT("Hand id"), (int64) Right.Id, (int64) Expected.Id);
+		TestEqual(TEXT("Hand type"), (int32) Right.HandType, (int32) EHandType::LEAP_HAND_RIGHT);
+		TestEqual(TEXT("Grab strength"), Right.GrabStrength, Expected.GrabStrength);
+		TestTrue(TEXT("Index extended"), ((Right.ExtendedFingers & (1 << 1)) != 0) == Expected.Index.IsExtended);
+		TestEqual(TEXT("Palm"), FVector(Right.Joints[2][0], Right.Joints[2][1], Right.Joints[2][2]), Expected.Palm.Position);
+		const float* IndexTip = Right.Joints[3 + 1 * 5 + 4];
+		TestEqual(TEXT("Index tip"), FVector(IndexTip[0], IndexTip[1], IndexTip[2]), Expected.Index.Distal.NextJoint);
+		const FQuat PalmRotation(Right.PalmRotation[0], Right.PalmRotation[1], Right.PalmRotation[2], Right.PalmRotation[3]);
+		TestTrue(TEXT("Palm rotation"), PalmRotation.Equals(Expected.Palm.Orientation.Quaternion(), 1.e-4f));
+	}
+
+	Client.SendGoodbye();
+	TestTrue(TEXT("Client unsubscribed"), WaitForClients(Server, 0));
+	TestEqual(TEXT("Every datagram sent"), Server.GetNumFailedSends(), (int64) 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapTrackingServerPortInUseTest, "UltraleapTracking.TrackingServer.PortInUse",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapTrackingServerPortInUseTest::RunTest(const FString& Parameters)
+{
+	FLeapTrackingServer Server;
+	if (!TestTrue(TEXT("Server started"), Server.Start(TEXT("127.0.0.1"), 0)))
+	{
+		return false;
+	}
+
+	// A second server on the same port fails rather than sharing the first one's datagrams
+	AddExpectedError(TEXT("Tracking server couldn't bind"));
+	FLeapTrackingServer Clash;
+	TestFalse(TEXT("Port in use"), Clash.Start(TEXT("127.0.0.1"), Server.GetPort()));
+	TestFalse(TEXT("Not running"), Clash.IsRunning());
+	TestTrue(TEXT("First server unaffected"), Server.IsRunning());
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapTrackingServerRateLimitTest, "UltraleapTracking.TrackingServer.RateLimit",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapTrackingServerRateLimitTest::RunTest(const FString& Parameters)
+{
+	FLeapTrackingServer Server;
+	FTestClient Slow;
+	FTestClient Fast;
+	if (!TestTrue(TEXT("Server started"), Server.Start(TEXT("127.0.0.1"), 0)) ||
+		!TestTrue(TEXT("Clients created"), Slow.Create(Server.GetPort()) && Fast.Create(Server.GetPort())))
+	{
+		return false;
+	}
+
+	Slow.SendHello(1);
+	Fast.SendHello(1000);
+	if (!TestTrue(TEXT("Clients subscribed"), WaitForClients(Server, 2)))
+	{
+		return false;
+	}
+
+	// Ten frames 10ms apart, the 1Hz client gets the first only, the other one is capped at leap.Server.MaxRate
+	// which is still faster
+	FLeapFrameData Frame;
+	FLeapSyntheticHands(2).GenerateFrame(1000000, Frame);
+	for (int32 Index = 0; Index < 10; Index++)
+	{
+		Server.PublishFrame(Frame);
+		FPlatformProcess::Sleep(0.01f);
+	}
+
+	uint8 Buffer[LeapTrackingProtocol::MaxFrameSize];
+	int32 SlowFrames = 0;
+	while (Slow.Receive(Buffer, sizeof(Buffer), 0.05) > 0)
+	{
+		SlowFrames++;
+	}
+	int32 FastFrames = 0;
+	while (Fast.Receive(Buffer, sizeof(Buffer), 0.05) > 0)
+	{
+		FastFrames++;
+	}
+	TestEqual(TEXT("Frames sent to the 1Hz client"), SlowFrames, 1);
+	TestEqual(TEXT("Frames sent to the fast client"), FastFrames, 10);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeapTrackingServerVersionTest, "UltraleapTracking.TrackingServer.Version",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FLeapTrackingServerVersionTest::RunTest(const FString& Parameters)
+{
+	FLeapTrackingServer Server;
+	FTestClient Client;
+	if (!TestTrue(TEXT("Server started"), Server.Start(TEXT("127.0.0.1"), 0)) ||
+		!TestTrue(TEXT("Client created"), Client.Create(Server.GetPort())))
+	{
+		return false;
+	}
+
+	// An unknown version isn't subscribed, the server answers with its own
+	Client.SendHello(60, LeapTrackingProtocol::Version + 1);
+	const double End = FPlatformTime::Seconds() + ReceiveTimeoutSeconds;
+	uint8 Buffer[LeapTrackingProtocol::MaxFrameSize];
+	int32 BytesRead = 0;
+	while (BytesRead == 0 && FPlatformTime::Seconds() < End)
+	{
+		Server.ReceiveMessages(FPlatformTime::Seconds());
+		BytesRead = Client.Receive(Buffer, sizeof(Buffer), 0.01);
+	}
+
+	uint16 Version = 0;
+	TestTrue(TEXT("Goodbye received"),
+		LeapTrackingProtocol::ReadPreamble(Buffer, BytesRead, Version) == LeapTrackingProtocol::EMessageType::Goodbye);
+	TestEqual(TEXT("Server version"), (int32) Version, (int32) LeapTrackingProtocol::Version);
+	TestEqual(TEXT("Clients"), Server.GetNumClients(), 0);
+	return true;
+}
+
+#endif
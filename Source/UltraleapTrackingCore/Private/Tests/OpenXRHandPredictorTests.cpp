@@ -0,0 +1,80 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "OpenXRHandPredictor.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOpenXRHandPredictorTest, "UltraleapTracking.OpenXRHandPredictor.Extrapolate",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+bool FOpenXRHandPredictorTest::RunTest(const FString& Parameters)
+{
+	FOpenXRHandPredictor Predictor;
+	TArray<FVector> Positions;
+	TArray<FQuat> Rotations;
+	TestEqual(TEXT("No confidence without samples"), Predictor.Predict(0, Positions, Rotations), 0.f);
+
+	// Two keypoints at 90Hz, one moving at 100cm/s along X and the other turning at 2rad/s about Z
+	const int64 SampleInterval = 11111;
+	const FVector LinearVelocity(100.f, 0.f, 0.f);
+	const float AngularSpeed = 2.f;
+	auto Sample = [&](const int64 Time)
+	{
+		const float Seconds = Time / 1000000.f;
+		Positions = {FVector(10.f, 5.f, 0.f) + LinearVelocity * Seconds, FVector(0.f, 0.f, 20.f)};
+		Rotations = {FQuat::Identity, FQuat(FVector::UpVector, AngularSpeed * Seconds)};
+		Predictor.AddSample(Positions, Rotations, Time);
+	};
+	for (int32 Index = 0; Index < 4; Index++)
+	{
+		Sample(Index * SampleInterval);
+	}
+	const int64 LastTime = 3 * SampleInterval;
+	TestTrue(TEXT("Has sample"), Predictor.HasSample());
+	TestEqual(TEXT("Sample time"), Predictor.GetSampleTime(), LastTime);
+
+	// At the sample time the prediction is the sample
+	TArray<FVector> Predicted;
+	TArray<FQuat> PredictedRotations;
+	TestEqual(TEXT("Full confidence at the sample"), Predictor.Predict(LastTime, Predicted, PredictedRotations), 1.f);
+	TestTrue(TEXT("Sample position"), Predicted[0].Equals(Positions[0], 0.001f));
+
+	// 20ms ahead both keypoints keep going, with less confidence
+	const int64 Ahead = LastTime + 20000;
+	const float Confidence = Predictor.Predict(Ahead, Predicted, PredictedRotations);
+	TestTrue(TEXT("Less confident ahead"), Confidence > 0.f && Confidence < 1.f);
+	TestTrue(TEXT("Moved 2cm"), Predicted[0].Equals(Positions[0] + FVector(2.f, 0.f, 0.f), 0.01f));
+	TestTrue(TEXT("Still keypoint stays"), Predicted[1].Equals(Positions[1], 0.001f));
+	TestTrue(TEXT("Turned 0.04rad"),
+		PredictedRotations[1].Equals(FQuat(FVector::UpVector, AngularSpeed * Ahead / 1000000.f), 0.001f));
+	TestTrue(TEXT("Further is less confident"), Predictor.Predict(Ahead + 10000, Predicted, PredictedRotations) < Confidence);
+
+	// The horizon is clamped, as is a single keypoint
+	FVector Position;
+	FQuat Rotation;
+	TestTrue(TEXT("Keypoint predicted"), Predictor.PredictKeypoint(0, LastTime + 1000000, Position, Rotation));
+	const float MaxDistance = LinearVelocity.X * Predictor.MaxHorizon / 1000000.f;
+	TestTrue(TEXT("Clamped horizon"), Position.Equals(Positions[0] + FVector(MaxDistance, 0.f, 0.f), 0.01f));
+	TestFalse(TEXT("Keypoint out of range"), Predictor.PredictKeypoint(2, Ahead, Position, Rotation));
+
+	// The same sample again changes nothing, a reset forgets the motion
+	Predictor.AddSample(Positions, Rotations, LastTime);
+	Predictor.Predict(Ahead, Predicted, PredictedRotations);
+	TestTrue(TEXT("Repeated sample ignored"), Predicted[0].Equals(Positions[0] + FVector(2.f, 0.f, 0.f), 0.01f));
+	Predictor.Reset();
+	TestFalse(TEXT("Reset"), Predictor.HasSample());
+	Predictor.AddSample(Positions, Rotations, LastTime);
+	Predictor.Predict(Ahead, Predicted, PredictedRotations);
+	TestTrue(TEXT("No velocity after a reset"), Predicted[0].Equals(Positions[0], 0.001f));
+	return true;
+}
+
+#endif
@@ -0,0 +1,161 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "UltraleapAnalyticsCommandlet.h"
+
+#include "Async/ParallelFor.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "LeapSessionAnalytics.h"
+#include "LeapUtility.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+#include <atomic>
+
+UUltraleapAnalyticsCommandlet::UUltraleapAnalyticsCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UUltraleapAnalyticsCommandlet::Main(const FString& Params)
+{
+	FString Inputs;
+	FString MetricNames = TEXT("all");
+	FString Format = TEXT("json");
+	FString OutputPath;
+	int32 NumWorkers = FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+	FLeapSessionAnalyticsSettings Settings;
+
+	FParse::Value(*Params, TEXT("Input="), Inputs, false);
+	FParse::Value(*Params, TEXT("Metrics="), MetricNames, false);
+	FParse::Value(*Params, TEXT("Format="), Format);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	FParse::Value(*Params, TEXT("Workers="), NumWorkers);
+	FParse::Value(*Params, TEXT("JitterWindow="), Settings.JitterWindow);
+	FParse::Value(*Params, TEXT("VelocityBin="), Settings.VelocityBinWidth);
+
+	if (!FLeapSessionAnalyticsSettings::ParseMetrics(MetricNames, Settings.Metrics))
+	{
+		UE_LOG(UltraleapTrackingLog, Error, TEXT("UltraleapAnalytics doesn't know -Metrics=%s"), *MetricNames);
+		return 1;
+	}
+	const bool bCsv = Format.Equals(TEXT("csv"), ESearchCase::IgnoreCase);
+	if (!bCsv && !Format.Equals(TEXT("json"), ESearchCase::IgnoreCase))
+	{
+		UE_LOG(UltraleapTrackingLog, Error, TEXT("UltraleapAnalytics needs -Format=json or -Format=csv"));
+		return 1;
+	}
+
+	TArray<FString> InputPaths;
+	Inputs.ParseIntoArray(InputPaths, TEXT("+"));
+	TArray<FString> Paths;
+	for (const FString& InputPath : InputPaths)
+	{
+		if (IFileManager::Get().DirectoryExists(*InputPath))
+		{
+			TArray<FString> Found;
+			IFileManager::Get().FindFilesRecursive(Found, *InputPath, TEXT("*.ulma"), true, false);
+			IFileManager::Get().FindFilesRecursive(Found, *InputPath, TEXT("*.lmt"), true, false, false);
+			Found.Sort();
+			Paths.Append(Found);
+		}
+		else
+		{
+			Paths.Add(InputPath);
+		}
+	}
+	if (Paths.Num() == 0)
+	{
+		UE_LOG(UltraleapTrackingLog, Error, TEXT("UltraleapAnalytics has no sessions, pass -Input=<file or directory>"));
+		return 1;
+	}
+
+	// Sessions differ a lot in length, so workers claim them one at a time rather than in fixed batches
+	NumWorkers = FMath::Clamp(NumWorkers, 1, Paths.Num());
+	TArray<FLeapSessionStats> Sessions;
+	Sessions.SetNum(Paths.Num());
+	TArray<bool> Succeeded;
+	Succeeded.SetNumZeroed(Paths.Num());
+	std::atomic<int32> NextSession{0};
+	const double StartSeconds = FPlatformTime::Seconds();
+
+	ParallelFor(NumWorkers, [&](int32 Worker) {
+		for (int32 Session = NextSession++; Session < Paths.Num(); Session = NextSession++)
+		{
+			Succeeded[Session] = FLeapSessionAnalyzer::AnalyzeFile(Paths[Session], Settings, Sessions[Session]);
+			if (!Succeeded[Session])
+			{
+				UE_LOG(UltraleapTrackingLog, Warning, TEXT("UltraleapAnalytics couldn't read %s"), *Paths[Session]);
+			}
+		}
+	});
+
+	FLeapSessionStats Total;
+	Total.Reset(Settings);
+	TArray<FString> Failed;
+	for (int32 Session = 0; Session < Paths.Num(); Session++)
+	{
+		if (Succeeded[Session])
+		{
+			Total.Accumulate(Sessions[Session]);
+		}
+		else
+		{
+			Failed.Add(Paths[Session]);
+		}
+	}
+	UE_LOG(UltraleapTrackingLog, Display, TEXT("UltraleapAnalytics analyzed %d sessions, %lld frames in %.2fs on %d workers"),
+		Total.NumSessions, Total.NumFrames, FPlatformTime::Seconds() - StartSeconds, NumWorkers);
+
+	FString Report;
+	if (bCsv)
+	{
+		Report = FLeapSessionStats::GetCsvHeader(Settings) + LINE_TERMINATOR;
+		for (int32 Session = 0; Session < Paths.Num(); Session++)
+		{
+			if (Succeeded[Session])
+			{
+				Report += Sessions[Session].ToCsvRow(Settings) + LINE_TERMINATOR;
+			}
+		}
+		Total.Source = TEXT("total");
+		Report += Total.ToCsvRow(Settings) + LINE_TERMINATOR;
+	}
+	else
+	{
+		TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+		TArray<TSharedPtr<FJsonValue>> SessionsJson;
+		for (int32 Session = 0; Session < Paths.Num(); Session++)
+		{
+			if (Succeeded[Session])
+			{
+				SessionsJson.Add(MakeShared<FJsonValueObject>(Sessions[Session].ToJson(Settings)));
+			}
+		}
+		Json->SetArrayField(TEXT("sessions"), SessionsJson);
+		Json->SetObjectField(TEXT("total"), Total.ToJson(Settings));
+		Json->SetStringArrayField(TEXT("failed"), Failed);
+
+		TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Report);
+		FJsonSerializer::Serialize(Json, Writer);
+	}
+
+	UE_LOG(UltraleapTrackingLog, Display, TEXT("UltraleapAnalytics: %s"), *Report);
+	if (!OutputPath.IsEmpty() && !FFileHelper::SaveStringToFile(Report, *OutputPath))
+	{
+		UE_LOG(UltraleapTrackingLog, Error, TEXT("UltraleapAnalytics couldn't write %s"), *OutputPath);
+		return 1;
+	}
+	return Failed.Num() > 0 ? 1 : 0;
+}
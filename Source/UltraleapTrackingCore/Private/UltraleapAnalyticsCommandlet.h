@@ -0,0 +1,41 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "CoreMinimal.h"
+
+#include "UltraleapAnalyticsCommandlet.generated.h"
+
+/**
+ * Computes tracking quality metrics over many recorded sessions, without a device or rendering, and reports them per
+ * session and in total as JSON or CSV. Sessions are analyzed in parallel, each worker takes the next unclaimed one.
+ *
+ * Metrics: jitter (palm position spectrum in octave bands and second difference RMS), pinch (pinch strength
+ * histogram), dropouts (hand visibility, dropout count and length, frame gaps) and velocity (palm speed histogram).
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=UltraleapAnalytics -Input=<path>[+<path>...] [options]
+ *   -Input=<paths>         motion archives (.ulma), LeapC recordings (.lmt) or directories searched for both
+ *   -Metrics=<names>       comma separated metrics (all)
+ *   -Workers=<n>           worker threads (a thread per core)
+ *   -JitterWindow=<n>      frames per jitter spectrum window (64)
+ *   -VelocityBin=<cm/s>    palm speed histogram bin width (10)
+ *   -Format=<json|csv>     report format (json)
+ *   -Output=<file>         also write the report to a file
+ */
+UCLASS()
+class UUltraleapAnalyticsCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UUltraleapAnalyticsCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,195 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#include "UltraleapReplayBenchmarkCommandlet.h"
+
+#include "Dom/JsonObject.h"
+#include "FUltraleapTrackingInputDevice.h"
+#include "HAL/IConsoleManager.h"
+#include "LeapBenchmark.h"
+#include "LeapMallocCounter.h"
+#include "LeapReplayWrapper.h"
+#include "LeapUtility.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+UUltraleapReplayBenchmarkCommandlet::UUltraleapReplayBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UUltraleapReplayBenchmarkCommandlet::Main(const FString& Params)
+{
+	FString RecordingPath;
+	FString MeshPath;
+	FString AnimClassPath;
+	FString OutputPath;
+	int32 NumHands = 2;
+	int32 Seed = 0;
+	int32 NumFrames = 2000;
+	int32 NumWarmupFrames = 120;
+	float Step = 1.f / 90.f;
+
+	FParse::Value(*Params, TEXT("Recording="), RecordingPath);
+	FParse::Value(*Params, TEXT("Mesh="), MeshPath);
+	FParse::Value(*Params, TEXT("AnimClass="), AnimClassPath);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	FParse::Value(*Params, TEXT("Hands="), NumHands);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("Warmup="), NumWarmupFrames);
+	FParse::Value(*Params, TEXT("Step="), Step);
+	const bool bInterpolation = FParse::Param(*Params, TEXT("Interpolation"));
+	const bool bSmoothing = FParse::Param(*Params, TEXT("Smoothing"));
+
+	if (NumFrames <= 0 || Step <= 0.f)
+	{
+		UE_LOG(UltraleapTrackingLog, Error, TEXT("UltraleapReplayBenchmark needs -Frames > 0 and -Step > 0"));
+		return 1;
+	}
+
+	// Evaluate anim on this thread so the Anim stage measures the whole evaluation
+	if (IConsoleVariable* ParallelAnim = IConsoleManager::Get().FindConsoleVariable(TEXT("a.ParallelAnimEvaluation")))
+	{
+		ParallelAnim->Set(0);
+	}
+
+	FLeapMallocCounter& MallocCounter = FLeapMallocCounter::Install();
+
+	TSharedPtr<FLeapReplayWrapper> Replay = MakeShareable(new FLeapReplayWrapper);
+	bool bFromRecording = false;
+	if (!RecordingPath.IsEmpty())
+	{
+		bFromRecording = Replay->LoadRecording(RecordingPath);
+	}
+	if (!bFromRecording)
+	{
+		Replay->UseSyntheticHands(NumHands, Seed);
+	}
+
+	FLeapBenchmarkPipeline Pipeline;
+	if (!Pipeline.Create(Replay, bInterpolation, bSmoothing))
+	{
+		UE_LOG(UltraleapTrackingLog, Error, TEXT("UltraleapReplayBenchmark has no BodyState skeleton"));
+		return 1;
+	}
+	FUltraleapTrackingInputDevice* Device = Pipeline.Device.Get();
+	UBodyStateSkeleton* Skeleton = Pipeline.Skeleton;
+
+	FLeapBenchmarkAnimScene AnimScene;
+	const bool bAnim = !MeshPath.IsEmpty() && !AnimClassPath.IsEmpty() && AnimScene.Create(MeshPath, AnimClassPath);
+
+	FLeapBenchmarkStage WrapperStage(TEXT("Wrapper"));
+	FLeapBenchmarkStage CaptureStage(TEXT("Capture"));
+	FLeapBenchmarkStage ParseStage(TEXT("ParseEvents"));
+	FLeapBenchmarkStage BodyStateStage(TEXT("BodyState"));
+	FLeapBenchmarkStage AnimStage(TEXT("Anim"));
+	FLeapBenchmarkStage TotalStage(TEXT("Total"));
+
+	int32 CapturedFrames = 0;
+
+	for (int32 Frame = 0; Frame < NumWarmupFrames + NumFrames; Frame++)
+	{
+		const bool bMeasure = Frame >= NumWarmupFrames;
+
+		Pipeline.Advance(Step);
+
+		MallocCounter.StartCounting();
+		const uint64 CaptureStart = FPlatformTime::Cycles64();
+		const bool bCaptured = Device->CaptureFrame();
+		const uint64 CaptureCycles = FPlatformTime::Cycles64() - CaptureStart;
+		const uint64 WrapperCycles = FMath::Min<uint64>(Replay->ConsumeCycles(), CaptureCycles);
+		const FLeapMallocCounter::FCounts CaptureCounts = MallocCounter.GetCounts();
+
+		MallocCounter.StartCounting();
+		const uint64 ParseStart = FPlatformTime::Cycles64();
+		if (bCaptured)
+		{
+			Device->ParseEvents();
+		}
+		const uint64 ParseCycles = FPlatformTime::Cycles64() - ParseStart;
+		const FLeapMallocCounter::FCounts ParseCounts = MallocCounter.GetCounts();
+
+		MallocCounter.StartCounting();
+		const uint64 BodyStateStart = FPlatformTime::Cycles64();
+		Device->UpdateInput(Device->GetBodyStateDeviceId(), Skeleton);
+		const uint64 BodyStateCycles = FPlatformTime::Cycles64() - BodyStateStart;
+		const FLeapMallocCounter::FCounts BodyStateCounts = MallocCounter.GetCounts();
+
+		uint64 AnimCycles = 0;
+		FLeapMallocCounter::FCounts AnimCounts;
+		if (bAnim)
+		{
+			MallocCounter.StartCounting();
+			const uint64 AnimStart = FPlatformTime::Cycles64();
+			AnimScene.Evaluate(Step);
+			AnimCycles = FPlatformTime::Cycles64() - AnimStart;
+			AnimCounts = MallocCounter.GetCounts();
+		}
+		MallocCounter.StopCounting();
+
+		if (!bMeasure)
+		{
+			continue;
+		}
+		CapturedFrames += bCaptured ? 1 : 0;
+
+		// Wrapper allocations can't be told apart from the capture that calls it, they are counted under Capture
+		WrapperStage.Add(WrapperCycles, FLeapMallocCounter::FCounts());
+		CaptureStage.Add(CaptureCycles - WrapperCycles, CaptureCounts);
+		ParseStage.Add(ParseCycles, ParseCounts);
+		BodyStateStage.Add(BodyStateCycles, BodyStateCounts);
+		if (bAnim)
+		{
+			AnimStage.Add(AnimCycles, AnimCounts);
+		}
+
+		FLeapMallocCounter::FCounts TotalCounts;
+		TotalCounts.Allocations = CaptureCounts.Allocations + ParseCounts.Allocations + BodyStateCounts.Allocations + AnimCounts.Allocations;
+		TotalCounts.Bytes = CaptureCounts.Bytes + ParseCounts.Bytes + BodyStateCounts.Bytes + AnimCounts.Bytes;
+		TotalStage.Add(CaptureCycles + ParseCycles + BodyStateCycles + AnimCycles, TotalCounts);
+	}
+
+	AnimScene.Destroy();
+	Pipeline.Destroy();
+
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetStringField(TEXT("source"), bFromRecording ? RecordingPath : TEXT("synthetic"));
+	Report->SetNumberField(TEXT("frames"), NumFrames);
+	Report->SetNumberField(TEXT("captured_frames"), CapturedFrames);
+	Report->SetNumberField(TEXT("warmup_frames"), NumWarmupFrames);
+	Report->SetNumberField(TEXT("step_s"), Step);
+	Report->SetBoolField(TEXT("interpolation"), bInterpolation);
+	Report->SetBoolField(TEXT("smoothing"), bSmoothing);
+
+	TSharedRef<FJsonObject> Stages = MakeShared<FJsonObject>();
+	for (const FLeapBenchmarkStage* Stage : {&WrapperStage, &CaptureStage, &ParseStage, &BodyStateStage, &AnimStage, &TotalStage})
+	{
+		if (Stage->Micros.Num() > 0)
+		{
+			Stages->SetObjectField(Stage->Name, Stage->ToJson());
+		}
+	}
+	Report->SetObjectField(TEXT("stages"), Stages);
+
+	FString Json;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Report, Writer);
+
+	UE_LOG(UltraleapTrackingLog, Display, TEXT("UltraleapReplayBenchmark: %s"), *Json);
+	if (!OutputPath.IsEmpty() && !FFileHelper::SaveStringToFile(Json, *OutputPath))
+	{
+		UE_LOG(UltraleapTrackingLog, Error, TEXT("UltraleapReplayBenchmark couldn't write %s"), *OutputPath);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,44 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "CoreMinimal.h"
+
+#include "UltraleapReplayBenchmarkCommandlet.generated.h"
+
+/**
+ * Runs the tracking pipeline headless at a fixed step and reports per stage timings as JSON.
+ *
+ * Stages: Wrapper (frame source), Capture (frame conversion, smoothing), ParseEvents, BodyState and,
+ * if a mesh and anim class are given, Anim (anim instance update and bone evaluation).
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=UltraleapReplayBenchmark [options]
+ *   -Recording=<file>      LeapC recording to replay, synthetic hands otherwise
+ *   -Hands=<n>             synthetic hand count (2)
+ *   -Seed=<n>              synthetic hand seed (0)
+ *   -Frames=<n>            measured frames (2000)
+ *   -Warmup=<n>            unmeasured frames first (120)
+ *   -Step=<seconds>        fixed step (1/90)
+ *   -Interpolation         enable frame interpolation
+ *   -Smoothing             enable joint and rotation smoothing
+ *   -Mesh=<path>           skeletal mesh for the Anim stage
+ *   -AnimClass=<path>      anim blueprint generated class for the Anim stage
+ *   -Output=<file>         also write the JSON report to a file
+ */
+UCLASS()
+class UUltraleapReplayBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UUltraleapReplayBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
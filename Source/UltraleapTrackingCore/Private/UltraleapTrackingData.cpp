@@ -42,24 +42,14 @@ void FLeapFrameData::SetFromLeapFrame(struct _LEAP_TRACKING_EVENT* frame)
 
 	TimeStamp = frame->info.timestamp;
 
-	// Copy hand data
-	if (Hands.Num() != NumberOfHandsVisible)	// always clear the hand data if number of hands changed
-	{
-		Hands.Empty();
-	}
+	// Copy hand data, resizing without shrinking keeps the digit and bone arrays of hands that stay allocated
+	Hands.SetNum(NumberOfHandsVisible, false);
 
 	LeftHandVisible = false;
 	RightHandVisible = false;
 
 	for (int i = 0; i < NumberOfHandsVisible; i++)
 	{
-		// Expand as necessary to fit
-		if (Hands.Num() <= i)
-		{
-			FLeapHandData HandData;
-			Hands.Add(HandData);
-		}
-
 		const LEAP_HAND& LeapHand = frame->pHands[i];
 		Hands[i].SetFromLeapHand((_LEAP_HAND*) &LeapHand);
 
@@ -343,6 +333,7 @@ FLeapOptions::FLeapOptions()
 	LeapServiceLogLevel = LEAP_LOG_INFO;	// most verbose by default
 	bUseTimeWarp = true;
 	bUseInterpolation = true;
+	bUseOpenXRPrediction = false;
 	bTransformOriginToHMD = true;
 	TimewarpOffset = 5500;
 	TimewarpFactor = 1.f;
@@ -358,11 +349,152 @@ FLeapOptions::FLeapOptions()
 	EndPinchThreshold = .5f;
 	GrabTimeout = 100000;
 	PinchTimeout = 100000;
+	bUseJointSmoothing = false;
+	JointSmoothingMinCutoff = 1.5f;
+	JointSmoothingCutoffSlope = 0.05f;
+	JointSmoothingDeltaCutoff = 1.f;
+	bUseRotationSmoothing = false;
+	RotationSmoothingMinCutoff = 1.5f;
+	RotationSmoothingCutoffSlope = 0.5f;
+	bUseFixedRateProcessing = false;
 	bUseOpenXRAsSource = false;
+	bUseOpenXRDirectBodyState = false;
 	// bEnableImageStreaming = false;		//default image streaming to off
 }
 
-FLeapStats::FLeapStats() : FrameExtrapolationInMS(0)
+FLeapServiceConnectionStats::FLeapServiceConnectionStats()
+	: bIsConnected(false), Connections(0), ConnectionsLost(0), ReconnectAttempts(0), ReconnectBackoffSeconds(0), SecondsInState(0)
+{
+}
+
+FLeapJointQueryResult::FLeapJointQueryResult()
+	: Hand(EHandType::LEAP_HAND_LEFT), Digit(0), Joint(0), Position(FVector::ZeroVector), Distance(0)
+{
+}
+
+FLeapGestureTemplate::FLeapGestureTemplate() : Name(NAME_None), Duration(0), Extent(0), Threshold(0)
+{
+}
+
+FLeapStartupStats::FLeapStartupStats()
+	: ConnectedMS(0), DeviceFoundMS(0), FirstFrameMS(0), FirstHandMS(0), bUsedCachedDevice(false), MapLoadToHandMS(0)
+{
+}
+
+FLeapStats::FLeapStats() : FrameExtrapolationInMS(0), bIsTrackingPaused(false), TrackingConsumers(0)
+{
+}
+
+FLeapLatencyPercentiles::FLeapLatencyPercentiles() : SampleCount(0), MeanMS(0), P50MS(0), P90MS(0), P99MS(0), MaxMS(0)
+{
+}
+
+FLeapConfigValue::FLeapConfigValue()
+	: Type(ELeapConfigValueType::LEAP_CONFIG_UNKNOWN), BoolValue(false), IntValue(0), FloatValue(0)
+{
+}
+
+FLeapConfigValue FLeapConfigValue::MakeBool(bool Value)
+{
+	FLeapConfigValue ConfigValue;
+	ConfigValue.Type = ELeapConfigValueType::LEAP_CONFIG_BOOL;
+	ConfigValue.BoolValue = Value;
+	return ConfigValue;
+}
+
+FLeapConfigValue FLeapConfigValue::MakeInt(int32 Value)
+{
+	FLeapConfigValue ConfigValue;
+	ConfigValue.Type = ELeapConfigValueType::LEAP_CONFIG_INT;
+	ConfigValue.IntValue = Value;
+	return ConfigValue;
+}
+
+FLeapConfigValue FLeapConfigValue::MakeFloat(float Value)
+{
+	FLeapConfigValue ConfigValue;
+	ConfigValue.Type = ELeapConfigValueType::LEAP_CONFIG_FLOAT;
+	ConfigValue.FloatValue = Value;
+	return ConfigValue;
+}
+
+FLeapConfigValue FLeapConfigValue::MakeString(const FString& Value)
+{
+	FLeapConfigValue ConfigValue;
+	ConfigValue.Type = ELeapConfigValueType::LEAP_CONFIG_STRING;
+	ConfigValue.StringValue = Value;
+	return ConfigValue;
+}
+
+void FLeapConfigValue::SetFromLeapVariant(const struct _LEAP_VARIANT* Variant)
+{
+	*this = FLeapConfigValue();
+	switch (Variant->type)
+	{
+		case eLeapValueType_Boolean:
+			Type = ELeapConfigValueType::LEAP_CONFIG_BOOL;
+			BoolValue = Variant->boolValue;
+			break;
+		case eLeapValueType_Int32:
+			Type = ELeapConfigValueType::LEAP_CONFIG_INT;
+			IntValue = Variant->iValue;
+			break;
+		case eLeapValueType_Float:
+			Type = ELeapConfigValueType::LEAP_CONFIG_FLOAT;
+			FloatValue = Variant->fValue;
+			break;
+		case eLeapValueType_String:
+			Type = ELeapConfigValueType::LEAP_CONFIG_STRING;
+			StringValue = Variant->strValue ? UTF8_TO_TCHAR(Variant->strValue) : TEXT("");
+			break;
+		default:
+			break;
+	}
+}
+
+bool FLeapConfigValue::operator==(const FLeapConfigValue& Other) const
+{
+	if (Type != Other.Type)
+	{
+		return false;
+	}
+	switch (Type)
+	{
+		case ELeapConfigValueType::LEAP_CONFIG_BOOL:
+			return BoolValue == Other.BoolValue;
+		case ELeapConfigValueType::LEAP_CONFIG_INT:
+			return IntValue == Other.IntValue;
+		case ELeapConfigValueType::LEAP_CONFIG_FLOAT:
+			return FloatValue == Other.FloatValue;
+		case ELeapConfigValueType::LEAP_CONFIG_STRING:
+			return StringValue == Other.StringValue;
+		default:
+			return true;
+	}
+}
+
+FString FLeapConfigValue::ToString() const
+{
+	switch (Type)
+	{
+		case ELeapConfigValueType::LEAP_CONFIG_BOOL:
+			return BoolValue ? TEXT("true") : TEXT("false");
+		case ELeapConfigValueType::LEAP_CONFIG_INT:
+			return FString::FromInt(IntValue);
+		case ELeapConfigValueType::LEAP_CONFIG_FLOAT:
+			return FString::SanitizeFloat(FloatValue);
+		case ELeapConfigValueType::LEAP_CONFIG_STRING:
+			return StringValue;
+		default:
+			return TEXT("<unknown>");
+	}
+}
+
+FLeapConfigResult::FLeapConfigResult() : bSuccess(false)
+{
+}
+
+FLeapConfigResult::FLeapConfigResult(const FString& InKey) : bSuccess(false), Key(InKey)
 {
 }
 
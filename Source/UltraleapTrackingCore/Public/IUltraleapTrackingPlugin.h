@@ -8,7 +8,9 @@
 
 #pragma once
 
+#include "Async/Future.h"
 #include "IInputDeviceModule.h"
+#include "LeapJointCache.h"
 #include "UltraleapTrackingData.h"
 
 class ULeapComponent;
@@ -49,11 +51,25 @@ public:
 	/** Remove an event delegate from the leap input device loop*/
 	virtual void RemoveEventDelegate(const ULeapComponent* EventDelegate){};
 
+	/**
+	 * Keep hand tracking running for a consumer the plugin can't see, e.g. code reading the BodyState skeleton directly.
+	 * With leap.Pause.Auto set, tracking otherwise pauses while no component, hand mesh, LiveLink client or subscriber
+	 * consumes hands. Every Add needs a matching Remove.
+	 */
+	virtual void AddTrackingConsumer(){};
+	virtual void RemoveTrackingConsumer(){};
+
 	virtual FLeapStats GetLeapStats()
 	{
 		return FLeapStats();
 	};
 
+	/** Rolling percentiles of the hand data age at a pipeline stage */
+	virtual FLeapLatencyPercentiles GetLatencyPercentiles(ELeapLatencyStage Stage)
+	{
+		return FLeapLatencyPercentiles();
+	};
+
 	/** Set Leap Options such as time warp, interpolation and tracking modes */
 	virtual void SetOptions(const FLeapOptions& InOptions){};
 
@@ -69,9 +85,38 @@ public:
 	/** Polling method for latest frame data*/
 	virtual void GetLatestFrameData(FLeapFrameData& OutData) = 0;
 
+	/** The latest frame flattened per hand, for reading single joints without copying the frame. Game thread only */
+	virtual const FLeapJointCache& GetJointCache()
+	{
+		static const FLeapJointCache Empty;
+		return Empty;
+	}
+
 	/** Set a Leap Policy, such as image streaming or optimization type*/
 	virtual void SetLeapPolicy(ELeapPolicyFlag Flag, bool Enable) = 0;
 
+	/**
+	 * Read a tracking service setting without blocking. The future completes on the service thread once the service
+	 * answers, hop to the game thread before touching UObjects. Fails after leap.Config.Timeout seconds, or at once
+	 * without a service connection
+	 */
+	virtual TFuture<FLeapConfigResult> RequestConfigValue(const FString& Key)
+	{
+		return MakeFailedConfigResult(Key);
+	}
+
+	/** Write a tracking service setting without blocking, the future completes once the service has applied it */
+	virtual TFuture<FLeapConfigResult> SaveConfigValue(const FString& Key, const FLeapConfigValue& Value)
+	{
+		return MakeFailedConfigResult(Key);
+	}
+
+	/** Last value read or successfully written through the plugin, for settings UIs that must not wait */
+	virtual bool GetCachedConfigValue(const FString& Key, FLeapConfigValue& OutValue)
+	{
+		return false;
+	}
+
 	/** List the attached (plugged in) devices */
 	virtual void GetAttachedDevices(TArray<FString>& Devices) = 0;
 
@@ -80,4 +125,12 @@ public:
 
 	virtual void SetSwizzles(
 		ELeapQuatSwizzleAxisB ToX, ELeapQuatSwizzleAxisB ToY, ELeapQuatSwizzleAxisB ToZ, ELeapQuatSwizzleAxisB ToW) = 0;
+
+	/** A config request future that has already failed, for sources without a service to ask */
+	static TFuture<FLeapConfigResult> MakeFailedConfigResult(const FString& Key)
+	{
+		TPromise<FLeapConfigResult> Promise;
+		Promise.SetValue(FLeapConfigResult(Key));
+		return Promise.GetFuture();
+	}
 };
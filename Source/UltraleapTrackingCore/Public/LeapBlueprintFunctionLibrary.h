@@ -13,6 +13,8 @@
 
 #include "LeapBlueprintFunctionLibrary.generated.h"
 
+class USceneComponent;
+
 /**
  * Useful global blueprint functions for Ultraleap Tracking
  */
@@ -37,10 +39,91 @@ class ULeapBlueprintFunctionLibrary : public UBlueprintFunctionLibrary
 	UFUNCTION(BlueprintCallable, Category = "Ultraleap Tracking Functions")
 	static void GetLeapStats(FLeapStats& OutStats);
 
+	/** Gets rolling percentiles of how old the hand data is at a pipeline stage, needs leap.Latency.Enable */
+	UFUNCTION(BlueprintCallable, Category = "Ultraleap Tracking Functions")
+	static void GetLatencyPercentiles(ELeapLatencyStage Stage, FLeapLatencyPercentiles& OutPercentiles);
+
+	/**
+	 * One joint of the latest frame, false if the hand isn't tracked. Digits run from the thumb (0) to the pinky (4),
+	 * joints from the metacarpal's base (0) to the fingertip (4). Reads a per frame cache instead of copying the frame
+	 */
+	UFUNCTION(BlueprintPure, Category = "Ultraleap Tracking Functions")
+	static bool GetLeapJoint(EHandType Hand, int32 Digit, int32 Joint, FVector& Position, FRotator& Rotation);
+
+	/** Fingertip of a digit from the thumb (0) to the pinky (4) in the latest frame, false if the hand isn't tracked */
+	UFUNCTION(BlueprintPure, Category = "Ultraleap Tracking Functions")
+	static bool GetLeapFingertip(EHandType Hand, int32 Digit, FVector& Position);
+
+	/** Palm of the latest frame, false if the hand isn't tracked */
+	UFUNCTION(BlueprintPure, Category = "Ultraleap Tracking Functions")
+	static bool GetLeapPalm(EHandType Hand, FVector& Position, FVector& Normal, FVector& Direction, FRotator& Orientation);
+
+	/** Pinch and grab of the latest frame, false if the hand isn't tracked */
+	UFUNCTION(BlueprintPure, Category = "Ultraleap Tracking Functions")
+	static bool GetLeapPinch(EHandType Hand, float& PinchStrength, float& PinchDistance, float& GrabStrength);
+
+	/**
+	 * The hands' space as a world transform. Hand locations, and the locations the queries below take and return, are
+	 * relative to the component the hands are attached to, e.g. the pawn's VR origin: pass it as Tracking Origin.
+	 * Without one it's the XR system's tracking space, or the world without an XR system
+	 */
+	UFUNCTION(BlueprintPure, Category = "Ultraleap Tracking Functions")
+	static FTransform GetLeapTrackingToWorldTransform(const USceneComponent* TrackingOrigin);
+
+	/** A world location, e.g. an actor's, in the hands' space, see Get Leap Tracking To World Transform */
+	UFUNCTION(BlueprintPure, Category = "Ultraleap Tracking Functions")
+	static FVector ConvertWorldLocationToLeapSpace(const USceneComponent* TrackingOrigin, const FVector& WorldLocation);
+
+	/** A location in the hands' space, e.g. a query result's, in the world, see Get Leap Tracking To World Transform */
+	UFUNCTION(BlueprintPure, Category = "Ultraleap Tracking Functions")
+	static FVector ConvertLeapLocationToWorld(const USceneComponent* TrackingOrigin, const FVector& LeapLocation);
+
+	/** Joint of either hand of the latest frame nearest to Point in the hands' space, fingertips only if Fingertips Only */
+	UFUNCTION(BlueprintPure, Category = "Ultraleap Tracking Functions")
+	static bool FindNearestLeapJoint(const FVector& Point, bool bFingertipsOnly, FLeapJointQueryResult& Result);
+
+	/** Hand of the latest frame nearest to Point in the hands' space */
+	UFUNCTION(BlueprintPure, Category = "Ultraleap Tracking Functions")
+	static bool FindNearestLeapHand(const FVector& Point, TEnumAsByte<EHandType>& Hand, float& Distance);
+
+	/** Hand nearest to a world location, e.g. an actor's, with Distance in world units. See Find Nearest Leap Hand */
+	UFUNCTION(BlueprintPure, Category = "Ultraleap Tracking Functions")
+	static bool FindNearestLeapHandToWorldLocation(
+		const USceneComponent* TrackingOrigin, const FVector& WorldLocation, TEnumAsByte<EHandType>& Hand, float& Distance);
+
+	/** Joints inside a box of half size Extent placed by Box Transform in the hands' space, returns how many */
+	UFUNCTION(BlueprintCallable, Category = "Ultraleap Tracking Functions")
+	static int32 FindLeapJointsInBox(
+		const FTransform& BoxTransform, const FVector& Extent, TArray<FLeapJointQueryResult>& Results);
+
+	/** Joints within Radius of Center in the hands' space, returns how many */
+	UFUNCTION(BlueprintCallable, Category = "Ultraleap Tracking Functions")
+	static int32 FindLeapJointsInSphere(const FVector& Center, float Radius, TArray<FLeapJointQueryResult>& Results);
+
+	/** Whether any joint of the hand is inside a box of half size Extent placed by Box Transform in the hands' space */
+	UFUNCTION(BlueprintPure, Category = "Ultraleap Tracking Functions")
+	static bool IsLeapHandInBox(EHandType Hand, const FTransform& BoxTransform, const FVector& Extent);
+
+	/** Joint of the hand nearest to the segment from Start to End in the hands' space, false if the hand isn't tracked */
+	UFUNCTION(BlueprintPure, Category = "Ultraleap Tracking Functions")
+	static bool GetLeapHandDistanceToSegment(
+		EHandType Hand, const FVector& Start, const FVector& End, FLeapJointQueryResult& Result);
+
+	/** Distance between two fingertips of the latest frame, of the same hand or not. Digits from the thumb (0) to the pinky (4) */
+	UFUNCTION(BlueprintPure, Category = "Ultraleap Tracking Functions")
+	static bool GetLeapFingertipDistance(EHandType HandA, int32 DigitA, EHandType HandB, int32 DigitB, float& Distance);
+
 	/** Change leap policy */
 	UFUNCTION(BlueprintCallable, Category = "Ultraleap Tracking Functions")
 	static void SetLeapPolicy(ELeapPolicyFlag Flag, bool Enable);
 
+	/**
+	 * Last value of a tracking service setting read or written through the plugin, without waiting on the service. Use
+	 * the Request Leap Config Value node to refresh it
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Ultraleap Tracking Functions")
+	static bool GetCachedLeapConfigValue(const FString& Key, FLeapConfigValue& OutValue);
+
 	/** List the attached (plugged in) devices */
 	UFUNCTION(BlueprintCallable, Category = "Leap Motion Functions")
 	static void GetAttachedLeapDevices(TArray<FString>& Devices);
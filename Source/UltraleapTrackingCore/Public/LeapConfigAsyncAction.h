@@ -0,0 +1,55 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "UltraleapTrackingData.h"
+
+#include "LeapConfigAsyncAction.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FLeapConfigResultSignature, const FLeapConfigResult&, Result);
+
+/**
+ * Latent Blueprint nodes reading and writing tracking service settings. The game thread never waits on the service,
+ * the node's output pins fire from the game thread's task queue once the service answers or leap.Config.Timeout expires.
+ */
+UCLASS()
+class ULTRALEAPTRACKING_API ULeapConfigAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	/** Fires with the value read, or with the value written once the service has applied it */
+	UPROPERTY(BlueprintAssignable)
+	FLeapConfigResultSignature OnSuccess;
+
+	/** Fires if the service refused the request, has no such setting, didn't answer or isn't connected */
+	UPROPERTY(BlueprintAssignable)
+	FLeapConfigResultSignature OnFailure;
+
+	/** Read a tracking service setting */
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"),
+		Category = "Ultraleap Tracking Functions")
+	static ULeapConfigAsyncAction* RequestLeapConfigValue(UObject* WorldContextObject, const FString& Key);
+
+	/** Write a tracking service setting, the value's type must be set */
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"),
+		Category = "Ultraleap Tracking Functions")
+	static ULeapConfigAsyncAction* SaveLeapConfigValue(
+		UObject* WorldContextObject, const FString& Key, const FLeapConfigValue& Value);
+
+	virtual void Activate() override;
+
+private:
+	void HandleResult(const FLeapConfigResult& Result);
+
+	FString Key;
+	FLeapConfigValue Value;
+	bool bIsSave;
+};
@@ -0,0 +1,191 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeapJointCache.h"
+#include "UltraleapTrackingData.h"
+
+struct FLeapGestureRecognizerSettings
+{
+	/** Time steps a template and a window are resampled to */
+	int32 NumSamples = 32;
+	/** Furthest a warping path may stray from the diagonal, as a fraction of NumSamples */
+	float WarpingBand = 0.1f;
+	/** RMS distance per time step of normalized samples below which a gesture matches, see FLeapGestureTemplate::Threshold */
+	float Threshold = 0.35f;
+	/** Template and window comparisons per frame, each costs at most one banded DTW of NumSamples */
+	int32 MaxEvaluationsPerFrame = 24;
+	/** A match is reported once nothing better has turned up for this long, so at its best fitting window */
+	float SettleSeconds = 0.1f;
+	/** After a match the hand's history is cleared and it isn't searched for this long */
+	float CooldownSeconds = 0.5f;
+	/** Weight of the fingertips, relative to the palm, against the palm's trajectory */
+	float FingertipWeight = 0.25f;
+	/** A window is compared if its palm moved between 1 / ExtentTolerance and ExtentTolerance times the template's */
+	float ExtentTolerance = 2.f;
+};
+
+struct FLeapGestureMatch
+{
+	FName Name;
+	EHandType Hand = EHandType::LEAP_HAND_LEFT;
+	/** 1 for a perfect match, falling to 0 at the template's threshold */
+	float Confidence = 0.f;
+	/** RMS distance per time step */
+	float Distance = 0.f;
+};
+
+/** Where the comparisons went, each is counted once at the stage that settled it */
+struct FLeapGestureSearchStats
+{
+	int64 Evaluations = 0;
+	/** Palm movement too small or large for the template */
+	int64 PrunedByExtent = 0;
+	/** First and last time steps alone are too far apart */
+	int64 PrunedByKim = 0;
+	/** Window outside the template's warping envelope */
+	int64 PrunedByKeogh = 0;
+	/** DTW stopped as soon as no path could beat the threshold or a better match */
+	int64 AbandonedDtw = 0;
+	int64 CompletedDtw = 0;
+};
+
+/**
+ * Recognizes motion gestures such as swipes, circles and taps by comparing the recent trajectory of each hand's palm
+ * and fingertips with recorded templates.
+ *
+ * Each frame appends the hands to a short history. A comparison takes the window of history as long as a template
+ * (and 0.8 and 1.25 times as long, for slower and faster performances), resamples it to NumSamples time steps and
+ * normalizes it: the palm relative to its mean and scaled by its RMS spread, the fingertips relative to the palm. Windows
+ * are compared with dynamic time warping in a Sakoe-Chiba band, behind a cascade of cheaper checks that rule most of
+ * them out first: the palm's extent, LB_Kim on the first and last steps and LB_Keogh against the template's envelope.
+ * The DTW itself is abandoned once its partial cost plus the remaining LB_Keogh bound exceeds the threshold or the best
+ * match found for the hand so far.
+ *
+ * Comparisons are spread over frames round robin, at most MaxEvaluationsPerFrame per frame, so the cost per frame is
+ * fixed however many templates there are. A hand's best match is reported once it has stopped improving.
+ */
+class ULTRALEAPTRACKING_API FLeapGestureRecognizer
+{
+public:
+	/** Palm then thumb to pinky tips */
+	static constexpr int32 NumPoints = 1 + FLeapJointCache::NumDigits;
+
+	struct FSample
+	{
+		double Time = 0.0;
+		FVector Points[NumPoints];
+	};
+
+	FLeapGestureRecognizer();
+	explicit FLeapGestureRecognizer(const FLeapGestureRecognizerSettings& InSettings);
+
+	/** Resets the history, the templates are kept */
+	void SetSettings(const FLeapGestureRecognizerSettings& InSettings);
+
+	const FLeapGestureRecognizerSettings& GetSettings() const
+	{
+		return Settings;
+	}
+
+	/** Make a template from a recorded hand, false if it's too short or barely moves */
+	bool MakeTemplate(FName Name, const TArray<FSample>& Recorded, FLeapGestureTemplate& OutTemplate) const;
+
+	/** False if the template has no samples, templates made with a different NumSamples are resampled */
+	bool AddTemplate(const FLeapGestureTemplate& Template);
+	void ClearTemplates();
+
+	int32 GetNumTemplates() const
+	{
+		return Templates.Num();
+	}
+
+	/** Add the hands of a frame and append the gestures they complete to OutMatches. Time in seconds */
+	void AddFrame(const FLeapJointCache& Joints, double Time, TArray<FLeapGestureMatch>& OutMatches);
+
+	/** Same as AddFrame, with one hand at a time. Call EndFrame once both hands of the frame have been added */
+	void AddHand(EHandType Hand, bool bVisible, const FSample& Sample);
+	void EndFrame(double Time, TArray<FLeapGestureMatch>& OutMatches);
+
+	/** Forget the hands' histories */
+	void Reset();
+
+	const FLeapGestureSearchStats& GetStats() const
+	{
+		return Stats;
+	}
+
+	static void GetSample(const FLeapJointCache::FHand& Hand, double Time, FSample& OutSample);
+
+private:
+	static constexpr int32 NumHands = 2;
+	static constexpr int32 NumScales = 3;
+	static constexpr int32 HistoryCapacity = 512;
+	static constexpr int32 NumFeatures = NumPoints * 3;
+
+	struct FTemplate
+	{
+		/** As added, to rebuild the rest from when the settings change */
+		FLeapGestureTemplate Source;
+		float Threshold;
+		TArray<float> Features;
+		TArray<float> Upper;
+		TArray<float> Lower;
+	};
+
+	struct FHandHistory
+	{
+		/** Ring of samples, oldest at Head */
+		FSample Samples[HistoryCapacity];
+		int32 Head = 0;
+		int32 Num = 0;
+		double CooldownEnd = -1.0;
+
+		/** Best match not reported yet */
+		int32 PendingTemplate = INDEX_NONE;
+		float PendingConfidence = 0.f;
+		float PendingDistance = 0.f;
+		double PendingTime = 0.0;
+
+		const FSample& At(const int32 Index) const
+		{
+			return Samples[(Head + Index) % HistoryCapacity];
+		}
+	};
+
+	/** Resample the window from End - Duration to End, false if the history doesn't reach back that far */
+	bool ResampleWindow(const FHandHistory& History, double Duration, TArray<FVector>& OutPoints) const;
+
+	/** Normalize resampled points into features, returns the palm's RMS spread */
+	float Normalize(const TArray<FVector>& Points, TArray<float>& OutFeatures) const;
+
+	/** Compare the resampled window with a template, the summed squared cost or MaxCost if it doesn't beat MaxCost */
+	float Evaluate(const FTemplate& Template, float MaxCost);
+
+	float Dtw(const TArray<float>& Window, const FTemplate& Template, float MaxCost);
+
+	FLeapGestureRecognizerSettings Settings;
+	int32 BandWidth;
+	TArray<FTemplate> Templates;
+	TUniquePtr<FHandHistory> Histories[NumHands];
+	bool bVisible[NumHands];
+
+	/** Next candidate, hand major then template then scale */
+	int32 Cursor;
+
+	FLeapGestureSearchStats Stats;
+
+	// Per comparison scratch
+	TArray<FVector> WindowPoints;
+	TArray<float> Query;
+	TArray<float> CumulativeBound;
+	TArray<float> PreviousRow;
+	TArray<float> CurrentRow;
+};
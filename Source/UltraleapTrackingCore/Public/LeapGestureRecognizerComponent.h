@@ -0,0 +1,98 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "LeapGestureRecognizer.h"
+#include "UltraleapTrackingData.h"
+
+#include "LeapGestureRecognizerComponent.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(
+	FLeapGestureSignature, FName, Gesture, TEnumAsByte<EHandType>, Hand, float, Confidence);
+
+/**
+ * Recognizes motion gestures such as swipes, circles and taps from recorded templates, see FLeapGestureRecognizer.
+ *
+ * Record a template by calling StartRecordingGesture, performing the gesture and calling StopRecordingGesture, then
+ * save the returned template in Templates. Every tick the latest hands are compared with the templates within a fixed
+ * budget of comparisons, and OnGestureRecognized fires once per performed gesture.
+ */
+UCLASS(ClassGroup = "Input Controller", meta = (BlueprintSpawnableComponent))
+class ULTRALEAPTRACKING_API ULeapGestureRecognizerComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	ULeapGestureRecognizerComponent();
+
+	/** Event called when a hand completes a gesture, Confidence falls from 1 for a perfect match to 0 at the threshold */
+	UPROPERTY(BlueprintAssignable, Category = "Leap Events")
+	FLeapGestureSignature OnGestureRecognized;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Leap Gestures")
+	TArray<FLeapGestureTemplate> Templates;
+
+	/** Distance between a performance and a template below which it matches, for templates without their own */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Leap Gestures", meta = (ClampMin = "0.01"))
+	float Threshold;
+
+	/** Template comparisons per tick, more templates are spread over more ticks rather than costing more per tick */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Leap Gestures", meta = (ClampMin = "1"))
+	int32 MaxComparisonsPerTick;
+
+	/** After a gesture is recognized the hand isn't searched for this long, in seconds */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Leap Gestures", meta = (ClampMin = "0"))
+	float CooldownSeconds;
+
+	/** How much the fingertips' pose counts against the palm's path, 0 for the palm only */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Leap Gestures", meta = (ClampMin = "0"))
+	float FingertipWeight;
+
+	/** Add a template to Templates and start recognizing it */
+	UFUNCTION(BlueprintCallable, Category = "Leap Gestures")
+	bool AddGestureTemplate(const FLeapGestureTemplate& Template);
+
+	UFUNCTION(BlueprintCallable, Category = "Leap Gestures")
+	void ClearGestureTemplates();
+
+	/** Start recording a hand as a new template, recording stops by itself after 2.5 seconds */
+	UFUNCTION(BlueprintCallable, Category = "Leap Gestures")
+	void StartRecordingGesture(FName Name, EHandType Hand);
+
+	/**
+	 * Stop recording and make the template, false if the hand wasn't tracked throughout or barely moved. The template
+	 * isn't added, see AddGestureTemplate
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Leap Gestures")
+	bool StopRecordingGesture(FLeapGestureTemplate& Template);
+
+	UFUNCTION(BlueprintPure, Category = "Leap Gestures")
+	bool IsRecordingGesture() const
+	{
+		return bRecording;
+	}
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	FLeapGestureRecognizerSettings GetSettings() const;
+
+	FLeapGestureRecognizer Recognizer;
+	TArray<FLeapGestureMatch> Matches;
+
+	bool bRecording;
+	bool bRecordingLost;
+	FName RecordingName;
+	TEnumAsByte<EHandType> RecordingHand;
+	TArray<FLeapGestureRecognizer::FSample> Recording;
+};
@@ -0,0 +1,55 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeapJointCache.h"
+#include "UltraleapTrackingData.h"
+
+/**
+ * Spatial questions about the hands, answered from the per frame joint cache rather than by copying and walking a frame.
+ * Only visible hands take part. Positions are in the same space as the frame data, IUltraleapTrackingPlugin::GetJointCache()
+ * gives the latest frame's joints.
+ */
+class ULTRALEAPTRACKING_API FLeapHandQueries
+{
+public:
+	/** Joint of either hand nearest to Point, fingertips only if bFingertipsOnly. False if no hand is visible */
+	static bool FindNearestJoint(
+		const FLeapJointCache& Joints, const FVector& Point, bool bFingertipsOnly, FLeapJointQueryResult& OutResult);
+
+	/**
+	 * Add the joints inside a box to OutResults and return how many were added. The box has half size Extent and is placed
+	 * and oriented by BoxTransform, whose scale is ignored
+	 */
+	static int32 FindJointsInBox(const FLeapJointCache& Joints, const FTransform& BoxTransform, const FVector& Extent,
+		TArray<FLeapJointQueryResult>& OutResults);
+
+	/** Add the joints inside a sphere to OutResults and return how many were added */
+	static int32 FindJointsInSphere(
+		const FLeapJointCache& Joints, const FVector& Center, float Radius, TArray<FLeapJointQueryResult>& OutResults);
+
+	/** Whether any joint of the hand is inside the box, see FindJointsInBox */
+	static bool IsHandInBox(const FLeapJointCache& Joints, EHandType Hand, const FTransform& BoxTransform, const FVector& Extent);
+
+	/** Joint of the hand nearest to the segment from Start to End, false if the hand isn't visible */
+	static bool GetHandDistanceToSegment(const FLeapJointCache& Joints, EHandType Hand, const FVector& Start, const FVector& End,
+		FLeapJointQueryResult& OutResult);
+
+	/** Distance between two fingertips, of the same hand or not. False if either hand isn't visible */
+	static bool GetFingertipDistance(
+		const FLeapJointCache& Joints, EHandType HandA, int32 DigitA, EHandType HandB, int32 DigitB, float& OutDistance);
+
+	/**
+	 * Distances between every fingertip of HandA and every fingertip of HandB, indexed [DigitA][DigitB]. With the same
+	 * hand twice this is the symmetric matrix of its own fingertip spreads. False if either hand isn't visible
+	 */
+	static bool GetFingertipDistances(const FLeapJointCache& Joints, EHandType HandA, EHandType HandB,
+		float OutDistances[FLeapJointCache::NumDigits][FLeapJointCache::NumDigits]);
+};
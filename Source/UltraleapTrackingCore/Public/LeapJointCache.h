@@ -0,0 +1,59 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UltraleapTrackingData.h"
+
+/**
+ * The latest frame flattened to fixed size arrays per hand, so single joints, the palm or the pinch can be read without
+ * copying FLeapFrameData and its nested arrays. The input device rebuilds it at most once per frame, on first access.
+ *
+ * Digits run from the thumb (0) to the pinky (4), joints from the metacarpal's base (0) to the fingertip (4).
+ */
+class ULTRALEAPTRACKING_API FLeapJointCache
+{
+public:
+	static constexpr int32 NumDigits = 5;
+	static constexpr int32 NumJoints = 5;
+
+	struct FHand
+	{
+		FHand();
+
+		bool bVisible = false;
+
+		FVector JointPositions[NumDigits][NumJoints];
+		/** Rotation of the bone starting at each joint, the fingertip takes the distal bone's */
+		FRotator JointRotations[NumDigits][NumJoints];
+
+		FVector PalmPosition = FVector::ZeroVector;
+		FVector PalmNormal = FVector::ZeroVector;
+		FVector PalmDirection = FVector::ZeroVector;
+		FRotator PalmOrientation = FRotator::ZeroRotator;
+
+		float PinchStrength = 0.f;
+		float PinchDistance = 0.f;
+		float GrabStrength = 0.f;
+	};
+
+	/** Flatten the first hand of each side in the frame, sides without one become invisible */
+	void SetFromFrame(const FLeapFrameData& Frame);
+
+	const FHand& GetHand(EHandType HandType) const
+	{
+		return Hands[HandType == EHandType::LEAP_HAND_LEFT ? 0 : 1];
+	}
+
+	/** False if the hand isn't visible or the digit or joint is out of range */
+	bool GetJoint(EHandType HandType, int32 Digit, int32 Joint, FVector& OutPosition, FRotator& OutRotation) const;
+
+private:
+	FHand Hands[2];
+};
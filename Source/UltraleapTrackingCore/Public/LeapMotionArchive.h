@@ -0,0 +1,216 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "LeapJointCache.h"
+
+#include <atomic>
+
+class FArchive;
+class FEvent;
+class FRunnableThread;
+
+/**
+ * Compact archive of hand motion for QA and analytics, much smaller and faster to scan than LeapC recordings or
+ * serialized FLeapFrameData.
+ *
+ * Frames are grouped into blocks. Inside a block every scalar (a timestamp, one axis of one joint, ...) is a column of
+ * quantized integers, predicted from the previous one or two values and Rice coded with a parameter picked per column,
+ * so a hand at rest costs about a bit per value. Columns are independently decodable and an index of block times at
+ * the end of the file lets a reader seek to a time range without touching the rest.
+ *
+ * Layout, little endian:
+ *   Header  uint32 Magic ('ULMA'), uint16 Version, uint16 FramesPerBlock, float PositionStep, RotationStep, StrengthStep
+ *   Block   uint32 Size, int64 FirstTime, int64 LastTime, uint16 NumFrames, uint16 NumColumns, uint16 ColumnSizes[],
+ *           then the columns: time, hand mask, then per hand every component of every channel
+ *   Index   per block uint64 Offset, uint32 Size, uint32 NumFrames, int64 FirstTime, int64 LastTime
+ *   Footer  uint64 IndexOffset, uint32 NumBlocks, uint32 Magic
+ * A file without a footer, e.g. from a crashed session, is read by walking the blocks.
+ */
+namespace LeapMotionArchive
+{
+const int32 NumHands = 2;
+
+/** Channels of each hand, the unit a reader decodes or skips */
+const int32 PalmPositionChannel = 0;
+const int32 PalmOrientationChannel = 1;
+/** One channel per joint, see JointChannel */
+const int32 FirstJointChannel = 2;
+/** Pinch and grab strength */
+const int32 StrengthChannel = FirstJointChannel + FLeapJointCache::NumDigits * FLeapJointCache::NumJoints;
+const int32 NumChannelsPerHand = StrengthChannel + 1;
+
+const uint64 AllChannels = (uint64(1) << (NumHands * NumChannelsPerHand)) - 1;
+
+inline int32 JointChannel(const int32 Digit, const int32 Joint)
+{
+	return FirstJointChannel + Digit * FLeapJointCache::NumJoints + Joint;
+}
+
+/** Bit of a channel in a reader's channel mask, HandIndex 0 is the left hand */
+inline uint64 ChannelBit(const int32 HandIndex, const int32 Channel)
+{
+	return uint64(1) << (HandIndex * NumChannelsPerHand + Channel);
+}
+
+/** Every channel of one hand */
+inline uint64 HandChannels(const int32 HandIndex)
+{
+	return ((uint64(1) << NumChannelsPerHand) - 1) << (HandIndex * NumChannelsPerHand);
+}
+
+/** Where a block is and which times it covers */
+struct FBlockIndexEntry
+{
+	uint64 Offset;
+	uint32 Size;
+	uint32 NumFrames;
+	int64 FirstTime;
+	int64 LastTime;
+};
+}	 // namespace LeapMotionArchive
+
+/** One archived frame, the left hand first */
+struct ULTRALEAPTRACKING_API FLeapMotionArchiveFrame
+{
+	struct FHand
+	{
+		FHand();
+
+		bool bVisible = false;
+		FVector PalmPosition = FVector::ZeroVector;
+		FQuat PalmOrientation = FQuat::Identity;
+		FVector JointPositions[FLeapJointCache::NumDigits][FLeapJointCache::NumJoints];
+		float PinchStrength = 0.f;
+		float GrabStrength = 0.f;
+	};
+
+	/** Frames are expected in time order */
+	int64 TimeMicros = 0;
+	FHand Hands[LeapMotionArchive::NumHands];
+
+	void SetFromJoints(const FLeapJointCache& Joints, int64 InTimeMicros);
+};
+
+/**
+ * Streams frames to an archive. AddFrame only copies the frame into one of a few preallocated block buffers, a
+ * writer thread encodes and writes full blocks. If the thread falls behind by every buffer new frames are dropped
+ * and counted rather than blocking the caller.
+ */
+class ULTRALEAPTRACKING_API FLeapMotionArchiveWriter : public FRunnable
+{
+public:
+	FLeapMotionArchiveWriter();
+	virtual ~FLeapMotionArchiveWriter();
+
+	/** Path from leap.Archive.Path made absolute, empty if the device shouldn't record */
+	static FString GetConfiguredPath();
+
+	/** PositionStep is the quantization step of positions in their units, centimetres for frame data */
+	bool Open(const FString& Path, int32 FramesPerBlock = 256, float PositionStep = 0.01f);
+
+	/** Encode the pending frames, write the index and close the file. Waits for the writer thread */
+	void Close();
+
+	bool IsOpen() const
+	{
+		return Archive != nullptr;
+	}
+
+	/** One producer thread at a time. Doesn't allocate */
+	void AddFrame(const FLeapMotionArchiveFrame& Frame);
+
+	int64 GetBytesWritten() const
+	{
+		return BytesWritten;
+	}
+
+	int32 GetNumDroppedFrames() const
+	{
+		return NumDroppedFrames;
+	}
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	static constexpr int32 NumBlockBuffers = 4;
+
+	void WriteBlock(const TArray<FLeapMotionArchiveFrame>& Frames);
+
+	FArchive* Archive;
+	int32 FramesPerBlock;
+	float PositionStep;
+
+	// Producer fills Blocks[NumProduced % NumBlockBuffers], the writer thread empties the ones before it
+	TArray<FLeapMotionArchiveFrame> Blocks[NumBlockBuffers];
+	std::atomic<uint32> NumProduced{0};
+	std::atomic<uint32> NumConsumed{0};
+
+	// Writer thread only until it has stopped
+	TArray<LeapMotionArchive::FBlockIndexEntry> Index;
+	TArray<int64> ColumnValues;
+	TArray<uint8> BlockBuffer;
+	bool bWriteFailed;
+
+	FRunnableThread* Thread;
+	FEvent* WakeEvent;
+	std::atomic<bool> bStopping{false};
+	std::atomic<int64> BytesWritten{0};
+	std::atomic<int32> NumDroppedFrames{0};
+};
+
+/** Reads an archive, decoding only the blocks in the requested time range and the requested channels */
+class ULTRALEAPTRACKING_API FLeapMotionArchiveReader
+{
+public:
+	FLeapMotionArchiveReader();
+	~FLeapMotionArchiveReader();
+
+	bool Open(const FString& Path);
+	void Close();
+
+	int32 GetNumFrames() const;
+
+	int32 GetNumBlocks() const
+	{
+		return Index.Num();
+	}
+
+	/** Time of the first and last frame, in the recorded microseconds */
+	int64 GetStartTime() const;
+	int64 GetEndTime() const;
+
+	/**
+	 * Replace OutFrames with the frames from StartTime to EndTime inclusive. Time and visibility are always decoded,
+	 * channels missing from ChannelMask (see LeapMotionArchive::ChannelBit) keep their defaults, as do hidden hands
+	 */
+	bool Read(int64 StartTime, int64 EndTime, uint64 ChannelMask, TArray<FLeapMotionArchiveFrame>& OutFrames);
+
+private:
+	bool ReadIndex(int64 FileSize);
+	bool RebuildIndex(int64 FileSize);
+	bool DecodeBlock(const LeapMotionArchive::FBlockIndexEntry& Block, int64 StartTime, int64 EndTime, uint64 ChannelMask,
+		TArray<FLeapMotionArchiveFrame>& OutFrames);
+
+	FArchive* Archive;
+	float PositionStep;
+	float RotationStep;
+	float StrengthStep;
+	TArray<LeapMotionArchive::FBlockIndexEntry> Index;
+
+	// Decoding scratch
+	TArray<uint8> BlockBuffer;
+	TArray<int64> ColumnValues;
+	TArray<int64> Times;
+	TArray<int64> HandMasks;
+};
@@ -0,0 +1,241 @@
+/******************************************************************************
+ * Copyright (C) Ultraleap, Inc. 2011-2021.                                   *
+ *                                                                            *
+ * Use subject to the terms of the Apache License 2.0 available at            *
+ * http://www.apache.org/licenses/LICENSE-2.0, or another agreement           *
+ * between Ultraleap and you, your company or other organization.             *
+ ******************************************************************************/
+
+#pragma once
+
+// Wire format of the plugin tracking server. Deliberately free of engine types so external tools can include it as is,
+// see Extras/LeapTrackingClient for a reference client.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Every datagram starts with the same 8 byte preamble:
+ *   uint32 Magic ('ULTP'), uint16 Version, uint8 Type, uint8 HandCount (0 for other messages)
+ *
+ * Client -> server
+ *   Hello    preamble, uint16 MaxRateHz, uint16 reserved. Subscribes, or renews the subscription, of the sender address.
+ *            Clients send it about once a second, the server drops clients it hasn't heard from for a few seconds.
+ *   Goodbye  preamble. Unsubscribes the sender.
+ *
+ * Server -> client
+ *   Frame    preamble, uint32 Sequence, int32 FrameId, int64 TimestampMicros, then HandCount hands.
+ *            Sequence counts the frames sent to that client, so a gap is a dropped datagram.
+ *   Goodbye  preamble with the server version, sent in reply to a Hello with an unsupported version.
+ *
+ * All values are little endian, floats are IEEE 754. Encoding is a plain copy, so like the engine this assumes a little
+ * endian host. Positions are in centimetres in Unreal space (X forward, Y right, Z up) after HMD compensation, exactly
+ * what the plugin hands to blueprints.
+ */
+namespace LeapTrackingProtocol
+{
+const uint32_t Magic = 0x50544C55;
+const uint16_t Version = 1;
+const uint16_t DefaultPort = 24601;
+
+/** One left and one right hand, further hands are not sent. A full frame is 768 bytes, well inside one datagram */
+const int32_t MaxHands = 2;
+
+/** Elbow, wrist, palm, then for thumb, index, middle, ring and pinky the metacarpal base and the four bone tips */
+const int32_t NumJoints = 3 + 5 * 5;
+
+enum class EMessageType : uint8_t
+{
+	Invalid = 0,
+	Hello = 1,
+	Frame = 2,
+	Goodbye = 3
+};
+
+struct FHand
+{
+	uint32_t Id;
+	/** 0 left, 1 right */
+	uint8_t HandType;
+	/** Bit per digit, thumb first */
+	uint8_t ExtendedFingers;
+	float Confidence;
+	float GrabStrength;
+	float PinchStrength;
+	/** Palm orientation X, Y, Z, W */
+	float PalmRotation[4];
+	float Joints[NumJoints][3];
+};
+
+struct FFrameHeader
+{
+	uint32_t Sequence;
+	int32_t FrameId;
+	int64_t TimestampMicros;
+	uint8_t HandCount;
+};
+
+const size_t PreambleSize = 8;
+const size_t HelloSize = PreambleSize + 4;
+const size_t FrameHeaderSize = PreambleSize + 16;
+const size_t HandSize = 4 + 1 + 1 + 2 + 3 * 4 + 4 * 4 + NumJoints * 3 * 4;
+const size_t MaxFrameSize = FrameHeaderSize + MaxHands * HandSize;
+
+/** Byte offset of the frame sequence number, lets a server patch it per client without encoding again */
+const size_t SequenceOffset = PreambleSize;
+
+namespace Detail
+{
+template <typename T>
+inline void Put(uint8_t*& Cursor, const T Value)
+{
+	memcpy(Cursor, &Value, sizeof(T));
+	Cursor += sizeof(T);
+}
+
+template <typename T>
+inline T Get(const uint8_t*& Cursor)
+{
+	T Value;
+	memcpy(&Value, Cursor, sizeof(T));
+	Cursor += sizeof(T);
+	return Value;
+}
+
+inline void PutPreamble(uint8_t*& Cursor, const uint16_t InVersion, const EMessageType Type, const uint8_t HandCount)
+{
+	Put<uint32_t>(Cursor, Magic);
+	Put<uint16_t>(Cursor, InVersion);
+	Put<uint8_t>(Cursor, (uint8_t) Type);
+	Put<uint8_t>(Cursor, HandCount);
+}
+}	 // namespace Detail
+
+/** Type and version of a datagram, Invalid if it isn't one of ours */
+inline EMessageType ReadPreamble(const uint8_t* Data, const size_t Size, uint16_t& OutVersion)
+{
+	if (Size < PreambleSize)
+	{
+		return EMessageType::Invalid;
+	}
+	const uint8_t* Cursor = Data;
+	if (Detail::Get<uint32_t>(Cursor) != Magic)
+	{
+		return EMessageType::Invalid;
+	}
+	OutVersion = Detail::Get<uint16_t>(Cursor);
+	const uint8_t Type = Detail::Get<uint8_t>(Cursor);
+	return Type >= (uint8_t) EMessageType::Hello && Type <= (uint8_t) EMessageType::Goodbye ? (EMessageType) Type
+																							: EMessageType::Invalid;
+}
+
+/** Returns the bytes written, 0 if the buffer is too small */
+inline size_t WriteHello(uint8_t* Buffer, const size_t Size, const uint16_t MaxRateHz, const uint16_t InVersion = Version)
+{
+	if (Size < HelloSize)
+	{
+		return 0;
+	}
+	uint8_t* Cursor = Buffer;
+	Detail::PutPreamble(Cursor, InVersion, EMessageType::Hello, 0);
+	Detail::Put<uint16_t>(Cursor, MaxRateHz);
+	Detail::Put<uint16_t>(Cursor, 0);
+	return HelloSize;
+}
+
+inline bool ReadHello(const uint8_t* Data, const size_t Size, uint16_t& OutMaxRateHz)
+{
+	if (Size < HelloSize)
+	{
+		return false;
+	}
+	const uint8_t* Cursor = Data + PreambleSize;
+	OutMaxRateHz = Detail::Get<uint16_t>(Cursor);
+	return true;
+}
+
+inline size_t WriteGoodbye(uint8_t* Buffer, const size_t Size)
+{
+	if (Size < PreambleSize)
+	{
+		return 0;
+	}
+	uint8_t* Cursor = Buffer;
+	Detail::PutPreamble(Cursor, Version, EMessageType::Goodbye, 0);
+	return PreambleSize;
+}
+
+/** Returns the bytes written, 0 if the buffer is too small or there are too many hands */
+inline size_t WriteFrame(uint8_t* Buffer, const size_t Size, const FFrameHeader& Header, const FHand* Hands)
+{
+	const size_t FrameSize = FrameHeaderSize + Header.HandCount * HandSize;
+	if (Header.HandCount > MaxHands || Size < FrameSize)
+	{
+		return 0;
+	}
+	uint8_t* Cursor = Buffer;
+	Detail::PutPreamble(Cursor, Version, EMessageType::Frame, Header.HandCount);
+	Detail::Put<uint32_t>(Cursor, Header.Sequence);
+	Detail::Put<int32_t>(Cursor, Header.FrameId);
+	Detail::Put<int64_t>(Cursor, Header.TimestampMicros);
+
+	for (int32_t HandIndex = 0; HandIndex < Header.HandCount; HandIndex++)
+	{
+		const FHand& Hand = Hands[HandIndex];
+		Detail::Put<uint32_t>(Cursor, Hand.Id);
+		Detail::Put<uint8_t>(Cursor, Hand.HandType);
+		Detail::Put<uint8_t>(Cursor, Hand.ExtendedFingers);
+		Detail::Put<uint16_t>(Cursor, 0);
+		Detail::Put<float>(Cursor, Hand.Confidence);
+		Detail::Put<float>(Cursor, Hand.GrabStrength);
+		Detail::Put<float>(Cursor, Hand.PinchStrength);
+		memcpy(Cursor, Hand.PalmRotation, sizeof(Hand.PalmRotation));
+		Cursor += sizeof(Hand.PalmRotation);
+		memcpy(Cursor, Hand.Joints, sizeof(Hand.Joints));
+		Cursor += sizeof(Hand.Joints);
+	}
+	return FrameSize;
+}
+
+/** Hands must have room for MaxHands */
+inline bool ReadFrame(const uint8_t* Data, const size_t Size, FFrameHeader& OutHeader, FHand* Hands)
+{
+	if (Size < FrameHeaderSize)
+	{
+		return false;
+	}
+	OutHeader.HandCount = Data[PreambleSize - 1];
+	if (OutHeader.HandCount > MaxHands || Size < FrameHeaderSize + OutHeader.HandCount * HandSize)
+	{
+		return false;
+	}
+
+	const uint8_t* Cursor = Data + PreambleSize;
+	OutHeader.Sequence = Detail::Get<uint32_t>(Cursor);
+	OutHeader.FrameId = Detail::Get<int32_t>(Cursor);
+	OutHeader.TimestampMicros = Detail::Get<int64_t>(Cursor);
+
+	for (int32_t HandIndex = 0; HandIndex < OutHeader.HandCount; HandIndex++)
+	{
+		FHand& Hand = Hands[HandIndex];
+		Hand.Id = Detail::Get<uint32_t>(Cursor);
+		Hand.HandType = Detail::Get<uint8_t>(Cursor);
+		Hand.ExtendedFingers = Detail::Get<uint8_t>(Cursor);
+		Cursor += 2;
+		Hand.Confidence = Detail::Get<float>(Cursor);
+		Hand.GrabStrength = Detail::Get<float>(Cursor);
+		Hand.PinchStrength = Detail::Get<float>(Cursor);
+		memcpy(Hand.PalmRotation, Cursor, sizeof(Hand.PalmRotation));
+		Cursor += sizeof(Hand.PalmRotation);
+		memcpy(Hand.Joints, Cursor, sizeof(Hand.Joints));
+		Cursor += sizeof(Hand.Joints);
+	}
+	return true;
+}
+
+inline void PatchSequence(uint8_t* Frame, const uint32_t Sequence)
+{
+	memcpy(Frame + SequenceOffset, &Sequence, sizeof(Sequence));
+}
+}	 // namespace LeapTrackingProtocol
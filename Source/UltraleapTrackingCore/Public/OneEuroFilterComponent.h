@@ -10,6 +10,43 @@
 
 #include "OneEuroFilterComponent.generated.h"
 
+/**
+ * One Euro filter for rotations. The adaptive cutoff is driven by angular speed (rad/s) and the low pass step is a
+ * slerp towards the new sample, so there is no Euler wraparound or gimbal flip.
+ */
+class ULTRALEAPTRACKING_API FLeapOneEuroRotationFilter
+{
+public:
+	FLeapOneEuroRotationFilter();
+
+	void Init(const float InMinCutoff, const float InCutoffSlope, const float InDeltaCutoff);
+
+	/** Smooth rotation */
+	FQuat Filter(const FQuat& InRaw, const float InDeltaTime);
+
+	/** Forget the history, the next sample passes through unfiltered */
+	void Reset();
+
+	/** If the filter was not executed yet */
+	bool IsFirstTime() const;
+
+	static float CalculateAlpha(const float InCutoff, const float InDeltaTime);
+
+	float MinCutoff;
+	float CutoffSlope;
+	float DeltaCutoff;
+
+private:
+	/** The previous filtered value */
+	FQuat Previous;
+
+	/** The previous filtered angular speed */
+	float PreviousSpeed;
+
+	/** If this is the first time doing a filter */
+	bool bFirstTime;
+};
+
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
 class ULTRALEAPTRACKING_API UOneEuroFilterComponent : public UActorComponent
 {
@@ -56,14 +93,22 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Ultraleap IE")
 	FVector Filter(const FVector& InRaw, const float InDeltaTime);
 
+	/** Smooth rotation, see SetRotationCutoffSlope */
+	UFUNCTION(BlueprintCallable, Category = "Ultraleap IE")
+	FRotator FilterRotation(const FRotator& InRaw, const float InDeltaTime);
+
 	/** Set the minimum cutoff */
 	UFUNCTION(BlueprintCallable, Category = "Ultraleap IE")
 	void SetMinCutoff(const float InMinCutoff);
 
-	/** Set the cutoff slope */
+	/** Set the cutoff slope, in Hz per cm/s of speed */
 	UFUNCTION(BlueprintCallable, Category = "Ultraleap IE")
 	void SetCutoffSlope(const float InCutoffSlope);
 
+	/** Set the cutoff slope of FilterRotation, in Hz per rad/s of angular speed */
+	UFUNCTION(BlueprintCallable, Category = "Ultraleap IE")
+	void SetRotationCutoffSlope(const float InRotationCutoffSlope);
+
 	/** Set the delta slope */
 	UFUNCTION(BlueprintCallable, Category = "Ultraleap IE")
 	void SetDeltaCutoff(const float InDeltaCutoff);
@@ -78,4 +123,5 @@ private:
 	double DeltaCutoff;
 	FLowpassFilter RawFilter;
 	FLowpassFilter DeltaFilter;
+	FLeapOneEuroRotationFilter RotationFilter;
 };
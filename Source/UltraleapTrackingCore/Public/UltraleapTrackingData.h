@@ -61,6 +61,27 @@ enum ELeapServiceLogLevel
 	LEAP_LOG_INFO
 };
 
+/** Pipeline stages at which the age of the hand data is measured, relative to the device timestamp */
+UENUM(BlueprintType)
+enum ELeapLatencyStage
+{
+	LEAP_LATENCY_SERVICE_THREAD,	// Tracking event received on the LeapC service thread
+	LEAP_LATENCY_GAME_THREAD,		// Frame consumed by the game thread input tick
+	LEAP_LATENCY_ANIM_EVALUATION,	// BodyState bones evaluated by an anim graph
+	LEAP_LATENCY_RENDER_SUBMIT		// Render thread finished submitting the frame
+};
+
+/** Type held by a tracking service configuration value */
+UENUM(BlueprintType)
+enum class ELeapConfigValueType : uint8
+{
+	LEAP_CONFIG_UNKNOWN,	// Not set, or the service has no setting with the key
+	LEAP_CONFIG_BOOL,
+	LEAP_CONFIG_INT,
+	LEAP_CONFIG_FLOAT,
+	LEAP_CONFIG_STRING
+};
+
 USTRUCT(BlueprintType)
 struct ULTRALEAPTRACKING_API FLeapDevice
 {
@@ -106,6 +127,64 @@ struct ULTRALEAPTRACKING_API FLeapDevice
 	void SetFromLeapDevice(struct _LEAP_DEVICE_INFO* LeapInfo);
 };
 
+/** State of the service thread's connection to the tracking service */
+USTRUCT(BlueprintType)
+struct ULTRALEAPTRACKING_API FLeapServiceConnectionStats
+{
+	GENERATED_USTRUCT_BODY()
+	FLeapServiceConnectionStats();
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	bool bIsConnected;
+
+	/** Connections made since the connection was opened, more than one means the service went away and came back */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	int32 Connections;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	int32 ConnectionsLost;
+
+	/** Failed polls while disconnected, each followed by a backoff wait */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	int32 ReconnectAttempts;
+
+	/** Current wait between reconnect attempts, 0 while connected */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	float ReconnectBackoffSeconds;
+
+	/** Time since the last connect or disconnect */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	float SecondsInState;
+};
+
+/** Time to first hand, in milliseconds from opening the connection, 0 until reached */
+USTRUCT(BlueprintType)
+struct ULTRALEAPTRACKING_API FLeapStartupStats
+{
+	GENERATED_USTRUCT_BODY()
+	FLeapStartupStats();
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	float ConnectedMS;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	float DeviceFoundMS;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	float FirstFrameMS;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	float FirstHandMS;
+
+	/** The device found is the one remembered from the last session, its info was available while connecting */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	bool bUsedCachedDevice;
+
+	/** From the end of the last map load until hands were tracked, 0 until they are */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	float MapLoadToHandMS;
+};
+
 /** Read only stats from the plugin such as version and prediction interval. */
 USTRUCT(BlueprintType)
 struct ULTRALEAPTRACKING_API FLeapStats
@@ -121,6 +200,158 @@ struct ULTRALEAPTRACKING_API FLeapStats
 
 	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
 	float FrameExtrapolationInMS;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	FLeapServiceConnectionStats ServiceConnection;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	FLeapStartupStats Startup;
+
+	/** Tracking paused because nothing consumes hands, only with leap.Pause.Auto set */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	bool bIsTrackingPaused;
+
+	/** Components, hand meshes, LiveLink clients, subscribers and recent polls keeping tracking running */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Stats")
+	int32 TrackingConsumers;
+};
+
+/** Rolling latency percentiles for one pipeline stage, in milliseconds */
+USTRUCT(BlueprintType)
+struct ULTRALEAPTRACKING_API FLeapLatencyPercentiles
+{
+	GENERATED_USTRUCT_BODY()
+	FLeapLatencyPercentiles();
+
+	/** Samples in the rolling window */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Latency")
+	int32 SampleCount;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Latency")
+	float MeanMS;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Latency")
+	float P50MS;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Latency")
+	float P90MS;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Latency")
+	float P99MS;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Latency")
+	float MaxMS;
+};
+
+/** A tracking service setting, as read with LeapRequestConfigValue or written with LeapSaveConfigValue */
+USTRUCT(BlueprintType)
+struct ULTRALEAPTRACKING_API FLeapConfigValue
+{
+	GENERATED_USTRUCT_BODY()
+	FLeapConfigValue();
+
+	/** Only the matching value field is meaningful */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leap Config")
+	ELeapConfigValueType Type;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leap Config")
+	bool BoolValue;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leap Config")
+	int32 IntValue;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leap Config")
+	float FloatValue;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leap Config")
+	FString StringValue;
+
+	static FLeapConfigValue MakeBool(bool Value);
+	static FLeapConfigValue MakeInt(int32 Value);
+	static FLeapConfigValue MakeFloat(float Value);
+	static FLeapConfigValue MakeString(const FString& Value);
+
+	/** Copies the value, LeapC's string is only valid until the next poll */
+	void SetFromLeapVariant(const struct _LEAP_VARIANT* Variant);
+
+	bool operator==(const FLeapConfigValue& Other) const;
+	FString ToString() const;
+};
+
+/** Outcome of an asynchronous configuration read or write */
+USTRUCT(BlueprintType)
+struct ULTRALEAPTRACKING_API FLeapConfigResult
+{
+	GENERATED_USTRUCT_BODY()
+	FLeapConfigResult();
+	explicit FLeapConfigResult(const FString& InKey);
+
+	/** False if the service refused the request, had no such setting, didn't answer in time or the connection closed */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Config")
+	bool bSuccess;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Config")
+	FString Key;
+
+	/** The value read, or the value written once the service has applied it */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Config")
+	FLeapConfigValue Value;
+};
+
+/** A joint found by a spatial hand query, see FLeapHandQueries */
+USTRUCT(BlueprintType)
+struct ULTRALEAPTRACKING_API FLeapJointQueryResult
+{
+	GENERATED_USTRUCT_BODY()
+	FLeapJointQueryResult();
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Hand Query")
+	TEnumAsByte<EHandType> Hand;
+
+	/** From the thumb (0) to the pinky (4) */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Hand Query")
+	int32 Digit;
+
+	/** From the metacarpal's base (0) to the fingertip (4) */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Hand Query")
+	int32 Joint;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Hand Query")
+	FVector Position;
+
+	/** To the queried point or segment, or to the volume's center */
+	UPROPERTY(BlueprintReadOnly, Category = "Leap Hand Query")
+	float Distance;
+};
+
+/**
+ * A recorded motion gesture, see FLeapGestureRecognizer. Made by recording a hand with ULeapGestureRecognizerComponent
+ * and saved with the component, Samples aren't meant to be edited by hand.
+ */
+USTRUCT(BlueprintType)
+struct ULTRALEAPTRACKING_API FLeapGestureTemplate
+{
+	GENERATED_USTRUCT_BODY()
+	FLeapGestureTemplate();
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leap Gesture")
+	FName Name;
+
+	/** How long the gesture took when it was recorded, in seconds */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leap Gesture")
+	float Duration;
+
+	/** Palm movement of the recording in cm, performances much smaller or larger than this aren't compared */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leap Gesture")
+	float Extent;
+
+	/** Match distance for this gesture, 0 uses the recognizer's */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leap Gesture")
+	float Threshold;
+
+	/** Normalized palm and fingertip positions, the palm then the thumb to the pinky tip for each time step */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leap Gesture")
+	TArray<FVector> Samples;
 };
 
 USTRUCT(BlueprintType)
@@ -151,6 +382,10 @@ struct ULTRALEAPTRACKING_API FLeapOptions
 	UPROPERTY(BlueprintReadWrite, Category = "Leap Options")
 	bool bUseInterpolation;
 
+	/** With OpenXR as the source, interpolate by extrapolating hands with a constant velocity model. Off uses them as sampled */
+	UPROPERTY(BlueprintReadWrite, Category = "Leap Options")
+	bool bUseOpenXRPrediction;
+
 	/** Should all leap data be transported to HMD space? */
 	UPROPERTY(BlueprintReadWrite, Category = "Leap Options")
 	bool bTransformOriginToHMD;
@@ -201,10 +436,48 @@ struct ULTRALEAPTRACKING_API FLeapOptions
 	UPROPERTY(BlueprintReadWrite, Category = "Gesture Options")
 	float PinchTimeout;
 
+	/** Smooth all joint positions with a per-joint One Euro filter before events and BodyState receive the frame */
+	UPROPERTY(BlueprintReadWrite, Category = "Smoothing Options")
+	bool bUseJointSmoothing;
+
+	/** Cutoff frequency in Hz applied when joints are still. Lower is smoother but lags more */
+	UPROPERTY(BlueprintReadWrite, Category = "Smoothing Options")
+	float JointSmoothingMinCutoff;
+
+	/** How much the cutoff rises with joint speed (Hz per cm/s). Higher reduces lag on fast motion */
+	UPROPERTY(BlueprintReadWrite, Category = "Smoothing Options")
+	float JointSmoothingCutoffSlope;
+
+	/** Cutoff frequency in Hz used to smooth the joint speed estimate */
+	UPROPERTY(BlueprintReadWrite, Category = "Smoothing Options")
+	float JointSmoothingDeltaCutoff;
+
+	/** Smooth palm, arm and bone orientations with a quaternion One Euro filter */
+	UPROPERTY(BlueprintReadWrite, Category = "Smoothing Options")
+	bool bUseRotationSmoothing;
+
+	/** Cutoff frequency in Hz applied when bones are not rotating */
+	UPROPERTY(BlueprintReadWrite, Category = "Smoothing Options")
+	float RotationSmoothingMinCutoff;
+
+	/** How much the cutoff rises with angular speed (Hz per rad/s) */
+	UPROPERTY(BlueprintReadWrite, Category = "Smoothing Options")
+	float RotationSmoothingCutoffSlope;
+
+	/** Convert, smooth and check gestures on every device frame exactly once, timed by the device rather than the game
+	 * frame rate. Frames are processed on the service thread, so interpolation doesn't apply. LeapC source only */
+	UPROPERTY(BlueprintReadWrite, Category = "Leap Options")
+	bool bUseFixedRateProcessing;
+
 	/** Experimental: Pull tracking data from OpenXR instead of LeapC.dll. Note that Pinch and Grasp events and strength are not yet
 	 * implemented  */
 	UPROPERTY(BlueprintReadWrite, Category = "Leap Options")
 	bool bUseOpenXRAsSource;
+
+	/** With OpenXR as the source, fill BodyState bones straight from the OpenXR joint poses instead of going through
+	 * the Leap frame. Events and frame data are unaffected. Ignored while joint or rotation smoothing is enabled */
+	UPROPERTY(BlueprintReadWrite, Category = "Leap Options")
+	bool bUseOpenXRDirectBodyState;
 };
 
 USTRUCT(BlueprintType)
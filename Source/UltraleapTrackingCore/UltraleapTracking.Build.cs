@@ -124,6 +124,9 @@ namespace UnrealBuildTool.Rules
 			PrivateDependencyModuleNames.AddRange(
 				new string[]
 				{
+					"Json",
+					"Networking",
+					"Sockets",
 					// ... add private dependencies that you statically link with here ...
 				}
 				);